@@ -0,0 +1,219 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Algorithms/BrainStimulator/BarycentricTreecode.h>
+#include <Core/Thread/Parallel.h>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::BrainStimulator;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+
+ALGORITHM_PARAMETER_DEF(BrainStimulator, TreecodeTheta);
+ALGORITHM_PARAMETER_DEF(BrainStimulator, TreecodeDegree);
+
+namespace
+{
+  const int maxDegree = 16;
+  const int maxDepth = 32;
+}
+
+BarycentricTreecode::BarycentricTreecode(const std::vector<Vector>& sources,
+  const std::vector<Vector>& weights, double theta, int degree)
+  : theta_(theta), degree_(std::min(std::max(degree, 1), maxDegree))
+{
+  numProxies_ = (degree_ + 1) * (degree_ + 1) * (degree_ + 1);
+  const size_t numSources = std::min(sources.size(), weights.size());
+  if (numSources == 0)
+    return;
+
+  // Build the octree breadth first so the children of a cluster are stored
+  // next to each other; the sources are sorted along with it.
+  std::vector<size_t> order(numSources);
+  std::iota(order.begin(), order.end(), 0);
+  points_.assign(sources.begin(), sources.begin() + numSources);
+
+  clusters_.push_back(makeCluster(0, numSources, 0));
+  for (size_t c = 0; c < clusters_.size(); ++c)
+  {
+    const Cluster cluster = clusters_[c];
+    if (cluster.end - cluster.begin <= numProxies_ || cluster.depth >= maxDepth)
+      continue;
+
+    // split the range into octants around the center of the bounding box
+    auto octant = [&](size_t s)
+    {
+      const Vector& p = sources[s];
+      return (p.x() > cluster.center.x() ? 1 : 0) + (p.y() > cluster.center.y() ? 2 : 0) + (p.z() > cluster.center.z() ? 4 : 0);
+    };
+    std::stable_sort(order.begin() + cluster.begin, order.begin() + cluster.end,
+      [&](size_t a, size_t b) { return octant(a) < octant(b); });
+
+    clusters_[c].firstChild = clusters_.size();
+    size_t begin = cluster.begin;
+    while (begin < cluster.end)
+    {
+      const int oct = octant(order[begin]);
+      size_t end = begin + 1;
+      while (end < cluster.end && octant(order[end]) == oct)
+        ++end;
+      for (size_t s = begin; s < end; ++s)
+        points_[s] = sources[order[s]];
+      clusters_.push_back(makeCluster(begin, end, cluster.depth + 1));
+      begin = end;
+    }
+    clusters_[c].numChildren = clusters_.size() - clusters_[c].firstChild;
+  }
+
+  for (size_t s = 0; s < numSources; ++s)
+    points_[s] = sources[order[s]];
+  weights_.resize(numSources);
+  for (size_t s = 0; s < numSources; ++s)
+    weights_[s] = weights[order[s]];
+
+  // Only clusters with more sources than proxies are worth approximating
+  size_t numProxyClusters = 0;
+  for (auto& cluster : clusters_)
+  {
+    if (cluster.end - cluster.begin > numProxies_)
+      cluster.proxyBegin = numProxies_ * numProxyClusters++;
+  }
+  proxyPoints_.resize(numProxies_ * numProxyClusters);
+  proxyWeights_.assign(numProxies_ * numProxyClusters, Vector(0.0, 0.0, 0.0));
+
+  Parallel::For(0, clusters_.size(), 1, [this](size_t begin, size_t end)
+  {
+    for (size_t c = begin; c < end; ++c)
+    {
+      if (clusters_[c].proxyBegin != npos)
+        computeProxies(clusters_[c]);
+    }
+  });
+}
+
+BarycentricTreecode::Cluster BarycentricTreecode::makeCluster(size_t begin, size_t end, int depth) const
+{
+  Vector lo = points_[begin];
+  Vector hi = points_[begin];
+  for (size_t s = begin + 1; s < end; ++s)
+  {
+    lo = Min(lo, points_[s]);
+    hi = Max(hi, points_[s]);
+  }
+
+  Cluster cluster;
+  cluster.center = 0.5 * (lo + hi);
+  cluster.radius = 0.5 * (hi - lo).length();
+  cluster.begin = begin;
+  cluster.end = end;
+  cluster.firstChild = 0;
+  cluster.numChildren = 0;
+  cluster.proxyBegin = npos;
+  cluster.depth = depth;
+  return cluster;
+}
+
+void BarycentricTreecode::computeProxies(Cluster& cluster)
+{
+  const int n = degree_;
+
+  // Chebyshev points of the second kind on the bounding box of the sources
+  Vector lo = points_[cluster.begin];
+  Vector hi = points_[cluster.begin];
+  for (size_t s = cluster.begin + 1; s < cluster.end; ++s)
+  {
+    lo = Min(lo, points_[s]);
+    hi = Max(hi, points_[s]);
+  }
+
+  double nodes[3][maxDegree + 1];
+  for (int d = 0; d < 3; ++d)
+  {
+    const double mid = 0.5 * (lo[d] + hi[d]);
+    const double half = 0.5 * (hi[d] - lo[d]);
+    for (int k = 0; k <= n; ++k)
+      nodes[d][k] = mid + half * std::cos(k * M_PI / n);
+  }
+
+  for (int i = 0; i <= n; ++i)
+    for (int j = 0; j <= n; ++j)
+      for (int k = 0; k <= n; ++k)
+        proxyPoints_[cluster.proxyBegin + (i * (n + 1) + j) * (n + 1) + k] = Vector(nodes[0][i], nodes[1][j], nodes[2][k]);
+
+  // barycentric weights of the Chebyshev points
+  double bary[maxDegree + 1];
+  for (int k = 0; k <= n; ++k)
+    bary[k] = ((k % 2) ? -1.0 : 1.0) * ((k == 0 || k == n) ? 0.5 : 1.0);
+
+  double L[3][maxDegree + 1];
+  for (size_t s = cluster.begin; s < cluster.end; ++s)
+  {
+    for (int d = 0; d < 3; ++d)
+    {
+      const double x = points_[s][d];
+      int exact = -1;
+      double denom = 0.0;
+      for (int k = 0; k <= n; ++k)
+      {
+        const double diff = x - nodes[d][k];
+        if (diff == 0.0)
+        {
+          exact = k;
+          break;
+        }
+        L[d][k] = bary[k] / diff;
+        denom += L[d][k];
+      }
+
+      if (exact >= 0)
+      {
+        for (int k = 0; k <= n; ++k)
+          L[d][k] = (k == exact) ? 1.0 : 0.0;
+      }
+      else
+      {
+        for (int k = 0; k <= n; ++k)
+          L[d][k] /= denom;
+      }
+    }
+
+    const Vector& q = weights_[s];
+    for (int i = 0; i <= n; ++i)
+      for (int j = 0; j <= n; ++j)
+      {
+        const double Lij = L[0][i] * L[1][j];
+        Vector* proxy = &proxyWeights_[cluster.proxyBegin + (i * (n + 1) + j) * (n + 1)];
+        for (int k = 0; k <= n; ++k)
+          proxy[k] += (Lij * L[2][k]) * q;
+      }
+  }
+}
@@ -0,0 +1,133 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_ALGORITHMS_BRAINSTIMULATOR_BARYCENTRICTREECODE_H
+#define CORE_ALGORITHMS_BRAINSTIMULATOR_BARYCENTRICTREECODE_H
+
+#include <Core/GeometryPrimitives/Vector.h>
+#include <Core/Algorithms/Base/AlgorithmBase.h>
+#include <vector>
+#include <Core/Algorithms/BrainStimulator/share.h>
+
+///@file BarycentricTreecode
+///@brief Treecode for fast summation of magnetic field kernels
+///
+///@details
+/// Evaluates F(t) = sum_s K(x_s - t, q_s) for kernels K that are linear in the
+/// vector weight q_s, such as the Biot-Savart and magnetic dipole kernels.
+/// The sources are sorted into an octree. A cluster that is well separated from
+/// the target (radius < theta * distance) is replaced by proxy sources on a
+/// tensor grid of Chebyshev points, whose weights follow from barycentric
+/// Lagrange interpolation, so no kernel specific expansions are needed
+/// (Wang, Krasny and Tlupova, 2020). The error decreases with smaller theta and
+/// higher interpolation degree.
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace BrainStimulator {
+
+  /// Multipole acceptance parameter of the treecode; 0 selects the exact direct summation
+  ALGORITHM_PARAMETER_DECL(TreecodeTheta);
+  /// Degree of the Chebyshev interpolation used for the cluster proxies
+  ALGORITHM_PARAMETER_DECL(TreecodeDegree);
+
+  class SCISHARE BarycentricTreecode
+  {
+  public:
+    BarycentricTreecode(const std::vector<Geometry::Vector>& sources,
+      const std::vector<Geometry::Vector>& weights, double theta, int degree);
+
+    /// Sum of kernel(x_s - target, q_s) over all sources; kernel has the signature
+    /// Geometry::Vector (const Geometry::Vector& r, const Geometry::Vector& q)
+    template <class Kernel>
+    Geometry::Vector evaluate(const Geometry::Vector& target, const Kernel& kernel) const
+    {
+      Geometry::Vector F(0.0, 0.0, 0.0);
+      if (!clusters_.empty())
+        accumulate(0, target, kernel, F);
+      return F;
+    }
+
+    size_t numClusters() const { return clusters_.size(); }
+
+    /// theta has to be below 1, otherwise a cluster around the target can be
+    /// accepted and the singular kernel gets interpolated; 0 is left to the
+    /// callers for the exact direct summation.
+    static bool validTheta(double theta) { return theta >= 0.0 && theta < 1.0; }
+
+  private:
+    struct Cluster
+    {
+      Geometry::Vector center;
+      double radius;
+      size_t begin, end;            // range of the sorted sources
+      size_t firstChild, numChildren;
+      size_t proxyBegin;            // offset of the proxies, or npos for clusters evaluated directly
+      int depth;
+    };
+
+    template <class Kernel>
+    void accumulate(size_t c, const Geometry::Vector& target, const Kernel& kernel, Geometry::Vector& F) const
+    {
+      const Cluster& cluster = clusters_[c];
+      if (cluster.proxyBegin != npos && cluster.radius < theta_ * (cluster.center - target).length())
+      {
+        for (size_t k = cluster.proxyBegin; k < cluster.proxyBegin + numProxies_; ++k)
+          F += kernel(proxyPoints_[k] - target, proxyWeights_[k]);
+      }
+      else if (cluster.numChildren == 0)
+      {
+        for (size_t s = cluster.begin; s < cluster.end; ++s)
+          F += kernel(points_[s] - target, weights_[s]);
+      }
+      else
+      {
+        for (size_t child = cluster.firstChild; child < cluster.firstChild + cluster.numChildren; ++child)
+          accumulate(child, target, kernel, F);
+      }
+    }
+
+    Cluster makeCluster(size_t begin, size_t end, int depth) const;
+    void computeProxies(Cluster& cluster);
+
+    static const size_t npos = static_cast<size_t>(-1);
+
+    double theta_;
+    int degree_;
+    size_t numProxies_;
+    std::vector<Geometry::Vector> points_;
+    std::vector<Geometry::Vector> weights_;
+    std::vector<Cluster> clusters_;
+    std::vector<Geometry::Vector> proxyPoints_;
+    std::vector<Geometry::Vector> proxyWeights_;
+  };
+
+}}}}
+
+#endif
@@ -27,6 +27,7 @@
 
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/BrainStimulator/BiotSavartSolverAlgorithm.h>
+#include <Core/Algorithms/BrainStimulator/VectorArrays.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
@@ -37,6 +38,7 @@
 #include <Core/Thread/Barrier.h>
 #include <Core/Thread/Parallel.h>
 #include <boost/lexical_cast.hpp>
+#include <atomic>
 #include <cassert>
 #include <iomanip>
 #include <locale>
@@ -57,12 +59,129 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, VectorBField);
 ALGORITHM_PARAMETER_DEF(BrainStimulator, VectorAField);
 ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 
+namespace
+{
+  //! Terms of the direct summations, one block of sources at a time (see sumInBlocks)
+
+  //! Magnetic field of piece-wise linear coil segments; rn receives the distances
+  BRAINSTIMULATOR_SIMD_CLONES
+  void pieceWiseFieldTerms(size_t n, const double* mx, const double* my, const double* mz,
+    const double* dx, const double* dy, const double* dz, const double* absCurrent,
+    double px, double py, double pz,
+    double* __restrict fx, double* __restrict fy, double* __restrict fz, double* __restrict rn)
+  {
+    for (size_t i = 0; i < n; ++i)
+    {
+      //! Vector connecting the infinitesimal curve-element
+      const double rx = mx[i] - px, ry = my[i] - py, rz = mz[i] - pz;
+      const double Rn = std::sqrt(rx * rx + ry * ry + rz * rz);
+      const double scale = absCurrent[i] / (Rn * Rn * Rn);
+      rn[i] = Rn;
+      fx[i] = 1.0e-7 * (ry * dz[i] - rz * dy[i]) * scale;
+      fy[i] = 1.0e-7 * (rz * dx[i] - rx * dz[i]) * scale;
+      fz[i] = 1.0e-7 * (rx * dy[i] - ry * dx[i]) * scale;
+    }
+  }
+
+  //! Magnetic vector potential of piece-wise linear coil segments
+  BRAINSTIMULATOR_SIMD_CLONES
+  void pieceWisePotentialTerms(size_t n, const double* mx, const double* my, const double* mz,
+    const double* dx, const double* dy, const double* dz, const double* absCurrent,
+    double px, double py, double pz,
+    double* __restrict fx, double* __restrict fy, double* __restrict fz)
+  {
+    for (size_t i = 0; i < n; ++i)
+    {
+      const double rx = mx[i] - px, ry = my[i] - py, rz = mz[i] - pz;
+      const double scale = absCurrent[i] / std::sqrt(rx * rx + ry * ry + rz * rz);
+      fx[i] = 1.0e-7 * dx[i] * scale;
+      fy[i] = 1.0e-7 * dy[i] * scale;
+      fz[i] = 1.0e-7 * dz[i] * scale;
+    }
+  }
+
+  //! Magnetic field of volumetric current elements
+  BRAINSTIMULATOR_SIMD_CLONES
+  void volumetricFieldTerms(size_t n, const double* cx, const double* cy, const double* cz,
+    const double* jx, const double* jy, const double* jz, const double* evol,
+    double px, double py, double pz,
+    double* __restrict fx, double* __restrict fy, double* __restrict fz)
+  {
+    for (size_t i = 0; i < n; ++i)
+    {
+      const double rx = cx[i] - px, ry = cy[i] - py, rz = cz[i] - pz;
+      const double Rl = std::sqrt(rx * rx + ry * ry + rz * rz);
+      const double scale = evol[i] / (4.0 * M_PI * Rl);
+      fx[i] = (jy[i] * rz - jz[i] * ry) * scale;
+      fy[i] = (jz[i] * rx - jx[i] * rz) * scale;
+      fz[i] = (jx[i] * ry - jy[i] * rx) * scale;
+    }
+  }
+
+  //! Magnetic vector potential of volumetric current elements
+  BRAINSTIMULATOR_SIMD_CLONES
+  void volumetricPotentialTerms(size_t n, const double* cx, const double* cy, const double* cz,
+    const double* jx, const double* jy, const double* jz, const double* evol,
+    double px, double py, double pz,
+    double* __restrict fx, double* __restrict fy, double* __restrict fz)
+  {
+    for (size_t i = 0; i < n; ++i)
+    {
+      const double rx = cx[i] - px, ry = cy[i] - py, rz = cz[i] - pz;
+      const double scale = evol[i] / (4.0 * M_PI * std::sqrt(rx * rx + ry * ry + rz * rz));
+      fx[i] = jx[i] * scale;
+      fy[i] = jy[i] * scale;
+      fz[i] = jz[i] * scale;
+    }
+  }
+
+  //! Magnetic field of magnetic dipoles
+  BRAINSTIMULATOR_SIMD_CLONES
+  void dipoleFieldTerms(size_t n, const double* lx, const double* ly, const double* lz,
+    const double* mx, const double* my, const double* mz,
+    double px, double py, double pz,
+    double* __restrict fx, double* __restrict fy, double* __restrict fz)
+  {
+    for (size_t i = 0; i < n; ++i)
+    {
+      const double rx = lx[i] - px, ry = ly[i] - py, rz = lz[i] - pz;
+      const double Rl = std::sqrt(rx * rx + ry * ry + rz * rz);
+      const double Rl3 = Rl * Rl * Rl;
+      const double Rl5 = Rl * Rl * Rl * Rl * Rl;
+      const double mDotR = mx[i] * rx + my[i] * ry + mz[i] * rz;
+      fx[i] = 1.0e-7 * (rx * 3 * mDotR / Rl5 - mx[i] / Rl3);
+      fy[i] = 1.0e-7 * (ry * 3 * mDotR / Rl5 - my[i] / Rl3);
+      fz[i] = 1.0e-7 * (rz * 3 * mDotR / Rl5 - mz[i] / Rl3);
+    }
+  }
+
+  //! Magnetic vector potential of magnetic dipoles
+  BRAINSTIMULATOR_SIMD_CLONES
+  void dipolePotentialTerms(size_t n, const double* lx, const double* ly, const double* lz,
+    const double* mx, const double* my, const double* mz,
+    double px, double py, double pz,
+    double* __restrict fx, double* __restrict fy, double* __restrict fz)
+  {
+    for (size_t i = 0; i < n; ++i)
+    {
+      const double rx = lx[i] - px, ry = ly[i] - py, rz = lz[i] - pz;
+      const double Rl = std::sqrt(rx * rx + ry * ry + rz * rz);
+      const double Rl3 = Rl * Rl * Rl;
+      fx[i] = 1.0e-7 * (my[i] * rz - mz[i] * ry) / Rl3;
+      fy[i] = 1.0e-7 * (mz[i] * rx - mx[i] * rz) / Rl3;
+      fz[i] = 1.0e-7 * (mx[i] * ry - my[i] * rx) / Rl3;
+    }
+  }
+}
+
 class KernelBase
 {
  public:
   KernelBase(const AlgorithmBase* algo, int t)
       : algo_(algo), numprocessors_(Parallel::NumCores()),
-        barrier_("BSV KernelBase Barrier", numprocessors_), typeOut_(t)
+        barrier_("BSV KernelBase Barrier", numprocessors_), typeOut_(t),
+        treecodeTheta_(algo->get(Parameters::TreecodeTheta).toDouble()),
+        treecodeDegree_(algo->get(Parameters::TreecodeDegree).toInt())
   {}
 
   virtual ~KernelBase() = default;
@@ -93,6 +212,50 @@ class KernelBase
   int typeOut_;
   DenseMatrixHandle matOut_;
 
+  //! treecode accuracy, theta = 0 keeps the exact direct summation
+  double treecodeTheta_;
+  int treecodeDegree_;
+
+  bool useTreecode() const { return treecodeTheta_ > 0.0; }
+
+  //! Evaluate the sum over all sources at the model nodes with a treecode,
+  //! kernel(R, q) gets R = source - model node
+  template <class Kernel>
+  void treecodeIntegration(const std::vector<Vector>& sources, const std::vector<Vector>& weights, const Kernel& kernel)
+  {
+    algo_->remark("Evaluating " + std::to_string(sources.size()) + " sources with a treecode, theta = " +
+                  std::to_string(treecodeTheta_) + ", degree = " + std::to_string(treecodeDegree_));
+
+    const BarycentricTreecode tree(sources, weights, treecodeTheta_, treecodeDegree_);
+    std::atomic<bool> failed(false);
+
+    Parallel::For(0, modelSize_, 256, [&](size_t begin, size_t end)
+    {
+      try
+      {
+        Point modelNode;
+        for (size_t iM = begin; iM < end; ++iM)
+        {
+          vmesh_->get_node(modelNode, VMesh::Node::index_type(iM));
+          const Vector F = tree.evaluate(Vector(modelNode), kernel);
+          matOut_->put(iM, 0, F[0]);
+          matOut_->put(iM, 1, F[1]);
+          matOut_->put(iM, 2, F[2]);
+        }
+      }
+      catch (...)
+      {
+        failed = true;
+      }
+    });
+
+    if (failed)
+    {
+      algo_->error("Treecode evaluation crashed while integrating");
+      success_.assign(success_.size(), false);
+    }
+  }
+
   bool preIntegration(FieldHandle& mesh, FieldHandle& coil)
   {
     vmesh_ = mesh->vmesh();
@@ -190,6 +353,39 @@ class PieceWiseKernel : public KernelBase
       coilNodes_.emplace_back(enode2);
     }
 
+    discretizeCoil();
+
+    if (useTreecode())
+    {
+      std::vector<Vector> sources, weights;
+      sources.reserve(mid_.size());
+      weights.reserve(mid_.size());
+      for (size_t i = 0; i < mid_.size(); ++i)
+      {
+        sources.push_back(mid_[i]);
+        weights.push_back(dL_[i] * absCurrent_[i]);
+      }
+
+      if (typeOut_ == 1)
+      {
+        //! Biot-Savart Magnetic Field
+        treecodeIntegration(sources, weights, [](const Vector& R, const Vector& dL)
+          { const double Rn = R.length(); return 1.0e-7 * Cross(R, dL) / (Rn * Rn * Rn); });
+      }
+      else if (typeOut_ == 2)
+      {
+        //! Biot-Savart Magnetic Vector Potential Field
+        treecodeIntegration(sources, weights, [](const Vector& R, const Vector& dL)
+          { return 1.0e-7 * dL / R.length(); });
+      }
+      return postIntegration(outdata);
+    }
+
+    algo_->remark("Per core load: " + formatWithCommas(modelSize_ / numprocessors_ * mid_.size()) +
+                  " field computations.");
+    algo_->remark("To speed up this module, reduce the number of nodes in either the input mesh or "
+                  "the coil, or pick a simpler algorithm.");
+
     //! Start the multi threaded
     Parallel::RunTasks([this](int i) { ParallelKernel(i); }, numprocessors_);
 
@@ -212,6 +408,12 @@ class PieceWiseKernel : public KernelBase
   //! keep nodes on the coil cached
   std::vector<Vector> coilNodes_;
 
+  //! integration points of all coil segments: midpoints and curve elements of the
+  //! sub-segments and the absolute current of their segment
+  VectorArrays mid_;
+  VectorArrays dL_;
+  std::vector<double> absCurrent_;
+
   //! execute in parallel
   void ParallelKernel(int proc_num)
   {
@@ -224,18 +426,13 @@ class PieceWiseKernel : public KernelBase
 
     assert(begins <= ends);
 
-    //! buffer of points used for integration
-    std::vector<Vector> integrPoints;
-    integrPoints.reserve(256);
-
-    //! keep previous step length
-    //! used for optimization purpose
-    double prevSegLen = 123456789.12345678;
-
-    //! number of integration points
-    int nips = 0;
-
-    bool remarkedOnProblemSize = false;
+    const double* mx = mid_.x.data();
+    const double* my = mid_.y.data();
+    const double* mz = mid_.z.data();
+    const double* dx = dL_.x.data();
+    const double* dy = dL_.y.data();
+    const double* dz = dL_.z.data();
+    const double* absCurrent = absCurrent_.data();
 
     try
     {
@@ -243,104 +440,37 @@ class PieceWiseKernel : public KernelBase
       {
         Point modelNodeP;
         vmesh_->get_node(modelNodeP, iM);
-        const Vector modelNodeV(modelNodeP);
+        const double px = modelNodeP.x(), py = modelNodeP.y(), pz = modelNodeP.z();
 
         // result
         Vector F;
+        bool tooClose = false;
 
-        for (size_t iC0 = 0, iC1 = 1, iCV = 0; iC0 < coilNodes_.size(); iC0 += 2, iC1 += 2, iCV++)
+        if (typeOut_ == 1)
         {
-          double currentFromField;
-          vcoilField_->get_value(currentFromField, iCV);
-
-          const double current = currentFromField == 0.0 ? 1.0 : currentFromField;
-          auto absCurrent = std::fabs(current);
-
-          Vector coilNodeThis;
-          Vector coilNodeNext;
-
-          if (current >= 0.0)
-          {
-            coilNodeThis = coilNodes_[iC0];
-            coilNodeNext = coilNodes_[iC1];
-          }
-          else
+          //! Biot-Savart Magnetic Field
+          F = sumInBlocks(mid_.size(), [&](size_t b, size_t n, double* fx, double* fy, double* fz)
           {
-            coilNodeThis = coilNodes_[iC1];
-            coilNodeNext = coilNodes_[iC0];
-          }
-
-          //! Length of the curve element
-          Vector diffNodes = coilNodeNext - coilNodeThis;
-          const double newSegLen = diffNodes.length();
-
-          // first check if externally suplied integration step is available and use it
-          if (extstep_ > 0) { nips = newSegLen / extstep_; }
-          else
-          {
-            //! optimization
-            //! only recompute integration step only if segment length changes
-            if (fabs(prevSegLen - newSegLen) > 0.00000001)
-            {
-              prevSegLen = newSegLen;
-
-              // auto adaptive integration step calculation
-              nips = adjustNumberOfIntegrationPoints(newSegLen);
-            }
-          }
-
-          if (nips < 3) { algo_->warning("integration step too big"); }
-
-          integrPoints.clear();
-
-          if (!remarkedOnProblemSize && proc_num == 0)
-          {
-            auto problemSize = (ends - begins) * coilNodes_.size() * nips;
-            algo_->remark(
-                "Per core load: " + formatWithCommas(problemSize) + " field computations.");
-            algo_->remark(
-                "To speed up this module, reduce the number of nodes in either the input mesh or "
-                "the coil, or pick a simpler algorithm.");
-            remarkedOnProblemSize = true;
-          }
-
-          //! curve segment discretization
-          for (int iip = 0; iip < nips; iip++)
-          {
-            const double interpolant = static_cast<double>(iip) / static_cast<double>(nips);
-            auto v = Interpolate(coilNodeThis, coilNodeNext, interpolant);
-            integrPoints.push_back(v);
-          }
-
-          //! integration step over line segment
-          for (int iip = 0; iip < nips - 1; iip++)
+            double rn[sumBlockSize];
+            pieceWiseFieldTerms(n, mx + b, my + b, mz + b, dx + b, dy + b, dz + b, absCurrent + b,
+              px, py, pz, fx, fy, fz, rn);
+            tooClose |= *std::min_element(rn, rn + n) < 0.00001;
+          });
+        }
+        else if (typeOut_ == 2)
+        {
+          //! Biot-Savart Magnetic Vector Potential Field
+          F = sumInBlocks(mid_.size(), [&](size_t b, size_t n, double* fx, double* fy, double* fz)
           {
-            const auto piip = integrPoints[iip];
-            const auto piip1 = integrPoints[iip + 1];
-            //! Vector connecting the infinitesimal curve-element
-            auto Rxyz = (piip + piip1) / 2 - modelNodeV;
-
-            //! Infinitesimal curve-element components
-            auto dLxyz = piip1 - piip;
-
-            const double Rn = Rxyz.length();
-
-            if (typeOut_ == 1)
-            {
-              //! check for distance between coil and model close to zero
-              //! it might cause numerical stability issues with respect to the cross-product
-              if (Rn < 0.00001) { algo_->warning("coil<->model distance approaching zero!"); }
-              //! Biot-Savart Magnetic Field
-              F += 1.0e-7 * Cross(Rxyz, dLxyz) * (absCurrent / (Rn * Rn * Rn));
-            }
-            else if (typeOut_ == 2)
-            {
-              //! Biot-Savart Magnetic Vector Potential Field
-              F += 1.0e-7 * dLxyz * (absCurrent / (Rn));
-            }
-          }
+            pieceWisePotentialTerms(n, mx + b, my + b, mz + b, dx + b, dy + b, dz + b, absCurrent + b,
+              px, py, pz, fx, fy, fz);
+          });
         }
 
+        //! check for distance between coil and model close to zero
+        //! it might cause numerical stability issues with respect to the cross-product
+        if (tooClose) { algo_->warning("coil<->model distance approaching zero!"); }
+
         matOut_->put(iM, 0, F[0]);
         matOut_->put(iM, 1, F[1]);
         matOut_->put(iM, 2, F[2]);
@@ -372,6 +502,56 @@ class PieceWiseKernel : public KernelBase
       if (!success_[q]) return;
   }
 
+  //! Discretize all coil segments once, so the kernel only reads plain arrays
+  void discretizeCoil()
+  {
+    double prevSegLen = 123456789.12345678;
+    int nips = 0;
+
+    mid_ = VectorArrays();
+    dL_ = VectorArrays();
+    absCurrent_.clear();
+
+    for (size_t iC0 = 0, iC1 = 1, iCV = 0; iC0 < coilNodes_.size(); iC0 += 2, iC1 += 2, iCV++)
+    {
+      double currentFromField;
+      vcoilField_->get_value(currentFromField, iCV);
+
+      const double current = currentFromField == 0.0 ? 1.0 : currentFromField;
+      const auto absCurrent = std::fabs(current);
+
+      const Vector& coilNodeThis = current >= 0.0 ? coilNodes_[iC0] : coilNodes_[iC1];
+      const Vector& coilNodeNext = current >= 0.0 ? coilNodes_[iC1] : coilNodes_[iC0];
+
+      //! Length of the curve element
+      const double newSegLen = (coilNodeNext - coilNodeThis).length();
+
+      // first check if externally suplied integration step is available and use it
+      if (extstep_ > 0) { nips = newSegLen / extstep_; }
+      //! only recompute integration step only if segment length changes
+      else if (fabs(prevSegLen - newSegLen) > 0.00000001)
+      {
+        prevSegLen = newSegLen;
+
+        // auto adaptive integration step calculation
+        nips = adjustNumberOfIntegrationPoints(newSegLen);
+      }
+
+      if (nips < 3) { algo_->warning("integration step too big"); }
+
+      //! curve segment discretization
+      Vector piip = Interpolate(coilNodeThis, coilNodeNext, 0.0);
+      for (int iip = 0; iip < nips - 1; iip++)
+      {
+        const auto piip1 = Interpolate(coilNodeThis, coilNodeNext, static_cast<double>(iip + 1) / nips);
+        mid_.push_back((piip + piip1) / 2);
+        dL_.push_back(piip1 - piip);
+        absCurrent_.push_back(absCurrent);
+        piip = piip1;
+      }
+    }
+  }
+
   //! Auto adjust accuracy of integration
   int adjustNumberOfIntegrationPoints(double len)
   {
@@ -417,6 +597,45 @@ class VolumetricKernel : public KernelBase
 
     vmesh_->synchronize(Mesh::NODES_E | Mesh::EDGES_E);
 
+    //! read the coil elements once
+    Point coilCenter;
+    Vector current;
+    centers_.reserve(coilSize_);
+    currents_.reserve(coilSize_);
+    volumes_.reserve(coilSize_);
+    for (VMesh::Elem::index_type iC = 0; iC < coilSize_; iC++)
+    {
+      vcoilField_->get_value(current, iC);
+      vcoilField_->get_center(coilCenter, iC);  // auto resolve based on basis_order
+      centers_.push_back(Vector(coilCenter));
+      currents_.push_back(current);
+      volumes_.push_back(vcoil_->get_volume(iC));
+    }
+
+    if (useTreecode())
+    {
+      std::vector<Vector> sources(coilSize_), weights(coilSize_);
+      for (size_t iC = 0; iC < centers_.size(); iC++)
+      {
+        sources[iC] = centers_[iC];
+        weights[iC] = currents_[iC] * volumes_[iC];
+      }
+
+      if (typeOut_ == 1)
+      {
+        //! Biot-Savart Magnetic Field
+        treecodeIntegration(sources, weights, [](const Vector& R, const Vector& J)
+          { return Cross(J, R) / (4.0 * M_PI * R.length()); });
+      }
+      else if (typeOut_ == 2)
+      {
+        //! Biot-Savart Magnetic Vector Potential Field
+        treecodeIntegration(sources, weights, [](const Vector& R, const Vector& J)
+          { return J / (4.0 * M_PI * R.length()); });
+      }
+      return postIntegration(outdata);
+    }
+
     //! Start the multi threaded
     Parallel::RunTasks([this](int i) { ParallelKernel(i); }, numprocessors_);
 
@@ -424,51 +643,58 @@ class VolumetricKernel : public KernelBase
   }
 
  private:
+  //! element centers, current densities and volumes of the coil
+  VectorArrays centers_;
+  VectorArrays currents_;
+  std::vector<double> volumes_;
+
   void ParallelKernel(int proc_num)
   {
     assert(proc_num >= 0);
 
     int cnt = 0;
     Point modelNode;
-    Point coilCenter;
-    Vector current;
 
     const VMesh::Node::index_type begins = (modelSize_ * proc_num) / numprocessors_;
     const VMesh::Node::index_type ends = (modelSize_ * (proc_num + 1)) / numprocessors_;
 
     assert(begins <= ends);
 
+    const double* cx = centers_.x.data();
+    const double* cy = centers_.y.data();
+    const double* cz = centers_.z.data();
+    const double* jx = currents_.x.data();
+    const double* jy = currents_.y.data();
+    const double* jz = currents_.z.data();
+    const double* evol = volumes_.data();
+
     try
     {
       for (auto iM = begins; iM < ends; ++iM)
       {
         vmesh_->get_node(modelNode, iM);
+        const double px = modelNode.x(), py = modelNode.y(), pz = modelNode.z();
 
         //! accumulatedresult
-        Vector F, R;
+        Vector F;
 
-        for (VMesh::Elem::index_type iC = 0; iC < coilSize_; iC++)
+        if (typeOut_ == 1)
         {
-          vcoilField_->get_value(current, iC);
-
-          vcoilField_->get_center(coilCenter, iC);  // auto resolve based on basis_order
-
-          const double evol = vcoil_->get_volume(iC);
-
-          R = coilCenter - modelNode;
-
-          const double Rl = R.length();
-
-          if (typeOut_ == 1)
+          //! Biot-Savart Magnetic Field
+          F = sumInBlocks(centers_.size(), [&](size_t b, size_t n, double* fx, double* fy, double* fz)
           {
-            //! Biot-Savart Magnetic Field
-            F += Cross(current, R) * (evol / (4.0 * M_PI * Rl));
-          }
-          else if (typeOut_ == 2)
+            volumetricFieldTerms(n, cx + b, cy + b, cz + b, jx + b, jy + b, jz + b, evol + b,
+              px, py, pz, fx, fy, fz);
+          });
+        }
+        else if (typeOut_ == 2)
+        {
+          //! Biot-Savart Magnetic Vector Potential Field
+          F = sumInBlocks(centers_.size(), [&](size_t b, size_t n, double* fx, double* fy, double* fz)
           {
-            //! Biot-Savart Magnetic Vector Potential Field
-            F += current * (evol / (4.0 * M_PI * Rl));
-          }
+            volumetricPotentialTerms(n, cx + b, cy + b, cz + b, jx + b, jy + b, jz + b, evol + b,
+              px, py, pz, fx, fy, fz);
+          });
         }
 
         matOut_->put(iM, 0, F[0]);
@@ -525,6 +751,49 @@ class DipolesKernel : public KernelBase
     // needed?
     vmesh_->synchronize(Mesh::NODES_E | Mesh::EDGES_E);
 
+    //! read the dipoles once
+    Point dipoleLocation;
+    Vector dipoleMoment;
+    locations_.reserve(coilSize_);
+    moments_.reserve(coilSize_);
+    for (VMesh::Elem::index_type iC = 0; iC < coilSize_; iC++)
+    {
+      vcoilField_->get_value(dipoleMoment, iC);
+      vcoilField_->get_center(dipoleLocation, iC);  // auto resolve based on basis_order
+      locations_.push_back(Vector(dipoleLocation));
+      moments_.push_back(dipoleMoment);
+    }
+
+    if (useTreecode())
+    {
+      std::vector<Vector> sources(coilSize_), weights(coilSize_);
+      for (size_t iC = 0; iC < locations_.size(); iC++)
+      {
+        sources[iC] = locations_[iC];
+        weights[iC] = moments_[iC];
+      }
+
+      if (typeOut_ == 1)
+      {
+        //! Biot-Savart Magnetic Field
+        treecodeIntegration(sources, weights, [](const Vector& R, const Vector& m)
+        {
+          const double Rl = R.length();
+          return 1.0e-7 * (3 * R * Dot(m, R) / (Rl * Rl * Rl * Rl * Rl) - m / (Rl * Rl * Rl));
+        });
+      }
+      else if (typeOut_ == 2)
+      {
+        //! Biot-Savart Magnetic Vector Potential Field
+        treecodeIntegration(sources, weights, [](const Vector& R, const Vector& m)
+        {
+          const double Rl = R.length();
+          return 1.0e-7 * Cross(m, R) / (Rl * Rl * Rl);
+        });
+      }
+      return postIntegration(outdata);
+    }
+
     //! Start the multi threaded
     Parallel::RunTasks([this](int i) { ParallelKernel(i); }, numprocessors_);
 
@@ -532,48 +801,56 @@ class DipolesKernel : public KernelBase
   }
 
  private:
+  //! dipole locations and moments
+  VectorArrays locations_;
+  VectorArrays moments_;
+
   void ParallelKernel(int proc_num)
   {
     assert(proc_num >= 0);
 
     int cnt = 0;
     Point modelNode;
-    Point dipoleLocation;
-    Vector dipoleMoment;
 
     const VMesh::Node::index_type begins = (modelSize_ * proc_num) / numprocessors_;
     const VMesh::Node::index_type ends = (modelSize_ * (proc_num + 1)) / numprocessors_;
 
     assert(begins <= ends);
 
+    const double* lx = locations_.x.data();
+    const double* ly = locations_.y.data();
+    const double* lz = locations_.z.data();
+    const double* mx = moments_.x.data();
+    const double* my = moments_.y.data();
+    const double* mz = moments_.z.data();
+
     try
     {
       for (VMesh::Node::index_type iM = begins; iM < ends; iM++)
       {
         vmesh_->get_node(modelNode, iM);
+        const double px = modelNode.x(), py = modelNode.y(), pz = modelNode.z();
 
         //! accumulated result
-        Vector F, R;
+        Vector F;
 
-        for (VMesh::Elem::index_type iC = 0; iC < coilSize_; iC++)
+        if (typeOut_ == 1)
         {
-          vcoilField_->get_value(dipoleMoment, iC);
-          vcoilField_->get_center(dipoleLocation, iC);  // auto resolve based on basis_order
-
-          R = dipoleLocation - modelNode;
-          double Rl = R.length();
-
-          if (typeOut_ == 1)
+          //! Biot-Savart Magnetic Field
+          F = sumInBlocks(locations_.size(), [&](size_t b, size_t n, double* fx, double* fy, double* fz)
           {
-            //! Biot-Savart Magnetic Field
-            F += 1.0e-7 * (3 * R * Dot(dipoleMoment, R) / (Rl * Rl * Rl * Rl * Rl) -
-                              dipoleMoment / (Rl * Rl * Rl));
-          }
-          if (typeOut_ == 2)
+            dipoleFieldTerms(n, lx + b, ly + b, lz + b, mx + b, my + b, mz + b,
+              px, py, pz, fx, fy, fz);
+          });
+        }
+        if (typeOut_ == 2)
+        {
+          //! Biot-Savart Magnetic Vector Potential Field
+          F = sumInBlocks(locations_.size(), [&](size_t b, size_t n, double* fx, double* fy, double* fz)
           {
-            //! Biot-Savart Magnetic Vector Potential Field
-            F += 1.0e-7 * Cross(dipoleMoment, R) / (Rl * Rl * Rl);
-          }
+            dipolePotentialTerms(n, lx + b, ly + b, lz + b, mx + b, my + b, mz + b,
+              px, py, pz, fx, fy, fz);
+          });
         }
 
         matOut_->put(iM, 0, F[0]);
@@ -588,7 +865,6 @@ class DipolesKernel : public KernelBase
           {
             cnt = 0;
             algo_->update_progress_max(iM, ends - begins);
-            ;
           }
         }
       }
@@ -631,6 +907,12 @@ bool BiotSavartSolverAlgorithm::run(
     return (false);
   }
 
+  if (!BarycentricTreecode::validTheta(get(Parameters::TreecodeTheta).toDouble()))
+  {
+    error("Treecode theta has to be 0 for the exact summation or between 0 and 1.");
+    return (false);
+  }
+
   if (coil->vmesh()->is_curvemesh())
   {
     if (coil->vfield()->is_constantdata() && coil->vfield()->is_scalar())
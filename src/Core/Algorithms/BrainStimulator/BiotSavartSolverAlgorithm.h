@@ -34,6 +34,7 @@
 #include <Core/Datatypes/Matrix.h>
 
 #include <Core/Algorithms/Base/AlgorithmBase.h>
+#include <Core/Algorithms/BrainStimulator/BarycentricTreecode.h>
 #include <Core/Algorithms/BrainStimulator/share.h>
 
 ///@file BiotSavartSolverAlgorithm
@@ -64,6 +65,8 @@ namespace BrainStimulator {
     BiotSavartSolverAlgorithm()
     {
       addParameter(Parameters::OutType, 0);
+      addParameter(Parameters::TreecodeTheta, 0.0);
+      addParameter(Parameters::TreecodeDegree, 4);
     }
     AlgorithmOutput run(const AlgorithmInput& input) const override;
     bool run(FieldHandle mesh, FieldHandle coil, Datatypes::DenseMatrixHandle& outdata, int outtype) const;
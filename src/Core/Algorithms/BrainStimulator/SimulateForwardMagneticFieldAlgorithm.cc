@@ -41,6 +41,7 @@
 #include <Core/Logging/ScopedTimeRemarker.h>
 #include <Core/Logging/Log.h>
 #include <Core/Algorithms/BrainStimulator/SimulateForwardMagneticFieldAlgorithm.h>
+#include <Core/Algorithms/BrainStimulator/VectorArrays.h>
 #include <string>
 #include <vector>
 #include <algorithm>
@@ -60,6 +61,12 @@ AlgorithmInputName SimulateForwardMagneticFieldAlgo::DetectorLocations("Detector
 AlgorithmOutputName SimulateForwardMagneticFieldAlgo::MagneticField("MagneticField");
 AlgorithmOutputName SimulateForwardMagneticFieldAlgo::MagneticFieldMagnitudes("MagneticFieldMagnitudes");
 
+SimulateForwardMagneticFieldAlgo::SimulateForwardMagneticFieldAlgo()
+{
+  addParameter(Parameters::TreecodeTheta, 0.0);
+  addParameter(Parameters::TreecodeDegree, 4);
+}
+
 class CalcFMField
 {
   public:
@@ -75,13 +82,14 @@ class CalcFMField
 					   FieldHandle detectors);
 
   private:
-    void interpolate(int proc, Point p);
+    Vector interpolate(const Point& p) const;
     void set_up_cell_cache();
+    void set_up_sources();
     void calc_parallel(int proc);
+    void calc_treecode();
 
     const AlgorithmBase* algo_;
     int np_;
-    std::vector<Vector> interp_value_;
     std::vector<std::pair<std::string, Tensor> > tens_;
     bool have_tensors_;
 
@@ -93,6 +101,13 @@ class CalcFMField
 
     std::vector<per_cell_cache>  cell_cache_;
 
+    // Element currents and dipoles both contribute Cross(P, radius)/|radius|^3 * scale,
+    // with scale the element volume or 1 for a dipole. The elements come first, so
+    // source i < num_elems is element i.
+    VectorArrays source_positions_;
+    VectorArrays source_moments_;
+    std::vector<double> source_scales_;
+
     VField* efld_; // Electric Field
     VField* ctfld_; // Conductivity Field
     VField* dipfld_; // Dipole Field
@@ -107,30 +122,51 @@ class CalcFMField
     VField* magmagfld_; // Magnetic Field Magnitudes
 };
 
-void CalcFMField::interpolate(int proc, Point p)
+namespace
 {
-  emsh_->synchronize(Mesh::ELEM_LOCATE_E);
-
-  VMesh::Elem::index_type inside_cell = 0;
-  bool outside = !(emsh_->locate(inside_cell, p));
-
-  VMesh::size_type num_elems = emsh_->num_elems();
-
-  for (VMesh::Elem::index_type idx; idx<num_elems; idx++)
+  // Terms of the summation in CalcFMField::interpolate, one block of sources at a time
+  BRAINSTIMULATOR_SIMD_CLONES
+  void sourceTerms(size_t n, const double* sx, const double* sy, const double* sz,
+    const double* mx, const double* my, const double* mz, const double* scale,
+    double px, double py, double pz,
+    double* __restrict fx, double* __restrict fy, double* __restrict fz)
   {
-    if (outside || idx != inside_cell)
+    for (size_t i = 0; i < n; ++i)
     {
-      per_cell_cache &c = cell_cache_[idx];
-      Vector radius = p - c.center_;
-
-      Vector valueJXR = Cross(c.cur_density_, radius);
-      double length = radius.length();
-
-      interp_value_[proc] += ((valueJXR / (length * length * length)) * c.volume_);
+      const double rx = px - sx[i], ry = py - sy[i], rz = pz - sz[i];
+      const double length = std::sqrt(rx * rx + ry * ry + rz * rz);
+      const double length3 = length * length * length;
+      fx[i] = ((my[i] * rz - mz[i] * ry) / length3) * scale[i];
+      fy[i] = ((mz[i] * rx - mx[i] * rz) / length3) * scale[i];
+      fz[i] = ((mx[i] * ry - my[i] * rx) / length3) * scale[i];
     }
   }
 }
 
+Vector CalcFMField::interpolate(const Point& p) const
+{
+  VMesh::Elem::index_type inside_cell = 0;
+  const bool outside = !(emsh_->locate(inside_cell, p));
+  const size_t skip = outside ? source_scales_.size() : static_cast<size_t>(inside_cell);
+
+  const double px = p.x(), py = p.y(), pz = p.z();
+  const double* sx = source_positions_.x.data();
+  const double* sy = source_positions_.y.data();
+  const double* sz = source_positions_.z.data();
+  const double* mx = source_moments_.x.data();
+  const double* my = source_moments_.y.data();
+  const double* mz = source_moments_.z.data();
+  const double* scale = source_scales_.data();
+
+  return sumInBlocks(source_scales_.size(), [&](size_t b, size_t n, double* fx, double* fy, double* fz)
+  {
+    sourceTerms(n, sx + b, sy + b, sz + b, mx + b, my + b, mz + b, scale + b, px, py, pz, fx, fy, fz);
+    // the element containing the point does not contribute
+    if (skip >= b && skip < b + n)
+      fx[skip - b] = fy[skip - b] = fz[skip - b] = 0.0;
+  });
+}
+
 void CalcFMField::set_up_cell_cache()
 {
   VMesh::size_type num_elems = emsh_->num_elems();
@@ -186,6 +222,33 @@ void CalcFMField::set_up_cell_cache()
   }
 }
 
+void CalcFMField::set_up_sources()
+{
+  VMesh::size_type num_dipoles = dipmsh_->num_nodes();
+  const size_t num_sources = cell_cache_.size() + num_dipoles;
+  source_positions_.reserve(num_sources);
+  source_moments_.reserve(num_sources);
+  source_scales_.reserve(num_sources);
+
+  for (const auto& c : cell_cache_)
+  {
+    source_positions_.push_back(Vector(c.center_));
+    source_moments_.push_back(c.cur_density_);
+    source_scales_.push_back(c.volume_);
+  }
+
+  Point pt;
+  Vector P;
+  for (VMesh::Node::index_type dip_idx = 0; dip_idx < num_dipoles; dip_idx++)
+  {
+    dipmsh_->get_center(pt, dip_idx);
+    dipfld_->value(P, dip_idx);
+    source_positions_.push_back(Vector(pt));
+    source_moments_.push_back(P);
+    source_scales_.push_back(1.0);
+  }
+}
+
 void CalcFMField::calc_parallel(int proc)
 {
 
@@ -198,12 +261,8 @@ void CalcFMField::calc_parallel(int proc)
 
   Vector mag_field;
   Point  pt;
-  Point  pt2;
-  Vector P;
   const double one_over_4_pi = 1.0 / (4 * M_PI);
 
-  VMesh::size_type num_dipoles = dipmsh_->num_nodes();
-
   int cnt = 0;
   for (VMesh::Node::index_type idx = start; idx < end; idx++ )
   {
@@ -211,28 +270,12 @@ void CalcFMField::calc_parallel(int proc)
 
     detmsh_->get_center(pt, idx);
 
-    // init the interp val to 0
-    interp_value_[proc] = Vector(0,0,0);
-    interpolate(proc, pt);
-
-    mag_field = interp_value_[proc];
+    // element currents followed by the dipoles
+    mag_field = interpolate(pt);
 
     Vector normal;
     detfld_->get_value(normal,idx);
 
-    // iterate over the dipoles.
-    for (VMesh::Node::index_type dip_idx = 0; dip_idx < num_dipoles; dip_idx++)
-    {
-      dipmsh_->get_center(pt2, dip_idx);
-      dipfld_->value(P,dip_idx);
-
-      Vector radius = pt - pt2; // detector - source
-      Vector valuePXR = Cross(P, radius);
-      double length = radius.length();
-
-      mag_field += valuePXR / (length * length * length);
-    }
-
     mag_field *= one_over_4_pi;
     magmagfld_->set_value(Dot(mag_field, normal),idx);
     magfld_->set_value(mag_field,idx);
@@ -250,6 +293,60 @@ void CalcFMField::calc_parallel(int proc)
 
 }
 
+void CalcFMField::calc_treecode()
+{
+  // The element currents and the dipoles share the kernel Cross(P, radius)/|radius|^3,
+  // so both go into one tree.
+  const size_t num_sources = source_scales_.size();
+  std::vector<Vector> sources(num_sources), weights(num_sources);
+  for (size_t i = 0; i < num_sources; ++i)
+  {
+    sources[i] = source_positions_[i];
+    weights[i] = source_moments_[i] * source_scales_[i];
+  }
+
+  const double theta = algo_->get(Parameters::TreecodeTheta).toDouble();
+  const int degree = algo_->get(Parameters::TreecodeDegree).toInt();
+  const BarycentricTreecode tree(sources, weights, theta, degree);
+
+  // kernel gets source - detector, i.e. minus the radius used in calc_parallel.
+  // A source on the detector is the center of the element containing it, which
+  // does not contribute; it is skipped here as 0/0 cannot be subtracted later.
+  auto kernel = [](const Vector& R, const Vector& P)
+  {
+    const double length = R.length();
+    if (length == 0.0)
+      return Vector(0.0, 0.0, 0.0);
+    return Cross(R, P) / (length * length * length);
+  };
+
+  const double one_over_4_pi = 1.0 / (4 * M_PI);
+
+  Parallel::For(0, detmsh_->num_nodes(), 256, [&](size_t begin, size_t end)
+  {
+    Point pt;
+    Vector normal;
+    VMesh::Elem::index_type inside_cell;
+    for (VMesh::Node::index_type idx = begin; idx < static_cast<index_type>(end); idx++)
+    {
+      detmsh_->get_center(pt, idx);
+      Vector mag_field = tree.evaluate(Vector(pt), kernel);
+
+      // as in interpolate(), the element containing the detector does not contribute
+      if (emsh_->locate(inside_cell, pt))
+      {
+        const per_cell_cache& c = cell_cache_[inside_cell];
+        mag_field -= kernel(c.center_ - pt, c.cur_density_ * c.volume_);
+      }
+
+      mag_field *= one_over_4_pi;
+      detfld_->get_value(normal, idx);
+      magmagfld_->set_value(Dot(mag_field, normal), idx);
+      magfld_->set_value(mag_field, idx);
+    }
+  });
+}
+
 boost::tuple<FieldHandle,FieldHandle> CalcFMField::calc_forward_magnetic_field(FieldHandle efield, FieldHandle ctfield, FieldHandle dipoles, FieldHandle detectors)
 {
   efld_ = efield->vfield();
@@ -298,17 +395,23 @@ boost::tuple<FieldHandle,FieldHandle> CalcFMField::calc_forward_magnetic_field(F
 
   // Make sure we have more than zero threads
   np_ = Parallel::NumCores();
-  interp_value_.resize(np_,Vector(0.0,0.0,0.0));
 
   // cache per cell calculations that are used over and over again.
   set_up_cell_cache();
+  set_up_sources();
+
+  // locate() builds its search structure lazily, so do it before the threads start
+  emsh_->synchronize(Mesh::ELEM_LOCATE_E);
 
 #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
   // do the parallel work.
   Thread::parallel(this, &CalcFMField::calc_parallel, np_, mod);
 #endif
 
-  Parallel::RunTasks([this](int i) { calc_parallel(i); }, np_);
+  if (algo_->get(Parameters::TreecodeTheta).toDouble() > 0.0)
+    calc_treecode();
+  else
+    Parallel::RunTasks([this](int i) { calc_parallel(i); }, np_);
 
   return boost::make_tuple(magnetic_field, magnetic_field_magnitudes);
 
@@ -336,6 +439,11 @@ boost::tuple<FieldHandle, FieldHandle> SimulateForwardMagneticFieldAlgo::run(Fie
     THROW_ALGORITHM_INPUT_ERROR("Must have Vector field as Detector Locations input");
   }
 
+  if (!BarycentricTreecode::validTheta(get(Parameters::TreecodeTheta).toDouble()))
+  {
+    THROW_ALGORITHM_INPUT_ERROR("Treecode theta has to be 0 for the exact summation or between 0 and 1.");
+  }
+
   CalcFMField algo(this);
   FieldHandle MField, MFieldMagnitudes;
 
@@ -0,0 +1,110 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <gtest/gtest.h>
+#include <Core/Algorithms/BrainStimulator/BarycentricTreecode.h>
+#include <Core/GeometryPrimitives/Vector.h>
+#include <Core/GeometryPrimitives/PointVectorOperators.h>
+#include <random>
+
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms::BrainStimulator;
+
+namespace
+{
+  Vector dipoleField(const Vector& R, const Vector& m)
+  {
+    const double Rl = R.length();
+    return 1.0e-7 * (3 * R * Dot(m, R) / (Rl * Rl * Rl * Rl * Rl) - m / (Rl * Rl * Rl));
+  }
+
+  class BarycentricTreecodeTest : public ::testing::Test
+  {
+  protected:
+    void SetUp() override
+    {
+      std::mt19937 gen(42);
+      std::uniform_real_distribution<double> unit(-1.0, 1.0);
+      for (int i = 0; i < 5000; ++i)
+      {
+        sources_.emplace_back(unit(gen), unit(gen), 0.1 * unit(gen));
+        weights_.emplace_back(unit(gen), unit(gen), unit(gen));
+      }
+      for (int i = 0; i < 100; ++i)
+        targets_.emplace_back(2 * unit(gen), 2 * unit(gen), 0.5 + unit(gen) * unit(gen));
+    }
+
+    double relativeError(const BarycentricTreecode& tree) const
+    {
+      double err = 0, norm = 0;
+      for (const auto& t : targets_)
+      {
+        Vector direct(0, 0, 0);
+        for (size_t s = 0; s < sources_.size(); ++s)
+          direct += dipoleField(sources_[s] - t, weights_[s]);
+        err += (tree.evaluate(t, dipoleField) - direct).length2();
+        norm += direct.length2();
+      }
+      return std::sqrt(err / norm);
+    }
+
+    std::vector<Vector> sources_, weights_, targets_;
+  };
+}
+
+TEST_F(BarycentricTreecodeTest, ZeroThetaIsDirectSum)
+{
+  BarycentricTreecode tree(sources_, weights_, 0.0, 4);
+  EXPECT_LT(relativeError(tree), 1e-12);
+}
+
+TEST_F(BarycentricTreecodeTest, ErrorDecreasesWithDegree)
+{
+  BarycentricTreecode coarse(sources_, weights_, 0.7, 2);
+  BarycentricTreecode fine(sources_, weights_, 0.7, 6);
+  EXPECT_GT(coarse.numClusters(), 1);
+
+  const double coarseError = relativeError(coarse);
+  const double fineError = relativeError(fine);
+  EXPECT_LT(coarseError, 1e-1);
+  EXPECT_LT(fineError, 1e-4);
+  EXPECT_LT(fineError, coarseError);
+}
+
+TEST(BarycentricTreecodeEdgeTest, CoincidentSources)
+{
+  std::vector<Vector> sources(2000, Vector(1, 2, 3));
+  std::vector<Vector> weights(2000, Vector(0, 0, 1));
+  BarycentricTreecode tree(sources, weights, 0.5, 3);
+
+  const Vector target(10, 0, 0);
+  const Vector F = tree.evaluate(target, dipoleField);
+  const Vector expected = 2000.0 * dipoleField(Vector(1, 2, 3) - target, Vector(0, 0, 1));
+  EXPECT_NEAR(0.0, (F - expected).length() / expected.length(), 1e-12);
+}
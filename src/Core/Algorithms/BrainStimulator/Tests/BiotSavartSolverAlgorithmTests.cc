@@ -0,0 +1,331 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <Core/Algorithms/BrainStimulator/BiotSavartSolverAlgorithm.h>
+#include <Core/Algorithms/BrainStimulator/VectorArrays.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/GeometryPrimitives/PointVectorOperators.h>
+#include <random>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::BrainStimulator;
+
+// The kernels sum the same terms as a plain loop over Vectors, in the same
+// order, so they should match such a loop up to the rounding of each term.
+static const double kernelTolerance = 1e-12;
+
+TEST(VectorArraysTest, SumInBlocksMatchesScalarLoop)
+{
+  auto term = [](size_t i) { return Vector(std::sin(0.1 * i), 1.0 / (i + 1), i % 7 - 3.0); };
+
+  for (size_t n : { 0, 1, 255, 256, 257, 1000 })
+  {
+    std::vector<int> visits(n, 0);
+    const Vector F = sumInBlocks(n, [&](size_t b, size_t count, double* fx, double* fy, double* fz)
+    {
+      for (size_t i = 0; i < count; ++i)
+      {
+        const Vector t = term(b + i);
+        fx[i] = t.x(); fy[i] = t.y(); fz[i] = t.z();
+        ++visits[b + i];
+      }
+    });
+
+    Vector expected(0, 0, 0);
+    for (size_t i = 0; i < n; ++i)
+      expected += term(i);
+
+    EXPECT_EQ(expected, F) << "n = " << n;
+    EXPECT_EQ(std::vector<int>(n, 1), visits) << "n = " << n;
+  }
+}
+
+namespace
+{
+  FieldHandle pointCloud(const std::vector<Point>& points, data_info_type type)
+  {
+    FieldInformation fi(mesh_info_type::POINTCLOUDMESH_E, databasis_info_type::LINEARDATA_E, type);
+    auto field = CreateField(fi);
+    for (const auto& p : points)
+      field->vmesh()->add_point(p);
+    field->vfield()->resize_values();
+    return field;
+  }
+
+  // Model nodes a few units away from the sources in the unit cube
+  FieldHandle modelNodes()
+  {
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+    std::vector<Point> points;
+    for (int i = 0; i < 20; ++i)
+      points.emplace_back(0.5 + 2 * unit(gen), 0.5 + 2 * unit(gen), 3.0 + unit(gen));
+    return pointCloud(points, data_info_type::DOUBLE_E);
+  }
+
+  std::vector<Point> nodesOf(FieldHandle field)
+  {
+    std::vector<Point> points(field->vmesh()->num_nodes());
+    for (VMesh::Node::index_type i = 0; i < static_cast<index_type>(points.size()); ++i)
+      field->vmesh()->get_point(points[i], i);
+    return points;
+  }
+
+  DenseMatrixHandle solve(FieldHandle mesh, FieldHandle coil, int outtype, double theta = 0.0)
+  {
+    BiotSavartSolverAlgorithm algo;
+    algo.set(Parameters::TreecodeTheta, theta);
+    algo.set(Parameters::TreecodeDegree, 6);
+    DenseMatrixHandle result;
+    EXPECT_TRUE(algo.run(mesh, coil, result, outtype));
+    return result;
+  }
+
+  // Largest difference between rows, relative to the largest expected row
+  double relativeError(const DenseMatrix& actual, const std::vector<Vector>& expected)
+  {
+    double err = 0, norm = 0;
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+      const Vector row(actual(i, 0), actual(i, 1), actual(i, 2));
+      err = std::max(err, (row - expected[i]).length());
+      norm = std::max(norm, expected[i].length());
+    }
+    return err / norm;
+  }
+
+  // Unit square loop with a different current on each side, the third of which
+  // is zero and counts as one like in the solver
+  FieldHandle squareCoil()
+  {
+    FieldInformation fi(mesh_info_type::CURVEMESH_E, databasis_info_type::CONSTANTDATA_E, data_info_type::DOUBLE_E);
+    auto coil = CreateField(fi);
+    auto vmesh = coil->vmesh();
+    vmesh->add_point(Point(0, 0, 0));
+    vmesh->add_point(Point(1, 0, 0));
+    vmesh->add_point(Point(1, 1, 0));
+    vmesh->add_point(Point(0, 1, 0));
+    VMesh::Node::array_type edge(2);
+    for (index_type i = 0; i < 4; ++i)
+    {
+      edge[0] = i;
+      edge[1] = (i + 1) % 4;
+      vmesh->add_elem(edge);
+    }
+    coil->vfield()->resize_values();
+    const double currents[] = { 2.0, -1.5, 0.0, 0.5 };
+    for (index_type i = 0; i < 4; ++i)
+      coil->vfield()->set_value(currents[i], i);
+    return coil;
+  }
+
+  std::vector<Vector> pieceWiseReference(FieldHandle mesh, FieldHandle coil, int outtype)
+  {
+    // unit length segments are split into 160 pieces, of which the solver
+    // integrates the first 159
+    const int nips = 160;
+    std::vector<Vector> expected;
+    for (const auto& p : nodesOf(mesh))
+    {
+      Vector F(0, 0, 0);
+      for (VMesh::Edge::index_type e = 0; e < 4; ++e)
+      {
+        VMesh::Node::array_type nodes;
+        Point a, b;
+        double current;
+        coil->vmesh()->get_nodes(nodes, e);
+        coil->vmesh()->get_point(a, nodes[0]);
+        coil->vmesh()->get_point(b, nodes[1]);
+        coil->vfield()->get_value(current, e);
+        if (current == 0.0)
+          current = 1.0;
+        if (current < 0.0)
+          std::swap(a, b);
+
+        for (int i = 0; i < nips - 1; ++i)
+        {
+          const Point p0 = a + (b - a) * (static_cast<double>(i) / nips);
+          const Point p1 = a + (b - a) * (static_cast<double>(i + 1) / nips);
+          const Vector R = Vector(0.5 * (p0 + p1)) - Vector(p);
+          const Vector dL = p1 - p0;
+          if (outtype == 1)
+            F += 1.0e-7 * Cross(R, dL) * (std::fabs(current) / (R.length() * R.length() * R.length()));
+          else
+            F += 1.0e-7 * dL * (std::fabs(current) / R.length());
+        }
+      }
+      expected.push_back(F);
+    }
+    return expected;
+  }
+
+  FieldHandle dipoles()
+  {
+    std::mt19937 gen(5);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<Point> locations;
+    for (int i = 0; i < 300; ++i)
+      locations.emplace_back(unit(gen), unit(gen), unit(gen));
+    auto field = pointCloud(locations, data_info_type::VECTOR_E);
+    for (index_type i = 0; i < 300; ++i)
+      field->vfield()->set_value(Vector(unit(gen) - 0.5, unit(gen) - 0.5, unit(gen) - 0.5), i);
+    return field;
+  }
+
+  std::vector<Vector> dipoleReference(FieldHandle mesh, FieldHandle coil, int outtype)
+  {
+    const auto locations = nodesOf(coil);
+    std::vector<Vector> expected;
+    for (const auto& p : nodesOf(mesh))
+    {
+      Vector F(0, 0, 0);
+      for (size_t i = 0; i < locations.size(); ++i)
+      {
+        Vector m;
+        coil->vfield()->get_value(m, static_cast<index_type>(i));
+        const Vector R = locations[i] - p;
+        const double Rl = R.length();
+        if (outtype == 1)
+          F += 1.0e-7 * (3 * R * Dot(m, R) / (Rl * Rl * Rl * Rl * Rl) - m / (Rl * Rl * Rl));
+        else
+          F += 1.0e-7 * Cross(m, R) / (Rl * Rl * Rl);
+      }
+      expected.push_back(F);
+    }
+    return expected;
+  }
+
+  // 7x7x7 cells in the unit cube with a current density that varies per cell
+  FieldHandle currentVolume()
+  {
+    FieldInformation fi(mesh_info_type::LATVOLMESH_E, databasis_info_type::CONSTANTDATA_E, data_info_type::VECTOR_E);
+    auto mesh = CreateMesh(fi, 8, 8, 8, Point(0, 0, 0), Point(1, 1, 1));
+    auto field = CreateField(fi, mesh);
+    field->vfield()->resize_values();
+    for (VMesh::Elem::index_type i = 0; i < field->vmesh()->num_elems(); ++i)
+      field->vfield()->set_value(Vector(std::cos(0.3 * i), std::sin(0.2 * i), 1.0), i);
+    return field;
+  }
+
+  std::vector<Vector> volumetricReference(FieldHandle mesh, FieldHandle coil, int outtype)
+  {
+    std::vector<Vector> expected;
+    for (const auto& p : nodesOf(mesh))
+    {
+      Vector F(0, 0, 0);
+      for (VMesh::Elem::index_type i = 0; i < coil->vmesh()->num_elems(); ++i)
+      {
+        Point center;
+        Vector J;
+        coil->vmesh()->get_center(center, i);
+        coil->vfield()->get_value(J, i);
+        const Vector R = center - p;
+        const double volume = coil->vmesh()->get_volume(i);
+        if (outtype == 1)
+          F += Cross(J, R) * (volume / (4.0 * M_PI * R.length()));
+        else
+          F += J * (volume / (4.0 * M_PI * R.length()));
+      }
+      expected.push_back(F);
+    }
+    return expected;
+  }
+}
+
+TEST(BiotSavartSolverAlgorithmTest, PieceWiseKernelMatchesScalarSum)
+{
+  auto mesh = modelNodes();
+  auto coil = squareCoil();
+  for (int outtype : { 1, 2 })
+  {
+    auto result = solve(mesh, coil, outtype);
+    ASSERT_TRUE(result != nullptr);
+    EXPECT_LT(relativeError(*result, pieceWiseReference(mesh, coil, outtype)), kernelTolerance) << "outtype " << outtype;
+  }
+}
+
+TEST(BiotSavartSolverAlgorithmTest, DipolesKernelMatchesScalarSum)
+{
+  auto mesh = modelNodes();
+  auto coil = dipoles();
+  for (int outtype : { 1, 2 })
+  {
+    auto result = solve(mesh, coil, outtype);
+    ASSERT_TRUE(result != nullptr);
+    EXPECT_LT(relativeError(*result, dipoleReference(mesh, coil, outtype)), kernelTolerance) << "outtype " << outtype;
+  }
+}
+
+TEST(BiotSavartSolverAlgorithmTest, VolumetricKernelMatchesScalarSum)
+{
+  auto mesh = modelNodes();
+  auto coil = currentVolume();
+  for (int outtype : { 1, 2 })
+  {
+    auto result = solve(mesh, coil, outtype);
+    ASSERT_TRUE(result != nullptr);
+    EXPECT_LT(relativeError(*result, volumetricReference(mesh, coil, outtype)), kernelTolerance) << "outtype " << outtype;
+  }
+}
+
+TEST(BiotSavartSolverAlgorithmTest, TreecodeMatchesScalarSum)
+{
+  // the sources fill the unit cube and the nodes are at least one unit away,
+  // so a degree 6 expansion with theta 0.5 is accurate to better than 1e-8
+  const double treecodeTolerance = 1e-6;
+  auto mesh = modelNodes();
+  for (int outtype : { 1, 2 })
+  {
+    auto coil = squareCoil();
+    EXPECT_LT(relativeError(*solve(mesh, coil, outtype, 0.5), pieceWiseReference(mesh, coil, outtype)), treecodeTolerance);
+    coil = dipoles();
+    EXPECT_LT(relativeError(*solve(mesh, coil, outtype, 0.5), dipoleReference(mesh, coil, outtype)), treecodeTolerance);
+    coil = currentVolume();
+    EXPECT_LT(relativeError(*solve(mesh, coil, outtype, 0.5), volumetricReference(mesh, coil, outtype)), treecodeTolerance);
+  }
+}
+
+TEST(BiotSavartSolverAlgorithmTest, RejectsTreecodeThetaOutsideUnitInterval)
+{
+  auto mesh = modelNodes();
+  auto coil = dipoles();
+  for (double theta : { -0.1, 1.0, 1.5 })
+  {
+    BiotSavartSolverAlgorithm algo;
+    algo.set(Parameters::TreecodeTheta, theta);
+    DenseMatrixHandle result;
+    EXPECT_FALSE(algo.run(mesh, coil, result, 1)) << "theta " << theta;
+  }
+}
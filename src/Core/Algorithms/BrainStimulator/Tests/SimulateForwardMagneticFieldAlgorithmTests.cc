@@ -44,10 +44,12 @@
 #include <Core/Datatypes/Matrix.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Testing/Utils/MatrixTestUtilities.h>
+#include <Core/GeometryPrimitives/PointVectorOperators.h>
 
 using namespace SCIRun;
 using namespace SCIRun::Core;
 using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
 using namespace SCIRun::TestUtils;
 using namespace SCIRun::Core::Algorithms::DataIO;
 using namespace SCIRun::Core::Algorithms::Fields;
@@ -127,3 +129,132 @@ TEST(SimulateForwardMagneticFieldAlgoTest, TestOnLatVol)
   EXPECT_MATRIX_EQ_TOLERANCE(*MField_matrix, *MField_expected_matrix, 1e-16);
   EXPECT_MATRIX_EQ_TOLERANCE(*MFieldMagnitudes_matrix, *MFieldMagnitudes_expected_matrix, 1e-16);
 }
+
+namespace
+{
+  // 4x4x4 cells in the unit cube with a constant electric field and conductivity per cell
+  void makeVolumeConductor(FieldHandle& efield, FieldHandle& conductivity)
+  {
+    FieldInformation efi(mesh_info_type::LATVOLMESH_E, databasis_info_type::CONSTANTDATA_E, data_info_type::VECTOR_E);
+    auto mesh = CreateMesh(efi, 5, 5, 5, Point(0, 0, 0), Point(1, 1, 1));
+    efield = CreateField(efi, mesh);
+    FieldInformation cfi(mesh_info_type::LATVOLMESH_E, databasis_info_type::CONSTANTDATA_E, data_info_type::DOUBLE_E);
+    conductivity = CreateField(cfi, mesh);
+    efield->vfield()->resize_values();
+    conductivity->vfield()->resize_values();
+    for (VMesh::Elem::index_type i = 0; i < mesh->vmesh()->num_elems(); ++i)
+    {
+      efield->vfield()->set_value(Vector(std::cos(0.3 * i), std::sin(0.2 * i), 0.5), i);
+      conductivity->vfield()->set_value(1.0 + 0.01 * i, i);
+    }
+  }
+
+  FieldHandle pointCloudWithVectors(const std::vector<Point>& points, const std::vector<Vector>& values)
+  {
+    FieldInformation fi(mesh_info_type::POINTCLOUDMESH_E, databasis_info_type::LINEARDATA_E, data_info_type::VECTOR_E);
+    auto field = CreateField(fi);
+    for (const auto& p : points)
+      field->vmesh()->add_point(p);
+    field->vfield()->resize_values();
+    for (index_type i = 0; i < static_cast<index_type>(values.size()); ++i)
+      field->vfield()->set_value(values[i], i);
+    return field;
+  }
+
+  // Sum over the element currents and the dipoles written out with Vectors. The
+  // element that contains the detector is left out.
+  Vector forwardFieldReference(FieldHandle efield, FieldHandle conductivity, FieldHandle dipoles, const Point& detector)
+  {
+    VMesh::Elem::index_type inside = -1;
+    efield->vmesh()->locate(inside, detector);
+
+    Vector F(0, 0, 0);
+    for (VMesh::Elem::index_type i = 0; i < efield->vmesh()->num_elems(); ++i)
+    {
+      if (i == inside)
+        continue;
+      Point center;
+      Vector E;
+      double sigma;
+      efield->vmesh()->get_center(center, i);
+      efield->vfield()->get_value(E, i);
+      conductivity->vfield()->get_value(sigma, i);
+      const Vector radius = detector - center;
+      const double length = radius.length();
+      F += Cross(-sigma * E, radius) / (length * length * length) * efield->vmesh()->get_volume(i);
+    }
+    for (VMesh::Node::index_type i = 0; i < dipoles->vmesh()->num_nodes(); ++i)
+    {
+      Point location;
+      Vector P;
+      dipoles->vmesh()->get_center(location, i);
+      dipoles->vfield()->get_value(P, i);
+      const Vector radius = detector - location;
+      const double length = radius.length();
+      F += Cross(P, radius) / (length * length * length);
+    }
+    return F / (4 * M_PI);
+  }
+}
+
+TEST(SimulateForwardMagneticFieldAlgoTest, MatchesScalarSumOverSources)
+{
+  FieldHandle efield, conductivity;
+  makeVolumeConductor(efield, conductivity);
+  auto dipoles = pointCloudWithVectors({ Point(0.3, 0.4, 0.2), Point(0.7, 0.6, 0.8), Point(0.5, 0.1, 0.9) },
+    { Vector(1, 0, 0), Vector(0, -2, 1), Vector(0.5, 0.5, 0.5) });
+
+  // detectors outside the volume and two inside, whose own cell is skipped;
+  // the last one is on the center of its cell
+  std::vector<Point> points;
+  std::vector<Vector> normals;
+  for (int i = 0; i < 12; ++i)
+  {
+    const double phi = 2 * M_PI * i / 12;
+    points.emplace_back(0.5 + 1.5 * std::cos(phi), 0.5 + 1.5 * std::sin(phi), 0.5 + 0.1 * i);
+    normals.emplace_back(std::cos(phi), std::sin(phi), 0);
+  }
+  points.emplace_back(0.55, 0.45, 0.6);
+  normals.emplace_back(0, 0, 1);
+  points.emplace_back(0.375, 0.625, 0.375);
+  normals.emplace_back(0, 1, 0);
+  auto detectors = pointCloudWithVectors(points, normals);
+
+  // the direct sum must match to rounding; theta 0.5 with degree 6 is a few
+  // orders of magnitude less accurate for detectors this close to the sources
+  for (double theta : { 0.0, 0.5 })
+  {
+    SimulateForwardMagneticFieldAlgo algo;
+    algo.set(Algorithms::BrainStimulator::Parameters::TreecodeTheta, theta);
+    algo.set(Algorithms::BrainStimulator::Parameters::TreecodeDegree, 6);
+    FieldHandle MField, MFieldMagnitudes;
+    boost::tie(MField, MFieldMagnitudes) = algo.run(efield, conductivity, dipoles, detectors);
+
+    const double tolerance = theta > 0 ? 1e-4 : 1e-12;
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      const Vector expected = forwardFieldReference(efield, conductivity, dipoles, points[i]);
+      Vector actual;
+      double magnitude;
+      MField->vfield()->get_value(actual, static_cast<index_type>(i));
+      MFieldMagnitudes->vfield()->get_value(magnitude, static_cast<index_type>(i));
+      EXPECT_LT((actual - expected).length(), tolerance * expected.length()) << "detector " << i << ", theta " << theta;
+      EXPECT_NEAR(Dot(expected, normals[i]), magnitude, tolerance * expected.length()) << "detector " << i << ", theta " << theta;
+    }
+  }
+}
+
+TEST(SimulateForwardMagneticFieldAlgoTest, RejectsTreecodeThetaOutsideUnitInterval)
+{
+  FieldHandle efield, conductivity;
+  makeVolumeConductor(efield, conductivity);
+  auto dipoles = pointCloudWithVectors({ Point(0.3, 0.4, 0.2) }, { Vector(1, 0, 0) });
+  auto detectors = pointCloudWithVectors({ Point(2, 2, 2) }, { Vector(0, 0, 1) });
+
+  for (double theta : { -0.1, 1.0, 1.5 })
+  {
+    SimulateForwardMagneticFieldAlgo algo;
+    algo.set(Algorithms::BrainStimulator::Parameters::TreecodeTheta, theta);
+    EXPECT_THROW(algo.run(efield, conductivity, dipoles, detectors), Algorithms::AlgorithmInputException) << "theta " << theta;
+  }
+}
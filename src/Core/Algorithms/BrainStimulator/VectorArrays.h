@@ -0,0 +1,107 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_ALGORITHMS_BRAINSTIMULATOR_VECTORARRAYS_H
+#define CORE_ALGORITHMS_BRAINSTIMULATOR_VECTORARRAYS_H
+
+#include <Core/GeometryPrimitives/Vector.h>
+#include <algorithm>
+#include <vector>
+
+///@file VectorArrays
+///@brief Structure-of-arrays storage for the field summation kernels
+///
+///@details
+/// The magnetic field kernels sum a closed-form expression over many sources.
+/// Keeping the sources in separate x, y and z arrays, read once from the
+/// fields, lets the inner loops run over plain doubles that the compiler
+/// turns into packed SIMD instructions. For that the loops live in free
+/// functions with __restrict outputs, so no runtime alias checks are needed,
+/// and their sources are built with -fno-math-errno, since the errno branch of
+/// std::sqrt keeps the loop from vectorizing.
+
+/// Compile a summation kernel for AVX-512 and AVX2 besides the baseline
+/// instruction set; the loader picks the version for the running CPU.
+#if defined(__x86_64__) && defined(__linux__) && defined(__has_attribute)
+#  if __has_attribute(target_clones)
+#    define BRAINSTIMULATOR_SIMD_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+#  endif
+#endif
+#ifndef BRAINSTIMULATOR_SIMD_CLONES
+#  define BRAINSTIMULATOR_SIMD_CLONES
+#endif
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace BrainStimulator {
+
+  /// Number of terms handed to the kernel of sumInBlocks at a time
+  const size_t sumBlockSize = 256;
+
+  struct VectorArrays
+  {
+    std::vector<double> x, y, z;
+
+    size_t size() const { return x.size(); }
+
+    void reserve(size_t n)
+    {
+      x.reserve(n); y.reserve(n); z.reserve(n);
+    }
+
+    void push_back(const Geometry::Vector& v)
+    {
+      x.push_back(v.x()); y.push_back(v.y()); z.push_back(v.z());
+    }
+
+    Geometry::Vector operator[](size_t i) const { return Geometry::Vector(x[i], y[i], z[i]); }
+  };
+
+  /// Sum n terms that are produced in blocks by terms(begin, count, fx, fy, fz).
+  /// terms should be a plain loop over arrays so it vectorizes; the sum itself
+  /// is done here in index order, which keeps the result equal to a scalar loop.
+  template <class Terms>
+  Geometry::Vector sumInBlocks(size_t n, const Terms& terms)
+  {
+    double fx[sumBlockSize], fy[sumBlockSize], fz[sumBlockSize];
+
+    Geometry::Vector F(0.0, 0.0, 0.0);
+    for (size_t begin = 0; begin < n; begin += sumBlockSize)
+    {
+      const size_t count = std::min(sumBlockSize, n - begin);
+      terms(begin, count, fx, fy, fz);
+      for (size_t i = 0; i < count; ++i)
+        F += Geometry::Vector(fx[i], fy[i], fz[i]);
+    }
+    return F;
+  }
+
+}}}}
+
+#endif
@@ -0,0 +1,140 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/MatrixTypeConversions.h>
+#include <Core/Algorithms/Legacy/Fields/Mapping/BuildMappingMatrixAlgo.h>
+#include <Testing/Utils/SCIRunUnitTests.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  std::vector<double> sourceValues(FieldHandle source)
+  {
+    VMesh* vmesh = source->vmesh();
+    std::vector<double> values(vmesh->num_nodes());
+    for (VMesh::Node::index_type idx = 0; idx < vmesh->num_nodes(); ++idx)
+    {
+      Point p;
+      vmesh->get_center(p, idx);
+      values[idx] = p.x()*p.x() + std::sin(2.0*p.y())*p.z();
+    }
+    return values;
+  }
+
+  // Half of the destination nodes are outside the unit cube and are mapped
+  // onto the closest element on the boundary of the source.
+  FieldHandle destination(int basis_order)
+  {
+    FieldInformation fi("LatVolMesh", basis_order, "double");
+    MeshHandle mesh = CreateMesh(fi, 9, 8, 7, Point(-0.15, -0.1, -0.2), Point(1.1, 1.2, 1.05));
+    return CreateField(fi, mesh);
+  }
+
+  double closestElementValue(FieldHandle source, const std::vector<double>& values, const Point& p)
+  {
+    VMesh* smesh = source->vmesh();
+    smesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E);
+    double dist;
+    Point r;
+    VMesh::coords_type coords;
+    VMesh::Elem::index_type elem;
+    EXPECT_TRUE(smesh->find_closest_elem(dist, r, coords, elem, p));
+
+    VMesh::ElemInterpolate interp;
+    smesh->get_interpolate_weights(coords, elem, interp, 1);
+    double value = 0.0;
+    for (size_t k = 0; k < interp.node_index.size(); ++k)
+      value += interp.weights[k]*values[interp.node_index[k]];
+    return value;
+  }
+
+  // Rows may pick a different element when a node lies on a shared face, so
+  // compare the mapped values rather than the matrix entries.
+  void expectMatchesClosestElementSearch(FieldHandle source, int dbasis_order)
+  {
+    BuildMappingMatrixAlgo algo;
+    FieldHandle dest = destination(dbasis_order);
+    MatrixHandle mapping;
+    ASSERT_TRUE(algo.runImpl(source, dest, mapping));
+
+    auto sparse = castMatrix::toSparse(mapping);
+    ASSERT_TRUE(sparse != nullptr);
+    VMesh* dmesh = dest->vmesh();
+    const VMesh::size_type num_values = dbasis_order == 0 ? dmesh->num_elems() : dmesh->num_nodes();
+    ASSERT_EQ(num_values, sparse->nrows());
+    ASSERT_EQ(source->vmesh()->num_nodes(), sparse->ncols());
+
+    const std::vector<double> values = sourceValues(source);
+    const Eigen::Map<const Eigen::VectorXd> x(values.data(), values.size());
+    const Eigen::VectorXd mapped = *sparse * x;
+
+    for (VMesh::index_type idx = 0; idx < num_values; ++idx)
+    {
+      Point p;
+      if (dbasis_order == 0) dmesh->get_center(p, VMesh::Elem::index_type(idx));
+      else dmesh->get_center(p, VMesh::Node::index_type(idx));
+      EXPECT_NEAR(closestElementValue(source, values, p), mapped[idx], 1e-10) << "at " << p;
+    }
+  }
+}
+
+TEST(BuildMappingMatrixAlgoTests, InterpolatedDataFromTetVolMatchesClosestElementSearch)
+{
+  FieldHandle source = GridTetVolLinearBasis(6, 5, 4);
+  expectMatchesClosestElementSearch(source, 1);
+  expectMatchesClosestElementSearch(source, 0);
+}
+
+TEST(BuildMappingMatrixAlgoTests, InterpolatedDataFromLatVolMatchesClosestElementSearch)
+{
+  FieldHandle source = CreateEmptyLatVol(5, 6, 7, data_info_type::DOUBLE_E, Point(0, 0, 0), Point(1, 1, 1));
+  expectMatchesClosestElementSearch(source, 1);
+  expectMatchesClosestElementSearch(source, 0);
+}
+
+TEST(BuildMappingMatrixAlgoTests, InterpolatedDataFromTriSurfMatchesClosestElementSearch)
+{
+  FieldHandle source = CubeTriSurfLinearBasis(data_info_type::DOUBLE_E);
+  expectMatchesClosestElementSearch(source, 1);
+  expectMatchesClosestElementSearch(source, 0);
+}
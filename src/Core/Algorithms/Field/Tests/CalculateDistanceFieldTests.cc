@@ -0,0 +1,216 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/CalculateDistanceField.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/CalculateSignedDistanceField.h>
+#include <Testing/Utils/SCIRunUnitTests.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  const double spacing = 0.125;
+
+  // Grid around the unit cube of CubeTriSurfLinearBasis, which spans [0,1]x[0,1]x[-1,0]
+  FieldHandle latVolAroundCube()
+  {
+    return CreateEmptyLatVol(17, 17, 17, data_info_type::DOUBLE_E, Point(-0.5, -0.5, -1.5), Point(1.5, 1.5, 0.5));
+  }
+
+  // Same values as a point cloud, which searches the closest element for every value
+  FieldHandle pointCloudOf(FieldHandle grid)
+  {
+    FieldInformation fi(mesh_info_type::POINTCLOUDMESH_E, databasis_info_type::LINEARDATA_E, data_info_type::DOUBLE_E);
+    FieldHandle points = CreateField(fi);
+    auto vmesh = grid->vmesh();
+    for (VMesh::Node::index_type i = 0; i < vmesh->num_nodes(); ++i)
+    {
+      Point p;
+      vmesh->get_center(p, i);
+      points->vmesh()->add_point(p);
+    }
+    points->vfield()->resize_values();
+    return points;
+  }
+
+  // The sign is only well defined where a single face of the cube is closest;
+  // on the diagonals it depends on which of the tied elements is picked.
+  bool singleFaceClosest(const Point& p)
+  {
+    const double lo[3] = { 0.0, 0.0, -1.0 }, hi[3] = { 1.0, 1.0, 0.0 };
+    int outside = 0, within = 0;
+    double gaps[6];
+    for (int k = 0; k < 3; ++k)
+    {
+      if (p[k] < lo[k] || p[k] > hi[k]) outside++;
+      else if (p[k] > lo[k] + 1e-9 && p[k] < hi[k] - 1e-9) within++;
+      gaps[2*k] = std::fabs(p[k] - lo[k]);
+      gaps[2*k+1] = std::fabs(p[k] - hi[k]);
+    }
+    if (outside > 0) return outside == 1 && within == 2;
+    std::sort(gaps, gaps + 6);
+    return gaps[1] - gaps[0] > 1e-9;
+  }
+
+  void compareValues(FieldHandle grid, FieldHandle reference, double tolerance, bool checkSign)
+  {
+    ASSERT_EQ(reference->vfield()->num_values(), grid->vfield()->num_values());
+    for (VMesh::index_type i = 0; i < grid->vfield()->num_values(); ++i)
+    {
+      double actual, expected;
+      grid->vfield()->get_value(actual, i);
+      reference->vfield()->get_value(expected, i);
+      // values next to the object are searched for, further away they are propagated
+      EXPECT_NEAR(std::fabs(expected), std::fabs(actual), std::fabs(expected) < spacing ? 1e-12 : tolerance) << " at value " << i;
+
+      Point p;
+      grid->vmesh()->get_center(p, VMesh::Node::index_type(i));
+      if (checkSign && singleFaceClosest(p))
+      {
+        EXPECT_EQ(expected < 0.0, actual < 0.0) << " at value " << i;
+      }
+    }
+  }
+
+  // Without ApproximateOnGrid every value gets its own closest element search
+  void expectSameValues(FieldHandle grid, FieldHandle reference)
+  {
+    ASSERT_EQ(reference->vfield()->num_values(), grid->vfield()->num_values());
+    for (VMesh::index_type i = 0; i < grid->vfield()->num_values(); ++i)
+    {
+      double actual, expected;
+      grid->vfield()->get_value(actual, i);
+      reference->vfield()->get_value(expected, i);
+      EXPECT_EQ(expected, actual) << " at value " << i;
+    }
+  }
+}
+
+TEST(CalculateDistanceFieldAlgoTests, LatVolMatchesClosestElementSearch)
+{
+  auto cube = CubeTriSurfLinearBasis(data_info_type::DOUBLE_E);
+  auto grid = latVolAroundCube();
+
+  CalculateDistanceFieldAlgo algo;
+  FieldHandle distance, reference;
+  ASSERT_TRUE(algo.runImpl(grid, cube, distance));
+  ASSERT_TRUE(algo.runImpl(pointCloudOf(grid), cube, reference));
+
+  expectSameValues(distance, reference);
+}
+
+TEST(CalculateDistanceFieldAlgoTests, LatVolTruncatesDistance)
+{
+  auto cube = CubeTriSurfLinearBasis(data_info_type::DOUBLE_E);
+  auto grid = latVolAroundCube();
+
+  CalculateDistanceFieldAlgo algo;
+  algo.set(Parameters::Truncate, true);
+  algo.set(Parameters::TruncateDistance, 0.3);
+  FieldHandle distance, reference;
+  ASSERT_TRUE(algo.runImpl(grid, cube, distance));
+  ASSERT_TRUE(algo.runImpl(pointCloudOf(grid), cube, reference));
+
+  expectSameValues(distance, reference);
+}
+
+TEST(CalculateDistanceFieldAlgoTests, LatVolSignedDistanceMatchesClosestElementSearch)
+{
+  auto cube = CubeTriSurfLinearBasis(data_info_type::DOUBLE_E);
+  auto grid = latVolAroundCube();
+
+  CalculateSignedDistanceFieldAlgo algo;
+  FieldHandle distance, reference;
+  ASSERT_TRUE(algo.run(grid, cube, distance));
+  ASSERT_TRUE(algo.run(pointCloudOf(grid), cube, reference));
+
+  expectSameValues(distance, reference);
+}
+
+TEST(CalculateDistanceFieldAlgoTests, LatVolApproximationIsCloseToClosestElementSearch)
+{
+  auto cube = CubeTriSurfLinearBasis(data_info_type::DOUBLE_E);
+  auto grid = latVolAroundCube();
+
+  CalculateDistanceFieldAlgo algo;
+  FieldHandle reference;
+  ASSERT_TRUE(algo.runImpl(pointCloudOf(grid), cube, reference));
+
+  algo.set(Parameters::ApproximateOnGrid, true);
+  FieldHandle distance;
+  ASSERT_TRUE(algo.runImpl(grid, cube, distance));
+
+  compareValues(distance, reference, 0.05*spacing, false);
+}
+
+TEST(CalculateDistanceFieldAlgoTests, LatVolApproximationTruncatesDistance)
+{
+  auto cube = CubeTriSurfLinearBasis(data_info_type::DOUBLE_E);
+  auto grid = latVolAroundCube();
+
+  CalculateDistanceFieldAlgo algo;
+  algo.set(Parameters::Truncate, true);
+  algo.set(Parameters::TruncateDistance, 0.3);
+  FieldHandle reference;
+  ASSERT_TRUE(algo.runImpl(pointCloudOf(grid), cube, reference));
+
+  algo.set(Parameters::ApproximateOnGrid, true);
+  FieldHandle distance;
+  ASSERT_TRUE(algo.runImpl(grid, cube, distance));
+
+  compareValues(distance, reference, 0.05*spacing, false);
+}
+
+TEST(CalculateDistanceFieldAlgoTests, LatVolSignedApproximationIsCloseToClosestElementSearch)
+{
+  auto cube = CubeTriSurfLinearBasis(data_info_type::DOUBLE_E);
+  auto grid = latVolAroundCube();
+
+  CalculateSignedDistanceFieldAlgo algo;
+  FieldHandle reference;
+  ASSERT_TRUE(algo.run(pointCloudOf(grid), cube, reference));
+
+  algo.set(Parameters::ApproximateOnGrid, true);
+  FieldHandle distance;
+  ASSERT_TRUE(algo.run(grid, cube, distance));
+
+  compareValues(distance, reference, 0.05*spacing, true);
+}
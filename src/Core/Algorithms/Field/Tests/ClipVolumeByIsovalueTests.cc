@@ -36,6 +36,7 @@
 #include <Core/Datatypes/Matrix.h>
 #include <Core/Algorithms/Legacy/Fields/ClipMesh/ClipMeshByIsovalue.h>
 #include <Testing/Utils/SCIRunUnitTests.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Testing/Utils/MatrixTestUtilities.h>
@@ -118,3 +119,174 @@ TEST(ClipVolumeByIsovalueAlgoTest, DISABLED_ClipVolumeByIsovalue_LatVol_DataOnNo
   EXPECT_EQ(output->vmesh()->num_elems(),1);
   EXPECT_EQ(output->vfield()->num_values(),8);
 }
+
+namespace
+{
+  using Cells = std::vector<std::vector<index_type> >;
+
+  FieldHandle makeField(mesh_info_type type, const std::vector<Point>& points, const Cells& cells,
+    const std::vector<double>& values)
+  {
+    FieldInformation fi(type, databasis_info_type::LINEARDATA_E, data_info_type::DOUBLE_E);
+    FieldHandle field = CreateField(fi);
+    for (const auto& p : points)
+      field->vmesh()->add_point(p);
+    for (const auto& cell : cells)
+    {
+      VMesh::Node::array_type nodes(cell.size());
+      std::copy(cell.begin(), cell.end(), nodes.begin());
+      field->vmesh()->add_elem(nodes);
+    }
+    field->vfield()->resize_values();
+    for (size_t i = 0; i < values.size(); ++i)
+      field->vfield()->set_value(values[i], static_cast<index_type>(i));
+    return field;
+  }
+
+  // Two tets sharing the face 0-1-2, so the new nodes on edges 0-1 and 0-2 are
+  // created by both. One tet has two nodes on either side, the other one node.
+  FieldHandle twoTets()
+  {
+    return makeField(mesh_info_type::TETVOLMESH_E,
+      { Point(0,0,0), Point(1,0,0), Point(0,1,0), Point(0,0,1), Point(0,0,-1) },
+      { { 0,1,2,3 }, { 0,2,1,4 } },
+      { 0, 1, 1, 0.2, 0.8 });
+  }
+
+  FieldHandle twoHexes()
+  {
+    return makeField(mesh_info_type::HEXVOLMESH_E,
+      { Point(0,0,0), Point(1,0,0), Point(1,1,0), Point(0,1,0), Point(0,0,1), Point(1,0,1), Point(1,1,1), Point(0,1,1),
+        Point(2,0,0), Point(2,1,0), Point(2,0,1), Point(2,1,1) },
+      { { 0,1,2,3,4,5,6,7 }, { 1,8,9,2,5,10,11,6 } },
+      { 0, 0.5, 0.5, 0, 0, 0.5, 0.5, 0, 1, 1, 1, 1 });
+  }
+
+  // Unit square split along the diagonal 0-2, which both triangles cut
+  FieldHandle twoTris()
+  {
+    return makeField(mesh_info_type::TRISURFMESH_E,
+      { Point(0,0,0), Point(1,0,0), Point(1,1,0), Point(0,1,0) },
+      { { 0,1,2 }, { 0,2,3 } },
+      { 0, 1, 1, 0 });
+  }
+
+  FieldHandle clip(FieldHandle input, double isovalue, bool lessThan)
+  {
+    ClipMeshByIsovalueAlgo algo;
+    algo.set(Parameters::ScalarIsoValue, isovalue);
+    algo.set(Parameters::LessThanIsoValue, lessThan);
+    FieldHandle output;
+    EXPECT_TRUE(algo.run(input, output));
+    return output;
+  }
+
+  // The nodes and elements are expected in the order a serial sweep over the
+  // input elements creates them.
+  void expectMesh(FieldHandle field, const std::vector<Point>& points, const Cells& cells)
+  {
+    auto vmesh = field->vmesh();
+    ASSERT_EQ(points.size(), vmesh->num_nodes());
+    ASSERT_EQ(cells.size(), vmesh->num_elems());
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      Point p;
+      vmesh->get_point(p, VMesh::Node::index_type(i));
+      EXPECT_NEAR(0.0, (p - points[i]).length(), 1e-12) << "node " << i;
+    }
+    for (size_t i = 0; i < cells.size(); ++i)
+    {
+      VMesh::Node::array_type nodes;
+      vmesh->get_nodes(nodes, VMesh::Elem::index_type(i));
+      EXPECT_EQ(cells[i], Cells::value_type(nodes.begin(), nodes.end())) << "element " << i;
+    }
+  }
+
+  void expectValues(FieldHandle field, const std::vector<double>& values)
+  {
+    ASSERT_EQ(values.size(), field->vfield()->num_values());
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+      double v;
+      field->vfield()->get_value(v, static_cast<index_type>(i));
+      EXPECT_DOUBLE_EQ(values[i], v) << "value " << i;
+    }
+  }
+}
+
+TEST(ClipVolumeByIsovalueAlgoTest, TetVolSharedCutsAreMerged)
+{
+  auto above = clip(twoTets(), 0.5, true);
+  expectMesh(above,
+    { Point(1,0,0), Point(0,1,0), Point(0.5,0,0), Point(0,0.5,0), Point(0.375,0,0.625), Point(0,0.375,0.625),
+      Point(0.25,0.25,0), Point(0.1875,0.1875,0.625), Point(0,0,-1), Point(0,0,-0.625), Point(0.25,0,-0.3125),
+      Point(0,0.25,-0.3125) },
+    { { 7,2,0,4 }, { 1,5,3,7 }, { 1,3,6,7 }, { 0,7,6,2 }, { 0,1,6,7 }, { 1,3,11,6 },
+      { 0,2,6,10 }, { 8,9,10,11 }, { 1,6,11,10 }, { 1,11,8,10 }, { 1,6,10,0 }, { 1,0,10,8 } });
+  expectValues(above, { 1, 1, 0.5, 0.5, 0.5, 0.5, 0.5, 0.5, 0.8, 0.5, 0.5, 0.5 });
+
+  auto below = clip(twoTets(), 0.5, false);
+  expectMesh(below,
+    { Point(0,0,1), Point(0,0,0), Point(0,0.375,0.625), Point(0,0.5,0), Point(0.375,0,0.625), Point(0.5,0,0),
+      Point(0,0.4375,0.3125), Point(0.4375,0,0.3125), Point(0,0,-0.625) },
+    { { 7,2,0,4 }, { 1,5,3,7 }, { 1,3,6,7 }, { 0,7,6,2 }, { 0,1,6,7 }, { 1,3,5,8 } });
+  expectValues(below, { 0.2, 0, 0.5, 0.5, 0.5, 0.5, 0.5, 0.5, 0.5 });
+}
+
+TEST(ClipVolumeByIsovalueAlgoTest, HexVolKeepsWholeHexesAndProjectsTheSheet)
+{
+  auto below = clip(twoHexes(), 0.75, false);
+  expectMesh(below,
+    { Point(0,0,0), Point(1,0,0), Point(1,1,0), Point(0,1,0), Point(0,0,1), Point(1,0,1), Point(1,1,1), Point(0,1,1),
+      Point(1.5,0,0), Point(1.5,0,1), Point(1.5,1,1), Point(1.5,1,0) },
+    { { 0,1,2,3,4,5,6,7 }, { 2,6,5,1,11,10,9,8 } });
+
+  auto above = clip(twoHexes(), 0.25, true);
+  expectMesh(above,
+    { Point(1,0,0), Point(2,0,0), Point(2,1,0), Point(1,1,0), Point(1,0,1), Point(2,0,1), Point(2,1,1), Point(1,1,1),
+      Point(0.5,0,0), Point(0.5,1,0), Point(0.5,1,1), Point(0.5,0,1) },
+    { { 0,1,2,3,4,5,6,7 }, { 4,7,3,0,11,10,9,8 } });
+}
+
+TEST(ClipVolumeByIsovalueAlgoTest, TriSurfSharedCutsAreMerged)
+{
+  auto above = clip(twoTris(), 0.5, true);
+  expectMesh(above,
+    { Point(1,0,0), Point(1,1,0), Point(0.5,0,0), Point(0.5,0.5,0), Point(0.5,1,0) },
+    { { 0,1,3 }, { 0,3,2 }, { 1,4,3 } });
+  expectValues(above, { 1, 1, 0.5, 0.5, 0.5 });
+
+  auto below = clip(twoTris(), 0.5, false);
+  expectMesh(below,
+    { Point(0,0,0), Point(0.5,0,0), Point(0.5,0.5,0), Point(0,1,0), Point(0.5,1,0) },
+    { { 0,1,2 }, { 3,0,2 }, { 3,2,4 } });
+  expectValues(below, { 0, 0.5, 0.5, 0, 0.5 });
+}
+
+TEST(ClipVolumeByIsovalueAlgoTest, TetVolSidesOfASphereFillTheGrid)
+{
+  // 6000 tets, more than one block of elements
+  auto grid = GridTetVolLinearBasis(10, 10, 10);
+  for (VMesh::Node::index_type i = 0; i < grid->vmesh()->num_nodes(); ++i)
+  {
+    Point p;
+    grid->vmesh()->get_point(p, i);
+    grid->vfield()->set_value((p - Point(0.5, 0.5, 0.5)).length(), i);
+  }
+
+  auto volume = [](FieldHandle field)
+  {
+    double sum = 0.0;
+    for (VMesh::Elem::index_type e = 0; e < field->vmesh()->num_elems(); ++e)
+      sum += field->vmesh()->get_volume(e);
+    return sum;
+  };
+
+  auto outside = clip(grid, 0.35, true);
+  auto inside = clip(grid, 0.35, false);
+  EXPECT_EQ(2816, outside->vmesh()->num_nodes());
+  EXPECT_EQ(9348, outside->vmesh()->num_elems());
+  EXPECT_EQ(1555, inside->vmesh()->num_nodes());
+  EXPECT_EQ(4440, inside->vmesh()->num_elems());
+  EXPECT_NEAR(1.0, volume(outside) + volume(inside), 1e-12);
+}
@@ -36,6 +36,7 @@
 #include <Core/Algorithms/Legacy/Fields/MeshDerivatives/GetFieldBoundaryAlgo.h>
 #include <Core/Datatypes/MatrixTypeConversions.h>
 #include <Testing/Utils/SCIRunUnitTests.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
@@ -156,3 +157,95 @@ TEST(GetFieldBoundaryTest, CanLogErrorMessage)
 
   EXPECT_FALSE(algo.run(input, output));
 }
+
+namespace
+{
+  using Cells = std::vector<std::vector<index_type> >;
+
+  FieldHandle makeField(mesh_info_type type, const std::vector<Point>& points, const Cells& cells)
+  {
+    FieldInformation fi(type, databasis_info_type::LINEARDATA_E, data_info_type::DOUBLE_E);
+    FieldHandle field = CreateField(fi);
+    for (const auto& p : points)
+      field->vmesh()->add_point(p);
+    for (const auto& cell : cells)
+    {
+      VMesh::Node::array_type nodes(cell.size());
+      std::copy(cell.begin(), cell.end(), nodes.begin());
+      field->vmesh()->add_elem(nodes);
+    }
+    field->vfield()->resize_values();
+    return field;
+  }
+
+  // The boundary nodes and faces are expected in the order a serial sweep over
+  // the input elements finds them.
+  void expectBoundary(FieldHandle input, const std::vector<Point>& points, const Cells& cells)
+  {
+    GetFieldBoundaryAlgo algo;
+    FieldHandle boundary;
+    MatrixHandle mapping;
+    ASSERT_TRUE(algo.run(input, boundary, mapping));
+
+    auto vmesh = boundary->vmesh();
+    ASSERT_EQ(points.size(), vmesh->num_nodes());
+    ASSERT_EQ(cells.size(), vmesh->num_elems());
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      Point p;
+      vmesh->get_point(p, VMesh::Node::index_type(i));
+      EXPECT_EQ(points[i], p) << "node " << i;
+    }
+    for (size_t i = 0; i < cells.size(); ++i)
+    {
+      VMesh::Node::array_type nodes;
+      vmesh->get_nodes(nodes, VMesh::Elem::index_type(i));
+      EXPECT_EQ(cells[i], Cells::value_type(nodes.begin(), nodes.end())) << "element " << i;
+    }
+
+    ASSERT_TRUE(mapping != nullptr);
+    EXPECT_EQ(points.size(), mapping->nrows());
+    EXPECT_EQ(input->vmesh()->num_nodes(), mapping->ncols());
+  }
+}
+
+TEST(GetFieldBoundaryTest, TetVolSharedFaceIsInterior)
+{
+  expectBoundary(makeField(mesh_info_type::TETVOLMESH_E,
+      { Point(0,0,0), Point(1,0,0), Point(0,1,0), Point(0,0,1), Point(0,0,-1) },
+      { { 0,1,2,3 }, { 0,2,1,4 } }),
+    { Point(1,0,0), Point(0,1,0), Point(0,0,1), Point(0,0,0), Point(0,0,-1) },
+    { { 0,1,2 }, { 3,2,1 }, { 3,0,2 }, { 1,0,4 }, { 3,4,0 }, { 3,1,4 } });
+}
+
+TEST(GetFieldBoundaryTest, HexVolSharedFaceIsInterior)
+{
+  expectBoundary(makeField(mesh_info_type::HEXVOLMESH_E,
+      { Point(0,0,0), Point(1,0,0), Point(1,1,0), Point(0,1,0), Point(0,0,1), Point(1,0,1), Point(1,1,1), Point(0,1,1),
+        Point(2,0,0), Point(2,1,0), Point(2,0,1), Point(2,1,1) },
+      { { 0,1,2,3,4,5,6,7 }, { 1,8,9,2,5,10,11,6 } }),
+    { Point(0,0,0), Point(1,0,0), Point(1,1,0), Point(0,1,0), Point(0,0,1), Point(0,1,1), Point(1,1,1), Point(1,0,1),
+      Point(2,0,0), Point(2,1,0), Point(2,1,1), Point(2,0,1) },
+    { { 0,1,2,3 }, { 4,5,6,7 }, { 0,4,7,1 }, { 2,6,5,3 }, { 0,3,5,4 },
+      { 1,8,9,2 }, { 6,10,11,7 }, { 1,7,11,8 }, { 2,9,10,6 }, { 8,11,10,9 } });
+}
+
+TEST(GetFieldBoundaryTest, TriSurfSharedEdgeIsInterior)
+{
+  expectBoundary(makeField(mesh_info_type::TRISURFMESH_E,
+      { Point(0,0,0), Point(1,0,0), Point(1,1,0), Point(0,1,0) },
+      { { 0,1,2 }, { 0,2,3 } }),
+    { Point(0,0,0), Point(1,0,0), Point(1,1,0), Point(0,1,0) },
+    { { 0,1 }, { 1,2 }, { 2,3 }, { 3,0 } });
+}
+
+TEST(GetFieldBoundaryTest, TetVolGridBoundaryIsTheCubeSurface)
+{
+  // 6000 tets, more than one block of elements; each of the 600 boundary
+  // quads is split into two triangles.
+  GetFieldBoundaryAlgo algo;
+  FieldHandle boundary;
+  ASSERT_TRUE(algo.run(GridTetVolLinearBasis(10, 10, 10), boundary));
+  EXPECT_EQ(602, boundary->vmesh()->num_nodes());
+  EXPECT_EQ(1200, boundary->vmesh()->num_elems());
+}
@@ -28,11 +28,15 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Datatypes/Matrix.h>
 #include <Core/Algorithms/Legacy/Fields/Mapping/MapFieldDataFromSourceToDestination.h>
 #include <Testing/Utils/SCIRunUnitTests.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Testing/Utils/MatrixTestUtilities.h>
@@ -53,3 +57,101 @@ TEST(MapFieldDataFromSourceToDestinationAlgoTests, ThrowsOnNullInput)
   AlgorithmInput empty;
   EXPECT_THROW(algo.run(empty), AlgorithmProcessingException);
 }
+
+namespace
+{
+  double sourceFunction(const Point& p)
+  {
+    return p.x()*p.x() + std::sin(2.0*p.y())*p.z();
+  }
+
+  FieldHandle sourceWithData(FieldHandle source)
+  {
+    VMesh* vmesh = source->vmesh();
+    for (VMesh::Node::index_type idx = 0; idx < vmesh->num_nodes(); ++idx)
+    {
+      Point p;
+      vmesh->get_center(p, idx);
+      source->vfield()->set_value(sourceFunction(p), idx);
+    }
+    return source;
+  }
+
+  // The destination sticks out of the unit cube, so part of it has to be
+  // mapped from the closest element on the boundary of the source.
+  FieldHandle destination(int basis_order)
+  {
+    FieldInformation fi("LatVolMesh", basis_order, "double");
+    MeshHandle mesh = CreateMesh(fi, 9, 8, 7, Point(-0.15, -0.1, -0.2), Point(1.1, 1.2, 1.05));
+    FieldHandle field = CreateField(fi, mesh);
+    field->vfield()->resize_values();
+    field->vfield()->clear_all_values();
+    return field;
+  }
+
+  double closestElementValue(FieldHandle source, const Point& p)
+  {
+    VMesh* smesh = source->vmesh();
+    smesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E);
+    double dist;
+    Point r;
+    VMesh::coords_type coords;
+    VMesh::Elem::index_type elem;
+    EXPECT_TRUE(smesh->find_closest_elem(dist, r, coords, elem, p));
+
+    VMesh::ElemInterpolate interp;
+    smesh->get_interpolate_weights(coords, elem, interp, 1);
+    double value = 0.0;
+    for (size_t k = 0; k < interp.node_index.size(); ++k)
+    {
+      double v;
+      source->vfield()->get_value(v, interp.node_index[k]);
+      value += interp.weights[k]*v;
+    }
+    return value;
+  }
+
+  void expectMatchesClosestElementSearch(FieldHandle source, int dbasis_order)
+  {
+    MapFieldDataFromSourceToDestinationAlgo algo;
+    algo.setOption(Parameters::MappingMethod, "interpolateddata");
+
+    FieldHandle dest = destination(dbasis_order);
+    FieldHandle output;
+    ASSERT_TRUE(algo.runImpl(source, dest, output));
+
+    VMesh* omesh = output->vmesh();
+    VField* ofield = output->vfield();
+    ASSERT_EQ(dest->vfield()->num_values(), ofield->num_values());
+    for (VMesh::index_type idx = 0; idx < ofield->num_values(); ++idx)
+    {
+      Point p;
+      if (dbasis_order == 0) omesh->get_center(p, VMesh::Elem::index_type(idx));
+      else omesh->get_center(p, VMesh::Node::index_type(idx));
+      double value;
+      ofield->get_value(value, idx);
+      EXPECT_NEAR(closestElementValue(source, p), value, 1e-10) << "at " << p;
+    }
+  }
+}
+
+TEST(MapFieldDataFromSourceToDestinationAlgoTests, InterpolatedDataFromTetVolMatchesClosestElementSearch)
+{
+  FieldHandle source = sourceWithData(GridTetVolLinearBasis(6, 5, 4));
+  expectMatchesClosestElementSearch(source, 1);
+  expectMatchesClosestElementSearch(source, 0);
+}
+
+TEST(MapFieldDataFromSourceToDestinationAlgoTests, InterpolatedDataFromLatVolMatchesClosestElementSearch)
+{
+  FieldHandle source = sourceWithData(CreateEmptyLatVol(5, 6, 7, data_info_type::DOUBLE_E, Point(0, 0, 0), Point(1, 1, 1)));
+  expectMatchesClosestElementSearch(source, 1);
+  expectMatchesClosestElementSearch(source, 0);
+}
+
+TEST(MapFieldDataFromSourceToDestinationAlgoTests, InterpolatedDataFromTriSurfMatchesClosestElementSearch)
+{
+  FieldHandle source = sourceWithData(CubeTriSurfLinearBasis(data_info_type::DOUBLE_E));
+  expectMatchesClosestElementSearch(source, 1);
+  expectMatchesClosestElementSearch(source, 0);
+}
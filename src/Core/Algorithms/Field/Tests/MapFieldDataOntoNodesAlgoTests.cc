@@ -0,0 +1,102 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Algorithms/Legacy/Fields/Mapping/MapFieldDataOntoNodes.h>
+#include <Testing/Utils/SCIRunUnitTests.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  FieldHandle sourceWithData(FieldHandle source)
+  {
+    VMesh* vmesh = source->vmesh();
+    for (VMesh::Node::index_type idx = 0; idx < vmesh->num_nodes(); ++idx)
+    {
+      Point p;
+      vmesh->get_center(p, idx);
+      source->vfield()->set_value(p.x()*p.x() + std::sin(2.0*p.y())*p.z(), idx);
+    }
+    return source;
+  }
+
+  // The nodes are located in batches, check every one of them against a
+  // separate interpolation at that point. Nodes outside the source get the
+  // outside value.
+  void expectMatchesPointwiseInterpolation(FieldHandle source)
+  {
+    MapFieldDataOntoNodesAlgo algo;
+    algo.set(Parameters::OutsideValue, -5.0);
+
+    FieldHandle dest = CreateEmptyLatVol(13, 12, 11, data_info_type::DOUBLE_E, Point(-0.15, -0.1, -0.2), Point(1.1, 1.2, 1.05));
+    FieldHandle output;
+    ASSERT_TRUE(algo.runImpl(source, dest, output));
+
+    VMesh* omesh = output->vmesh();
+    VField* ofield = output->vfield();
+    ASSERT_EQ(omesh->num_nodes(), ofield->num_values());
+
+    source->vmesh()->synchronize(Mesh::ELEM_LOCATE_E);
+    int outside = 0;
+    for (VMesh::Node::index_type idx = 0; idx < omesh->num_nodes(); ++idx)
+    {
+      Point p;
+      omesh->get_center(p, idx);
+      double expected;
+      if (!source->vfield()->interpolate(expected, p, -5.0))
+        outside++;
+      double value;
+      ofield->get_value(value, idx);
+      EXPECT_NEAR(expected, value, 1e-10) << "at " << p;
+    }
+    EXPECT_GT(outside, 0);
+    EXPECT_LT(outside, omesh->num_nodes());
+  }
+}
+
+TEST(MapFieldDataOntoNodesAlgoTests, InterpolatedDataFromTetVolMatchesPointwiseInterpolation)
+{
+  expectMatchesPointwiseInterpolation(sourceWithData(GridTetVolLinearBasis(6, 5, 4)));
+}
+
+TEST(MapFieldDataOntoNodesAlgoTests, InterpolatedDataFromLatVolMatchesPointwiseInterpolation)
+{
+  expectMatchesPointwiseInterpolation(sourceWithData(CreateEmptyLatVol(5, 6, 7, data_info_type::DOUBLE_E, Point(0, 0, 0), Point(1, 1, 1))));
+}
@@ -161,6 +161,66 @@ TEST(BuildFEMatrixAlgorithmTests, TestMeshSize1e4)
   EXPECT_TRUE(expectedOutput("1e4.mat")->isApprox(*output));
 }
 
+TEST(BuildFEMatrixAlgorithmTests, ElementAndNodeAssemblyAgree)
+{
+  using namespace FEInputData;
+  auto mesh = loadTestMesh("fem_1e4_elements.fld");
+  ASSERT_THAT(mesh, NotNull());
+
+  BuildFEMatrixAlgo algo;
+  algo.set(BuildFEMatrixAlgo::ElementAssembly, true);
+  auto byElement = algo.run(withInputData((Variables::InputField, mesh))).get<SparseRowMatrix>(BuildFEMatrixAlgo::Stiffness_Matrix);
+  algo.set(BuildFEMatrixAlgo::ElementAssembly, false);
+  auto byNode = algo.run(withInputData((Variables::InputField, mesh))).get<SparseRowMatrix>(BuildFEMatrixAlgo::Stiffness_Matrix);
+
+  ASSERT_THAT(byElement, NotNull());
+  ASSERT_THAT(byNode, NotNull());
+  EXPECT_EQ(byNode->nonZeros(), byElement->nonZeros());
+  EXPECT_TRUE(byNode->isApprox(*byElement, 1e-12));
+}
+
+TEST(BuildFEMatrixAlgorithmTests, RerunWithNewConductivitiesMatchesFreshRun)
+{
+  using namespace FEInputData;
+  auto mesh = loadTestMesh("fem_1e4_elements.fld");
+  ASSERT_THAT(mesh, NotNull());
+
+  auto setConductivities = [&mesh](double scale)
+  {
+    auto field = mesh->vfield();
+    for (VMesh::Elem::index_type e = 0; e < mesh->vmesh()->num_elems(); ++e)
+      field->set_value(scale * (1 + e % 3), e);
+  };
+
+  BuildFEMatrixAlgo algo;
+  setConductivities(1);
+  auto first = algo.run(withInputData((Variables::InputField, mesh))).get<SparseRowMatrix>(BuildFEMatrixAlgo::Stiffness_Matrix);
+  ASSERT_THAT(first, NotNull());
+  auto firstCopy = makeShared<SparseRowMatrix>(*first);
+
+  // first output is still held, so the structure is copied into a new matrix
+  setConductivities(2);
+  auto second = algo.run(withInputData((Variables::InputField, mesh))).get<SparseRowMatrix>(BuildFEMatrixAlgo::Stiffness_Matrix);
+  ASSERT_THAT(second, NotNull());
+  EXPECT_NE(first, second);
+  EXPECT_TRUE(first->isApprox(*firstCopy, 0));
+
+  BuildFEMatrixAlgo fresh;
+  auto expected = fresh.run(withInputData((Variables::InputField, mesh))).get<SparseRowMatrix>(BuildFEMatrixAlgo::Stiffness_Matrix);
+  EXPECT_EQ(expected->nonZeros(), second->nonZeros());
+  EXPECT_TRUE(expected->isApprox(*second, 1e-12));
+
+  // nobody holds on to the second output anymore, so it is refilled in place
+  auto secondAddress = second.get();
+  second.reset();
+  setConductivities(3);
+  auto third = algo.run(withInputData((Variables::InputField, mesh))).get<SparseRowMatrix>(BuildFEMatrixAlgo::Stiffness_Matrix);
+  ASSERT_THAT(third, NotNull());
+  EXPECT_EQ(secondAddress, third.get());
+  EXPECT_TRUE(first->isApprox(*firstCopy, 0));
+  EXPECT_TRUE((3 * *firstCopy).isApprox(*third, 1e-12));
+}
+
 // move to nightly: file too big for github unit test repo
 TEST(BuildFEMatrixAlgorithmTests, DISABLED_TestMeshSize1e5)
 {
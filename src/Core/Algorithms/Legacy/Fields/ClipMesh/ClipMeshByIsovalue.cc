@@ -33,12 +33,14 @@
 #include <Core/Datatypes/Legacy/Field/VField.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Matrix.h>
-#include <Core/Datatypes/SparseRowMatrixFromMap.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
-#include <unordered_map>
+#include <Core/Datatypes/Legacy/Field/MeshTableBuilder.h>
+#include <Core/Thread/Parallel.h>
 
 #include <algorithm>
-#include <set>
+#include <array>
+#include <atomic>
+#include <limits>
 
 
 using namespace SCIRun;
@@ -76,862 +78,639 @@ int tri_permute_table[7][3] = {
   { 2, 0, 1 }, // 0x6
 };
 
-namespace detail
+namespace
 {
-  struct edgepair_t
-  {
-    VField::index_type first;
-    VField::index_type second;
-    double dfirst;
-  };
+  using Core::Thread::Parallel;
 
-  struct edgepairhash
-  {
-    size_t operator()(const edgepair_t &a) const
-    {
-      std::hash<size_t> h;
-      return h(a.first ^ a.second);
-    }
-  };
+  /// Elements are clipped in fixed blocks, so the counts and offsets of a
+  /// block do not depend on how the blocks are scheduled.
+  const size_t clipBlockSize = 4096;
 
-  typedef std::unordered_map<VField::index_type, VMesh::Node::index_type> node_hash_type;
-  typedef std::unordered_map<edgepair_t, VMesh::Node::index_type, edgepairhash> edge_hash_type;
+  /// The most nodes a single element contributes to the clipped mesh.
+  const index_type maxClipSlots = 9;
 
-  bool operator==(const edgepair_t &a, const edgepair_t &b)
-  {
-    return a.first == b.first && a.second == b.second;
-  }
-
-  bool operator!=(const edgepair_t &a, const edgepair_t &b)
-  {
-    return !(a == b);
-  }
+  /// About how much memory the clipped blocks may keep between the passes.
+  /// A mostly kept tet volume needs a few hundred bytes per element, so this
+  /// covers about a million elements; the blocks past it are clipped again.
+  const size_t clipCacheBudget = size_t(256) << 20;
 
-  struct facetriple_t
+  /// What one element contributes to the clipped mesh: the input nodes it
+  /// keeps and the new nodes on the edges and faces it cuts, in the order the
+  /// element creates them, plus its output elements as indices into these.
+  struct ClippedElement
   {
-    VField::index_type first, second, third;
-    double dsecond, dthird;
-  };
+    /// A kept input node is stored as { node, -1, -1 }, a new node by the
+    /// sorted input nodes of the edge or face it lies on.
+    std::array<index_type, 3> key[maxClipSlots];
+    Point point[maxClipSlots];
+    int numSlots;
+    int elems[7][8];
+    int numElems;
 
-  bool operator==(const facetriple_t &a, const facetriple_t &b)
-  {
-    return a.first == b.first && a.second == b.second && a.third == b.third;
-  }
+    void clear() { numSlots = 0; numElems = 0; }
 
-  bool operator!=(const facetriple_t &a, const facetriple_t &b)
-  {
-    return !(a == b);
-  }
+    static bool kept(const std::array<index_type, 3>& k) { return k[1] < 0; }
 
-  struct facetriplehash
-  {
-    size_t operator()(const facetriple_t &a) const
+    void keep(VMesh::Node::index_type node, const Point& p)
     {
-      std::hash<size_t> h;
-      return h(a.first ^ a.second ^ a.third);
+      key[numSlots] = {{ static_cast<index_type>(node), -1, -1 }};
+      point[numSlots++] = p;
     }
-  };
-
-  typedef std::unordered_map<facetriple_t, VMesh::Node::index_type, facetriplehash> face_hash_type;
-
-}
-
-ALGORITHM_PARAMETER_DEF(Fields, LessThanIsoValue);
-ALGORITHM_PARAMETER_DEF(Fields, ScalarIsoValue);
-
-ClipMeshByIsovalueAlgo::ClipMeshByIsovalueAlgo()
-{
-  addParameter(Parameters::LessThanIsoValue, 1);
-  addParameter(Parameters::ScalarIsoValue, 0.0);
-}
-
-class ClipMeshByIsovalueAlgoTet {
-
-  public:
-    bool run(const AlgorithmBase* algo,FieldHandle input, FieldHandle& output, MatrixHandle& mapping) const;
-
-  private:
-    VMesh::Node::index_type
-    edge_lookup(VField::index_type u0, VField::index_type u1, double d0,
-          const Point &p, detail::edge_hash_type &edgemap,
-          VMesh *clipped) const;
-
-    VMesh::Node::index_type
-    face_lookup(VField::index_type u0, VField::index_type u1, VField::index_type u2,
-          double d1, double d2,
-          const Point &p, detail::face_hash_type &facemap,
-          VMesh *clipped) const;
-
- };
-
-VMesh::Node::index_type ClipMeshByIsovalueAlgoTet::edge_lookup(VField::index_type u0, VField::index_type u1, double d0, const Point &p, detail::edge_hash_type &edgemap, VMesh *clipped) const
-{
-  using namespace detail;
-  edgepair_t np;
-  if (u0 < u1)  { np.first = u0; np.second = u1; np.dfirst = d0; }
-  else { np.first = u1; np.second = u0; np.dfirst = 1.0 - d0; }
-
-  auto loc = edgemap.find(np);
 
-  if (loc == edgemap.end())
-  {
-    const VMesh::Node::index_type nodeindex = clipped->add_point(p);
-    edgemap[np] = nodeindex;
-    return nodeindex;
-  }
-  else
-  {
-   return loc->second;
-  }
-}
+    void split(index_type u0, index_type u1, const Point& p)
+    {
+      key[numSlots] = {{ std::min(u0, u1), std::max(u0, u1), -1 }};
+      point[numSlots++] = p;
+    }
 
-VMesh::Node::index_type ClipMeshByIsovalueAlgoTet::face_lookup(VField::index_type u0, VField::index_type u1, VField::index_type u2, double d1, double d2, const Point &p, detail::face_hash_type &facemap, VMesh *clipped) const
-{
-  using namespace detail;
-  facetriple_t nt;
-  if (u0 < u1)
-  {
-    if (u2 < u0)
+    void split(index_type u0, index_type u1, index_type u2, const Point& p)
     {
-      nt.first = u2; nt.second = u0; nt.third = u1;
-      nt.dsecond = 1.0 - d1 - d2; nt.dthird = d1;
+      key[numSlots] = {{ u0, u1, u2 }};
+      std::sort(key[numSlots].begin(), key[numSlots].end());
+      point[numSlots++] = p;
     }
-    else if (u2 < u1)
+
+    void add(int n0, int n1, int n2, int n3 = -1)
     {
-      nt.first = u0; nt.second = u2; nt.third = u1;
-      nt.dsecond = d2; nt.dthird = d1;
+      int* e = elems[numElems++];
+      e[0] = n0; e[1] = n1; e[2] = n2; e[3] = n3;
     }
-    else
+
+    /// Adds an element made of all slots, in order.
+    void addAll()
     {
-      nt.first = u0; nt.second = u1; nt.third = u2;
-      nt.dsecond = d1; nt.dthird = d2;
+      int* e = elems[numElems++];
+      for (int s = 0; s < numSlots; ++s) e[s] = s;
     }
-  }
-  else
+  };
+
+  /// The clipped elements of one block, kept from the count pass so that its
+  /// elements are clipped only once. Elements that add nothing are left out.
+  struct ClippedBlock
   {
-    if (u2 > u0)
+    bool cached = false;
+    std::vector<index_type> elem;
+    std::vector<int> slotBegin { 0 };
+    std::vector<std::array<index_type, 3> > key;
+    std::vector<Point> point;
+    /// Slots of the output elements of every entry, nodesPerElem per element
+    std::vector<int> cellBegin { 0 };
+    std::vector<int> cells;
+
+    size_t size() const { return elem.size(); }
+
+    void append(index_type idx, const ClippedElement& ce, size_t nodesPerElem)
     {
-      nt.first = u1; nt.second = u0; nt.third = u2;
-      nt.dsecond = 1.0 - d1 - d2; nt.dthird = d2;
+      elem.push_back(idx);
+      slotBegin.push_back(slotBegin.back() + ce.numSlots);
+      key.insert(key.end(), ce.key, ce.key + ce.numSlots);
+      point.insert(point.end(), ce.point, ce.point + ce.numSlots);
+      for (int e = 0; e < ce.numElems; ++e)
+        cells.insert(cells.end(), ce.elems[e], ce.elems[e] + nodesPerElem);
+      cellBegin.push_back(static_cast<int>(cells.size()));
     }
-    else if (u2 > u1)
+
+    void get(size_t i, ClippedElement& ce, size_t nodesPerElem) const
     {
-      nt.first = u1; nt.second = u2; nt.third = u0;
-      nt.dsecond = d2; nt.dthird = 1.0 - d1 - d2;
+      ce.numSlots = slotBegin[i + 1] - slotBegin[i];
+      std::copy(key.begin() + slotBegin[i], key.begin() + slotBegin[i + 1], ce.key);
+      std::copy(point.begin() + slotBegin[i], point.begin() + slotBegin[i + 1], ce.point);
+      ce.numElems = 0;
+      for (int c = cellBegin[i]; c < cellBegin[i + 1]; c += nodesPerElem)
+        std::copy(cells.begin() + c, cells.begin() + c + nodesPerElem, ce.elems[ce.numElems++]);
     }
-    else
+
+    size_t memory() const
     {
-      nt.first = u2; nt.second = u1; nt.third = u0;
-      nt.dsecond = d1; nt.dthird = 1.0 - d1 - d2;
+      return elem.capacity() * sizeof(index_type) + slotBegin.capacity() * sizeof(int) +
+        key.capacity() * sizeof(key[0]) + point.capacity() * sizeof(Point) +
+        cellBegin.capacity() * sizeof(int) + cells.capacity() * sizeof(int);
     }
-  }
-  const face_hash_type::iterator loc = facemap.find(nt);
-  if (loc == facemap.end())
-  {
-    const VMesh::Node::index_type nodeindex = clipped->add_point(p);
-    facemap[nt] = nodeindex;
-    return nodeindex;
-  }
-  else
+  };
+
+  void lowerTo(std::atomic<index_type>& value, index_type candidate)
   {
-    return (*loc).second;
+    index_type current = value.load(std::memory_order_relaxed);
+    while (candidate < current &&
+      !value.compare_exchange_weak(current, candidate, std::memory_order_relaxed)) {}
   }
-}
-
-bool ClipMeshByIsovalueAlgoTet::run(const AlgorithmBase* algo, FieldHandle input, FieldHandle& output, MatrixHandle &/*mapping*/) const
-{
-  VField* field = input->vfield();
-  VMesh*  mesh  = input->vmesh();
-  VMesh*  clipped = output->vmesh();
-
-  using namespace detail;
-  node_hash_type nodemap;
-  edge_hash_type edgemap;
-  face_hash_type facemap;
-
-  VMesh::Node::array_type onodes(4);
-  std::vector<double> v(4);
-  std::vector<Point> p(4);
-
-  double isoval = algo->get(Parameters::ScalarIsoValue).toDouble();
 
-  bool lte = !algo->get(Parameters::LessThanIsoValue).toBool();
-
-  VMesh::size_type num_elems = mesh->num_elems();
-
-  for (VMesh::Elem::index_type idx=0; idx<num_elems; idx++)
+  /// Builds the clipped mesh from clip(elem, out), which describes what
+  /// every element contributes and is called concurrently. nodeSource returns
+  /// the input node of every kept node and -1 for the new nodes.
+  ///
+  /// The elements are clipped in a count pass, which keeps the results of
+  /// the blocks for the numbering and fill passes that follow a prefix sum
+  /// over the blocks, up to clipCacheBudget; the other blocks are clipped
+  /// again in each of these passes. New nodes shared by several elements are merged by sorting
+  /// their keys, and every node is taken from the first element that creates
+  /// it, so the result is identical to adding the elements one by one.
+  template <class Clip>
+  void buildClippedMesh(VMesh* mesh, VMesh* clipped, const Clip& clip,
+    std::vector<index_type>& nodeSource)
   {
-    mesh->get_nodes(onodes, idx);
-
-      // Get the values and compute an inside/outside mask.
-    VField::index_type inside = 0;
-    mesh->get_centers(p, onodes);
-    field->get_values(v,onodes);
-    for (size_t i = 0; i < onodes.size(); i++)
+    const size_t numElems = static_cast<size_t>(mesh->num_elems());
+    const size_t numNodes = static_cast<size_t>(mesh->num_nodes());
+    const size_t numBlocks = (numElems + clipBlockSize - 1) / clipBlockSize;
+    const size_t nodesPerElem = clipped->num_nodes_per_elem();
+    auto blockEnd = [numElems](size_t b) { return static_cast<index_type>(std::min(numElems, (b + 1) * clipBlockSize)); };
+
+    std::vector<std::atomic<index_type> > firstUse(numNodes);
+    Parallel::For(0, numNodes, 1 << 14, [&](size_t begin, size_t end)
     {
-      inside = inside << 1;
-      if (v[i] > isoval)
-      {
-        inside |= 1;
-      }
-
-    }
+      for (size_t n = begin; n < end; ++n)
+        firstUse[n].store(std::numeric_limits<index_type>::max(), std::memory_order_relaxed);
+    });
 
-      // Invert the mask if we are doing less than.
-    if (lte) { inside = ~inside & 0xf; }
+    std::vector<ClippedBlock> blocks(numBlocks);
 
-    if (inside == 0)
-    {
-        // Discard outside elements.
-    }
-    else if (inside == 0xf)
+    // Calls f(idx, ce) for every element of block b that adds something.
+    auto forEachClipped = [&](size_t b, ClippedElement& scratch, auto f)
     {
-        // Add this element to the new mesh.
-      VMesh::Node::array_type nnodes(onodes.size());
-      for (size_t i = 0; i<onodes.size(); i++)
+      const ClippedBlock& block = blocks[b];
+      if (block.cached)
       {
-        if (nodemap.find((VField::index_type)onodes[i]) == nodemap.end())
+        for (size_t i = 0; i < block.size(); ++i)
         {
-          const VMesh::Node::index_type nodeindex = clipped->add_point(p[i]);
-          nodemap[(VField::index_type)onodes[i]] = nodeindex;
-          nnodes[i] = nodeindex;
-        }
-        else
-        {
-          nnodes[i] = nodemap[(VField::index_type)onodes[i]];
+          block.get(i, scratch, nodesPerElem);
+          f(block.elem[i], scratch);
         }
+        return;
       }
-
-      clipped->add_elem(nnodes);
-    }
-    else if (inside == 0x8 || inside == 0x4 || inside == 0x2 || inside == 0x1)
-    {
-        // Lop off 3 points and add resulting tet to the new mesh.
-      const int *perm = tet_permute_table[inside];
-      VMesh::Node::array_type nnodes(4);
-
-      if (nodemap.find((VField::index_type)onodes[perm[0]]) == nodemap.end())
+      for (index_type idx = b * clipBlockSize; idx < blockEnd(b); ++idx)
       {
-        const VMesh::Node::index_type nodeindex = clipped->add_point(p[perm[0]]);
-        nodemap[(VField::index_type)onodes[perm[0]]] = nodeindex;
-        nnodes[0] = nodeindex;
+        clip(idx, scratch);
+        if (scratch.numSlots > 0) f(idx, scratch);
       }
-      else
+    };
+
+    // Count pass: clip every element, note the first slot using every kept
+    // node and collect the new nodes of every block. The blocks are cached
+    // while the budget lasts, so which ones are depends on the scheduling but
+    // the result does not.
+    std::atomic<size_t> cacheMemory(0);
+    std::vector<index_type> elemOffset(numBlocks + 1, 0), splitOffset(numBlocks + 1, 0);
+    std::vector<std::vector<MeshIncidence<3> > > blockSplits(numBlocks);
+    Parallel::For(0, numBlocks, 1, [&](size_t begin, size_t end)
+    {
+      ClippedElement scratch;
+      for (size_t b = begin; b < end; ++b)
       {
-        nnodes[0] = nodemap[(VField::index_type)onodes[perm[0]]];
+        ClippedBlock& block = blocks[b];
+        const bool cache = cacheMemory.load(std::memory_order_relaxed) < clipCacheBudget;
+        index_type elems = 0;
+        forEachClipped(b, scratch, [&](index_type idx, const ClippedElement& ce)
+        {
+          for (int s = 0; s < ce.numSlots; ++s)
+          {
+            if (ClippedElement::kept(ce.key[s]))
+              lowerTo(firstUse[ce.key[s][0]], idx * maxClipSlots + s);
+            else
+              blockSplits[b].push_back({ ce.key[s], 0 });
+          }
+          elems += ce.numElems;
+          if (cache) block.append(idx, ce, nodesPerElem);
+        });
+        block.cached = cache;
+        if (cache) cacheMemory += block.memory();
+        elemOffset[b + 1] = elems;
+        splitOffset[b + 1] = blockSplits[b].size();
       }
-
-      const double imv = isoval - v[perm[0]];
-      const double dl1 = imv / (v[perm[1]] - v[perm[0]]);
-      const Point l1 = Interpolate(p[perm[0]], p[perm[1]], dl1);
-      const double dl2 = imv / (v[perm[2]] - v[perm[0]]);
-      const Point l2 = Interpolate(p[perm[0]], p[perm[2]], dl2);
-      const double dl3 = imv / (v[perm[3]] - v[perm[0]]);
-      const Point l3 = Interpolate(p[perm[0]], p[perm[3]], dl3);
-
-
-      nnodes[1] = edge_lookup((VField::index_type)onodes[perm[0]],
-                              (VField::index_type)onodes[perm[1]],
-                              dl1, l1, edgemap, clipped);
-
-      nnodes[2] = edge_lookup((VField::index_type)onodes[perm[0]],
-                              (VField::index_type)onodes[perm[2]],
-                              dl2, l2, edgemap, clipped);
-
-      nnodes[3] = edge_lookup((VField::index_type)onodes[perm[0]],
-                              (VField::index_type)onodes[perm[3]],
-                              dl3, l3, edgemap, clipped);
-
-      clipped->add_elem(nnodes);
-    }
-    else if (inside == 0x7 || inside == 0xb || inside == 0xd || inside == 0xe)
+    });
+    for (size_t b = 0; b < numBlocks; ++b)
     {
-        // Lop off 1 point, break up the resulting quads and add the
-        // resulting tets to the mesh.
-      const int *perm = tet_permute_table[inside];
-      VMesh::Node::array_type nnodes(4);
+      elemOffset[b + 1] += elemOffset[b];
+      splitOffset[b + 1] += splitOffset[b];
+    }
 
-      VMesh::Node::index_type inodes[9];
-      for (size_t i = 1; i < 4; i++)
+    // Merge the new nodes: after sorting, the first entry of every run of
+    // equal keys is the one created first.
+    std::vector<MeshIncidence<3> > splits(splitOffset[numBlocks]);
+    Parallel::For(0, numBlocks, 1, [&](size_t begin, size_t end)
+    {
+      for (size_t b = begin; b < end; ++b)
       {
-        if (nodemap.find((VField::index_type)onodes[perm[i]]) == nodemap.end())
-        {
-          const VMesh::Node::index_type nodeindex = clipped->add_point(p[perm[i]]);
-          nodemap[(VField::index_type)onodes[perm[i]]] = nodeindex;
-          inodes[i-1] = nodeindex;
-        }
-        else
+        for (size_t i = 0; i < blockSplits[b].size(); ++i)
         {
-          inodes[i-1] = nodemap[(VField::index_type)onodes[perm[i]]];
+          splits[splitOffset[b] + i] = blockSplits[b][i];
+          splits[splitOffset[b] + i].combined = splitOffset[b] + i;
         }
+        std::vector<MeshIncidence<3> >().swap(blockSplits[b]);
       }
+    });
+    SCIRun::detail::parallelSort(splits);
 
-      const double imv = isoval - v[perm[0]];
-      const double dl1 = imv / (v[perm[1]] - v[perm[0]]);
-      const Point l1 = Interpolate(p[perm[0]], p[perm[1]], dl1);
-      const double dl2 = imv / (v[perm[2]] - v[perm[0]]);
-      const Point l2 = Interpolate(p[perm[0]], p[perm[2]], dl2);
-      const double dl3 = imv / (v[perm[3]] - v[perm[0]]);
-      const Point l3 = Interpolate(p[perm[0]], p[perm[3]], dl3);
-
-
-      inodes[3] = edge_lookup((index_type)onodes[perm[0]],
-                              (index_type)onodes[perm[1]],
-                              dl1, l1, edgemap, clipped);
-
-      inodes[4] = edge_lookup((index_type)onodes[perm[0]],
-                              (index_type)onodes[perm[2]],
-                              dl2, l2, edgemap, clipped);
-
-      inodes[5] = edge_lookup((index_type)onodes[perm[0]],
-                              (index_type)onodes[perm[3]],
-                              dl3, l3, edgemap, clipped);
-
-      const Point c1 = Interpolate(l1, l2, 0.5);
-      const Point c2 = Interpolate(l2, l3, 0.5);
-      const Point c3 = Interpolate(l3, l1, 0.5);
-
-      inodes[6] = face_lookup((index_type)onodes[perm[0]],
-                              (index_type)onodes[perm[1]],
-                              (index_type)onodes[perm[2]],
-                              dl1*0.5, dl2*0.5,
-                              c1, facemap, clipped);
-      inodes[7] = face_lookup((index_type)onodes[perm[0]],
-                              (index_type)onodes[perm[2]],
-                              (index_type)onodes[perm[3]],
-                              dl2*0.5, dl3*0.5,
-                              c2, facemap, clipped);
-      inodes[8] = face_lookup((index_type)onodes[perm[0]],
-                              (index_type)onodes[perm[3]],
-                              (index_type)onodes[perm[1]],
-                              dl3*0.5, dl1*0.5,
-                              c3, facemap, clipped);
-
-      nnodes[0] = inodes[0];
-      nnodes[1] = inodes[3];
-      nnodes[2] = inodes[8];
-      nnodes[3] = inodes[6];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[1];
-      nnodes[1] = inodes[4];
-      nnodes[2] = inodes[6];
-      nnodes[3] = inodes[7];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[2];
-      nnodes[1] = inodes[5];
-      nnodes[2] = inodes[7];
-      nnodes[3] = inodes[8];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[0];
-      nnodes[1] = inodes[6];
-      nnodes[2] = inodes[8];
-      nnodes[3] = inodes[7];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[0];
-      nnodes[1] = inodes[8];
-      nnodes[2] = inodes[2];
-      nnodes[3] = inodes[7];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[0];
-      nnodes[1] = inodes[6];
-      nnodes[2] = inodes[7];
-      nnodes[3] = inodes[1];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[0];
-      nnodes[1] = inodes[1];
-      nnodes[2] = inodes[7];
-      nnodes[3] = inodes[2];
-      clipped->add_elem(nnodes);
+    std::vector<index_type> firstSplit(splits.size());
+    for (size_t i = 0, first = 0; i < splits.size(); ++i)
+    {
+      if (splits[i].key != splits[first].key) first = i;
+      firstSplit[splits[i].combined] = splits[first].combined;
     }
-    else// if (inside == 0x3 || inside == 0x5 || inside == 0x6 ||
-          //     inside == 0x9 || inside == 0xa || inside == 0xc)
+    std::vector<MeshIncidence<3> >().swap(splits);
+
+    // Number the nodes each block creates first, counting from zero in
+    // every block; the block offsets are added once all blocks are counted.
+    std::vector<index_type> outputNode(numNodes);
+    std::vector<index_type> splitNode(firstSplit.size());
+    std::vector<index_type> nodeOffset(numBlocks + 1, 0);
+    Parallel::For(0, numBlocks, 1, [&](size_t begin, size_t end)
     {
-        // Lop off two points, break the resulting quads, then add the
-        // new tets to the mesh.
-      const int *perm = tet_permute_table[inside];
-      VMesh::Node::array_type nnodes(4);
-
-      VMesh::Node::index_type inodes[8];
-      for (size_t i = 2; i < 4; i++)
+      ClippedElement scratch;
+      for (size_t b = begin; b < end; ++b)
       {
-        if (nodemap.find((VField::index_type)onodes[perm[i]]) == nodemap.end())
+        index_type nodes = 0;
+        index_type split = splitOffset[b];
+        forEachClipped(b, scratch, [&](index_type idx, const ClippedElement& ce)
         {
-          const VMesh::Node::index_type nodeindex = clipped->add_point(p[perm[i]]);
-          nodemap[(VField::index_type)onodes[perm[i]]] = nodeindex;
-          inodes[i-2] = nodeindex;
-        }
-        else
+          for (int s = 0; s < ce.numSlots; ++s)
+          {
+            if (ClippedElement::kept(ce.key[s]))
+            {
+              const index_type node = ce.key[s][0];
+              if (firstUse[node].load(std::memory_order_relaxed) == idx * maxClipSlots + s)
+                outputNode[node] = nodes++;
+            }
+            else
+            {
+              if (firstSplit[split] == split) splitNode[split] = nodes++;
+              split++;
+            }
+          }
+        });
+        nodeOffset[b + 1] = nodes;
+      }
+    });
+    for (size_t b = 0; b < numBlocks; ++b)
+      nodeOffset[b + 1] += nodeOffset[b];
+
+    clipped->resize_nodes(nodeOffset[numBlocks]);
+    clipped->resize_elems(elemOffset[numBlocks]);
+    nodeSource.resize(nodeOffset[numBlocks]);
+
+    // Fill pass: every element writes the nodes it creates first and its
+    // elements. The output mesh is new and not synchronized, so the cells are
+    // written straight into its element array instead of through set_nodes,
+    // which would take the mesh lock for every element.
+    index_type* cells = clipped->get_elems_pointer();
+    Parallel::For(0, numBlocks, 1, [&](size_t begin, size_t end)
+    {
+      ClippedElement scratch;
+      index_type ids[maxClipSlots];
+      for (size_t b = begin; b < end; ++b)
+      {
+        index_type* cell = cells + elemOffset[b] * nodesPerElem;
+        index_type split = splitOffset[b];
+        forEachClipped(b, scratch, [&](index_type idx, const ClippedElement& ce)
         {
-          inodes[i-2] = nodemap[(VField::index_type)onodes[perm[i]]];
-        }
+          for (int s = 0; s < ce.numSlots; ++s)
+          {
+            index_type source;
+            bool first;
+            if (ClippedElement::kept(ce.key[s]))
+            {
+              source = ce.key[s][0];
+              const index_type use = firstUse[source].load(std::memory_order_relaxed);
+              ids[s] = nodeOffset[use / maxClipSlots / clipBlockSize] + outputNode[source];
+              first = use == idx * maxClipSlots + s;
+            }
+            else
+            {
+              const index_type owner = firstSplit[split];
+              const size_t ownerBlock = std::upper_bound(splitOffset.begin(), splitOffset.end(), owner) - splitOffset.begin() - 1;
+              source = -1;
+              ids[s] = nodeOffset[ownerBlock] + splitNode[owner];
+              first = owner == split++;
+            }
+            if (first)
+            {
+              clipped->set_point(ce.point[s], VMesh::Node::index_type(ids[s]));
+              nodeSource[ids[s]] = source;
+            }
+          }
+          for (int e = 0; e < ce.numElems; ++e)
+            for (size_t n = 0; n < nodesPerElem; ++n)
+              *cell++ = ids[ce.elems[e][n]];
+        });
+        blocks[b] = ClippedBlock();
       }
-      const double imv0 = isoval - v[perm[0]];
-      const double dl02 = imv0 / (v[perm[2]] - v[perm[0]]);
-      const Point l02 = Interpolate(p[perm[0]], p[perm[2]], dl02);
-      const double dl03 = imv0 / (v[perm[3]] - v[perm[0]]);
-      const Point l03 = Interpolate(p[perm[0]], p[perm[3]], dl03);
-
-      const double imv1 = isoval - v[perm[1]];
-      const double dl12 = imv1 / (v[perm[2]] - v[perm[1]]);
-      const Point l12 = Interpolate(p[perm[1]], p[perm[2]], dl12);
-      const double dl13 = imv1 / (v[perm[3]] - v[perm[1]]);
-      const Point l13 = Interpolate(p[perm[1]], p[perm[3]], dl13);
-
-
-      inodes[2] = edge_lookup((index_type)onodes[perm[0]],
-                              (index_type)onodes[perm[2]],
-                              dl02, l02, edgemap, clipped);
-      inodes[3] = edge_lookup((index_type)onodes[perm[0]],
-                              (index_type)onodes[perm[3]],
-                              dl03, l03, edgemap, clipped);
-      inodes[4] = edge_lookup((index_type)onodes[perm[1]],
-                              (index_type)onodes[perm[2]],
-                              dl12, l12, edgemap, clipped);
-      inodes[5] = edge_lookup((index_type)onodes[perm[1]],
-                              (index_type)onodes[perm[3]],
-                              dl13, l13, edgemap, clipped);
-
-      const Point c1 = Interpolate(l02, l03, 0.5);
-      const Point c2 = Interpolate(l12, l13, 0.5);
-
-      inodes[6] = face_lookup((index_type)onodes[perm[0]],
-                              (index_type)onodes[perm[2]],
-                              (index_type)onodes[perm[3]],
-                              dl02*0.5,
-                              dl03*0.5,
-                              c1, facemap, clipped);
-      inodes[7] = face_lookup((index_type)onodes[perm[1]],
-                              (index_type)onodes[perm[2]],
-                              (index_type)onodes[perm[3]],
-                              dl12*0.5,
-                              dl13*0.5,
-                              c2, facemap, clipped);
-
-      nnodes[0] = inodes[7];
-      nnodes[1] = inodes[2];
-      nnodes[2] = inodes[0];
-      nnodes[3] = inodes[4];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[1];
-      nnodes[1] = inodes[5];
-      nnodes[2] = inodes[3];
-      nnodes[3] = inodes[7];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[1];
-      nnodes[1] = inodes[3];
-      nnodes[2] = inodes[6];
-      nnodes[3] = inodes[7];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[0];
-      nnodes[1] = inodes[7];
-      nnodes[2] = inodes[6];
-      nnodes[3] = inodes[2];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[0];
-      nnodes[1] = inodes[1];
-      nnodes[2] = inodes[6];
-      nnodes[3] = inodes[7];
-      clipped->add_elem(nnodes);
-    }
-  }
-
-  VField* ofield = output->vfield();
-  ofield->resize_values();
-  CopyProperties(*input, *output);
-
-    // Add the data values from the old field to the new field.
-  node_hash_type::iterator nmitr = nodemap.begin();
-  while (nmitr != nodemap.end())
-  {
-    ofield->copy_value(field,((*nmitr).first),((*nmitr).second));
-    ++nmitr;
+    });
   }
 
-    // Put the isovalue at the edge break points.
-  edge_hash_type::iterator emitr = edgemap.begin();
-  while (emitr != edgemap.end())
+  /// Kept nodes copy the data values from the old field, new nodes get the
+  /// isovalue.
+  void setClippedValues(VField* field, VField* ofield, double isoval,
+    const std::vector<index_type>& nodeSource)
   {
-    ofield->set_value(isoval,((*emitr).second));
-    ++emitr;
+    ofield->resize_values();
+    Parallel::For(0, nodeSource.size(), 1 << 14, [&](size_t begin, size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        if (nodeSource[i] >= 0)
+          ofield->copy_value(field, nodeSource[i], static_cast<index_type>(i));
+        else
+          ofield->set_value(isoval, static_cast<index_type>(i));
+      }
+    });
   }
+}
 
-    // Put the isovalue at the face break points.  Assumes linear
-    // interpolation across the faces (which seems safe, this is what we
-    // used to cut with.)
-  face_hash_type::iterator fmitr = facemap.begin();
-  while (fmitr != facemap.end())
-  {
-    ofield->set_value(isoval,((*fmitr).second));
-    ++fmitr;
-  }
+ALGORITHM_PARAMETER_DEF(Fields, LessThanIsoValue);
+ALGORITHM_PARAMETER_DEF(Fields, ScalarIsoValue);
 
-  #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-  if (algo->get_bool("build_mapping"))
-  {
-      // Create the interpolant matrix.
-    const size_type nrows = clipped->num_nodes();
-    const size_type ncols = mesh->num_nodes();
+ClipMeshByIsovalueAlgo::ClipMeshByIsovalueAlgo()
+{
+  addParameter(Parameters::LessThanIsoValue, 1);
+  addParameter(Parameters::ScalarIsoValue, 0.0);
+}
 
-    std::vector<index_type> cctmp(nrows*3);
-    std::vector<double> dtmp(nrows*3);
-    SparseRowMatrix::Builder sparseBuilder;
-    const SparseRowMatrix::Rows& rr = sparseBuilder.allocate_rows(nrows + 1);
+class ClipMeshByIsovalueAlgoTet {
 
-    for (index_type i = 0; i < nrows * 3; i++)
-    {
-      cctmp[i] = -1;
-    }
+  public:
+    bool run(const AlgorithmBase* algo,FieldHandle input, FieldHandle& output, MatrixHandle& mapping) const;
 
-    size_type nnz = 0;
+  private:
+    void clip(VMesh* mesh, VField* field, VMesh::Elem::index_type idx,
+          double isoval, bool lte, ClippedElement& out) const;
+ };
 
-      // Add the data values from the old field to the new field.
-    nmitr = nodemap.begin();
-    while (nmitr != nodemap.end())
-    {
-      cctmp[(*nmitr).second * 3] = (*nmitr).first;
-      dtmp[(*nmitr).second * 3 + 0] = 1.0;
-      nnz++;
-      ++nmitr;
-    }
+void ClipMeshByIsovalueAlgoTet::clip(VMesh* mesh, VField* field, VMesh::Elem::index_type idx, double isoval, bool lte, ClippedElement& out) const
+{
+  VMesh::Node::array_type onodes(4);
+  std::vector<double> v(4);
+  std::vector<Point> p(4);
 
-      // Insert the double hits into cc.
-      // Put the isovalue at the edge break points.
-    emitr = edgemap.begin();
-    while (emitr != edgemap.end())
-    {
-      cctmp[(*emitr).second * 3 + 0] = (*emitr).first.first;
-      cctmp[(*emitr).second * 3 + 1] = (*emitr).first.second;
-      dtmp[(*emitr).second * 3 + 0] = 1.0 - (*emitr).first.dfirst;
-      dtmp[(*emitr).second * 3 + 1] = (*emitr).first.dfirst;
-      nnz+=2;
-      ++emitr;
-    }
+  out.clear();
+  mesh->get_nodes(onodes, idx);
 
-      // Insert the double hits into cc.
-      // Put the isovalue at the edge break points.
-    fmitr = facemap.begin();
-    while (fmitr != facemap.end())
+    // Get the values and compute an inside/outside mask.
+  VField::index_type inside = 0;
+  field->get_values(v,onodes);
+  for (size_t i = 0; i < onodes.size(); i++)
+  {
+    inside = inside << 1;
+    if (v[i] > isoval)
     {
-      cctmp[(*fmitr).second * 3 + 0] = (*fmitr).first.first;
-      cctmp[(*fmitr).second * 3 + 1] = (*fmitr).first.second;
-      cctmp[(*fmitr).second * 3 + 2] = (*fmitr).first.third;
-      dtmp[(*fmitr).second * 3 + 0] =
-          1.0 - (*fmitr).first.dsecond - (*fmitr).first.dthird;;
-      dtmp[(*fmitr).second * 3 + 1] = (*fmitr).first.dsecond;
-      dtmp[(*fmitr).second * 3 + 2] = (*fmitr).first.dthird;
-      nnz+=3;
-
-      ++fmitr;
+      inside |= 1;
     }
 
-    const SparseRowMatrix::Columns& cc = sparseBuilder.allocate_columns(nnz);
-    const SparseRowMatrix::Storage& d = sparseBuilder.allocate_data(nnz);
-
-    index_type j;
-    index_type counter = 0;
-    rr[0] = 0;
-    for (j = 0; j < nrows*3; j++)
-    {
-      if (j%3 == 0) { rr[j/3 + 1] = rr[j/3]; }
-      if (cctmp[j] != -1)
-      {
-        cc[counter] = cctmp[j];
-        d[counter] = dtmp[j];
-        rr[j/3 + 1]++;
-        counter++;
-      }
-    }
-    mapping = new SparseRowMatrix(nrows, ncols, sparseBuilder.build(), nnz);
   }
-  #endif
 
-  return (true);
-}
+    // Invert the mask if we are doing less than.
+  if (lte) { inside = ~inside & 0xf; }
 
-// Algorithm for tri meshes
+  if (inside == 0)
+  {
+      // Discard outside elements.
+    return;
+  }
 
-class ClipMeshByIsovalueAlgoTri
-{
-  public:
-    bool run(const AlgorithmBase* algo,FieldHandle input, FieldHandle& output, MatrixHandle& mapping) const;
+  mesh->get_centers(p, onodes);
 
-private:
-    VMesh::Node::index_type
-    edge_lookup(VField::index_type u0, VField::index_type u1, double d0,
-          const Point &p, detail::edge_hash_type &edgemap,
-          VMesh *clipped) const;
-};
+  if (inside == 0xf)
+  {
+      // Add this element to the new mesh.
+    for (size_t i = 0; i<onodes.size(); i++)
+      out.keep(onodes[i], p[i]);
 
-VMesh::Node::index_type ClipMeshByIsovalueAlgoTri::edge_lookup(VField::index_type u0, VField::index_type u1, double d0, const Point &p, detail::edge_hash_type &edgemap, VMesh *clipped) const
-{
-  using namespace detail;
-  edgepair_t np;
-  if (u0 < u1)  { np.first = u0; np.second = u1; np.dfirst = d0; }
-  else { np.first = u1; np.second = u0; np.dfirst = 1.0 - d0; }
-  const auto loc = edgemap.find(np);
-  if (loc == edgemap.end())
+    out.add(0, 1, 2, 3);
+  }
+  else if (inside == 0x8 || inside == 0x4 || inside == 0x2 || inside == 0x1)
   {
-    const VMesh::Node::index_type nodeindex = clipped->add_point(p);
-    edgemap[np] = nodeindex;
-    return nodeindex;
+      // Lop off 3 points and add resulting tet to the new mesh.
+    const int *perm = tet_permute_table[inside];
+    out.keep(onodes[perm[0]], p[perm[0]]);
+
+    const double imv = isoval - v[perm[0]];
+    const double dl1 = imv / (v[perm[1]] - v[perm[0]]);
+    const Point l1 = Interpolate(p[perm[0]], p[perm[1]], dl1);
+    const double dl2 = imv / (v[perm[2]] - v[perm[0]]);
+    const Point l2 = Interpolate(p[perm[0]], p[perm[2]], dl2);
+    const double dl3 = imv / (v[perm[3]] - v[perm[0]]);
+    const Point l3 = Interpolate(p[perm[0]], p[perm[3]], dl3);
+
+    out.split(onodes[perm[0]], onodes[perm[1]], l1);
+    out.split(onodes[perm[0]], onodes[perm[2]], l2);
+    out.split(onodes[perm[0]], onodes[perm[3]], l3);
+
+    out.add(0, 1, 2, 3);
   }
-  else
+  else if (inside == 0x7 || inside == 0xb || inside == 0xd || inside == 0xe)
+  {
+      // Lop off 1 point, break up the resulting quads and add the
+      // resulting tets to the mesh.
+    const int *perm = tet_permute_table[inside];
+    for (size_t i = 1; i < 4; i++)
+      out.keep(onodes[perm[i]], p[perm[i]]);
+
+    const double imv = isoval - v[perm[0]];
+    const double dl1 = imv / (v[perm[1]] - v[perm[0]]);
+    const Point l1 = Interpolate(p[perm[0]], p[perm[1]], dl1);
+    const double dl2 = imv / (v[perm[2]] - v[perm[0]]);
+    const Point l2 = Interpolate(p[perm[0]], p[perm[2]], dl2);
+    const double dl3 = imv / (v[perm[3]] - v[perm[0]]);
+    const Point l3 = Interpolate(p[perm[0]], p[perm[3]], dl3);
+
+    out.split(onodes[perm[0]], onodes[perm[1]], l1);
+    out.split(onodes[perm[0]], onodes[perm[2]], l2);
+    out.split(onodes[perm[0]], onodes[perm[3]], l3);
+
+    const Point c1 = Interpolate(l1, l2, 0.5);
+    const Point c2 = Interpolate(l2, l3, 0.5);
+    const Point c3 = Interpolate(l3, l1, 0.5);
+
+    out.split(onodes[perm[0]], onodes[perm[1]], onodes[perm[2]], c1);
+    out.split(onodes[perm[0]], onodes[perm[2]], onodes[perm[3]], c2);
+    out.split(onodes[perm[0]], onodes[perm[3]], onodes[perm[1]], c3);
+
+    out.add(0, 3, 8, 6);
+    out.add(1, 4, 6, 7);
+    out.add(2, 5, 7, 8);
+    out.add(0, 6, 8, 7);
+    out.add(0, 8, 2, 7);
+    out.add(0, 6, 7, 1);
+    out.add(0, 1, 7, 2);
+  }
+  else// if (inside == 0x3 || inside == 0x5 || inside == 0x6 ||
+        //     inside == 0x9 || inside == 0xa || inside == 0xc)
   {
-    return loc->second;
+      // Lop off two points, break the resulting quads, then add the
+      // new tets to the mesh.
+    const int *perm = tet_permute_table[inside];
+    for (size_t i = 2; i < 4; i++)
+      out.keep(onodes[perm[i]], p[perm[i]]);
+
+    const double imv0 = isoval - v[perm[0]];
+    const double dl02 = imv0 / (v[perm[2]] - v[perm[0]]);
+    const Point l02 = Interpolate(p[perm[0]], p[perm[2]], dl02);
+    const double dl03 = imv0 / (v[perm[3]] - v[perm[0]]);
+    const Point l03 = Interpolate(p[perm[0]], p[perm[3]], dl03);
+
+    const double imv1 = isoval - v[perm[1]];
+    const double dl12 = imv1 / (v[perm[2]] - v[perm[1]]);
+    const Point l12 = Interpolate(p[perm[1]], p[perm[2]], dl12);
+    const double dl13 = imv1 / (v[perm[3]] - v[perm[1]]);
+    const Point l13 = Interpolate(p[perm[1]], p[perm[3]], dl13);
+
+    out.split(onodes[perm[0]], onodes[perm[2]], l02);
+    out.split(onodes[perm[0]], onodes[perm[3]], l03);
+    out.split(onodes[perm[1]], onodes[perm[2]], l12);
+    out.split(onodes[perm[1]], onodes[perm[3]], l13);
+
+    const Point c1 = Interpolate(l02, l03, 0.5);
+    const Point c2 = Interpolate(l12, l13, 0.5);
+
+    out.split(onodes[perm[0]], onodes[perm[2]], onodes[perm[3]], c1);
+    out.split(onodes[perm[1]], onodes[perm[2]], onodes[perm[3]], c2);
+
+    out.add(7, 2, 0, 4);
+    out.add(1, 5, 3, 7);
+    out.add(1, 3, 6, 7);
+    out.add(0, 7, 6, 2);
+    out.add(0, 1, 6, 7);
   }
 }
 
-bool ClipMeshByIsovalueAlgoTri::run(const AlgorithmBase* algo, FieldHandle input, FieldHandle& output, MatrixHandle &) const
+bool ClipMeshByIsovalueAlgoTet::run(const AlgorithmBase* algo, FieldHandle input, FieldHandle& output, MatrixHandle &/*mapping*/) const
 {
   VField* field = input->vfield();
   VMesh*  mesh  = input->vmesh();
   VMesh*  clipped = output->vmesh();
-
-  using namespace detail;
-
-  node_hash_type nodemap;
-  edge_hash_type edgemap;
-
-  VMesh::Node::array_type onodes(3);
-  std::vector<double> v(3);
-  std::vector<Point>  p(3);
+  VField* ofield = output->vfield();
 
   double isoval = algo->get(Parameters::ScalarIsoValue).toDouble();
 
   bool lte = !algo->get(Parameters::LessThanIsoValue).toBool();
 
-  VMesh::size_type num_elems = mesh->num_elems();
-  for (VMesh::Elem::index_type idx=0; idx<num_elems; idx++)
-  {
-    mesh->get_nodes(onodes, idx);
-
-    // Get the values and compute an inside/outside mask.
-    VField::index_type inside = 0;
-    mesh->get_centers(p, onodes);
-    field->get_values(v, onodes);
-
-    for (size_t i = 0; i < onodes.size(); i++)
-    {
-      inside = inside << 1;
-      if (v[i] > isoval)
-      {
-        inside |= 1;
-      }
-    }
+  std::vector<index_type> nodeSource;
+  buildClippedMesh(mesh, clipped,
+    [&](VMesh::Elem::index_type idx, ClippedElement& out) { clip(mesh, field, idx, isoval, lte, out); },
+    nodeSource);
 
-    // Invert the mask if we are doing less than.
-    if (lte) { inside = ~inside & 0x7; }
-
-    if (inside == 0)
-    {
-      // Discard outside elements.
-    }
-    else if (inside == 0x7)
-    {
-      // Add this element to the new mesh.
-      VMesh::Node::array_type nnodes(onodes.size());
+    // Put the isovalue at the edge and face break points.  Assumes linear
+    // interpolation across the faces (which seems safe, this is what we
+    // used to cut with.)
+  setClippedValues(field, ofield, isoval, nodeSource);
+  CopyProperties(*input, *output);
 
-      for (size_t i = 0; i<onodes.size(); i++)
-      {
-        if (nodemap.find((VField::index_type)onodes[i]) == nodemap.end())
-        {
-          const VMesh::Node::index_type nodeindex = clipped->add_point(p[i]);
-          nodemap[(VField::index_type)onodes[i]] = nodeindex;
-          nnodes[i] = nodeindex;
-        }
-        else
-        {
-          nnodes[i] = nodemap[(VField::index_type)onodes[i]];
-        }
-      }
+  return (true);
+}
 
-      clipped->add_elem(nnodes);
-    }
-    else if (inside == 0x1 || inside == 0x2 || inside == 0x4)
-    {
-      // Add the corner containing the inside point to the mesh.
-      const int *perm = tri_permute_table[inside];
-      VMesh::Node::array_type nnodes(onodes.size());
-      if (nodemap.find((VField::index_type)onodes[perm[0]]) == nodemap.end())
-      {
-        const VMesh::Node::index_type nodeindex =
-            clipped->add_point(p[perm[0]]);
-        nodemap[(VField::index_type)onodes[perm[0]]] = nodeindex;
-        nnodes[0] = nodeindex;
-      }
-      else
-      {
-        nnodes[0] = nodemap[(VField::index_type)onodes[perm[0]]];
-      }
+// Algorithm for tri meshes
 
-      const double imv = isoval - v[perm[0]];
+class ClipMeshByIsovalueAlgoTri
+{
+  public:
+    bool run(const AlgorithmBase* algo,FieldHandle input, FieldHandle& output, MatrixHandle& mapping) const;
 
-      const double dl1 = imv / (v[perm[1]] - v[perm[0]]);
-      const Point l1 = Interpolate(p[perm[0]], p[perm[1]], dl1);
-      const double dl2 = imv / (v[perm[2]] - v[perm[0]]);
-      const Point l2 = Interpolate(p[perm[0]], p[perm[2]], dl2);
+private:
+    void clip(VMesh* mesh, VField* field, VMesh::Elem::index_type idx,
+          double isoval, bool lte, ClippedElement& out) const;
+};
 
+void ClipMeshByIsovalueAlgoTri::clip(VMesh* mesh, VField* field, VMesh::Elem::index_type idx, double isoval, bool lte, ClippedElement& out) const
+{
+  VMesh::Node::array_type onodes(3);
+  std::vector<double> v(3);
+  std::vector<Point>  p(3);
 
-      nnodes[1] = edge_lookup((VField::index_type)onodes[perm[0]],
-			      (index_type)onodes[perm[1]],
-			      dl1, l1, edgemap, clipped);
+  out.clear();
+  mesh->get_nodes(onodes, idx);
 
-      nnodes[2] = edge_lookup((VField::index_type)onodes[perm[0]],
-			      (index_type)onodes[perm[2]],
-			      dl2, l2, edgemap, clipped);
+  // Get the values and compute an inside/outside mask.
+  VField::index_type inside = 0;
+  field->get_values(v, onodes);
 
-      clipped->add_elem(nnodes);
-    }
-    else
+  for (size_t i = 0; i < onodes.size(); i++)
+  {
+    inside = inside << 1;
+    if (v[i] > isoval)
     {
-      // Lop off the one point that is outside of the mesh, then add
-      // the remaining quad to the mesh by dicing it into two
-      // triangles.
-      const int *perm = tri_permute_table[inside];
-      VMesh::Node::array_type inodes(4);
-      if (nodemap.find((index_type)onodes[perm[1]]) == nodemap.end())
-      {
-        const VMesh::Node::index_type nodeindex = clipped->add_point(p[perm[1]]);
-        nodemap[(VField::index_type)onodes[perm[1]]] = nodeindex;
-        inodes[0] = nodeindex;
-      }
-      else
-      {
-        inodes[0] = nodemap[(VField::index_type)onodes[perm[1]]];
-      }
+      inside |= 1;
+    }
+  }
 
-      if (nodemap.find((VField::index_type)onodes[perm[2]]) == nodemap.end())
-      {
-        const VMesh::Node::index_type nodeindex = clipped->add_point(p[perm[2]]);
-        nodemap[(VField::index_type)onodes[perm[2]]] = nodeindex;
-        inodes[1] = nodeindex;
-      }
-      else
-      {
-        inodes[1] = nodemap[(VField::index_type)onodes[perm[2]]];
-      }
+  // Invert the mask if we are doing less than.
+  if (lte) { inside = ~inside & 0x7; }
 
-      const double imv = isoval - v[perm[0]];
-      const double dl1 = imv / (v[perm[1]] - v[perm[0]]);
-      const Point l1 = Interpolate(p[perm[0]], p[perm[1]], dl1);
-      const double dl2 = imv / (v[perm[2]] - v[perm[0]]);
-      const Point l2 = Interpolate(p[perm[0]], p[perm[2]], dl2);
+  if (inside == 0)
+  {
+    // Discard outside elements.
+    return;
+  }
 
-      inodes[2] = edge_lookup((VField::index_type)onodes[perm[0]],
-			      (VField::index_type)onodes[perm[1]],
-			      dl1, l1, edgemap, clipped);
+  mesh->get_centers(p, onodes);
 
-      inodes[3] = edge_lookup((VField::index_type)onodes[perm[0]],
-			      (VField::index_type)onodes[perm[2]],
-			      dl2, l2, edgemap, clipped);
+  if (inside == 0x7)
+  {
+    // Add this element to the new mesh.
+    for (size_t i = 0; i<onodes.size(); i++)
+      out.keep(onodes[i], p[i]);
 
-      VMesh::Node::array_type nnodes(onodes.size());
+    out.add(0, 1, 2);
+  }
+  else if (inside == 0x1 || inside == 0x2 || inside == 0x4)
+  {
+    // Add the corner containing the inside point to the mesh.
+    const int *perm = tri_permute_table[inside];
+    out.keep(onodes[perm[0]], p[perm[0]]);
 
-      nnodes[0] = inodes[0];
-      nnodes[1] = inodes[1];
-      nnodes[2] = inodes[3];
-      clipped->add_elem(nnodes);
+    const double imv = isoval - v[perm[0]];
 
-      nnodes[0] = inodes[0];
-      nnodes[1] = inodes[3];
-      nnodes[2] = inodes[2];
-      clipped->add_elem(nnodes);
-    }
-  }
+    const double dl1 = imv / (v[perm[1]] - v[perm[0]]);
+    const Point l1 = Interpolate(p[perm[0]], p[perm[1]], dl1);
+    const double dl2 = imv / (v[perm[2]] - v[perm[0]]);
+    const Point l2 = Interpolate(p[perm[0]], p[perm[2]], dl2);
 
-  VField* ofield = output->vfield();
-  ofield->resize_values();
-  #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-   ofield->copy_properties(field);
-  #endif
+    out.split(onodes[perm[0]], onodes[perm[1]], l1);
+    out.split(onodes[perm[0]], onodes[perm[2]], l2);
 
-  // Add the data values from the old field to the new field.
-  node_hash_type::iterator nmitr = nodemap.begin();
-  while (nmitr != nodemap.end())
-  {
-    ofield->copy_value(field,((*nmitr).first),((*nmitr).second));
-    ++nmitr;
+    out.add(0, 1, 2);
   }
-
-  // Put the isovalue at the edge break points.
-  edge_hash_type::iterator emitr = edgemap.begin();
-  while (emitr != edgemap.end())
+  else
   {
-    ofield->set_value(isoval, ((*emitr).second));
-    ++emitr;
+    // Lop off the one point that is outside of the mesh, then add
+    // the remaining quad to the mesh by dicing it into two
+    // triangles.
+    const int *perm = tri_permute_table[inside];
+    out.keep(onodes[perm[1]], p[perm[1]]);
+    out.keep(onodes[perm[2]], p[perm[2]]);
+
+    const double imv = isoval - v[perm[0]];
+    const double dl1 = imv / (v[perm[1]] - v[perm[0]]);
+    const Point l1 = Interpolate(p[perm[0]], p[perm[1]], dl1);
+    const double dl2 = imv / (v[perm[2]] - v[perm[0]]);
+    const Point l2 = Interpolate(p[perm[0]], p[perm[2]], dl2);
+
+    out.split(onodes[perm[0]], onodes[perm[1]], l1);
+    out.split(onodes[perm[0]], onodes[perm[2]], l2);
+
+    out.add(0, 1, 3);
+    out.add(0, 3, 2);
   }
+}
 
-  #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-  if(algo->get_bool("build_mapping"))
-  {
-    // Create the interpolant matrix.
-
-    const size_type nrows = clipped->num_nodes();
-    const size_type ncols = mesh->num_nodes();
-    std::vector<index_type> cctmp(nrows*2);
-    std::vector<double> dtmp(nrows*2);
-    SparseRowMatrix::Builder sparseBuilder;
-    const SparseRowMatrix::Rows& rr = sparseBuilder.allocate_rows(nrows + 1);
-
-    for (index_type i = 0; i < nrows * 2; i++)
-    {
-      cctmp[i] = -1;
-    }
+bool ClipMeshByIsovalueAlgoTri::run(const AlgorithmBase* algo, FieldHandle input, FieldHandle& output, MatrixHandle &) const
+{
+  VField* field = input->vfield();
+  VMesh*  mesh  = input->vmesh();
+  VMesh*  clipped = output->vmesh();
+  VField* ofield = output->vfield();
 
-    size_type nnz = 0;
+  double isoval = algo->get(Parameters::ScalarIsoValue).toDouble();
 
-    // Add the data values from the old field to the new field.
-    nmitr = nodemap.begin();
-    while (nmitr != nodemap.end())
-    {
-      cctmp[(*nmitr).second * 2] = (*nmitr).first;
-      dtmp[(*nmitr).second * 2 + 0] = 1.0;
-      nnz++;
-      ++nmitr;
-    }
+  bool lte = !algo->get(Parameters::LessThanIsoValue).toBool();
 
-    // Insert the double hits into cc.
-    // Put the isovalue at the edge break points.
-    emitr = edgemap.begin();
-    while (emitr != edgemap.end())
-    {
-      cctmp[(*emitr).second * 2 + 0] = (*emitr).first.first;
-      cctmp[(*emitr).second * 2 + 1] = (*emitr).first.second;
-      dtmp[(*emitr).second * 2 + 0] = 1.0 - (*emitr).first.dfirst;
-      dtmp[(*emitr).second * 2 + 1] = (*emitr).first.dfirst;
-      nnz+=2;
-      ++emitr;
-    }
+  std::vector<index_type> nodeSource;
+  buildClippedMesh(mesh, clipped,
+    [&](VMesh::Elem::index_type idx, ClippedElement& out) { clip(mesh, field, idx, isoval, lte, out); },
+    nodeSource);
 
-    const SparseRowMatrix::Columns& cc = sparseBuilder.allocate_columns(nnz);
-    const SparseRowMatrix::Storage& d = sparseBuilder.allocate_data(nnz);
+  // Put the isovalue at the edge break points.
+  setClippedValues(field, ofield, isoval, nodeSource);
 
-    index_type j;
-    index_type counter = 0;
-    rr[0] = 0;
-    for (j = 0; j < nrows*2; j++)
-    {
-      if (j%2 == 0) { rr[j/2 + 1] = rr[j/2]; }
-      if (cctmp[j] != -1)
-      {
-        cc[counter] = cctmp[j];
-        d[counter] = dtmp[j];
-        rr[j/2 + 1]++;
-        counter++;
-      }
-    }
-    mapping = new SparseRowMatrix(nrows, ncols, sparseBuilder.build(), nnz);
-  }
+  #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
+   ofield->copy_properties(field);
   #endif
 
   return (true);
@@ -941,13 +720,6 @@ class ClipMeshByIsovalueAlgoHex
 {
   public:
     bool run(const AlgorithmBase* algo,FieldHandle input, FieldHandle& output, MatrixHandle& mapping) const;
-
-    static bool ud_pair_less(const std::pair<VField::index_type, double> &a,
-                             const std::pair<VField::index_type, double> &b)
-    {
-        return a.first < b.first;
-    };
-
 };
 
 bool ClipMeshByIsovalueAlgoHex::run(const AlgorithmBase* algo, FieldHandle input, FieldHandle& output, MatrixHandle &) const
@@ -976,239 +748,172 @@ bool ClipMeshByIsovalueAlgoHex::run(const AlgorithmBase* algo, FieldHandle input
   VMesh*  clipped = output->vmesh();
 
   // Get a list of the original boundary elements (code from FieldBoundary).
-  std::map<VMesh::DElem::index_type, VMesh::DElem::index_type> original_boundary;
   mesh->synchronize(Mesh::ELEM_NEIGHBORS_E | Mesh::FACES_E);
+  std::vector<char> original_boundary(mesh->num_delems(), 0);
 
   // Walk all the cells in the mesh looking for faces on the boundary
-
-  VMesh::size_type num_elems = mesh->num_elems();
-  VMesh::DElem::array_type delems;
-  VMesh::Elem::index_type nidx;
-
-  for (VMesh::Elem::index_type idx=0; idx< num_elems; idx++)
+  const VMesh::size_type num_elems = mesh->num_elems();
+  Parallel::For(0, num_elems, clipBlockSize, [&](size_t begin, size_t end)
   {
-    // Get all the faces in the cell.
-    mesh->get_delems(delems, idx);
-
-    for (size_t j=0; j<delems.size(); j++)
+    VMesh::DElem::array_type delems;
+    VMesh::Elem::index_type nidx;
+    for (VMesh::Elem::index_type idx = begin; idx < static_cast<index_type>(end); idx++)
     {
-      if( !mesh->get_neighbor(nidx, idx, delems[j] ) )
+      // Get all the faces in the cell.
+      mesh->get_delems(delems, idx);
+
+      for (size_t j=0; j<delems.size(); j++)
       {
         // Faces with no neighbors are on the boundary.
-        original_boundary[delems[j]] = delems[j];
+        if( !mesh->get_neighbor(nidx, idx, delems[j] ) )
+          original_boundary[delems[j]] = 1;
       }
     }
-  }
-
-  // Create a map to help differentiate between new nodes created for
-  // the inserted sheet, and the nodes on the stair stepped boundary.
-  std::map<VMesh::Node::index_type, VMesh::Node::index_type> clipped_to_original_nodemap;
-  typedef std::unordered_map<VField::index_type, VMesh::Node::index_type> hash_type;
-
-  hash_type nodemap;
-
-  std::vector<VMesh::Elem::index_type> elemmap;
+  });
 
   // Find all of the hexes inside the isosurface and add them to the
-  // clipped mesh.
-  for (VMesh::Elem::index_type idx=0; idx<num_elems; idx++)
-  {
-    bool inside = false;
-
-    VMesh::Node::array_type onodes;
-    mesh->get_nodes(onodes, idx);
-    inside = true;
-
-    for (size_t i = 0; i < onodes.size(); i++)
-    {
-      double v;
-      field->get_value(v, onodes[i]);
-
-      if( lte )
-      {
-        if( v > isoval )
-        {
-          inside = false;
-          break;
-        }
-      }
-      else
-      {
-        if( v < isoval )
-        {
-          inside = false;
-          break;
-        }
-      }
-    }
-
-    if (inside)
+  // clipped mesh. The node map helps to differentiate between new nodes
+  // created for the inserted sheet, and the nodes on the stair stepped
+  // boundary.
+  std::vector<index_type> clipped_to_original_nodemap;
+  buildClippedMesh(mesh, clipped,
+    [&](VMesh::Elem::index_type idx, ClippedElement& out)
     {
+      out.clear();
       VMesh::Node::array_type onodes;
       mesh->get_nodes(onodes, idx);
 
-      // Add this element to the new mesh.
-      VMesh::Node::array_type nnodes(onodes.size());
-
-      for (size_t i = 0; i<onodes.size(); i++)
+      for (size_t i = 0; i < onodes.size(); i++)
       {
-        if (nodemap.find((VField::index_type)onodes[i]) == nodemap.end())
-        {
-          Point np;
-          mesh->get_center(np, onodes[i]);
-          const VMesh::Node::index_type nodeindex = clipped->add_point(np);
-          clipped_to_original_nodemap[nodeindex] = onodes[i];
-          nodemap[(VField::index_type)onodes[i]] = nodeindex;
-          nnodes[i] = nodeindex;
-        }
-        else
-        {
-          nnodes[i] = nodemap[(VField::index_type)onodes[i]];
-        }
+        double v;
+        field->get_value(v, onodes[i]);
+        if (lte ? v > isoval : v < isoval) return;
       }
 
-      clipped->add_elem(nnodes);
-      elemmap.push_back(idx); // Assumes elements always added to end.
-    }
-  }
+      Point np;
+      for (size_t i = 0; i < onodes.size(); i++)
+      {
+        mesh->get_center(np, onodes[i]);
+        out.keep(onodes[i], np);
+      }
+      out.addAll();
+    },
+    clipped_to_original_nodemap);
 
   // Get the boundary elements of the clipped mesh (code from FieldBoundary)
   // We'll use this list of boundary elements (minus the elements from
   // the original boundary) so we know which nodes to project to the
   // isosurface to create the new sheet of hexes.
-  std::map<VMesh::Node::index_type, VMesh::Node::index_type> vertex_map;
-
-  std::vector<VMesh::Node::index_type> node_list;
-  std::vector<VMesh::DElem::index_type> face_list;
-
   clipped->synchronize( Mesh::ELEM_NEIGHBORS_E | Mesh::FACES_E );
 
-  // Walk all the cells in the clipped mesh to find the boundary faces.
+  // Walk all the cells in the clipped mesh to find the boundary faces,
+  // block by block so the faces keep the order of the cells.
+  const VMesh::size_type num_celems = clipped->num_elems();
+  const size_t num_blocks = (num_celems + clipBlockSize - 1) / clipBlockSize;
+  std::vector<std::vector<VMesh::DElem::index_type> > block_faces(num_blocks);
 
-  VMesh::size_type num_celems = clipped->num_elems();
-  VMesh::DElem::array_type faces;
-  VMesh::DElem::index_type old_face;
-  VMesh::Node::array_type face_nodes;
-  VMesh::Node::array_type nodes;
-
-  for (VMesh::Elem::index_type idx = 0; idx<num_celems; idx++)
+  Parallel::For(0, num_blocks, 1, [&](size_t begin, size_t end)
   {
-    // Get all the faces in the cell.
-    clipped->get_delems( faces, idx );
-
-    // Check each face for neighbors.
-    VMesh::DElem::array_type::iterator fiter = faces.begin();
-
-    while( fiter != faces.end() )
+    VMesh::DElem::array_type faces;
+    VMesh::DElem::index_type old_face;
+    VMesh::Node::array_type face_nodes;
+    VMesh::Elem::index_type nci;
+    for (size_t b = begin; b < end; ++b)
     {
-      VMesh::Elem::index_type nci;
-      VMesh::DElem::index_type fi = *fiter;
-      ++fiter;
-
-      if( !clipped->get_neighbor( nci, idx, fi ) )
+      const index_type last = std::min<index_type>(num_celems, (b + 1) * clipBlockSize);
+      for (VMesh::Elem::index_type idx = b * clipBlockSize; idx < last; idx++)
       {
-        // Faces with no neighbors are on the boundary.  Make sure
-        // that this face isn't on the original boundary.
-        bool is_old_boundary = false;
-        index_type i;
-
-        clipped->get_nodes( face_nodes, fi );
-        for (size_t j=0;j<4; j++) face_nodes[j] = clipped_to_original_nodemap[face_nodes[j]];
-        if( mesh->get_delem( old_face, face_nodes) )
-        {
-          auto bound_iter = original_boundary.find( old_face );
-          if( bound_iter != original_boundary.end() )
-          {
-            is_old_boundary = true;
-          }
-        }
+        // Get all the faces in the cell.
+        clipped->get_delems( faces, idx );
 
-        // Don't add the nodes from the faces of the original boundary
-        // to the list of nodes that we'll be projecting later to
-        // create the new sheet of hex elements.
-        if( !is_old_boundary )
+        for (size_t k = 0; k < faces.size(); k++)
         {
-          face_list.push_back( fi );
+          if( clipped->get_neighbor( nci, idx, faces[k] ) ) continue;
 
-          clipped->get_nodes( nodes, fi );
+          // Faces with no neighbors are on the boundary. Don't add the
+          // faces of the original boundary, their nodes are not projected
+          // to create the new sheet of hex elements.
+          clipped->get_nodes( face_nodes, faces[k] );
+          for (size_t j=0;j<4; j++) face_nodes[j] = clipped_to_original_nodemap[face_nodes[j]];
+          if( mesh->get_delem( old_face, face_nodes) && original_boundary[old_face] ) continue;
 
-          VMesh::Node::array_type::iterator niter = nodes.begin();
+          block_faces[b].push_back( faces[k] );
+        }
+      }
+    }
+  });
 
-          VMesh::size_type size = nodes.size();
-          for( i = 0; i < size; i++ )
-          {
-            auto node_iter = vertex_map.find( *niter );
-            if( node_iter == vertex_map.end() )
-            {
-              node_list.push_back( *niter );
-              vertex_map[*niter] = *niter;
-            }
-            ++niter;
-          }
+  // Collect the quads and their nodes in order; new_map maps a node on
+  // the clipped boundary to the node projected from it.
+  const index_type num_cnodes = clipped->num_nodes();
+  std::vector<VMesh::Node::index_type> node_list;
+  std::vector<index_type> new_map(num_cnodes, -1);
+  std::vector<std::array<index_type, 4> > face_list;
+
+  VMesh::Node::array_type nodes;
+  for (size_t b = 0; b < num_blocks; b++)
+  {
+    for (size_t k = 0; k < block_faces[b].size(); k++)
+    {
+      clipped->get_nodes( nodes, block_faces[b][k] );
+      std::array<index_type, 4> quad;
+      for (size_t j = 0; j < 4; j++)
+      {
+        quad[j] = nodes[j];
+        if (new_map[nodes[j]] < 0)
+        {
+          new_map[nodes[j]] = num_cnodes + node_list.size();
+          node_list.push_back( nodes[j] );
         }
       }
+      face_list.push_back( quad );
     }
   }
 
   // For each new node on the clipped boundary, project a new node to
-  // the isosurface create a map between the clipped boundary nodes
-  // and the new nodes to help us create hexes with the correct
-  // connectivity later.
+  // the isosurface.
   if (!tri_mesh->is_empty())
     tri_mesh->synchronize( Mesh::FIND_CLOSEST_ELEM_E );
-  std::map<VMesh::Node::index_type, VMesh::Node::index_type> new_map;
 
-  int cnt = 0;
-  for(size_t i = 0; i < node_list.size(); i++ )
+  clipped->resize_nodes(num_cnodes + node_list.size());
+  Parallel::For(0, node_list.size(), 256, [&](size_t begin, size_t end)
   {
-    VMesh::Node::index_type this_node = node_list[i];
-    Point n_p;
-    clipped->get_center( n_p, this_node );
-
-    Point new_result;
-    VMesh::Elem::index_type face_id;
-    double dist;
-
-    tri_mesh->find_closest_elem(dist, new_result, face_id, n_p );
+    for (size_t i = begin; i < end; i++)
+    {
+      Point n_p;
+      clipped->get_center( n_p, node_list[i] );
 
-    // Add the new node to the clipped mesh.
-    Point new_point( new_result );
-    VMesh::Node::index_type this_index = clipped->add_point( new_point );
+      Point new_result;
+      VMesh::Elem::index_type face_id;
+      double dist;
 
-    // Create a map for the new node to a node on the boundary of the
-    // clipped mesh.
-    new_map[this_node] = this_index;
-    cnt++;
-    if (cnt == 100)
-    {
-     cnt = 0;
-     #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-      algo->update_progress(i,(size_type)(1.3*num_celems));
-     #endif
+      tri_mesh->find_closest_elem(dist, new_result, face_id, n_p );
+      clipped->set_point( new_result, VMesh::Node::index_type(num_cnodes + i) );
     }
-  }
+  });
 
   // For each quad on the clipped boundary we have a map to the new
   // projected nodes so, create the new sheet of hexes from each quad
   // on the clipped boundary
-  std::vector<VMesh::Elem::index_type> new_elems;
-  for(size_t i = 0; i < face_list.size(); i++ )
+  clipped->resize_elems(num_celems + face_list.size());
+  Parallel::For(0, face_list.size(), 1 << 12, [&](size_t begin, size_t end)
   {
-    VMesh::Node::array_type nodes;
-    clipped->get_nodes( nodes, face_list[i] );
-
     VMesh::Node::array_type nnodes(8);
-    nnodes[0] = nodes[3];
-    nnodes[1] = nodes[2];
-    nnodes[2] = nodes[1];
-    nnodes[3] = nodes[0];
-    nnodes[4] = new_map[nodes[3]];
-    nnodes[5] = new_map[nodes[2]];
-    nnodes[6] = new_map[nodes[1]];
-    nnodes[7] = new_map[nodes[0]];
-
-    new_elems.push_back( clipped->add_elem( nnodes ) );
-  }
+    for (size_t i = begin; i < end; i++)
+    {
+      const std::array<index_type, 4>& quad = face_list[i];
+      nnodes[0] = quad[3];
+      nnodes[1] = quad[2];
+      nnodes[2] = quad[1];
+      nnodes[3] = quad[0];
+      nnodes[4] = new_map[quad[3]];
+      nnodes[5] = new_map[quad[2]];
+      nnodes[6] = new_map[quad[1]];
+      nnodes[7] = new_map[quad[0]];
+
+      clipped->set_nodes( nnodes, VMesh::Elem::index_type(num_celems + i) );
+    }
+  });
 
   // Force all the synch data to be rebuilt on next synch call.
   clipped->clear_synchronization();
@@ -1217,106 +922,6 @@ bool ClipMeshByIsovalueAlgoHex::run(const AlgorithmBase* algo, FieldHandle input
   ofield->resize_values();
   CopyProperties(*input, *output);
 
-  #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-  const size_type nrows = nodemap.size() + node_list.size();
-  // Create the interpolation matrix for downstream use.
-  hash_type::iterator hitr = nodemap.begin();
-  const size_type ncols = field->num_values();
-  const size_type nnz = nrows+7*node_list.size();
-  SparseRowMatrix::Data sparseData(nrows+1, nnz);
-  const SparseRowMatrix::Rows& rr = sparseData.rows();
-  const SparseRowMatrix::Columns& cc = sparseData.columns();
-  const SparseRowMatrix::Storage& d = sparseData.data();
-
-  // Nodes in the original mesh will have the same field values as
-  // before since we didn't move any of them.
-  while( hitr != nodemap.end() )
-  {
-    ofield->copy_value(field,((*hitr).first), ((*hitr).second));
-    cc[(*hitr).second] = (*hitr).first;
-    ++hitr;
-  }
-
-  // Nodes in the original mesh have a one-to-one correspondence in
-  // the interp matrix.
-  size_t i;
-  for( i = 0; i < nodemap.size(); i++ )
-  {
-    rr[i] = i;
-    d[i] = 1.0;
-  }
-
-  // Figure out the correspondence for the new nodes with the original mesh.
-  index_type counter = i;
-  index_type rrvalue = i;
-
-  mesh->synchronize(Mesh::LOCATE_E);
-  for( size_t j = 0; j < node_list.size(); j++ )
-  {
-    rr[counter+j] = rrvalue;
-
-    VMesh::Node::index_type ni = new_map[node_list[j]];
-
-    Point p;
-    clipped->get_center(p, ni);
-
-    // Find the cell in the old mesh which the new node is located in and
-    // interpolate values between the nodes in this cell for the new values.
-    VMesh::Elem::index_type el;
-    if( mesh->locate( el, p ) )
-    {
-      VMesh::ElemInterpolate ei;
-      mesh->get_interpolate_weights(p, ei, 1);
-
-      std::vector<std::pair<VField::index_type, double> > snodes(8);
-      for (int k = 0; k < 8; k++)
-      {
-        snodes[k].first =  ei.node_index[k];
-        snodes[k].second = ei.weights[k];
-      }
-      std::sort(snodes.begin(), snodes.end(), ud_pair_less);
-      double val;
-      double actual_val = 0;
-      for( int k = 0; k < 8; k++ )
-      {
-        field->get_value( val, snodes[k].first );
-        actual_val += snodes[k].first * val;
-        cc[rrvalue+k] = snodes[k].first;
-        d[rrvalue+k] = snodes[k].second;
-      }
-      ofield->set_value( actual_val, ni );
-    }
-    else
-    {
-      // Just find nearest node in the mesh.
-      VMesh::Node::index_type oi;
-      mesh->locate( oi, p );
-      cc[rrvalue] = oi;
-      d[rrvalue] = 1.0;
-      cc[rrvalue+1] = 0;
-      d[rrvalue+1] = 0.0;
-      cc[rrvalue+2] = 0;
-      d[rrvalue+2] = 0.0;
-      cc[rrvalue+3] = 0;
-      d[rrvalue+3] = 0.0;
-      cc[rrvalue+4] = 0;
-      d[rrvalue+4] = 0.0;
-      cc[rrvalue+5] = 0;
-      d[rrvalue+5] = 0.0;
-      cc[rrvalue+6] = 0;
-      d[rrvalue+6] = 0.0;
-      cc[rrvalue+7] = 0;
-      d[rrvalue+7] = 0.0;
-    }
-
-    rrvalue += 8;
-  }
-  rr[nrows] = rrvalue; // An extra entry goes on the end of rr.
-
-  // Create the interp matrix.
-  mapping = new SparseRowMatrix( nrows, ncols, sparseData, nrows+7*node_list.size() );
-  #endif
-
   return (true);
 }
 
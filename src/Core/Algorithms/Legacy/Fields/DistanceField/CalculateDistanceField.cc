@@ -27,6 +27,7 @@
 
 
 #include <Core/Algorithms/Legacy/Fields/DistanceField/CalculateDistanceField.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/GridDistanceTransform.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
@@ -48,6 +49,7 @@ ALGORITHM_PARAMETER_DEF(Fields, Truncate);
 ALGORITHM_PARAMETER_DEF(Fields, TruncateDistance);
 ALGORITHM_PARAMETER_DEF(Fields, OutputFieldDatatype);
 ALGORITHM_PARAMETER_DEF(Fields, OutputValueField);
+ALGORITHM_PARAMETER_DEF(Fields, ApproximateOnGrid);
 
 CalculateDistanceFieldAlgo::CalculateDistanceFieldAlgo()
 {
@@ -55,6 +57,7 @@ CalculateDistanceFieldAlgo::CalculateDistanceFieldAlgo()
   addParameter(Truncate, false);
   addParameter(TruncateDistance, 1.0);
   addParameter(OutputValueField, false);
+  addParameter(ApproximateOnGrid, false);
   addOption(BasisType, "same as input","same as input|constant|linear");
   addOption(OutputFieldDatatype, "double","char|unsigned char|short|unsigned short|int|unsigned int|float|double");
 }
@@ -138,6 +141,26 @@ class CalculateDistanceFieldP : public Interruptible
       }
     }
 
+    // Output on a regular grid: the closest points come from the distance transform
+    void parallel_grid(int proc, int nproc, const GridDistanceTransform& grid, double max)
+    {
+      VMesh::index_type start, end;
+      range(proc,nproc,start,end,grid.size());
+
+      double val = 0.0;
+      int cnt = 0;
+      VMesh::Elem::index_type fidx;
+      Point p2;
+
+      for (VMesh::index_type idx=start; idx<end; idx++)
+      {
+        if (!grid.closest(idx,val,p2,fidx)) val = max;
+        ofield->set_value(val,idx);
+
+        if (proc == 0) { cnt++; if (cnt == 1000) { algo_->update_progress_max(idx,end); cnt = 0; } }
+      }
+    }
+
     void parallel2(int proc, int nproc)
     {
       VMesh::size_type num_values = ofield->num_values();
@@ -405,6 +428,25 @@ CalculateDistanceFieldAlgo::runImpl(FieldHandle input, FieldHandle object, Field
   }
 
   detail::CalculateDistanceFieldP palgo(imesh,objmesh,ofield,this);
+
+  // On LatVol and Image meshes only a band around the object needs a closest element search,
+  // at the price of small errors further away, so this has to be asked for
+  if (get(Parameters::ApproximateOnGrid).toBool())
+  {
+    GridDistanceTransform grid(imesh,ofield->basis_order(),objmesh,this);
+    if (grid.applies())
+    {
+      double max = DBL_MAX;
+      if (get(Parameters::Truncate).toBool())
+        max = get(Parameters::TruncateDistance).toDouble();
+
+      grid.run(max);
+      auto task_g = [&palgo,&grid,max](int i) { palgo.parallel_grid(i, Parallel::NumCores(), grid, max); };
+      Parallel::RunTasks(task_g, Parallel::NumCores());
+      return (true);
+    }
+  }
+
   auto task_i = [&palgo](int i) { palgo.parallel(i, Parallel::NumCores()); };
   Parallel::RunTasks(task_i, Parallel::NumCores());
 
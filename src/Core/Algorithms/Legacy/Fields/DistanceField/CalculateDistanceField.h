@@ -44,6 +44,7 @@ namespace SCIRun {
         ALGORITHM_PARAMETER_DECL(TruncateDistance);
         ALGORITHM_PARAMETER_DECL(OutputFieldDatatype);
         ALGORITHM_PARAMETER_DECL(OutputValueField);
+        ALGORITHM_PARAMETER_DECL(ApproximateOnGrid);
 
         class SCISHARE CalculateDistanceFieldAlgo : public AlgorithmBase, public Core::Thread::Interruptible
         {
@@ -27,6 +27,8 @@
 
 
 #include <Core/Algorithms/Legacy/Fields/DistanceField/CalculateSignedDistanceField.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/CalculateDistanceField.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/GridDistanceTransform.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
@@ -63,255 +65,75 @@ class CalculateSignedDistanceFieldP : public Interruptible
 
       if (ofield->basis_order() == 0)
       {
-        VMesh::Elem::index_type fidx, fidx_n;
-        VMesh::Node::array_type nodes;
-        VMesh::DElem::array_type delems;
-        Vector n, k;
-        Point n0,n1,n2;
+        VMesh::Elem::index_type fidx;
         VMesh::index_type start, end;
         range(proc,nproc,start,end,num_values);
 
         for (VMesh::Elem::index_type idx = start; idx < end; idx++)
         {
-
-          Point p, p1, p2;
+          Point p, p2;
           imesh->get_center(p,idx);
-
           objmesh->find_closest_elem(val,p2,fidx,p);
-          objmesh->get_nodes(nodes,fidx);
-          objmesh->get_center(n0,nodes[0]);
-          objmesh->get_center(n1,nodes[1]);
-          objmesh->get_center(n2,nodes[2]);
-
-          n = Cross(Vector(n1-n0),Vector(n2-n1));
-          k = Vector(p-p2); k.normalize();
-
-          double angle = Dot(n,k);
-          if (angle < -epsilon)
-          {
-            val = -val;
-          }
-          else if (angle > epsilon)
-          {
-          }
-          else
-          {
-            // trouble
-            if (val != 0.0)
-            {
-               objmesh->get_delems(delems,fidx);
-               double mindist = DBL_MAX;
-               double dist;
-               int edgeidx = 0;
-               for (size_t r=0; r<delems.size();r++)
-               {
-                 objmesh->get_nodes(nodes,delems[r]);
-                 objmesh->get_center(p1,nodes[0]);
-                 objmesh->get_center(p2,nodes[1]);
-
-                if (Dot(Vector(p-p2),Vector(p2-p1)) >= 0.0)
-                {
-                  Vector v = Vector(p-p2);
-                  dist  = Dot(v,v);
-                }
-                else if (Dot(Vector(p-p1),Vector(p1-p2)) >= 0.0)
-                {
-                  Vector v = Vector(p-p1);
-                  dist = Dot(v,v);
-                }
-                else
-                {
-                  Vector v1 = Vector(p1-p2);
-                  Vector v = Vector(p-p2)-v1*(Dot(Vector(p-p2),v1)/Dot(v1,v1));
-                  dist = Dot(v,v);
-                }
-
-                if (dist < mindist) { mindist = dist; edgeidx = r;}
-              }
-              objmesh->get_neighbor(fidx_n,fidx,delems[edgeidx]);
-              objmesh->get_nodes(nodes,fidx);
-              objmesh->get_center(n0,nodes[0]);
-              objmesh->get_center(n1,nodes[1]);
-              objmesh->get_center(n2,nodes[2]);
-              n = Cross(Vector(n1-n0),Vector(n2-n1));
-              k = Vector(p-p2);
-              k.normalize();
-              angle = Dot(n,k);
-              if (angle < 0) val = -(val);
-            }
-          }
 
-          ofield->set_value(val,idx);
+          ofield->set_value(signed_distance(p,val,p2,fidx,epsilon),idx);
           if (proc == 0) { cnt++; if (cnt == 100) { pr_->update_progress_max(idx,end); cnt = 0; } }
         }
       }
       else if (ofield->basis_order() == 1)
       {
-        VMesh::Elem::index_type fidx, fidx_n;
-        VMesh::Node::array_type nodes;
-        VMesh::DElem::array_type delems;
-
-        Vector n, k;
-        Point n0,n1,n2;
+        VMesh::Elem::index_type fidx;
         VMesh::index_type start, end;
         range(proc,nproc,start,end,num_values);
 
         for (VMesh::Node::index_type idx =start; idx <end; idx++)
         {
-
-          Point p, p1, p2;
+          Point p, p2;
           imesh->get_center(p,idx);
           objmesh->find_closest_elem(val,p2,fidx,p);
 
-          objmesh->get_nodes(nodes,fidx);
-          objmesh->get_center(n0,nodes[0]);
-          objmesh->get_center(n1,nodes[1]);
-          objmesh->get_center(n2,nodes[2]);
-          n = Cross(Vector(n1-n0),Vector(n2-n1));
-          k = Vector(p-p2);
-          k.normalize();
-          double angle = Dot(n,k);
-          if (angle < -epsilon)
-          {
-            val = -val;
-          }
-          else if (angle > epsilon)
-          {
-          }
-          else
-          {
-            // trouble
-            if (val != 0.0)
-            {
-               objmesh->get_delems(delems,fidx);
-               double mindist = DBL_MAX;
-               double dist;
-               int edgeidx = 0;
-               for (size_t r=0; r<delems.size();r++)
-               {
-                 objmesh->get_nodes(nodes,delems[r]);
-                 objmesh->get_center(p1,nodes[0]);
-                 objmesh->get_center(p2,nodes[1]);
-
-                if (Dot(Vector(p-p2),Vector(p2-p1)) >= 0.0)
-                {
-                  Vector v = Vector(p-p2);
-                  dist  = Dot(v,v);
-                }
-                else if (Dot(Vector(p-p1),Vector(p1-p2)) >= 0.0)
-                {
-                  Vector v = Vector(p-p1);
-                  dist = Dot(v,v);
-                }
-                else
-                {
-                  Vector v1 = Vector(p1-p2);
-                  Vector v = Vector(p-p2)-v1*(Dot(Vector(p-p2),v1)/Dot(v1,v1));
-                  dist = Dot(v,v);
-                }
-
-                if (dist < mindist) { mindist = dist; edgeidx = r;}
-              }
-              objmesh->get_neighbor(fidx_n,fidx,delems[edgeidx]);
-              objmesh->get_nodes(nodes,fidx);
-              objmesh->get_center(n0,nodes[0]);
-              objmesh->get_center(n1,nodes[1]);
-              objmesh->get_center(n2,nodes[2]);
-              n = Cross(Vector(n1-n0),Vector(n2-n1));
-              k = Vector(p-p2);
-              k.normalize();
-              angle = Dot(n,k);
-              if (angle < 0.0) val = -(val);
-            }
-          }
-
-          ofield->set_value(val,idx);
+          ofield->set_value(signed_distance(p,val,p2,fidx,epsilon),idx);
           if (proc == 0) { cnt++; if (cnt == 100) { pr_->update_progress_max(idx,end); cnt = 0; } }
         }
       }
       else if (ofield->basis_order() > 1)
       {
-        VMesh::Elem::index_type fidx, fidx_n;
-        VMesh::Node::array_type nodes;
-        VMesh::DElem::array_type delems;
-
-        Vector n, k;
-        Point n0,n1,n2;
+        VMesh::Elem::index_type fidx;
         VMesh::index_type start, end;
         range(proc,nproc,start,end,num_evalues);
 
         for (VMesh::ENode::index_type idx=start; idx < end; idx++)
         {
-
-          Point p, p1, p2;
+          Point p, p2;
           imesh->get_center(p,idx);
           objmesh->find_closest_elem(val,p2,fidx,p);
 
-          objmesh->get_nodes(nodes,fidx);
-          objmesh->get_center(n0,nodes[0]);
-          objmesh->get_center(n1,nodes[1]);
-          objmesh->get_center(n2,nodes[2]);
-          n = Cross(Vector(n1-n0),Vector(n2-n1));
-          k = Vector(p-p2);
-          k.normalize();
-          double angle = Dot(n,k);
-          if (angle < -epsilon)
-          {
-            val = -val;
-          }
-          else if (angle > epsilon)
-          {
-          }
-          else
-          {
-            // trouble
-            if (val != 0.0)
-            {
-               objmesh->get_delems(delems,fidx);
-               double mindist = DBL_MAX;
-               double dist;
-               int edgeidx = 0;
-               for (size_t r=0; r<delems.size();r++)
-               {
-                 objmesh->get_nodes(nodes,delems[r]);
-                 objmesh->get_center(p1,nodes[0]);
-                 objmesh->get_center(p2,nodes[1]);
+          ofield->set_evalue(signed_distance(p,val,p2,fidx,epsilon),idx);
+          if (proc == 0) { cnt++; if (cnt == 100) { pr_->update_progress_max(idx,end); cnt = 0; } }
+        }
+      }
+    }
 
-                if (Dot(Vector(p-p2),Vector(p2-p1)) >= 0.0)
-                {
-                  Vector v = Vector(p-p2);
-                  dist  = Dot(v,v);
-                }
-                else if (Dot(Vector(p-p1),Vector(p1-p2)) >= 0.0)
-                {
-                  Vector v = Vector(p-p1);
-                  dist = Dot(v,v);
-                }
-                else
-                {
-                  Vector v1 = Vector(p1-p2);
-                  Vector v = Vector(p-p2)-v1*(Dot(Vector(p-p2),v1)/Dot(v1,v1));
-                  dist = Dot(v,v);
-                }
+    // Output on a regular grid: the closest points come from the distance transform
+    void parallel_grid(int proc, int nproc, const GridDistanceTransform& grid)
+    {
+      VMesh::index_type start, end;
+      range(proc,nproc,start,end,grid.size());
 
-                if (dist < mindist) { mindist = dist; edgeidx = r;}
-              }
-              objmesh->get_neighbor(fidx_n,fidx,delems[edgeidx]);
-              objmesh->get_nodes(nodes,fidx);
-              objmesh->get_center(n0,nodes[0]);
-              objmesh->get_center(n1,nodes[1]);
-              objmesh->get_center(n2,nodes[2]);
-              n = Cross(Vector(n1-n0),Vector(n2-n1));
-              k = Vector(p-p2);
-              k.normalize();
-              angle = Dot(n,k);
-              if (angle < 0.0) val = -(val);
-            }
-          }
+      double val = 0.0;
+      double epsilon = objmesh->get_epsilon();
+      int cnt = 0;
+      VMesh::Elem::index_type fidx;
+      Point p2;
 
-          ofield->set_evalue(val,idx);
-          if (proc == 0) { cnt++; if (cnt == 100) { pr_->update_progress_max(idx,end); cnt = 0; } }
-        }
+      for (VMesh::index_type idx = start; idx < end; idx++)
+      {
+        if (grid.closest(idx,val,p2,fidx))
+          val = signed_distance(grid.position(idx),val,p2,fidx,epsilon);
+        else
+          val = DBL_MAX;
+
+        ofield->set_value(val,idx);
+        if (proc == 0) { cnt++; if (cnt == 1000) { pr_->update_progress_max(idx,end); cnt = 0; } }
       }
     }
 
@@ -638,6 +460,80 @@ class CalculateSignedDistanceFieldP : public Interruptible
     }
 
 
+    // Sign of the distance val from p to its closest point p2 on element fidx,
+    // from the side of the element normal p lies on
+    double signed_distance(const Point& p, double val, Point p2, VMesh::Elem::index_type fidx, double epsilon)
+    {
+      VMesh::Elem::index_type fidx_n;
+      VMesh::Node::array_type nodes;
+      VMesh::DElem::array_type delems;
+      Point n0,n1,n2,p1;
+
+      objmesh->get_nodes(nodes,fidx);
+      objmesh->get_center(n0,nodes[0]);
+      objmesh->get_center(n1,nodes[1]);
+      objmesh->get_center(n2,nodes[2]);
+
+      Vector n = Cross(Vector(n1-n0),Vector(n2-n1));
+      Vector k = Vector(p-p2); k.normalize();
+
+      double angle = Dot(n,k);
+      if (angle < -epsilon)
+      {
+        val = -val;
+      }
+      else if (angle > epsilon)
+      {
+      }
+      else
+      {
+        // trouble
+        if (val != 0.0)
+        {
+          objmesh->get_delems(delems,fidx);
+          double mindist = DBL_MAX;
+          double dist;
+          int edgeidx = 0;
+          for (size_t r=0; r<delems.size();r++)
+          {
+            objmesh->get_nodes(nodes,delems[r]);
+            objmesh->get_center(p1,nodes[0]);
+            objmesh->get_center(p2,nodes[1]);
+
+            if (Dot(Vector(p-p2),Vector(p2-p1)) >= 0.0)
+            {
+              Vector v = Vector(p-p2);
+              dist  = Dot(v,v);
+            }
+            else if (Dot(Vector(p-p1),Vector(p1-p2)) >= 0.0)
+            {
+              Vector v = Vector(p-p1);
+              dist = Dot(v,v);
+            }
+            else
+            {
+              Vector v1 = Vector(p1-p2);
+              Vector v = Vector(p-p2)-v1*(Dot(Vector(p-p2),v1)/Dot(v1,v1));
+              dist = Dot(v,v);
+            }
+
+            if (dist < mindist) { mindist = dist; edgeidx = r;}
+          }
+          objmesh->get_neighbor(fidx_n,fidx,delems[edgeidx]);
+          objmesh->get_nodes(nodes,fidx);
+          objmesh->get_center(n0,nodes[0]);
+          objmesh->get_center(n1,nodes[1]);
+          objmesh->get_center(n2,nodes[2]);
+          n = Cross(Vector(n1-n0),Vector(n2-n1));
+          k = Vector(p-p2);
+          k.normalize();
+          angle = Dot(n,k);
+          if (angle < 0.0) val = -(val);
+        }
+      }
+      return val;
+    }
+
     void range(int proc, int nproc,
                VMesh::index_type& start, VMesh::index_type& end,
                VMesh::size_type size)
@@ -661,6 +557,7 @@ class CalculateSignedDistanceFieldP : public Interruptible
 CalculateSignedDistanceFieldAlgo::CalculateSignedDistanceFieldAlgo()
 {
   addParameter(OutputValueField, false);
+  addParameter(Parameters::ApproximateOnGrid, false);
 }
 
 bool
@@ -721,6 +618,21 @@ CalculateSignedDistanceFieldAlgo::run(FieldHandle input, FieldHandle object, Fie
   objmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E|Mesh::EDGES_E);
   CalculateSignedDistanceFieldP palgo(imesh, objmesh, ofield, this);
   const int numThreads = Parallel::NumCores();
+
+  // On LatVol and Image meshes only a band around the object needs a closest element search,
+  // at the price of small errors further away, so this has to be asked for
+  if (get(Parameters::ApproximateOnGrid).toBool())
+  {
+    GridDistanceTransform grid(imesh, ofield->basis_order(), objmesh, this);
+    if (grid.applies())
+    {
+      grid.run(DBL_MAX);
+      auto task_g = [&palgo,&grid,numThreads](int i) { palgo.parallel_grid(i, numThreads, grid); };
+      Parallel::RunTasks(task_g, numThreads);
+      return (true);
+    }
+  }
+
   auto task_i = [&palgo,numThreads](int i) { palgo.parallel(i, numThreads); };
   Parallel::RunTasks(task_i, numThreads);
 
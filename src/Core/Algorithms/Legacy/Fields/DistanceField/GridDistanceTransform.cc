@@ -0,0 +1,663 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Core/Algorithms/Legacy/Fields/DistanceField/GridDistanceTransform.h>
+#include <Core/GeometryPrimitives/CompGeom.h>
+#include <Core/Thread/Parallel.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Utility;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+using namespace SCIRun::Core::Algorithms::Fields;
+
+namespace
+{
+  void range(int proc, int nproc, VMesh::index_type& start, VMesh::index_type& end, VMesh::size_type size)
+  {
+    VMesh::size_type m = size/nproc;
+    start = proc*m;
+    end = (proc+1)*m;
+    if (proc == nproc-1) end = size;
+  }
+}
+
+GridDistanceTransform::GridDistanceTransform(VMesh* grid, int basisOrder, VMesh* objmesh, const ProgressReporter* pr) :
+  objmesh_(objmesh), pr_(pr), applies_(false), maxdist_(DBL_MAX), size_(0), slabAxis_(0), nodesPerElem_(0)
+{
+  for (int a = 0; a < 3; a++)
+  {
+    axis_[a] = Vector(0.0, 0.0, 0.0);
+    spacing_[a] = 0.0;
+    dims_[a] = 1;
+  }
+
+  if (!grid->is_regularmesh() || !grid->is_structuredmesh() || (basisOrder != 0 && basisOrder != 1))
+    return;
+
+  VMesh::dimension_type dims;
+  if (basisOrder == 0) grid->get_elem_dimensions(dims);
+  else grid->get_dimensions(dims);
+  if (dims.empty() || dims.size() > 3)
+    return;
+
+  size_ = 1;
+  for (size_t a = 0; a < dims.size(); a++)
+  {
+    dims_[a] = dims[a];
+    size_ *= dims[a];
+  }
+  // band slots are stored in 32 bits
+  if (size_ == 0 || size_ >= static_cast<VMesh::size_type>(CANDIDATE))
+    return;
+
+  auto center = [grid, basisOrder](VMesh::index_type idx)
+  {
+    Point p;
+    if (basisOrder == 0) grid->get_center(p, VMesh::Elem::index_type(idx));
+    else grid->get_center(p, VMesh::Node::index_type(idx));
+    return p;
+  };
+
+  origin_ = center(0);
+  VMesh::index_type stride = 1;
+  double scale = 0.0;
+  int numAxes = 0;
+  for (int a = 0; a < 3; a++)
+  {
+    if (dims_[a] > 1)
+    {
+      axis_[a] = center(stride) - origin_;
+      spacing_[a] = axis_[a].length();
+      scale = std::max(scale, spacing_[a]);
+      numAxes++;
+    }
+    stride *= dims_[a];
+  }
+  if (numAxes < 2 || scale == 0.0)
+    return;
+  slabAxis_ = dims_[2] > 1 ? 2 : 1;
+
+  // The transform is separable along orthogonal axes only
+  for (int a = 0; a < 3; a++)
+  {
+    if (dims_[a] == 1) continue;
+    if (spacing_[a] < 1e-12*scale) return;
+    for (int b = a+1; b < 3; b++)
+    {
+      if (dims_[b] > 1 && std::fabs(Dot(axis_[a], axis_[b])) > 1e-6*spacing_[a]*spacing_[b])
+        return;
+    }
+  }
+
+  // Check the indexing of the values against the mesh
+  if ((center(size_-1) - position(size_-1)).length() > 1e-6*scale)
+    return;
+
+  // Every point of the object needs to lie within a band width of a value: inside the
+  // grid up to half a cell, and close to the plane of a two dimensional grid
+  BBox box = objmesh->get_bounding_box();
+  if (!box.valid())
+    return;
+
+  Vector normal(0.0, 0.0, 0.0);
+  double minSpacing = DBL_MAX;
+  for (int a = 0; a < 3; a++)
+    if (dims_[a] > 1) minSpacing = std::min(minSpacing, spacing_[a]);
+  if (numAxes == 2)
+  {
+    if (dims_[0] == 1) normal = Cross(axis_[1], axis_[2]);
+    else if (dims_[1] == 1) normal = Cross(axis_[0], axis_[2]);
+    else normal = Cross(axis_[0], axis_[1]);
+    normal.safe_normalize();
+  }
+
+  for (int c = 0; c < 8; c++)
+  {
+    const Point corner((c & 1) ? box.get_max().x() : box.get_min().x(),
+                       (c & 2) ? box.get_max().y() : box.get_min().y(),
+                       (c & 4) ? box.get_max().z() : box.get_min().z());
+    const Vector v = corner - origin_;
+    for (int a = 0; a < 3; a++)
+    {
+      if (dims_[a] == 1) continue;
+      const double u = Dot(v, axis_[a]) / (spacing_[a]*spacing_[a]);
+      if (u < -0.5 || u > dims_[a] - 0.5) return;
+    }
+    if (numAxes == 2 && std::fabs(Dot(v, normal)) > 0.5*minSpacing)
+      return;
+  }
+
+  applies_ = true;
+}
+
+Point
+GridDistanceTransform::position(VMesh::index_type idx) const
+{
+  VMesh::index_type c[3];
+  coordinates(idx, c);
+  return origin_ + axis_[0]*static_cast<double>(c[0]) + axis_[1]*static_cast<double>(c[1]) +
+    axis_[2]*static_cast<double>(c[2]);
+}
+
+void
+GridDistanceTransform::coordinates(VMesh::index_type idx, VMesh::index_type c[3]) const
+{
+  c[0] = idx % dims_[0];
+  idx /= dims_[0];
+  c[1] = idx % dims_[1];
+  c[2] = idx / dims_[1];
+}
+
+void
+GridDistanceTransform::run(double maxdist)
+{
+  maxdist_ = maxdist;
+
+  // A cell diagonal, as the object may stick out of the grid by half a cell, and
+  // out of the plane of a two dimensional grid by half of the smallest spacing
+  double band = 0.0;
+  double minSpacing = DBL_MAX;
+  int numAxes = 0;
+  for (int a = 0; a < 3; a++)
+  {
+    if (dims_[a] == 1) continue;
+    band += spacing_[a]*spacing_[a];
+    minSpacing = std::min(minSpacing, spacing_[a]);
+    numAxes++;
+  }
+  if (numAxes == 2) band += 0.25*minSpacing*minSpacing;
+  band = std::min(1.01*std::sqrt(band), maxdist);
+
+  cache_elements();
+  feature_.assign(size_, NONE);
+  seedIndex_.clear();
+  seedPoint_.clear();
+  seedElem_.clear();
+  seedDist_.clear();
+
+  const int nproc = Parallel::NumCores();
+  if (nodesPerElem_ > 0)
+  {
+    // Every thread rasterizes the elements into its own slab of the grid
+    bands_.assign(nproc, Band());
+    Parallel::RunTasks([this, nproc, band](int proc) { rasterize_band(proc, nproc, band); }, nproc);
+
+    std::vector<size_t> offsets(nproc+1, 0);
+    for (int proc = 0; proc < nproc; proc++)
+      offsets[proc+1] = offsets[proc] + bands_[proc].index.size();
+
+    seedIndex_.resize(offsets[nproc]);
+    seedPoint_.resize(offsets[nproc]);
+    seedElem_.resize(offsets[nproc]);
+    seedDist_.resize(offsets[nproc]);
+
+    Parallel::RunTasks([this, &offsets](int proc)
+    {
+      const Band& band = bands_[proc];
+      for (size_t i = 0; i < band.index.size(); i++)
+      {
+        const size_t slot = offsets[proc] + i;
+        feature_[band.index[i]] = static_cast<uint32_t>(slot);
+        seedIndex_[slot] = band.index[i];
+        seedPoint_[slot] = band.point[i];
+        seedElem_[slot] = band.elem[i];
+        seedDist_[slot] = std::sqrt(band.dist2[i]);
+      }
+    }, nproc);
+    bands_.clear();
+  }
+  else
+  {
+    mark_band(band);
+
+    std::vector<VMesh::index_type> candidates;
+    for (VMesh::index_type idx = 0; idx < size_; idx++)
+    {
+      if (feature_[idx] == CANDIDATE)
+        candidates.push_back(idx);
+    }
+
+    std::vector<double> dist(candidates.size());
+    seedPoint_.resize(candidates.size());
+    seedElem_.resize(candidates.size());
+
+    Parallel::RunTasks([&](int proc) { search_band(proc, nproc, candidates, band, dist); }, nproc);
+
+    // Band values that have a closest point within the band width become the seeds
+    size_t numSeeds = 0;
+    for (size_t i = 0; i < candidates.size(); i++)
+    {
+      if (dist[i] < 0.0)
+      {
+        feature_[candidates[i]] = NONE;
+        continue;
+      }
+      feature_[candidates[i]] = static_cast<uint32_t>(numSeeds);
+      seedIndex_.push_back(candidates[i]);
+      seedDist_.push_back(dist[i]);
+      seedPoint_[numSeeds] = seedPoint_[i];
+      seedElem_[numSeeds] = seedElem_[i];
+      numSeeds++;
+    }
+    seedPoint_.resize(numSeeds);
+    seedElem_.resize(numSeeds);
+  }
+
+  // All values outside the band are further away than maxdist
+  if (seedIndex_.empty() || band >= maxdist)
+    return;
+
+  for (int a = 0; a < 3; a++)
+  {
+    if (dims_[a] == 1) continue;
+    Parallel::RunTasks([this, nproc, a](int proc) { transform_axis(proc, nproc, a); }, nproc);
+  }
+}
+
+void
+GridDistanceTransform::cache_elements()
+{
+  nodesPerElem_ = 0;
+  elemNodes_.clear();
+  neighborOffsets_.clear();
+  neighbors_.clear();
+
+  int n = 0;
+  if (objmesh_->is_linearmesh())
+  {
+    if (objmesh_->is_trisurfmesh()) n = 3;
+    else if (objmesh_->is_curvemesh()) n = 2;
+    else if (objmesh_->is_pointcloudmesh()) n = 1;
+  }
+  if (n == 0)
+    return;
+
+  VMesh::size_type num_elems = objmesh_->num_elems();
+  VMesh::Node::array_type nodes;
+  elemNodes_.resize(num_elems*n);
+  for (VMesh::Elem::index_type e = 0; e < num_elems; ++e)
+  {
+    objmesh_->get_nodes(nodes, e);
+    if (static_cast<int>(nodes.size()) != n)
+    {
+      elemNodes_.clear();
+      return;
+    }
+    for (int k = 0; k < n; k++)
+      objmesh_->get_center(elemNodes_[e*n+k], nodes[k]);
+  }
+
+  if (n == 3)
+  {
+    objmesh_->synchronize(Mesh::ELEM_NEIGHBORS_E);
+    VMesh::Elem::array_type elems;
+    neighborOffsets_.reserve(num_elems+1);
+    neighborOffsets_.push_back(0);
+    for (VMesh::Elem::index_type e = 0; e < num_elems; ++e)
+    {
+      objmesh_->get_neighbors(elems, e);
+      neighbors_.insert(neighbors_.end(), elems.begin(), elems.end());
+      neighborOffsets_.push_back(neighbors_.size());
+    }
+  }
+
+  nodesPerElem_ = n;
+}
+
+void
+GridDistanceTransform::project(const Point& p, VMesh::Elem::index_type elem, Point& result) const
+{
+  const Point* nodes = &elemNodes_[elem*nodesPerElem_];
+  if (nodesPerElem_ == 3) closest_point_on_tri(result, p, nodes[0], nodes[1], nodes[2]);
+  else if (nodesPerElem_ == 2) distance_to_line2_aux(result, p, nodes[0], nodes[1]);
+  else result = nodes[0];
+}
+
+bool
+GridDistanceTransform::index_range(const BBox& box, VMesh::index_type first[3], VMesh::index_type last[3]) const
+{
+  const Point& lo = box.get_min();
+  const Point& hi = box.get_max();
+  for (int a = 0; a < 3; a++)
+  {
+    first[a] = last[a] = 0;
+    if (dims_[a] == 1) continue;
+
+    double umin = DBL_MAX, umax = -DBL_MAX;
+    for (int c = 0; c < 8; c++)
+    {
+      const Point corner((c & 1) ? hi.x() : lo.x(), (c & 2) ? hi.y() : lo.y(), (c & 4) ? hi.z() : lo.z());
+      const double u = Dot(corner - origin_, axis_[a]) / (spacing_[a]*spacing_[a]);
+      umin = std::min(umin, u);
+      umax = std::max(umax, u);
+    }
+    if (umax < 0.0 || umin > static_cast<double>(dims_[a]-1))
+      return false;
+    first[a] = std::max(static_cast<VMesh::index_type>(std::ceil(umin)), static_cast<VMesh::index_type>(0));
+    last[a] = std::min(static_cast<VMesh::index_type>(std::floor(umax)), dims_[a]-1);
+    if (first[a] > last[a])
+      return false;
+  }
+  return true;
+}
+
+void
+GridDistanceTransform::rasterize_band(int proc, int nproc, double band)
+{
+  VMesh::index_type slabStart, slabEnd;
+  range(proc, nproc, slabStart, slabEnd, dims_[slabAxis_]);
+  if (slabStart >= slabEnd)
+    return;
+
+  Band& out = bands_[proc];
+  const double band2 = band*band;
+  const Vector inflate(band, band, band);
+  const VMesh::size_type num_elems = elemNodes_.size()/nodesPerElem_;
+  int cnt = 0;
+
+  for (VMesh::Elem::index_type e = 0; e < num_elems; ++e)
+  {
+    BBox box;
+    for (int k = 0; k < nodesPerElem_; k++)
+      box.extend(elemNodes_[e*nodesPerElem_+k]);
+    box.extend(box.get_min() - inflate);
+    box.extend(box.get_max() + inflate);
+
+    VMesh::index_type first[3], last[3];
+    if (!index_range(box, first, last))
+      continue;
+    first[slabAxis_] = std::max(first[slabAxis_], slabStart);
+    last[slabAxis_] = std::min(last[slabAxis_], slabEnd-1);
+    if (first[slabAxis_] > last[slabAxis_])
+      continue;
+
+    for (VMesh::index_type k = first[2]; k <= last[2]; k++)
+      for (VMesh::index_type j = first[1]; j <= last[1]; j++)
+      {
+        const Point row = origin_ + axis_[1]*static_cast<double>(j) + axis_[2]*static_cast<double>(k);
+        for (VMesh::index_type i = first[0]; i <= last[0]; i++)
+        {
+          const Point p = row + axis_[0]*static_cast<double>(i);
+          Point result;
+          project(p, e, result);
+          const double d2 = (p - result).length2();
+          if (d2 > band2) continue;
+
+          const VMesh::index_type idx = (k*dims_[1] + j)*dims_[0] + i;
+          const uint32_t slot = feature_[idx];
+          if (slot == NONE)
+          {
+            feature_[idx] = static_cast<uint32_t>(out.index.size());
+            out.index.push_back(idx);
+            out.point.push_back(result);
+            out.elem.push_back(e);
+            out.dist2.push_back(d2);
+          }
+          else if (d2 < out.dist2[slot])
+          {
+            out.point[slot] = result;
+            out.elem[slot] = e;
+            out.dist2[slot] = d2;
+          }
+        }
+      }
+
+    if (proc == 0 && pr_) { cnt++; if (cnt == 1000) { pr_->update_progress_max(e, num_elems); cnt = 0; } }
+  }
+}
+
+void
+GridDistanceTransform::mark_band(double band)
+{
+  VMesh::Node::array_type nodes;
+  VMesh::size_type num_elems = objmesh_->num_elems();
+  const Vector inflate(band, band, band);
+
+  for (VMesh::Elem::index_type e = 0; e < num_elems; ++e)
+  {
+    objmesh_->get_nodes(nodes, e);
+    BBox box;
+    for (size_t k = 0; k < nodes.size(); k++)
+    {
+      Point p;
+      objmesh_->get_center(p, nodes[k]);
+      box.extend(p);
+    }
+    if (!box.valid()) continue;
+    box.extend(box.get_min() - inflate);
+    box.extend(box.get_max() + inflate);
+
+    VMesh::index_type first[3], last[3];
+    if (!index_range(box, first, last))
+      continue;
+
+    for (VMesh::index_type k = first[2]; k <= last[2]; k++)
+      for (VMesh::index_type j = first[1]; j <= last[1]; j++)
+      {
+        const VMesh::index_type row = (k*dims_[1] + j)*dims_[0];
+        std::fill(feature_.begin() + row + first[0], feature_.begin() + row + last[0] + 1, CANDIDATE);
+      }
+  }
+}
+
+void
+GridDistanceTransform::search_band(int proc, int nproc, const std::vector<VMesh::index_type>& candidates,
+                                   double band, std::vector<double>& dist)
+{
+  VMesh::index_type start, end;
+  range(proc, nproc, start, end, candidates.size());
+
+  int cnt = 0;
+  double d;
+  Point result;
+  VMesh::Elem::index_type elem;
+  for (VMesh::index_type i = start; i < end; i++)
+  {
+    if (objmesh_->find_closest_elem(d, result, elem, position(candidates[i]), band))
+    {
+      dist[i] = d;
+      seedPoint_[i] = result;
+      seedElem_[i] = elem;
+    }
+    else
+    {
+      dist[i] = -1.0;
+    }
+
+    if (proc == 0 && pr_) { cnt++; if (cnt == 1000) { pr_->update_progress_max(i, end); cnt = 0; } }
+  }
+}
+
+// Feature transform along one axis: every value gets the seed that is nearest in the
+// axes done so far (Felzenszwalb and Huttenlocher, Distance Transforms of Sampled Functions)
+void
+GridDistanceTransform::transform_axis(int proc, int nproc, int axis)
+{
+  const VMesh::index_type n = dims_[axis];
+  VMesh::index_type stride = 1;
+  for (int a = 0; a < axis; a++) stride *= dims_[a];
+  const VMesh::size_type numLines = size_/n;
+
+  VMesh::index_type start, end;
+  range(proc, nproc, start, end, numLines);
+
+  std::vector<uint32_t> slots(n);
+  std::vector<double> g(n);
+  std::vector<VMesh::index_type> v(n);
+  std::vector<double> z(n+1);
+  const double h2 = spacing_[axis]*spacing_[axis];
+
+  for (VMesh::index_type line = start; line < end; line++)
+  {
+    const VMesh::index_type base = (line % stride) + (line / stride)*stride*n;
+    VMesh::index_type c[3];
+    coordinates(base, c);
+
+    // squared distance to the current seed in the axes done so far, in units of this axis
+    bool any = false;
+    for (VMesh::index_type q = 0; q < n; q++)
+    {
+      slots[q] = feature_[base + q*stride];
+      if (slots[q] == NONE) continue;
+      any = true;
+
+      VMesh::index_type s[3];
+      coordinates(seedIndex_[slots[q]], s);
+      double d = 0.0;
+      for (int a = 0; a < axis; a++)
+      {
+        const double da = static_cast<double>(c[a] - s[a])*spacing_[a];
+        d += da*da;
+      }
+      g[q] = d/h2;
+    }
+    if (!any) continue;
+
+    // lower envelope of the parabolas of all seeded values
+    VMesh::index_type k = -1;
+    for (VMesh::index_type q = 0; q < n; q++)
+    {
+      if (slots[q] == NONE) continue;
+      const double fq = g[q] + static_cast<double>(q*q);
+      double s = -DBL_MAX;
+      while (k >= 0)
+      {
+        const VMesh::index_type p = v[k];
+        s = (fq - (g[p] + static_cast<double>(p*p))) / (2.0*static_cast<double>(q - p));
+        if (s > z[k]) break;
+        k--;
+      }
+      if (k < 0) s = -DBL_MAX;
+      k++;
+      v[k] = q;
+      z[k] = s;
+      z[k+1] = DBL_MAX;
+    }
+
+    k = 0;
+    for (VMesh::index_type q = 0; q < n; q++)
+    {
+      while (z[k+1] < static_cast<double>(q)) k++;
+      feature_[base + q*stride] = slots[v[k]];
+    }
+  }
+}
+
+bool
+GridDistanceTransform::closest(VMesh::index_type idx, double& dist, Point& result,
+                               VMesh::Elem::index_type& elem) const
+{
+  const uint32_t own = feature_[idx];
+  if (own != NONE && seedIndex_[own] == idx)
+  {
+    dist = seedDist_[own];
+    result = seedPoint_[own];
+    elem = seedElem_[own];
+    return true;
+  }
+
+  // The nearest seed does not necessarily have the nearest closest point, the
+  // seeds of the neighbors are tried as well
+  const Point p = position(idx);
+  VMesh::index_type c[3];
+  coordinates(idx, c);
+
+  double bestDist2 = DBL_MAX;
+  Point bestPoint;
+  VMesh::Elem::index_type bestElem = -1;
+
+  // neighboring values mostly share their seeds and elements
+  VMesh::Elem::index_type tried[7];
+  int numTried = 0;
+  auto consider = [&](uint32_t slot)
+  {
+    if (slot == NONE) return;
+    if (nodesPerElem_ > 0)
+    {
+      if (std::find(tried, tried + numTried, seedElem_[slot]) != tried + numTried) return;
+      tried[numTried++] = seedElem_[slot];
+    }
+    Point q = seedPoint_[slot];
+    if (nodesPerElem_ > 0)
+      project(p, seedElem_[slot], q);
+    const double d2 = (p - q).length2();
+    if (d2 < bestDist2)
+    {
+      bestDist2 = d2;
+      bestPoint = q;
+      bestElem = seedElem_[slot];
+    }
+  };
+
+  consider(own);
+  VMesh::index_type stride = 1;
+  for (int a = 0; a < 3; a++)
+  {
+    if (c[a] > 0) consider(feature_[idx - stride]);
+    if (c[a] < dims_[a]-1) consider(feature_[idx + stride]);
+    stride *= dims_[a];
+  }
+
+  if (bestElem < 0)
+    return false;
+
+  // Walk over the surface while neighboring triangles are closer
+  if (!neighbors_.empty())
+  {
+    for (int step = 0; step < 16; step++)
+    {
+      const VMesh::Elem::index_type from = bestElem;
+      for (VMesh::index_type n = neighborOffsets_[from]; n < neighborOffsets_[from+1]; n++)
+      {
+        Point q;
+        project(p, neighbors_[n], q);
+        const double d2 = (p - q).length2();
+        if (d2 < bestDist2)
+        {
+          bestDist2 = d2;
+          bestPoint = q;
+          bestElem = neighbors_[n];
+        }
+      }
+      if (bestElem == from) break;
+    }
+  }
+
+  dist = std::sqrt(bestDist2);
+  if (dist > maxdist_)
+    return false;
+
+  result = bestPoint;
+  elem = bestElem;
+  return true;
+}
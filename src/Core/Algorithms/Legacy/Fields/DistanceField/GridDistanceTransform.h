@@ -0,0 +1,139 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_ALGORITHMS_FIELDS_DISTANCEFIELD_GRIDDISTANCETRANSFORM_H
+#define CORE_ALGORITHMS_FIELDS_DISTANCEFIELD_GRIDDISTANCETRANSFORM_H 1
+
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Utils/ProgressReporter.h>
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/GeometryPrimitives/Vector.h>
+#include <Core/GeometryPrimitives/BBox.h>
+#include <Core/Algorithms/Legacy/Fields/share.h>
+#include <cstdint>
+#include <vector>
+
+namespace SCIRun {
+  namespace Core {
+    namespace Algorithms {
+      namespace Fields {
+
+        /// Closest points on an object mesh for all values of a field on a regular
+        /// grid (LatVol, Image or Scanline mesh).
+        /// Values within a narrow band around the object get their exact closest
+        /// point: triangles, line segments and points are rasterized into the band,
+        /// other elements are searched with find_closest_elem. All other values are
+        /// filled in by a separable exact Euclidean feature transform of the band
+        /// (Felzenszwalb and Huttenlocher), which gives the nearest band value. Its
+        /// element, and those of the nearest band values of the neighbors, are
+        /// projected on; for linear surfaces and curves the result is improved further
+        /// by moving to neighboring elements while they are closer.
+        /// This is not exact: near the medial axis the nearest band value can belong to
+        /// the wrong part of the object, which costs up to a fifth of a cell and can flip
+        /// the sign of a signed distance. The distance algorithms only use it when their
+        /// ApproximateOnGrid parameter is set.
+        class SCISHARE GridDistanceTransform
+        {
+        public:
+          GridDistanceTransform(VMesh* grid, int basisOrder, VMesh* objmesh, const Utility::ProgressReporter* pr);
+
+          /// Whether the grid is regular and orthogonal and contains the object. Otherwise
+          /// the band would not give the closest points for all values and every value
+          /// needs its own search.
+          bool applies() const { return applies_; }
+
+          /// Finds the band and propagates its closest points, up to maxdist.
+          /// Needs a FIND_CLOSEST_ELEM_E synchronized object mesh.
+          void run(double maxdist);
+
+          /// Closest point for value idx, returns false if it is further away than maxdist
+          bool closest(VMesh::index_type idx, double& dist, Geometry::Point& result,
+                       VMesh::Elem::index_type& elem) const;
+
+          /// Location of value idx
+          Geometry::Point position(VMesh::index_type idx) const;
+
+          VMesh::size_type size() const { return size_; }
+
+        private:
+          void cache_elements();
+          void project(const Geometry::Point& p, VMesh::Elem::index_type elem, Geometry::Point& result) const;
+          void rasterize_band(int proc, int nproc, double band);
+          void mark_band(double band);
+          void search_band(int proc, int nproc, const std::vector<VMesh::index_type>& candidates,
+                           double band, std::vector<double>& dist);
+          void transform_axis(int proc, int nproc, int axis);
+          void coordinates(VMesh::index_type idx, VMesh::index_type c[3]) const;
+          bool index_range(const Geometry::BBox& box, VMesh::index_type first[3], VMesh::index_type last[3]) const;
+
+          static constexpr uint32_t NONE = 0xFFFFFFFF;
+          static constexpr uint32_t CANDIDATE = 0xFFFFFFFE;
+
+          VMesh* objmesh_;
+          const Utility::ProgressReporter* pr_;
+          bool applies_;
+          double maxdist_;
+
+          // Grid of values: value (i,j,k) lies at origin_ + i*axis_[0] + j*axis_[1] + k*axis_[2]
+          Geometry::Point origin_;
+          Geometry::Vector axis_[3];
+          double spacing_[3];
+          VMesh::index_type dims_[3];
+          VMesh::size_type size_;
+          int slabAxis_;
+
+          // Node locations of linear triangles, line segments or points, and the
+          // neighbors of every element
+          int nodesPerElem_;
+          std::vector<Geometry::Point> elemNodes_;
+          std::vector<VMesh::index_type> neighborOffsets_;
+          std::vector<VMesh::Elem::index_type> neighbors_;
+
+          // Band slot of the nearest band value of every value
+          std::vector<uint32_t> feature_;
+
+          // Band values with their closest point on the object
+          std::vector<VMesh::index_type> seedIndex_;
+          std::vector<Geometry::Point> seedPoint_;
+          std::vector<VMesh::Elem::index_type> seedElem_;
+          std::vector<double> seedDist_;
+
+          // Band values found by each thread while rasterizing
+          struct Band
+          {
+            std::vector<VMesh::index_type> index;
+            std::vector<Geometry::Point> point;
+            std::vector<VMesh::Elem::index_type> elem;
+            std::vector<double> dist2;
+          };
+          std::vector<Band> bands_;
+        };
+
+      }}}}
+
+#endif
@@ -27,6 +27,7 @@
 
 
 #include <Core/Algorithms/Legacy/Fields/Mapping/BuildMappingMatrixAlgo.h>
+#include <Core/Algorithms/Legacy/Fields/Mapping/LocateClosestElems.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Thread/Parallel.h>
@@ -432,15 +433,12 @@ namespace detail
     }
     else if (dfield_->basis_order() == 0 && sfield_->basis_order() == 1)
     {
-      Point p, r;
-      VMesh::coords_type coords;
-      VMesh::Elem::index_type didx;
       VMesh::ElemInterpolate interp;
-      for (VMesh::Elem::index_type idx=start; idx<end;idx++)
+      locateClosestElems<VMesh::Elem::index_type>(smesh_,dmesh_,start,end,
+        [&](VMesh::Elem::index_type idx, bool found, VMesh::Elem::index_type didx,
+            const VMesh::coords_type& coords, double dist)
       {
-        dmesh_->get_center(p,idx);
-        double dist;
-        if(smesh_->find_closest_elem(dist,r,coords,didx,p))
+        if (found)
         {
           if (maxdist_ < 0.0 || dist < maxdist_)
           {
@@ -461,19 +459,16 @@ namespace detail
           }
         }
         if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
+      });
     }
     else if (dfield_->basis_order() == 1 && sfield_->basis_order() == 1)
     {
-      Point p, r;
-      VMesh::coords_type coords;
-      VMesh::Elem::index_type didx;
       VMesh::ElemInterpolate interp;
-      for (VMesh::Node::index_type idx=start; idx<end;idx++)
+      locateClosestElems<VMesh::Node::index_type>(smesh_,dmesh_,start,end,
+        [&](VMesh::Node::index_type idx, bool found, VMesh::Elem::index_type didx,
+            const VMesh::coords_type& coords, double dist)
       {
-        dmesh_->get_center(p,idx);
-        double dist;
-        if(smesh_->find_closest_elem(dist,r,coords,didx,p))
+        if (found)
         {
           if (maxdist_ < 0.0 || dist < maxdist_)
           {
@@ -494,7 +489,7 @@ namespace detail
           }
         }
         if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
+      });
     }
 
     barrier_.wait();
@@ -590,7 +585,8 @@ bool BuildMappingMatrixAlgo::runImpl(FieldHandle source, FieldHandle destination
     n = sfield->num_values();
     if (smesh->num_elems() > 0)
     {
-      smesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E);
+      if (smesh->is_volume()) smesh->synchronize(Mesh::ELEM_LOCATE_E|Mesh::FIND_CLOSEST_ELEM_E);
+      else smesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E);
       VMesh::coords_type cs; cs[0] =0.0; cs[1] = 0.0; cs[2] = 0.0;
       VMesh::ElemInterpolate ei;
       smesh->get_interpolate_weights(cs,0,ei,sbasis_order);
@@ -0,0 +1,104 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_ALGORTIHMS_FIELDS_MAPPING_LOCATE_CLOSEST_ELEMS_H__
+#define CORE_ALGORTIHMS_FIELDS_MAPPING_LOCATE_CLOSEST_ELEMS_H__
+
+#include <algorithm>
+#include <vector>
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+
+namespace SCIRun {
+  namespace Core {
+    namespace Algorithms {
+      namespace Fields {
+
+/// Find for the centers of the destination nodes or elements start..end the
+/// closest element in the source mesh. For a volume source the centers are
+/// located in blocks with locate_many and only the points that are outside
+/// the source mesh are searched for one by one with find_closest_elem. Points
+/// hardly ever lie exactly on a surface or curve, so these are searched for
+/// directly. For every destination index callback(idx,found,elem,coords,dist)
+/// is called in order, points inside the source have a distance of zero.
+/// A volume source needs ELEM_LOCATE_E and FIND_CLOSEST_ELEM_E synchronized,
+/// other sources only FIND_CLOSEST_ELEM_E.
+template <class INDEX, class CALLBACK>
+void locateClosestElems(VMesh* smesh, const VMesh* dmesh,
+                        VMesh::index_type start, VMesh::index_type end,
+                        CALLBACK callback)
+{
+  if (!smesh->is_volume())
+  {
+    Geometry::Point p, r;
+    VMesh::Elem::index_type elem;
+    VMesh::coords_type coords;
+    for (VMesh::index_type idx=start; idx<end; idx++)
+    {
+      double dist;
+      dmesh->get_center(p,INDEX(idx));
+      bool found = smesh->find_closest_elem(dist,r,coords,elem,p);
+      callback(INDEX(idx),found,elem,coords,dist);
+    }
+    return;
+  }
+
+  const VMesh::size_type blocksize = 4096;
+
+  std::vector<Geometry::Point> points;
+  std::vector<VMesh::Elem::index_type> elems;
+  std::vector<VMesh::coords_type> coords;
+
+  for (VMesh::index_type bstart=start; bstart<end; bstart+=blocksize)
+  {
+    VMesh::index_type bend = std::min(bstart+blocksize,end);
+    points.resize(bend-bstart);
+    for (VMesh::index_type idx=bstart; idx<bend; idx++)
+      dmesh->get_center(points[idx-bstart],INDEX(idx));
+
+    smesh->locate_many(points,elems,coords);
+
+    for (VMesh::index_type idx=bstart; idx<bend; idx++)
+    {
+      const size_t k = idx-bstart;
+      double dist = 0.0;
+      bool found = true;
+      if (elems[k] < 0)
+      {
+        Geometry::Point r;
+        found = smesh->find_closest_elem(dist,r,coords[k],elems[k],points[k]);
+      }
+      callback(INDEX(idx),found,elems[k],coords[k],dist);
+    }
+  }
+}
+
+}}}}
+
+#endif
@@ -80,10 +80,46 @@ class MapFieldDataOntoNodesPAlgo : public Interruptible
     std::vector<bool> success_;
 
   private:
+    void getCenters(VMesh* omesh, VMesh::index_type start,
+      VMesh::index_type end, std::vector<Core::Geometry::Point>& points) const;
+
+    template <class DATA>
+    void mapBlocks(MappingDataSourceHandle& datasource, VMesh* omesh,
+      VField* ofield, VMesh::index_type start, VMesh::index_type end,
+      VMesh::size_type blocksize, int proc,
+      std::vector<Core::Geometry::Point>& points, std::vector<DATA>& vals) const;
+
     Barrier barrier_;
     unsigned int nproc;
 };
 
+void
+MapFieldDataOntoNodesPAlgo::getCenters(VMesh* omesh, VMesh::index_type start,
+  VMesh::index_type end, std::vector<Point>& points) const
+{
+  points.resize(end-start);
+  for (VMesh::Node::index_type idx=start; idx<end; idx++)
+    omesh->get_center(points[idx-start],idx);
+}
+
+template <class DATA>
+void
+MapFieldDataOntoNodesPAlgo::mapBlocks(MappingDataSourceHandle& datasource,
+  VMesh* omesh, VField* ofield, VMesh::index_type start,
+  VMesh::index_type end, VMesh::size_type blocksize, int proc,
+  std::vector<Point>& points, std::vector<DATA>& vals) const
+{
+  for (VMesh::index_type bstart=start; bstart<end; bstart+=blocksize)
+  {
+    VMesh::index_type bend = std::min(bstart+blocksize,end);
+    getCenters(omesh,bstart,bend,points);
+    datasource->get_data(vals,points);
+    for (VMesh::Node::index_type idx=bstart; idx<bend; idx++)
+      ofield->set_value(vals[idx-bstart],idx);
+    if (proc == 0) algo_->update_progress_max(bend-start,end-start);
+  }
+}
+
 void
 MapFieldDataOntoNodesPAlgo::parallel(int proc)
 {
@@ -116,18 +152,26 @@ MapFieldDataOntoNodesPAlgo::parallel(int proc)
   VField::index_type      end = localsize*(proc+1);
   if (proc == nproc-1) end = num_nodes;
 
-  int cnt = 0;
+  // The nodes are mapped in blocks, so that the data source can locate a
+  // whole block of points in one batched search instead of one at a time.
+  const VMesh::size_type blocksize = 4096;
+  std::vector<Point> points;
+
   if (is_flux_)
   {
     // To compute flux through a surface
-    Point p; Vector val; Vector norm;
-    for (VMesh::Node::index_type idx=start; idx<end; idx++)
+    std::vector<Vector> vals; Vector norm;
+    for (VMesh::index_type bstart=start; bstart<end; bstart+=blocksize)
     {
-      omesh->get_center(p,idx);
-      omesh->get_normal(norm,idx);
-      datasource->get_data(val,p);
-      ofield->set_value(Dot(val,norm),idx);
-      if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+      VMesh::index_type bend = std::min(bstart+blocksize,end);
+      getCenters(omesh,bstart,bend,points);
+      datasource->get_data(vals,points);
+      for (VMesh::Node::index_type idx=bstart; idx<bend; idx++)
+      {
+        omesh->get_normal(norm,idx);
+        ofield->set_value(Dot(vals[idx-bstart],norm),idx);
+      }
+      if (proc == 0) algo_->update_progress_max(bend-start,end-start);
     }
   }
   else
@@ -135,36 +179,18 @@ MapFieldDataOntoNodesPAlgo::parallel(int proc)
     // To map value, gradient, or gradientnorm
     if (datasource->is_scalar())
     {
-      Point p; double val;
-      for (VMesh::Node::index_type idx=start; idx<end; idx++)
-      {
-        omesh->get_center(p,idx);
-        datasource->get_data(val,p);
-        ofield->set_value(val,idx);
-        if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
+      std::vector<double> vals;
+      mapBlocks(datasource,omesh,ofield,start,end,blocksize,proc,points,vals);
     }
     else if (datasource->is_vector())
     {
-      Point p; Vector val;
-      for (VMesh::Node::index_type idx=start; idx<end; idx++)
-      {
-        omesh->get_center(p,idx);
-        datasource->get_data(val,p);
-        ofield->set_value(val,idx);
-        if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
+      std::vector<Vector> vals;
+      mapBlocks(datasource,omesh,ofield,start,end,blocksize,proc,points,vals);
     }
     else
     {
-      Point p; Tensor val;
-      for (VMesh::Node::index_type idx=start; idx<end; idx++)
-      {
-        omesh->get_center(p,idx);
-        datasource->get_data(val,p);
-        ofield->set_value(val,idx);
-        if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
+      std::vector<Tensor> vals;
+      mapBlocks(datasource,omesh,ofield,start,end,blocksize,proc,points,vals);
     }
   }
   // Wait until all of the threads are done
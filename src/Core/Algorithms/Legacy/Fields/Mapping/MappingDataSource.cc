@@ -105,17 +105,17 @@ class InterpolatedDataSource : public MappingDataSource {
 
     void get_data(std::vector<double>& data, const std::vector<Point>& p) const override
     {
-      sfield_->minterpolate(data,p,def_value_,mei_);
+      sfield_->minterpolate_many(data,p,def_value_,mei_);
     }
 
     void get_data(std::vector<Vector>& data, const std::vector<Point>& p) const override
     {
-      sfield_->minterpolate(data,p,Vector(def_value_,def_value_,def_value_),mei_);
+      sfield_->minterpolate_many(data,p,Vector(def_value_,def_value_,def_value_),mei_);
     }
 
     void get_data(std::vector<Tensor>& data, const std::vector<Point>& p) const override
     {
-      sfield_->minterpolate(data,p,Tensor(def_value_),mei_);
+      sfield_->minterpolate_many(data,p,Tensor(def_value_),mei_);
     }
 
     InterpolatedDataSource(FieldHandle sfield,double def_value)
@@ -161,22 +161,22 @@ class InterpolatedWeightedDataSource : public MappingDataSource {
 
     void get_data(std::vector<double>& data, const std::vector<Point>& p) const override
     {
-      wfield_->minterpolate(weights_,p,0.0,wmei_);
-      sfield_->minterpolate(data,p,def_value_,mei_);
+      wfield_->minterpolate_many(weights_,p,0.0,wmei_);
+      sfield_->minterpolate_many(data,p,def_value_,mei_);
       for (size_t j=0; j<weights_.size(); j++) data[j] = weights_[j]*data[j];
     }
 
     void get_data(std::vector<Vector>& data, const std::vector<Point>& p) const override
     {
-      wfield_->minterpolate(weights_,p,0.0,wmei_);
-      sfield_->minterpolate(data,p,Vector(def_value_,def_value_,def_value_),mei_);
+      wfield_->minterpolate_many(weights_,p,0.0,wmei_);
+      sfield_->minterpolate_many(data,p,Vector(def_value_,def_value_,def_value_),mei_);
       for (size_t j=0; j<weights_.size(); j++) data[j] = weights_[j]*data[j];
     }
 
     void get_data(std::vector<Tensor>& data, const std::vector<Point>& p) const override
     {
-      wfield_->minterpolate(weights_,p,0.0,wmei_);
-      sfield_->minterpolate(data,p,Tensor(def_value_),mei_);
+      wfield_->minterpolate_many(weights_,p,0.0,wmei_);
+      sfield_->minterpolate_many(data,p,Tensor(def_value_),mei_);
       for (size_t j=0; j<weights_.size(); j++) data[j] = weights_[j]*data[j];
     }
 
@@ -227,15 +227,15 @@ class InterpolatedWeightedTensorDataSource : public MappingDataSource {
 
     void get_data(std::vector<Vector>& data, const std::vector<Point>& p) const override
     {
-      wfield_->minterpolate(weights_,p,Tensor(0.0),wmei_);
-      sfield_->minterpolate(data,p,Vector(def_value_,def_value_,def_value_),mei_);
+      wfield_->minterpolate_many(weights_,p,Tensor(0.0),wmei_);
+      sfield_->minterpolate_many(data,p,Vector(def_value_,def_value_,def_value_),mei_);
       for (size_t j=0; j<weights_.size(); j++) data[j] = weights_[j]*data[j];
     }
 
     void get_data(std::vector<Tensor>& data, const std::vector<Point>& p) const override
     {
-      wfield_->minterpolate(data,p,Tensor(0.0),wmei_);
-      sfield_->minterpolate(tdata_,p,def_value_,mei_);
+      wfield_->minterpolate_many(data,p,Tensor(0.0),wmei_);
+      sfield_->minterpolate_many(tdata_,p,def_value_,mei_);
       for (size_t j=0; j<weights_.size(); j++) data[j] = tdata_[j]*data[j];
     }
 
@@ -321,7 +321,7 @@ class InterpolatedWeightedGradientSource : public MappingDataSource {
 
     void get_data(std::vector<Vector>& data, const std::vector<Point>& p) const override
     {
-      wfield_->minterpolate(weights_,p,0.0,wmei_);
+      wfield_->minterpolate_many(weights_,p,0.0,wmei_);
       sfield_->mgradient(grads_,p,def_value_,meg_);
       data.resize(grads_.size());
       for (size_t j=0; j<grads_.size();j++)
@@ -368,7 +368,7 @@ class InterpolatedWeightedTensorGradientSource : public MappingDataSource {
 
     void get_data(std::vector<Vector>& data, const std::vector<Point>& p) const override
     {
-      wfield_->minterpolate(weights_,p,0.0,wmei_);
+      wfield_->minterpolate_many(weights_,p,0.0,wmei_);
       sfield_->mgradient(grads_,p,def_value_,meg_);
       data.resize(grads_.size());
       for (size_t j=0; j<grads_.size();j++)
@@ -455,7 +455,7 @@ class InterpolatedWeightedGradientNormSource : public MappingDataSource {
     void get_data(std::vector<double>& data, const std::vector<Point>& p) const override
     {
       sfield_->mgradient(grads_,p,def_value_,meg_);
-      wfield_->minterpolate(weights_,p,0.0,wmei_);
+      wfield_->minterpolate_many(weights_,p,0.0,wmei_);
       data.resize(grads_.size());
       for (size_t j=0; j<grads_.size();j++)
         data[j] = (weights_[j]*Vector(grads_[j][0],grads_[j][1],grads_[j][2])).length();
@@ -502,7 +502,7 @@ class InterpolatedWeightedTensorGradientNormSource : public MappingDataSource {
     void get_data(std::vector<double>& data, const std::vector<Point>& p) const override
     {
       sfield_->mgradient(grads_,p,def_value_,meg_);
-      wfield_->minterpolate(weights_,p,0.0,wmei_);
+      wfield_->minterpolate_many(weights_,p,0.0,wmei_);
       data.resize(grads_.size());
       for (size_t j=0; j<grads_.size();j++)
         data[j] = (weights_[j]*Vector(grads_[j][0],grads_[j][1],grads_[j][2])).length();
@@ -36,8 +36,10 @@
 
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Datatypes/PropertyManagerExtensions.h>
+#include <Core/Thread/Parallel.h>
 
-#include <unordered_map>
+#include <atomic>
+#include <limits>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Algorithms;
@@ -53,22 +55,189 @@ GetFieldBoundaryAlgo::GetFieldBoundaryAlgo()
   addOption(AlgorithmParameterName("mapping"),"auto","auto|node|elem|none");
 }
 
-struct IndexHash
+namespace
 {
-  size_t operator()(const index_type &idx) const
-    { return (static_cast<size_t>(idx)); }
-};
+  using Core::Thread::Parallel;
+
+  /// Elements are processed in fixed blocks, so counts and offsets per block
+  /// do not depend on how the blocks are scheduled.
+  const size_t blockSize = 4096;
+
+  /// Room for the faces of any linear element times the nodes of each face,
+  /// so that element*slotsPerElem + face*nodesPerFace + node is unique.
+  const index_type slotsPerElem = 32;
+
+  struct BoundaryFace
+  {
+    VMesh::Elem::index_type elem;
+    VMesh::DElem::index_type face;
+    index_type firstSlot;
+  };
+
+  void lowerTo(std::atomic<index_type>& value, index_type candidate)
+  {
+    index_type current = value.load(std::memory_order_relaxed);
+    while (candidate < current &&
+      !value.compare_exchange_weak(current, candidate, std::memory_order_relaxed)) {}
+  }
+
+  /// Adds the faces of imesh without a neighbor to omesh. This is done in a
+  /// count pass, a prefix sum over the blocks and a fill pass, but the result
+  /// is that of a serial sweep over the elements: faces appear in element
+  /// order and nodes in the order in which they are first used.
+  /// nodeSource and elemSource return the input node and element of every
+  /// output node and element.
+  bool addBoundaryFaces(VMesh* imesh, VMesh* omesh,
+    std::vector<index_type>& nodeSource, std::vector<index_type>& elemSource)
+  {
+    const size_t numElems = static_cast<size_t>(imesh->num_elems());
+    const size_t numNodes = static_cast<size_t>(imesh->num_nodes());
+    const size_t numBlocks = (numElems + blockSize - 1) / blockSize;
+    const size_t nodesPerFace = omesh->num_nodes_per_elem();
+
+    std::vector<std::atomic<index_type> > firstUse(numNodes);
+    Parallel::For(0, numNodes, 1 << 14, [&](size_t begin, size_t end)
+    {
+      for (size_t n = begin; n < end; ++n)
+        firstUse[n].store(std::numeric_limits<index_type>::max(), std::memory_order_relaxed);
+    });
+
+    // Count pass: collect the boundary faces of every block and note for
+    // every node the first slot that uses it.
+    std::vector<std::vector<BoundaryFace> > faces(numBlocks);
+    std::atomic<bool> mixedFaces(false);
+    Parallel::For(0, numBlocks, 1, [&](size_t begin, size_t end)
+    {
+      VMesh::DElem::array_type delems;
+      VMesh::Node::array_type inodes;
+      VMesh::Elem::index_type nci;
+      for (size_t b = begin; b < end; ++b)
+      {
+        const size_t last = std::min(numElems, (b + 1) * blockSize);
+        for (VMesh::Elem::index_type ci = b * blockSize; ci < static_cast<index_type>(last); ++ci)
+        {
+          imesh->get_delems(delems, ci);
+          for (size_t p = 0; p < delems.size(); p++)
+          {
+            if (imesh->get_neighbor(nci, ci, delems[p])) continue;
+
+            imesh->get_nodes(inodes, delems[p]);
+            if (inodes.size() != nodesPerFace)
+            {
+              mixedFaces = true;
+              continue;
+            }
+            const index_type firstSlot = ci * slotsPerElem + p * nodesPerFace;
+            for (size_t q = 0; q < inodes.size(); q++)
+              lowerTo(firstUse[inodes[q]], firstSlot + q);
+            faces[b].push_back({ ci, delems[p], firstSlot });
+          }
+        }
+      }
+    });
+    if (mixedFaces)
+      return false;
+
+    std::vector<index_type> faceOffset(numBlocks + 1, 0), nodeOffset(numBlocks + 1, 0);
+    Parallel::For(0, numBlocks, 1, [&](size_t begin, size_t end)
+    {
+      VMesh::Node::array_type inodes;
+      for (size_t b = begin; b < end; ++b)
+      {
+        index_type count = 0;
+        for (const auto& face : faces[b])
+        {
+          imesh->get_nodes(inodes, face.face);
+          for (size_t q = 0; q < inodes.size(); q++)
+            if (firstUse[inodes[q]].load(std::memory_order_relaxed) == face.firstSlot + static_cast<index_type>(q)) count++;
+        }
+        faceOffset[b + 1] = faces[b].size();
+        nodeOffset[b + 1] = count;
+      }
+    });
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      faceOffset[b + 1] += faceOffset[b];
+      nodeOffset[b + 1] += nodeOffset[b];
+    }
+
+    omesh->resize_nodes(nodeOffset[numBlocks]);
+    omesh->resize_elems(faceOffset[numBlocks]);
+    nodeSource.resize(nodeOffset[numBlocks]);
+    elemSource.resize(faceOffset[numBlocks]);
+
+    // Fill pass: number the nodes, which have to be known for all blocks
+    // before any face can be written.
+    std::vector<index_type> outputNode(numNodes);
+    Parallel::For(0, numBlocks, 1, [&](size_t begin, size_t end)
+    {
+      VMesh::Node::array_type inodes;
+      Point point;
+      for (size_t b = begin; b < end; ++b)
+      {
+        index_type next = nodeOffset[b];
+        for (const auto& face : faces[b])
+        {
+          imesh->get_nodes(inodes, face.face);
+          for (size_t q = 0; q < inodes.size(); q++)
+          {
+            if (firstUse[inodes[q]].load(std::memory_order_relaxed) != face.firstSlot + static_cast<index_type>(q)) continue;
+            imesh->get_center(point, inodes[q]);
+            omesh->set_point(point, VMesh::Node::index_type(next));
+            nodeSource[next] = inodes[q];
+            outputNode[inodes[q]] = next++;
+          }
+        }
+      }
+    });
+
+    // The output mesh is new and not synchronized, so the faces are written
+    // straight into its element array; set_nodes would take the mesh lock for
+    // every face.
+    index_type* cells = omesh->get_elems_pointer();
+    Parallel::For(0, numBlocks, 1, [&](size_t begin, size_t end)
+    {
+      VMesh::Node::array_type inodes;
+      for (size_t b = begin; b < end; ++b)
+      {
+        index_type next = faceOffset[b];
+        for (const auto& face : faces[b])
+        {
+          imesh->get_nodes(inodes, face.face);
+          for (size_t q = 0; q < inodes.size(); q++)
+            cells[next * nodesPerFace + q] = outputNode[inodes[q]];
+          elemSource[next++] = face.elem;
+        }
+      }
+    });
+
+    return true;
+  }
+  /// Copies the values of the input elements or nodes the boundary was taken from.
+  void copyBoundaryValues(VField* ifield, VField* ofield,
+    const std::vector<index_type>& nodeSource, const std::vector<index_type>& elemSource)
+  {
+    const std::vector<index_type>* source = nullptr;
+    if (ifield->basis_order() == 0) source = &elemSource;
+    else if (ifield->basis_order() == 1) source = &nodeSource;
+    else return;
+
+    Parallel::For(0, source->size(), 1 << 14, [&](size_t begin, size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+        ofield->copy_value(ifield, (*source)[i], static_cast<index_type>(i));
+    });
+  }
+}
 
 bool
 GetFieldBoundaryAlgo::run(FieldHandle input, FieldHandle& output, MatrixHandle& mapping) const
 {
   ScopedAlgorithmStatusReporter asr(this, "GetFieldBoundary");
 
-  /// Define types we need for mapping
-  using hash_map_type = std::unordered_map<index_type,index_type,IndexHash>;
-
-  hash_map_type node_map;
-  hash_map_type elem_map;
+  /// Input node and element of every output node and element
+  std::vector<index_type> node_map;
+  std::vector<index_type> elem_map;
 
   /// Check whether we have an input field
   if (!input)
@@ -125,59 +294,10 @@ GetFieldBoundaryAlgo::run(FieldHandle input, FieldHandle& output, MatrixHandle&
 
   imesh->synchronize(Mesh::DELEMS_E | Mesh::ELEM_NEIGHBORS_E);
 
-  /// These are all virtual iterators, virtual index_types and array_types
-  VMesh::Elem::iterator be, ee;
-  VMesh::Elem::index_type nci, ci;
-  VMesh::DElem::array_type delems;
-  VMesh::Node::array_type inodes;
-  VMesh::Node::array_type onodes;
-  VMesh::Node::index_type a;
-
-  inodes.clear();
-  onodes.clear();
-  Point point;
-
-  /// This algorithm was copy from the original dynamic compiled version
-  /// and was slightly adapted to work here:
-
-  imesh->begin(be);
-  imesh->end(ee);
-
-  while (be != ee)
+  if (!addBoundaryFaces(imesh, omesh, node_map, elem_map))
   {
-
-    ci = *be;
-    imesh->get_delems(delems, ci);
-    for (size_t p = 0; p < delems.size(); p++)
-    {
-      auto includeface = false;
-
-      if (!(imesh->get_neighbor(nci, ci, delems[p]))) includeface = true;
-
-      if (includeface)
-      {
-        imesh->get_nodes(inodes, delems[p]);
-        onodes.resize(inodes.size());
-
-        for (size_t q = 0; q < inodes.size(); q++)
-        {
-          a = inodes[q];
-          auto it = node_map.find(a);
-          if (it == node_map.end())
-          {
-            imesh->get_center(point, a);
-            onodes[q] = omesh->add_node(point);
-            node_map[a] = onodes[q];
-          }
-          else
-          {
-            onodes[q] = node_map[a];
-          }
-        }
-        elem_map[omesh->add_elem(onodes)] = ci;
-      }
-    }
-    ++be;
+    error("Boundary faces of different element types cannot be combined into a single output mesh");
+    return (false);
   }
 
   mapping.reset();
@@ -209,15 +329,8 @@ GetFieldBoundaryAlgo::run(FieldHandle input, FieldHandle& output, MatrixHandle&
     std::vector<T> tripletList;
     tripletList.reserve(nrows);
 
-    hash_map_type::iterator it, it_end;
-    it = elem_map.begin();
-    it_end = elem_map.end();
-
-    while (it != it_end)
-    {
-      tripletList.push_back(T(it->first, it->second, 1));
-      ++it;
-    }
+    for (size_t i = 0; i < elem_map.size(); i++)
+      tripletList.push_back(T(i, elem_map[i], 1));
     SparseRowMatrixHandle mat(new SparseRowMatrix(nrows, ncols));
     mat->setFromTriplets(tripletList.begin(), tripletList.end());
     mapping = mat;
@@ -245,52 +358,14 @@ GetFieldBoundaryAlgo::run(FieldHandle input, FieldHandle& output, MatrixHandle&
     std::vector<T> tripletList;
     tripletList.reserve(nrows);
 
-    hash_map_type::iterator it, it_end;
-    it = node_map.begin();
-    it_end = node_map.end();
-
-    while (it != it_end)
-    {
-      tripletList.push_back(T(it->second, it->first, 1));
-      ++it;
-    }
+    for (size_t i = 0; i < node_map.size(); i++)
+      tripletList.push_back(T(i, node_map[i], 1));
     SparseRowMatrixHandle mat(new SparseRowMatrix(nrows, ncols));
     mat->setFromTriplets(tripletList.begin(), tripletList.end());
     mapping = mat;
   }
 
-  if (ifield->basis_order() == 0)
-  {
-    hash_map_type::iterator it, it_end;
-    it = elem_map.begin();
-    it_end = elem_map.end();
-
-    while (it != it_end)
-    {
-
-      VMesh::Elem::index_type idx1((*it).second);
-      VMesh::Elem::index_type idx2((*it).first);
-
-      /// Copying values
-      ofield->copy_value(ifield,idx1,idx2);
-      ++it;
-    }
-  }
-  else if (input->basis_order() == 1)
-  {
-    hash_map_type::iterator it, it_end;
-    it = node_map.begin();
-    it_end = node_map.end();
-
-    while (it != it_end)
-    {
-
-      VMesh::Node::index_type idx1((*it).first);
-      VMesh::Node::index_type idx2((*it).second);
-      ofield->copy_value(ifield,idx1,idx2);
-      ++it;
-    }
-  }
+  copyBoundaryValues(ifield, ofield, node_map, elem_map);
 
   CopyProperties(*input, *output);
 
@@ -307,11 +382,9 @@ GetFieldBoundaryAlgo::run(FieldHandle input, FieldHandle& output) const
 {
   ScopedAlgorithmStatusReporter asr(this, "GetFieldBoundary");
 
-  /// Define types we need for mapping
-  using hash_map_type = std::unordered_map<index_type,index_type,IndexHash>;
-
-  hash_map_type node_map;
-  hash_map_type elem_map;
+  /// Input node and element of every output node and element
+  std::vector<index_type> node_map;
+  std::vector<index_type> elem_map;
 
   /// Check whether we have an input field
   if (!input)
@@ -368,92 +441,15 @@ GetFieldBoundaryAlgo::run(FieldHandle input, FieldHandle& output) const
 
   imesh->synchronize(Mesh::DELEMS_E|Mesh::ELEM_NEIGHBORS_E);
 
-  /// These are all virtual iterators, virtual index_types and array_types
-  VMesh::Elem::iterator be, ee;
-  VMesh::Elem::index_type nci, ci;
-  VMesh::DElem::array_type delems;
-  VMesh::Node::array_type inodes;
-  VMesh::Node::array_type onodes;
-  VMesh::Node::index_type a;
-
-  inodes.clear();
-  onodes.clear();
-  Point point;
-
-  /// This algorithm was copy from the original dynamic compiled version
-  /// and was slightly adapted to work here:
-
-  imesh->begin(be);
-  imesh->end(ee);
-
-  while (be != ee)
+  if (!addBoundaryFaces(imesh, omesh, node_map, elem_map))
   {
-
-    ci = *be;
-    imesh->get_delems(delems, ci);
-    for (size_t p = 0; p < delems.size(); p++)
-    {
-      auto includeface = false;
-
-      if (!(imesh->get_neighbor(nci, ci, delems[p]))) includeface = true;
-
-      if (includeface)
-      {
-        imesh->get_nodes(inodes, delems[p]);
-        if (onodes.size() == 0) onodes.resize(inodes.size());
-        for (size_t q = 0; q < onodes.size(); q++)
-        {
-          a = inodes[q];
-          auto it = node_map.find(a);
-          if (it == node_map.end())
-          {
-            imesh->get_center(point, a);
-            onodes[q] = omesh->add_node(point);
-            node_map[a] = onodes[q];
-          }
-          else
-          {
-            onodes[q] = node_map[a];
-          }
-        }
-        elem_map[omesh->add_elem(onodes)] = ci;
-      }
-    }
-    ++be;
+    error("Boundary faces of different element types cannot be combined into a single output mesh");
+    return (false);
   }
 
   ofield->resize_fdata();
 
-  if (ifield->basis_order() == 0)
-  {
-    hash_map_type::iterator it, it_end;
-    it = elem_map.begin();
-    it_end = elem_map.end();
-
-    while (it != it_end)
-    {
-      VMesh::Elem::index_type idx1((*it).second);
-      VMesh::Elem::index_type idx2((*it).first);
-
-      /// Copying values
-      ofield->copy_value(ifield,idx1,idx2);
-      ++it;
-    }
-  }
-  else if (input->basis_order() == 1)
-  {
-    hash_map_type::iterator it, it_end;
-    it = node_map.begin();
-    it_end = node_map.end();
-
-    while (it != it_end)
-    {
-      VMesh::Node::index_type idx1((*it).first);
-      VMesh::Node::index_type idx2((*it).second);
-      ofield->copy_value(ifield,idx1,idx2);
-      ++it;
-    }
-  }
+  copyBoundaryValues(ifield, ofield, node_map, elem_map);
 
   CopyProperties(*input, *output);
 
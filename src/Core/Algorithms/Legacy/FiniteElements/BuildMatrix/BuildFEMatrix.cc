@@ -46,6 +46,7 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <cstdint>
 #include <boost/shared_array.hpp>
 
 using namespace SCIRun;
@@ -66,17 +67,50 @@ namespace SCIRun {
         template <typename T>
         using matrix_pointer_type = SharedPointer<matrix_type<T>>;
 
+// Symbolic part of the stiffness matrix, which only depends on the mesh
+struct FEMatrixStructure
+{
+  int meshId = -1;
+  index_type numElems = 0;
+  index_type globalDimension = 0;
+  bool elementAssembly = false; ///< value of the ElementAssembly parameter
+  bool colored = false;         ///< whether the colouring below is in use
+  std::vector<index_type> coloredBlocks;
+  std::vector<index_type> colorOffsets;
+};
+
+template <typename T>
+struct FEMatrixValues
+{
+  // Last output: its sparsity pattern is copied on the next run on the same mesh,
+  // or it is refilled in place if nobody else holds on to it anymore
+  matrix_pointer_type<T> last;
+
+  // GenerateBasis: stiffness matrix values for unit conductivity of each tissue type
+  int basisMeshId = -1;
+  matrix_pointer_type<T> basis;
+  std::vector<std::vector<T>> basisValues;
+};
+
+class BuildFEMatrixCache
+{
+public:
+  FEMatrixStructure structure;
+  FEMatrixValues<double> realValues;
+  FEMatrixValues<complex> complexValues;
+};
+
 template <typename T>
 class BuildFEMatrixAlgoImpl
 {
 public:
-  explicit BuildFEMatrixAlgoImpl(const AlgorithmBase* algo) : algo_(algo) {}
+  BuildFEMatrixAlgoImpl(const AlgorithmBase* algo, FEMatrixStructure& structure, FEMatrixValues<T>& values) :
+    algo_(algo), structure_(structure), values_(values) {}
   bool run(FieldHandle input, Datatypes::DenseMatrixHandle ctable, matrix_pointer_type<T>& output) const;
 private:
   const AlgorithmBase* algo_;
-  mutable int generation_ = 0;
-  mutable std::vector<std::vector<T>> basis_values_;
-  mutable matrix_pointer_type<T> basis_fematrix_;
+  FEMatrixStructure& structure_;
+  FEMatrixValues<T>& values_;
 };
 
 // Helper class
@@ -84,7 +118,7 @@ template <typename T>
 class FEMBuilder
 {
 public:
-  explicit FEMBuilder(const AlgorithmBase* algo) :
+  FEMBuilder(const AlgorithmBase* algo, FEMatrixStructure& structure) :
     algo_(algo), numprocessors_(Parallel::NumCores()),
     barrier_("FEMBuilder Barrier", numprocessors_),
     mesh_(nullptr), field_(nullptr),
@@ -95,10 +129,16 @@ public:
     global_dimension_nodes(0),
     global_dimension_add_nodes(0),
     global_dimension_derivatives(0),
-    global_dimension(0)
+    global_dimension(0),
+    structure_(structure),
+    reuse_structure_(false),
+    in_place_(false),
+    element_assembly_(false)
   {
   }
 
+  // A non-null output on entry is the result of an earlier run: on the same mesh
+  // its sparsity pattern is reused, and its storage if nobody else holds it.
   bool build_matrix(FieldHandle input,
                     DenseMatrixHandle ctable,
                     matrix_pointer_type<T>& output);
@@ -110,13 +150,14 @@ private:
 
   VMesh* mesh_;
   VField *field_;
+  MeshHandle mesh_handle_;
 
   matrix_pointer_type<T> fematrix_;
 
-  std::vector<bool> success_;
+  // one flag per thread; not a std::vector<bool>, which the threads could not write concurrently
+  std::vector<char> success_;
 
   boost::shared_array<index_type> rows_;
-  boost::shared_array<index_type> allcols_;
   std::vector<index_type> colidx_;
 
   index_type domain_dimension;
@@ -135,6 +176,19 @@ private:
   std::vector<std::pair<std::string, Tensor> > tensors_;
   std::vector<std::pair<std::string, T> > scalars_;
 
+  // Pattern of an earlier run on the same mesh
+  FEMatrixStructure& structure_;
+  matrix_pointer_type<T> previous_;
+  bool reuse_structure_;
+  bool in_place_;
+
+  // Element by element assembly. Blocks of consecutive elements are sorted by
+  // colour in structure_; blocks of one colour share no nodes, so their local
+  // matrices can be added to the global matrix by several threads at once
+  // without locking.
+  bool element_assembly_;
+  static constexpr index_type element_block_size = 256;
+
   // Entry point for the parallel version
   void parallel(int proc);
 
@@ -160,6 +214,21 @@ private:
                                   std::vector<double>& w,
                                   std::vector<std::vector<double>>& d,
                                   std::vector<std::vector<T>>& precompute);
+  bool build_element_matrix(VMesh::Elem::index_type c_ind,
+                            std::vector<T>& l_stiff,
+                            std::vector<T>& gradients,
+                            std::vector<VMesh::coords_type>& p,
+                            std::vector<double>& w,
+                            std::vector<std::vector<double>>& d,
+                            std::vector<std::vector<T>>& precompute);
+  bool color_element_blocks();
+  bool build_structure(int proc_num, index_type start_gd, index_type end_gd);
+  bool copy_structure(int proc_num, index_type start_gd, index_type end_gd);
+  bool assemble_elements(int proc_num,
+                         std::vector<VMesh::coords_type>& p,
+                         std::vector<double>& w,
+                         std::vector<std::vector<double>>& d,
+                         std::vector<std::vector<T>>& precompute);
   bool setup();
 
 };
@@ -174,6 +243,11 @@ FEMBuilder<T>::build_matrix(FieldHandle input,
   // Get virtual interface to data
   field_ = input->vfield();
   mesh_  = input->vmesh();
+  mesh_handle_ = input->mesh();
+
+  previous_ = output;
+  output.reset();
+  in_place_ = previous_ && previous_.use_count() == 1;
 
 #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
   // If we have the Conductivity property use it, if not we assume the values on
@@ -256,6 +330,7 @@ FEMBuilder<T>::build_matrix(FieldHandle input,
 
   // Start the multi threaded FE matrix builder.
   Parallel::RunTasks([this](int i) { parallel(i); }, numprocessors_);
+  previous_.reset();
   for (size_t j=0; j<success_.size(); j++)
   {
     if (!success_[j])
@@ -267,6 +342,11 @@ FEMBuilder<T>::build_matrix(FieldHandle input,
     }
   }
 
+  structure_.meshId = mesh_handle_->id();
+  structure_.numElems = mesh_->num_elems();
+  structure_.globalDimension = global_dimension;
+  structure_.elementAssembly = algo_->get(BuildFEMatrixAlgo::ElementAssembly).toBool();
+
   // Make sure it is symmetric
   if (algo_->get(BuildFEMatrixAlgo::ForceSymmetry).toBool())
   {
@@ -606,6 +686,231 @@ FEMBuilder<T>::build_local_matrix_regular(VMesh::Elem::index_type c_ind,
   return true;
 }
 
+/// build the full local stiffness matrix of an element, stored row by row
+template <typename T>
+bool
+FEMBuilder<T>::build_element_matrix(VMesh::Elem::index_type c_ind,
+                                 std::vector<T> &l_stiff,
+                                 std::vector<T> &gradients,
+                                 std::vector<VMesh::coords_type> &p,
+                                 std::vector<double> &w,
+                                 std::vector<std::vector<double>> &d,
+                                 std::vector<std::vector<T>> &precompute)
+{
+  Tensor tensor;
+
+  if (tensors_.empty())
+  {
+    field_->get_value(tensor,c_ind);
+  }
+  else
+  {
+    int tensor_index;
+    field_->get_value(tensor_index,c_ind);
+    tensor = tensors_[tensor_index].second;
+  }
+
+  auto Ca = tensor.val(0,0);
+  auto Cb = tensor.val(0,1);
+  auto Cc = tensor.val(0,2);
+  auto Cd = tensor.val(1,1);
+  auto Ce = tensor.val(1,2);
+  auto Cf = tensor.val(2,2);
+
+  std::fill(l_stiff.begin(), l_stiff.end(), T(0));
+
+  if ( (Ca==0) && (Cb==0) && (Cc==0) && (Cd==0) && (Ce==0) && (Cf==0) )
+    return true;
+
+  // Elements of a regular mesh all have the same jacobian, which is only computed
+  // for the first element
+  if (!mesh_->is_regularmesh() || precompute.empty())
+  {
+    precompute.resize(d.size());
+    auto vol = mesh_->get_element_size();
+
+    for (size_t i = 0; i < d.size(); i++)
+    {
+      auto& pc = precompute[i];
+      pc.resize(10);
+
+      double Ji[9];
+      auto detJ = mesh_->inverse_jacobian(p[i], c_ind, Ji);
+
+      if (detJ <= 0.0)
+      {
+        algo_->error("Mesh has elements with negative jacobians, check the order of the nodes that define an element");
+        return false;
+      }
+      // Volume associated with the local Gaussian Quadrature point:
+      // weightfactor * Volume Unit element * Volume ratio (real element/unit element)
+      detJ *= w[i] * vol;
+
+      for (int k = 0; k < 9; k++)
+        pc[k] = Ji[k];
+      pc[9] = detJ;
+    }
+  }
+
+  auto local_dimension2 = 2*local_dimension;
+
+  for (size_t i = 0; i < d.size(); i++)
+  {
+    const auto& pc = precompute[i];
+    auto Nxi = &d[i][0];
+    auto Nyi = &d[i][local_dimension];
+    auto Nzi = &d[i][local_dimension2];
+
+    // Gradients of all basis functions: local derivatives * inverse Jacobian
+    for (int j = 0; j < local_dimension; j++)
+    {
+      gradients[3*j]   = Nxi[j]*pc[0] + Nyi[j]*pc[1] + Nzi[j]*pc[2];
+      gradients[3*j+1] = Nxi[j]*pc[3] + Nyi[j]*pc[4] + Nzi[j]*pc[5];
+      gradients[3*j+2] = Nxi[j]*pc[6] + Nyi[j]*pc[7] + Nzi[j]*pc[8];
+    }
+
+    for (int k = 0; k < local_dimension; k++)
+    {
+      // Conductivity tensor * gradient * volume scaling factor
+      const auto* gk = &gradients[3*k];
+      const auto uxyzpabc = pc[9]*(gk[0]*Ca + gk[1]*Cb + gk[2]*Cc);
+      const auto uxyzpbde = pc[9]*(gk[0]*Cb + gk[1]*Cd + gk[2]*Ce);
+      const auto uxyzpcef = pc[9]*(gk[0]*Cc + gk[1]*Ce + gk[2]*Cf);
+
+      auto row = &l_stiff[k*local_dimension];
+      for (int j = 0; j < local_dimension; j++)
+        row[j] += gradients[3*j]*uxyzpabc + gradients[3*j+1]*uxyzpbde + gradients[3*j+2]*uxyzpcef;
+    }
+  }
+  return true;
+}
+
+/// greedy colouring of blocks of consecutive elements, such that blocks sharing
+/// a node get a different colour. Element numbering usually follows the geometry,
+/// so a block covers a compact region and only touches a few other blocks.
+template <typename T>
+bool
+FEMBuilder<T>::color_element_blocks()
+{
+  const index_type num_elems = mesh_->num_elems();
+  const index_type num_blocks = (num_elems + element_block_size - 1) / element_block_size;
+
+  // bit c is set when a block of colour c contains the node
+  std::vector<uint64_t> node_colors(global_dimension_nodes, 0);
+  std::vector<int> block_color(num_blocks);
+  std::vector<index_type> color_count;
+
+  VMesh::Node::array_type na;
+
+  for (index_type b = 0; b < num_blocks; b++)
+  {
+    const index_type start = b * element_block_size;
+    const index_type end = std::min(start + element_block_size, num_elems);
+
+    uint64_t used = 0;
+    for (VMesh::Elem::index_type e = start; e < end; ++e)
+    {
+      mesh_->get_nodes(na, e);
+      for (size_t k = 0; k < na.size(); k++)
+        used |= node_colors[na[k]];
+    }
+
+    // Out of colours, the element numbering is too scattered for this scheme
+    if (~used == 0)
+      return false;
+
+    int c = 0;
+    while (used & (uint64_t(1) << c))
+      c++;
+
+    for (VMesh::Elem::index_type e = start; e < end; ++e)
+    {
+      mesh_->get_nodes(na, e);
+      for (size_t k = 0; k < na.size(); k++)
+        node_colors[na[k]] |= uint64_t(1) << c;
+    }
+
+    block_color[b] = c;
+    if (c >= static_cast<int>(color_count.size()))
+      color_count.resize(c + 1, 0);
+    color_count[c]++;
+  }
+
+  structure_.colorOffsets.assign(color_count.size() + 1, 0);
+  for (size_t c = 0; c < color_count.size(); c++)
+    structure_.colorOffsets[c+1] = structure_.colorOffsets[c] + color_count[c];
+
+  auto next = structure_.colorOffsets;
+  structure_.coloredBlocks.resize(num_blocks);
+  for (index_type b = 0; b < num_blocks; b++)
+    structure_.coloredBlocks[next[block_color[b]]++] = b;
+
+  return true;
+}
+
+/// element by element assembly: each local matrix is computed once and added to
+/// all of its rows. The threads split up the element blocks of one colour at a time.
+template <typename T>
+bool
+FEMBuilder<T>::assemble_elements(int proc_num,
+                              std::vector<VMesh::coords_type> &p,
+                              std::vector<double> &w,
+                              std::vector<std::vector<double>> &d,
+                              std::vector<std::vector<T>> &precompute)
+{
+  std::vector<T> l_stiff(local_dimension*local_dimension);
+  std::vector<T> gradients(3*local_dimension);
+  VMesh::Node::array_type na;
+
+  bool success = true;
+  const index_type num_colors = static_cast<index_type>(structure_.colorOffsets.size()) - 1;
+  const index_type num_elems = mesh_->num_elems();
+
+  for (index_type c = 0; c < num_colors; c++)
+  {
+    const index_type cs = structure_.colorOffsets[c];
+    const index_type ce = structure_.colorOffsets[c+1];
+    const index_type start = cs + ((ce - cs) * proc_num) / numprocessors_;
+    const index_type end = cs + ((ce - cs) * (proc_num+1)) / numprocessors_;
+
+    try
+    {
+      for (index_type b = start; success && b < end; b++)
+      {
+        const index_type es = structure_.coloredBlocks[b] * element_block_size;
+        const index_type ee = std::min(es + element_block_size, num_elems);
+
+        for (VMesh::Elem::index_type c_ind = es; success && c_ind < ee; ++c_ind)
+        {
+          success = build_element_matrix(c_ind, l_stiff, gradients, p, w, d, precompute);
+          if (success)
+          {
+            mesh_->get_nodes(na, c_ind);
+            for (int k = 0; k < local_dimension; k++)
+            {
+              auto row = &l_stiff[k*local_dimension];
+              for (int j = 0; j < local_dimension; j++)
+                fematrix_->coeffRef(na[k], na[j]) += row[j];
+            }
+          }
+        }
+      }
+    }
+    catch (...)
+    {
+      algo_->error("BuildFEMatrix crashed while filling out stiffness matrix");
+      success = false;
+    }
+
+    if (proc_num == 0)
+      algo_->update_progress_max(num_colors + c + 1, 2*num_colors);
+
+    /// elements of the next colour share nodes with the ones of this colour
+    barrier_.wait();
+  }
+  return success;
+}
+
 template <typename T>
 bool
 FEMBuilder<T>::setup()
@@ -669,51 +974,62 @@ FEMBuilder<T>::setup()
     algo_->error("Mesh size < 0");
     success_[0] = false;
   }
-  LOG_DEBUG("Allocating buffer for nonzero row indices of size: {}", global_dimension+1);
-  rows_.reset(new index_type[global_dimension+1]);
-
   colidx_.resize(numprocessors_+1);
-  return true;
-}
+  const auto elementAssembly = algo_->get(BuildFEMatrixAlgo::ElementAssembly).toBool();
 
-// -- callback routine to execute in parallel
-template <typename T>
-void
-FEMBuilder<T>::parallel(int proc_num)
-{
-  success_[proc_num] = true;
+  reuse_structure_ = previous_ && mns > 0 && previous_->isCompressed() &&
+    structure_.meshId == mesh_handle_->id() &&
+    structure_.numElems == static_cast<index_type>(mesh_->num_elems()) &&
+    structure_.globalDimension == global_dimension &&
+    structure_.elementAssembly == elementAssembly &&
+    static_cast<index_type>(previous_->nrows()) == global_dimension &&
+    static_cast<index_type>(previous_->ncols()) == global_dimension;
 
-  if (proc_num == 0)
+  if (reuse_structure_)
   {
-    try
+    LOG_DEBUG("Reusing sparsity pattern of the previous stiffness matrix {}", in_place_ ? "in place" : "");
+    element_assembly_ = structure_.colored;
+
+    const index_type nnz = previous_->nonZeros();
+    if (in_place_)
     {
-      success_[proc_num] = setup();
+      fematrix_ = previous_;
     }
-    catch (...)
+    else
     {
-      algo_->error("BuildFEMatrix could not setup FE Stiffness computation");
-      success_[proc_num] = false;
+      fematrix_ = makeShared<matrix_type<T>>(global_dimension, global_dimension);
+      fematrix_->allocateCompressed(nnz);
+      fematrix_->get_rows()[global_dimension] = nnz;
     }
+
+    for (int p = 0; p <= numprocessors_; p++)
+      colidx_[p] = previous_->get_rows()[(global_dimension * p) / numprocessors_];
+    return true;
   }
 
-  barrier_.wait();
+  // The structure is rebuilt below
+  structure_.meshId = -1;
 
-  // In case one of the threads fails, we should have them fail all
-  for (int q = 0; q < numprocessors_; q++)
+  LOG_DEBUG("Allocating buffer for nonzero row indices of size: {}", global_dimension+1);
+  rows_.reset(new index_type[global_dimension+1]);
+
+  // Higher order elements are assembled node by node
+  element_assembly_ = elementAssembly && global_dimension_add_nodes == 0 && mns > 0;
+  if (element_assembly_ && !color_element_blocks())
   {
-    if (!success_[q])
-    {
-      std::ostringstream oss;
-      oss << "FEMBuilder::setup failed in thread " << q;
-      algo_->error(oss.str());
-      return;
-    }
+    algo_->remark("Element numbering too scattered for element by element assembly, assembling node by node.");
+    element_assembly_ = false;
   }
+  structure_.colored = element_assembly_;
 
-  /// distributing dofs among processors
-  const index_type start_gd = (global_dimension * proc_num)/numprocessors_;
-  const index_type end_gd  = (global_dimension * (proc_num+1))/numprocessors_;
+  return true;
+}
 
+// -- maps out the sparsity pattern of the rows [start_gd, end_gd) of this thread
+template <typename T>
+bool
+FEMBuilder<T>::build_structure(int proc_num, index_type start_gd, index_type end_gd)
+{
   /// creating sparse matrix structure
   std::vector<index_type> mycols;
 
@@ -813,16 +1129,12 @@ FEMBuilder<T>::parallel(int proc_num)
   {
     if (!success_[q])
     {
-      return;
+      return false;
     }
   }
 
-  std::vector<std::vector<T>> precompute;
   index_type st = 0;
 
-  if (proc_num == 0)
-    allcols_.reset();
-
   try
   {
     if (proc_num == 0)
@@ -835,14 +1147,18 @@ FEMBuilder<T>::parallel(int proc_num)
       }
 
       colidx_[numprocessors_] = st;
-      allcols_.reset(new index_type[st]);
+
+      /// the compressed storage of the matrix is filled in directly by all threads
+      fematrix_ = makeShared<matrix_type<T>>(global_dimension, global_dimension);
+      fematrix_->allocateCompressed(st);
+      fematrix_->get_rows()[global_dimension] = st;
     }
     success_[proc_num] = true;
   }
   catch (...)
   {
     if (proc_num == 0)
-      allcols_.reset();
+      fematrix_.reset();
 
     algo_->error("Could not allocate enough memory");
     success_[proc_num] = false;
@@ -855,20 +1171,18 @@ FEMBuilder<T>::parallel(int proc_num)
   for (int q=0; q<numprocessors_;q++)
   {
     if (! success_[q])
-      return;
+      return false;
   }
 
   try
   {
     /// updating global column by each of the processors
     const index_type s = colidx_[proc_num];
-    const size_t n = mycols.size();
-
-    for(size_t i=0; i<n; i++)
-      allcols_[i+s] = mycols[i];
+    std::copy(mycols.begin(), mycols.end(), fematrix_->get_cols() + s);
 
+    auto rows = fematrix_->get_rows();
     for(index_type i = start_gd; i<end_gd; i++)
-      rows_[i] += s;
+      rows[i] = rows_[i] + s;
 
     success_[proc_num] = true;
   }
@@ -885,25 +1199,46 @@ FEMBuilder<T>::parallel(int proc_num)
   for (auto q=0; q<numprocessors_; q++)
   {
     if (!success_[q])
-      return;
+      return false;
+  }
+
+  /// each thread checks its own rows, now that all row offsets are in place
+  if (matrix_type<T>::checkCompressedRows(fematrix_->get_rows(), fematrix_->get_cols(),
+    global_dimension, start_gd, end_gd) != matrix_type<T>::CompressedRowsSorted)
+  {
+    algo_->error("BuildFEMatrix generated an invalid stiffness matrix structure");
+    success_[proc_num] = false;
+  }
+
+  /// check point
+  barrier_.wait();
+
+  // Bail out if one of the processes failed
+  for (auto q=0; q<numprocessors_;q++)
+  {
+    if (!success_[q])
+      return false;
   }
 
+  return true;
+}
+
+// -- copies the sparsity pattern of the rows of this thread from the previous matrix
+template <typename T>
+bool
+FEMBuilder<T>::copy_structure(int proc_num, index_type start_gd, index_type end_gd)
+{
   try
   {
-    /// the main thread makes the matrix
-    if (proc_num == 0)
-    {
-      rows_[global_dimension] = st;
-      algo_->remark("Creating fematrix on main thread.");
-      fematrix_ = makeShared<matrix_type<T>>(global_dimension, global_dimension, rows_.get(), allcols_.get(), st);
-      rows_.reset();
-      allcols_.reset();
-    }
+    const auto prows = previous_->get_rows();
+    const auto pcols = previous_->get_cols();
+    std::copy(pcols + colidx_[proc_num], pcols + colidx_[proc_num+1], fematrix_->get_cols() + colidx_[proc_num]);
+    std::copy(prows + start_gd, prows + end_gd, fematrix_->get_rows() + start_gd);
     success_[proc_num] = true;
   }
   catch (...)
   {
-    algo_->error("BuildFEMatrix crashed while creating final stiffness matrix");
+    algo_->error("BuildFEMatrix crashed while copying the stiffness matrix structure");
     success_[proc_num] = false;
   }
 
@@ -911,14 +1246,114 @@ FEMBuilder<T>::parallel(int proc_num)
   barrier_.wait();
 
   // Bail out if one of the processes failed
-  for (auto q=0; q<numprocessors_;q++)
+  for (int q=0; q<numprocessors_; q++)
   {
     if (!success_[q])
+      return false;
+  }
+  return true;
+}
+
+// -- callback routine to execute in parallel
+template <typename T>
+void
+FEMBuilder<T>::parallel(int proc_num)
+{
+  success_[proc_num] = true;
+
+  if (proc_num == 0)
+  {
+    try
+    {
+      success_[proc_num] = setup();
+    }
+    catch (...)
+    {
+      algo_->error("BuildFEMatrix could not setup FE Stiffness computation");
+      success_[proc_num] = false;
+    }
+  }
+
+  barrier_.wait();
+
+  // In case one of the threads fails, we should have them fail all
+  for (int q = 0; q < numprocessors_; q++)
+  {
+    if (!success_[q])
+    {
+      std::ostringstream oss;
+      oss << "FEMBuilder::setup failed in thread " << q;
+      algo_->error(oss.str());
+      return;
+    }
+  }
+
+  /// distributing dofs among processors
+  const index_type start_gd = (global_dimension * proc_num)/numprocessors_;
+  const index_type end_gd  = (global_dimension * (proc_num+1))/numprocessors_;
+
+  if (reuse_structure_)
+  {
+    if (!in_place_ && !copy_structure(proc_num, start_gd, end_gd))
       return;
   }
+  else if (!build_structure(proc_num, start_gd, end_gd))
+  {
+    return;
+  }
+
+  VMesh::Elem::array_type ca;
+  VMesh::Node::array_type na;
+  VMesh::Edge::array_type ea;
+  std::vector<index_type> neib_dofs;
+  std::vector<std::vector<T>> precompute;
+
+  int cnt = 0;
+  size_type size_gd = end_gd-start_gd;
+  auto updateFrequency = 2*size_gd / 100;
+
+  if (element_assembly_)
+  {
+    std::vector<VMesh::coords_type> ni_points;
+    std::vector<double> ni_weights;
+    std::vector<std::vector<double>> ni_derivatives;
+
+    try
+    {
+      if (proc_num == 0)
+        rows_.reset();
+
+      /// zeroing in parallel
+      auto a = fematrix_->valuePtr();
+      std::fill(a + colidx_[proc_num], a + colidx_[proc_num+1], T(0));
+
+      create_numerical_integration(ni_points, ni_weights, ni_derivatives);
+      success_[proc_num] = true;
+    }
+    catch (...)
+    {
+      algo_->error("BuildFEMatrix crashed while filling out stiffness matrix");
+      success_[proc_num] = false;
+    }
+
+    /// all rows need to be cleared before elements are added to them
+    barrier_.wait();
+
+    for (int q=0; q<numprocessors_; q++)
+    {
+      if (!success_[q])
+        return;
+    }
+
+    success_[proc_num] = assemble_elements(proc_num, ni_points, ni_weights, ni_derivatives, precompute);
+    return;
+  }
 
   try
   {
+    if (proc_num == 0)
+      rows_.reset();
+
     /// zeroing in parallel
     const auto ns = colidx_[proc_num];
     const auto ne = colidx_[proc_num+1];
@@ -935,8 +1370,6 @@ FEMBuilder<T>::parallel(int proc_num)
     lsml.resize(local_dimension);
 
     /// loop over system dofs for this thread
-    cnt = 0;
-    size_gd = end_gd-start_gd;
     for (VMesh::Node::index_type i = start_gd; i<end_gd; ++i)
     {
       if (i < global_dimension_nodes)
@@ -1072,6 +1505,7 @@ FEMBuilder<T>::parallel(int proc_num)
 
 const AlgorithmParameterName BuildFEMatrixAlgo::ForceSymmetry("ForceSymmetry");
 const AlgorithmParameterName BuildFEMatrixAlgo::GenerateBasis("GenerateBasis");
+const AlgorithmParameterName BuildFEMatrixAlgo::ElementAssembly("ElementAssembly");
 
 template <typename T>
 bool
@@ -1111,7 +1545,12 @@ BuildFEMatrixAlgoImpl<T>::run(FieldHandle input, DenseMatrixHandle ctable, matri
     }
   }
 
-  FEMBuilder<T> builder(algo_);
+  FEMBuilder<T> builder(algo_, structure_);
+
+  // The previous output is handed back to the builder, so that its sparsity
+  // pattern, and its storage when nobody else holds it, can be reused
+  output = values_.last;
+  values_.last.reset();
 
   if (algo_->get(BuildFEMatrixAlgo::GenerateBasis).toBool())
   {
@@ -1136,29 +1575,33 @@ BuildFEMatrixAlgoImpl<T>::run(FieldHandle input, DenseMatrixHandle ctable, matri
     if (ctable)
     {
       auto nconds = ctable->nrows();
-      if ( (input->vmesh()->generation() != generation_) ||
-          (!basis_fematrix_) )
+      bool rebuilt = false;
+      if (input->mesh()->id() != values_.basisMeshId ||
+          values_.basisValues.size() != static_cast<size_t>(nconds) ||
+          !values_.basis)
       {
+        rebuilt = true;
+        values_.basisMeshId = -1;
         auto con = makeShared<DenseMatrix>(nconds, 1, 0.0);
         auto data = con->data();
 
-        if (!builder.build_matrix(input, con, basis_fematrix_) )
+        if (!builder.build_matrix(input, con, values_.basis) )
         {
           algo_->error("Build matrix method failed when building FEMatrix structure");
           return false;
         }
 
-        if (!basis_fematrix_)
+        if (!values_.basis)
         {
           algo_->error("Failed to build FEMatrix structure");
           return false;
         }
 
-        basis_values_.resize(nconds);
+        values_.basisValues.resize(nconds);
         for (size_type i=0; i < nconds; i++)
         {
-          matrix_pointer_type<T> stiffness;
-          /// @todo: can initialize array using std::fill
+          // starts out as the structure, so only the values are computed
+          auto stiffness = values_.basis;
           data[i] = 1.0;
 
           if (!builder.build_matrix(input, con, stiffness) )
@@ -1173,38 +1616,36 @@ BuildFEMatrixAlgoImpl<T>::run(FieldHandle input, DenseMatrixHandle ctable, matri
             return false;
           }
 
-          basis_values_[i].resize(stiffness->nonZeros());
-          for (size_type p=0; p< stiffness->nonZeros(); p++)
-          {
-            basis_values_[i][p] = stiffness->valuePtr()[p];
-          }
+          values_.basisValues[i].assign(stiffness->valuePtr(), stiffness->valuePtr() + stiffness->nonZeros());
           data[i] = 0.0;
         }
 
-        generation_ = input->vmesh()->generation();
+        values_.basisMeshId = input->mesh()->id();
       }
 
-      output.reset(basis_fematrix_->clone());
+      if (rebuilt || !output || output.use_count() != 1 ||
+          output->nonZeros() != values_.basis->nonZeros())
+      {
+        output.reset(values_.basis->clone());
+      }
 
       auto sum = output->valuePtr();
       auto cdata = ctable->data();
       auto n = ctable->ncols();
 
-      if (!basis_values_.empty())
-      {
-        for (size_t p=0; p < basis_values_[0].size(); p++)
-          sum[p] = 0.0;
-      }
+      std::fill(sum, sum + output->nonZeros(), T(0));
 
       for (auto i=0; i<nconds; i++)
       {
         auto weight = cdata[i*n];
-        for (size_t p=0; p < basis_values_[i].size(); p++)
+        for (size_t p=0; p < values_.basisValues[i].size(); p++)
         {
-          sum[p] += weight * basis_values_[i][p];
+          sum[p] += weight * values_.basisValues[i][p];
         }
       }
 
+      values_.last = output;
+      return true;
     }
     else
     {
@@ -1225,6 +1666,7 @@ BuildFEMatrixAlgoImpl<T>::run(FieldHandle input, DenseMatrixHandle ctable, matri
     return false;
   }
 
+  values_.last = output;
   return true;
 }
 
@@ -1237,11 +1679,14 @@ AlgorithmOutput BuildFEMatrixAlgo::run(const AlgorithmInput& input) const
   auto field = input.get<Field>(Variables::InputField);
   auto ctable = input.get<DenseMatrix>(Conductivity_Table);
 
+  if (!cache_)
+    cache_ = makeShared<BuildFEMatrixCache>();
+
 	AlgorithmOutput output;
   if (field && field->vfield() && field->vfield()->is_complex_double())
 	{
 		matrix_pointer_type<complex> stiffness;
-	  BuildFEMatrixAlgoImpl<complex> impl(this);
+	  BuildFEMatrixAlgoImpl<complex> impl(this, cache_->structure, cache_->complexValues);
 	  if (!impl.run(field, ctable, stiffness))
 	    THROW_ALGORITHM_PROCESSING_ERROR("False returned on legacy run call.--complex detected	");
 		output[Stiffness_Matrix_Complex] = stiffness;
@@ -1249,7 +1694,7 @@ AlgorithmOutput BuildFEMatrixAlgo::run(const AlgorithmInput& input) const
 	else
 	{
 		matrix_pointer_type<double> stiffness;
-	  BuildFEMatrixAlgoImpl<double> impl(this);
+	  BuildFEMatrixAlgoImpl<double> impl(this, cache_->structure, cache_->realValues);
 	  if (!impl.run(field, ctable, stiffness))
 	    THROW_ALGORITHM_PROCESSING_ERROR("False returned on legacy run call.");
 		output[Stiffness_Matrix] = stiffness;
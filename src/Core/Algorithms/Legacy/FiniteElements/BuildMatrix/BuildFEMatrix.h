@@ -38,11 +38,14 @@ namespace SCIRun {
 		namespace Algorithms {
 			namespace FiniteElements {
 
+class BuildFEMatrixCache;
+
 class SCISHARE BuildFEMatrixAlgo : public AlgorithmBase
 {
   public:
     static const AlgorithmParameterName ForceSymmetry;
     static const AlgorithmParameterName GenerateBasis;
+    static const AlgorithmParameterName ElementAssembly;
 
     static const AlgorithmInputName Conductivity_Table;
     static const AlgorithmOutputName Stiffness_Matrix;
@@ -58,9 +61,18 @@ class SCISHARE BuildFEMatrixAlgo : public AlgorithmBase
       // for instance conductivity search
       // This option only works for an indexed conductivity table
       addParameter(GenerateBasis, false);
+
+      // Compute each local stiffness matrix once and add it to all of its
+      // rows, instead of recomputing it for every node of the element
+      addParameter(ElementAssembly, true);
     }
 
     AlgorithmOutput run(const AlgorithmInput &) const override;
+
+  private:
+    // Sparsity pattern, element colouring and conductivity basis of the last
+    // mesh, so that runs with new conductivities on the same mesh only refill values
+    mutable SharedPointer<BuildFEMatrixCache> cache_;
 };
 
 }}}}
@@ -38,6 +38,8 @@
 #include <Core/Algorithms/Legacy/Forward/BuildBEMatrixAlgo.h>
 
 #include <algorithm>
+#include <array>
+#include <functional>
 #include <map>
 #include <iostream>
 #include <string>
@@ -54,23 +56,42 @@
 #include <Core/GeometryPrimitives/Vector.h>
 #include <Core/GeometryPrimitives/Point.h>
 #include <Core/GeometryPrimitives/PointVectorOperators.h>
+#include <Core/Thread/Parallel.h>
+#include <Core/Logging/Log.h>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Algorithms::Forward;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
 
 ALGORITHM_PARAMETER_DEF(Forward, FieldNameList);
 ALGORITHM_PARAMETER_DEF(Forward, FieldTypeList);
 ALGORITHM_PARAMETER_DEF(Forward, BoundaryConditionList);
 ALGORITHM_PARAMETER_DEF(Forward, InsideConductivityList);
 ALGORITHM_PARAMETER_DEF(Forward, OutsideConductivityList);
+ALGORITHM_PARAMETER_DEF(Forward, CrossBlockTolerance);
+
+DenseMatrix::EigenBase LowRankBlock::multiply(const DenseMatrix::EigenBase& x) const
+{
+  return U * (V.transpose() * x);
+}
+
+DenseMatrix::EigenBase LowRankBlock::multiplyTranspose(const DenseMatrix::EigenBase& x) const
+{
+  return V * (U.transpose() * x);
+}
+
+DenseMatrix LowRankBlock::toDense() const
+{
+  return U * V.transpose();
+}
 
 void BuildBEMatrixBase::getOmega(
   const Vector& y1,
   const Vector& y2,
   const Vector& y3,
-  DenseMatrix& coef)
+  double (&coef)[3])
 {
   /*
   This function deals with the analytical solutions of the various integrals in the stiffness matrix
@@ -145,9 +166,9 @@ void BuildBEMatrixBase::getOmega(
   double Zn3 = Dot(Cross(y1, y2) , N);
 
   double A2 = N.length2();
-  coef(0,0) = (1/A2) * ( Zn1*Omega + d * Dot(y32, OmegaVec) );
-  coef(0,1) = (1/A2) * ( Zn2*Omega + d * Dot(y13, OmegaVec) );
-  coef(0,2) = (1/A2) * ( Zn3*Omega + d * Dot(y21, OmegaVec) );
+  coef[0] = (1/A2) * ( Zn1*Omega + d * Dot(y32, OmegaVec) );
+  coef[1] = (1/A2) * ( Zn2*Omega + d * Dot(y13, OmegaVec) );
+  coef[2] = (1/A2) * ( Zn3*Omega + d * Dot(y21, OmegaVec) );
 
 }
 
@@ -158,7 +179,7 @@ void  BuildBEMatrixBase::get_cruse_weights(
   double s,
   double r,
   double area,
-  DenseMatrix& cruse_weights)
+  double (&cruse_weights)[3][7])
 {
   /*
   Inputs: p1,p2,p3= cartesian coordiantes of the triangle vertices ;
@@ -190,48 +211,45 @@ void  BuildBEMatrixBase::get_cruse_weights(
   Vector locp2(fg3_length , 0 , 0);
   Vector locp3(fg2_length * cos_alpha , fg2_length * sin_alpha , 0);
 
-  DenseMatrix Fx(3, 1);
-  Fx << locp3[0] - locp2[0],
+  const double Fx[3] = { locp3[0] - locp2[0],
     locp1[0] - locp3[0],
-    locp2[0] - locp1[0];
+    locp2[0] - locp1[0] };
 
-  DenseMatrix Fy(3, 1);
-  Fy << locp3[1] - locp2[1],
+  const double Fy[3] = { locp3[1] - locp2[1],
     locp1[1] - locp3[1],
-    locp2[1] - locp1[1];
+    locp2[1] - locp1[1] };
 
   Vector centroid = (locp1 + locp2 + locp3) / 3;
-  DenseMatrix loc_radpt_x(1, 7);
-  DenseMatrix loc_radpt_y(1, 7);
-  loc_radpt_x(0,0) = centroid[0];
-  loc_radpt_y(0,0) = centroid[1];
+  double loc_radpt_x[7];
+  double loc_radpt_y[7];
+  loc_radpt_x[0] = centroid[0];
+  loc_radpt_y[0] = centroid[1];
   Vector temp = (1-s) * centroid;
-  loc_radpt_x(0,1) = temp[0] + locp1[0]*s;
-  loc_radpt_y(0,1) = temp[1] + locp1[1]*s;
-  loc_radpt_x(0,2) = temp[0] + locp2[0]*s;
-  loc_radpt_y(0,2) = temp[1] + locp2[1]*s;
-  loc_radpt_x(0,3) = temp[0] + locp3[0]*s;
-  loc_radpt_y(0,3) = temp[1] + locp3[1]*s;
+  loc_radpt_x[1] = temp[0] + locp1[0]*s;
+  loc_radpt_y[1] = temp[1] + locp1[1]*s;
+  loc_radpt_x[2] = temp[0] + locp2[0]*s;
+  loc_radpt_y[2] = temp[1] + locp2[1]*s;
+  loc_radpt_x[3] = temp[0] + locp3[0]*s;
+  loc_radpt_y[3] = temp[1] + locp3[1]*s;
   temp = (1-r) * centroid;
-  loc_radpt_x(0,4) = temp[0] + locp1[0]*r;
-  loc_radpt_y(0,4) = temp[1] + locp1[1]*r;
-  loc_radpt_x(0,5) = temp[0] + locp2[0]*r;
-  loc_radpt_y(0,5) = temp[1] + locp2[1]*r;
-  loc_radpt_x(0,6) = temp[0] + locp3[0]*r;
-  loc_radpt_y(0,6) = temp[1] + locp3[1]*r;
-
-  auto A = (0.5/area) * (Fy * loc_radpt_x - Fx * loc_radpt_y);
+  loc_radpt_x[4] = temp[0] + locp1[0]*r;
+  loc_radpt_y[4] = temp[1] + locp1[1]*r;
+  loc_radpt_x[5] = temp[0] + locp2[0]*r;
+  loc_radpt_y[5] = temp[1] + locp2[1]*r;
+  loc_radpt_x[6] = temp[0] + locp3[0]*r;
+  loc_radpt_y[6] = temp[1] + locp3[1]*r;
 
-  DenseMatrix ones(1, 7, 1.0);
-  DenseMatrix E(3, 1);
   /*
+  cruse_weights = E*ones(1,7) - (0.5/area)*(Fy*loc_radpt_x - Fx*loc_radpt_y)
   E is a 1X3 matrix: [1st vertex  ;  2nd vertex  ;  3rd vertex]
   E = [1/3 ; 1/3 ; 1/3] + (0.5/area)*(Fy*xmid - Fx*ymid);
   but there is no need to compute the E because by our choice of the
   local coordinates, it is easy to show that the E is always [1 ; 0 ; 0]!
   */
-  E << 1,0,0;
-  cruse_weights = (E * ones) - A;
+  const double E[3] = { 1, 0, 0 };
+  for (int i=0; i<3; i++)
+    for (int j=0; j<7; j++)
+      cruse_weights[i][j] = E[i] - (0.5/area) * (Fy[i]*loc_radpt_x[j] - Fx[i]*loc_radpt_y[j]);
 }
 
 void BuildBEMatrixBase::get_g_coef(
@@ -242,28 +260,28 @@ void BuildBEMatrixBase::get_g_coef(
   double s,
   double r,
   const Vector& centroid,
-  DenseMatrix& g_coef)
+  double (&g_coef)[7])
 {
   // Inputs: p1,p2,p3= cartesian coordiantes of the triangle vertices ; op= Observation Point
   // Output: g_coef = G Values (Coefficients) at 7 Radon's points = 1/r
   Vector radpt = centroid - op;
-  g_coef(0,0) = 1 / radpt.length();
+  g_coef[0] = 1 / radpt.length();
 
   Vector temp = centroid * (1-s) - op;
   radpt = temp + p1 * s;
-  g_coef(0,1) = 1 / radpt.length();
+  g_coef[1] = 1 / radpt.length();
   radpt = temp + p2 * s;
-  g_coef(0,2) = 1 / radpt.length();
+  g_coef[2] = 1 / radpt.length();
   radpt = temp + p3 * s;
-  g_coef(0,3) = 1 / radpt.length();
+  g_coef[3] = 1 / radpt.length();
 
   temp = centroid * (1-r) - op;
   radpt = temp + p1 * r;
-  g_coef(0,4) = 1 / radpt.length();
+  g_coef[4] = 1 / radpt.length();
   radpt = temp + p2 * r;
-  g_coef(0,5) = 1 / radpt.length();
+  g_coef[5] = 1 / radpt.length();
   radpt = temp + p3 * r;
-  g_coef(0,6) = 1 / radpt.length();
+  g_coef[6] = 1 / radpt.length();
 }
 
 void BuildBEMatrixBase::bem_sing(
@@ -271,14 +289,14 @@ void BuildBEMatrixBase::bem_sing(
   const Vector& p2,
   const Vector& p3,
   unsigned int op_n,
-  DenseMatrix& g_values)
+  double (&g_values)[3])
 {
   /*
   This is Jeroen's method, converted from his Matlab code, for dealing with weightings corresponding to singular triangles
   */
   Vector A,B,C,P,BC,BA,AC,AP;
-  DenseMatrix WAPB(3,1);
-  DenseMatrix WAPC(3,1);
+  double WAPB[3];
+  double WAPC[3];
   int one=0,two=1,three=2;
 
   switch(op_n)
@@ -314,44 +332,44 @@ void BuildBEMatrixBase::bem_sing(
   {
     a=lAP; b=lBP; c=lAB;
     log_term=log( (b+c)/a );
-    WAPB(0,0)=a/2 * log_term;
+    WAPB[0]=a/2 * log_term;
     w=1-RL;
-    WAPB(1,0)=a* (( a-c)*(-1+w) + b*w*log_term )/(2*b);
+    WAPB[1]=a* (( a-c)*(-1+w) + b*w*log_term )/(2*b);
     w=RL;
-    WAPB(2,0)=a*w *( a-c  +  b*log_term )/(2*b);
+    WAPB[2]=a*w *( a-c  +  b*log_term )/(2*b);
   }
   else
   {
-    WAPB(0,0)=0; WAPB(1,0)=0; WAPB(2,0)=0;
+    WAPB[0]=0; WAPB[1]=0; WAPB[2]=0;
   }
 
   if(fabs(RL-1) > 0)
   {
     a = lAP; b = lCP; c = lAC;
     log_term = log( (b+c)/a );
-    WAPC(0,0)=a/2 * log_term;
+    WAPC[0]=a/2 * log_term;
     w = 1-RL;
-    WAPC(1,0)=a*w *( a-c  +  b*log_term )/(2*b);
+    WAPC[1]=a*w *( a-c  +  b*log_term )/(2*b);
     w = RL;
-    WAPC(2,0)=a* (( a-c)*(-1+w) + b*w*log_term )/(2*b);
+    WAPC[2]=a* (( a-c)*(-1+w) + b*w*log_term )/(2*b);
   }
   else
   {
-    WAPC(0,0)=0; WAPC(1,0)=0; WAPC(2,0)=0;
+    WAPC[0]=0; WAPC[1]=0; WAPC[2]=0;
   }
 
   if(RL<0)
   {
-    WAPB(0,0)*=-1.0; WAPB(1,0)*=-1.0; WAPB(2,0)*=-1.0;
+    WAPB[0]*=-1.0; WAPB[1]*=-1.0; WAPB[2]*=-1.0;
   }
   if(RL>1)
   {
-    WAPC(0,0)*=-1.0; WAPC(1,0)*=-1.0; WAPC(2,0)*=-1.0;
+    WAPC[0]*=-1.0; WAPC[1]*=-1.0; WAPC[2]*=-1.0;
   }
 
-  g_values(one,0) = WAPB(0,0) + WAPC(0,0);
-  g_values(two,0) = WAPB(1,0) + WAPC(1,0);
-  g_values(three,0) = WAPB(2,0) + WAPC(2,0);
+  g_values[one] = WAPB[0] + WAPC[0];
+  g_values[two] = WAPB[1] + WAPC[1];
+  g_values[three] = WAPB[2] + WAPC[2];
 }
 
 void BuildBEMatrixBase::get_auto_g(
@@ -359,10 +377,10 @@ void BuildBEMatrixBase::get_auto_g(
   const Vector& p2,
   const Vector& p3,
   unsigned int op_n,
-  DenseMatrix& g_values,
+  double (&g_values)[3],
   double s,
   double r,
-  DenseMatrix& R_W)
+  const double (&R_W)[7])
 {
   /*
   A routine to solve the Auto G-parameter integral for a triangle from
@@ -392,21 +410,21 @@ void BuildBEMatrixBase::get_auto_g(
   {
   case 0:
     op = p1;
-    g_values(0,0) = get_new_auto_g(op, p5, p4) + do_radon_g(p5, ctroid, p4, op, s, r, R_W);
-    g_values(1,0) = do_radon_g(p2, p6, p5, op, s, r, R_W) + do_radon_g(p5, p6, ctroid, op, s, r, R_W);
-    g_values(2,0) = do_radon_g(p3, p4, p6, op, s, r, R_W) + do_radon_g(p4, ctroid, p6, op, s, r, R_W);
+    g_values[0] = get_new_auto_g(op, p5, p4) + do_radon_g(p5, ctroid, p4, op, s, r, R_W);
+    g_values[1] = do_radon_g(p2, p6, p5, op, s, r, R_W) + do_radon_g(p5, p6, ctroid, op, s, r, R_W);
+    g_values[2] = do_radon_g(p3, p4, p6, op, s, r, R_W) + do_radon_g(p4, ctroid, p6, op, s, r, R_W);
     break;
   case 1:
     op = p2;
-    g_values(0,0) = do_radon_g(p1, p5, p4, op, s, r, R_W) + do_radon_g(p5, ctroid, p4, op, s, r, R_W);
-    g_values(1,0) = get_new_auto_g(op, p6, p5) + do_radon_g(p5, p6, ctroid, op, s, r, R_W);
-    g_values(2,0) = do_radon_g(p3, p4, p6, op, s, r, R_W) + do_radon_g(p4, ctroid, p6, op, s, r, R_W);
+    g_values[0] = do_radon_g(p1, p5, p4, op, s, r, R_W) + do_radon_g(p5, ctroid, p4, op, s, r, R_W);
+    g_values[1] = get_new_auto_g(op, p6, p5) + do_radon_g(p5, p6, ctroid, op, s, r, R_W);
+    g_values[2] = do_radon_g(p3, p4, p6, op, s, r, R_W) + do_radon_g(p4, ctroid, p6, op, s, r, R_W);
     break;
   case 2:
     op = p3;
-    g_values(0,0) = do_radon_g(p1, p5, p4, op, s, r, R_W) + do_radon_g(p5, ctroid, p4, op, s, r, R_W);
-    g_values(1,0) = do_radon_g(p2, p6, p5, op, s, r, R_W) + do_radon_g(p5, p6, ctroid, op, s, r, R_W);
-    g_values(2,0) = get_new_auto_g(op, p4, p6) + do_radon_g(p4, ctroid, p6, op, s, r, R_W);
+    g_values[0] = do_radon_g(p1, p5, p4, op, s, r, R_W) + do_radon_g(p5, ctroid, p4, op, s, r, R_W);
+    g_values[1] = do_radon_g(p2, p6, p5, op, s, r, R_W) + do_radon_g(p5, p6, ctroid, op, s, r, R_W);
+    g_values[2] = get_new_auto_g(op, p4, p6) + do_radon_g(p4, ctroid, p6, op, s, r, R_W);
     break;
   }
 }
@@ -472,7 +490,7 @@ double BuildBEMatrixBase::do_radon_g(
   const Vector& op,
   double s,
   double r,
-  DenseMatrix& R_W)
+  const double (&R_W)[7])
 {
   //  Inputs: p1,p2,p3= cartesian coordiantes of the triangle vertices ; op= Observation Point
   //  Output: g2 = G value for the triangle for "auto_g"
@@ -480,11 +498,11 @@ double BuildBEMatrixBase::do_radon_g(
 
   Vector centroid = (p1 + p2 + p3) / 3;
 
-  DenseMatrix g_coef(1, 7);
+  double g_coef[7];
   get_g_coef(p1, p2, p3, op, s, r, centroid, g_coef);
 
   double g2 = 0;
-  for (int i=0; i<7; i++)   g2 = g2 + g_coef(0,i)*R_W(0,i);
+  for (int i=0; i<7; i++)   g2 = g2 + g_coef[i]*R_W[i];
 
   Vector aV = Cross(p2 - p1, p3 - p2)*0.5;
 
@@ -510,8 +528,133 @@ public:
   double,
   double,
   const std::vector<double>& );
+
+  static void make_cross_G_lowrank_compute(VMesh* hsurf1, VMesh* hsurf2, LowRankBlock& cross_G,
+    double in_cond, double out_cond, const std::vector<double>& avInn, double tolerance);
+
+  static void make_cross_P_lowrank_compute(VMesh* hsurf1, VMesh* hsurf2, LowRankBlock& cross_P,
+    double in_cond, double out_cond, double tolerance);
+
+private:
+  /// Node positions and triangles of a surface, copied out of the VMesh once
+  /// so that the node x triangle loops make no virtual calls.
+  struct FlatSurface
+  {
+    explicit FlatSurface(VMesh* hsurf);
+
+    std::vector<Vector> points;
+    std::vector<std::array<index_type, 3> > triangles;
+  };
+
+  /// Weights and offsets of the 7 point Radon rule
+  struct RadonRule
+  {
+    RadonRule();
+
+    double weights[7];
+    double s;
+    double r;
+  };
+
+  /// A source triangle with its Cruse weights for the Radon points
+  struct CruseTriangle
+  {
+    Vector p1, p2, p3, centroid;
+    double area;
+    double weights[3][7];
+  };
+
+  static void make_cruse_triangles(const FlatSurface& surf, const std::vector<double>& areas,
+    const RadonRule& radon, std::vector<CruseTriangle>& cruse);
+
+  static void get_radon_g(const CruseTriangle& tri, const Vector& op,
+    const RadonRule& radon, double (&g_values)[3]);
+
+  /// For every node, the triangles containing it and the corner it occupies
+  typedef std::vector<std::vector<std::pair<size_t, int> > > NodeTriangles;
+
+  static void make_node_triangles(const FlatSurface& surf, NodeTriangles& nodeTriangles);
+
+  /// Fills one full row or column of the block being approximated
+  typedef std::function<void(size_t, std::vector<double>&)> EntriesFunction;
+
+  static void adaptive_cross_approximation(size_t rows, size_t cols,
+    const EntriesFunction& getRow, const EntriesFunction& getCol,
+    double tolerance, LowRankBlock& block);
+
+  // The assembly loops are split over the rows, i.e. the observation nodes,
+  // so every thread writes its own part of the matrix.
+  static const size_t rowGrain = 64;
 };
 
+BuildBEMatrixBaseCompute::FlatSurface::FlatSurface(VMesh* hsurf)
+{
+  VMesh::Node::size_type nnodes;
+  hsurf->size(nnodes);
+  points.reserve(nnodes);
+  for (index_type i = 0; i < nnodes; ++i)
+    points.push_back(Vector(hsurf->get_point(VMesh::Node::index_type(i))));
+
+  VMesh::Node::array_type nodes;
+  VMesh::Face::iterator fi, fie;
+  hsurf->begin(fi); hsurf->end(fie);
+  for (; fi != fie; ++fi)
+  {
+    hsurf->get_nodes(nodes, *fi);
+    triangles.push_back({{ nodes[0], nodes[1], nodes[2] }});
+  }
+}
+
+BuildBEMatrixBaseCompute::RadonRule::RadonRule()
+{
+  double sqrt15 = sqrt(15.0);
+  weights[0] = 9.0/40.0;
+  weights[1] = (155 + sqrt15) / 1200;
+  weights[2] = weights[1];
+  weights[3] = weights[1];
+  weights[4] = (155 - sqrt15) / 1200;
+  weights[5] = weights[4];
+  weights[6] = weights[4];
+
+  s = (1 - sqrt15) / 7;
+  r = (1 + sqrt15) / 7;
+}
+
+void BuildBEMatrixBaseCompute::make_cruse_triangles(const FlatSurface& surf,
+  const std::vector<double>& areas, const RadonRule& radon, std::vector<CruseTriangle>& cruse)
+{
+  cruse.resize(surf.triangles.size());
+  Parallel::For(0, cruse.size(), 1024, [&](size_t begin, size_t end)
+  {
+    for (size_t t = begin; t < end; ++t)
+    {
+      const auto& nodes = surf.triangles[t];
+      CruseTriangle& tri = cruse[t];
+      tri.p1 = surf.points[nodes[0]];
+      tri.p2 = surf.points[nodes[1]];
+      tri.p3 = surf.points[nodes[2]];
+      tri.centroid = (tri.p1 + tri.p2 + tri.p3) / 3.0;
+      tri.area = areas[t];
+      get_cruse_weights(tri.p1, tri.p2, tri.p3, radon.s, radon.r, tri.area, tri.weights);
+    }
+  });
+}
+
+void BuildBEMatrixBaseCompute::get_radon_g(const CruseTriangle& tri, const Vector& op,
+  const RadonRule& radon, double (&g_values)[3])
+{
+  double g_coef[7];
+  get_g_coef(tri.p1, tri.p2, tri.p3, op, radon.s, radon.r, tri.centroid, g_coef);
+  for (int i=0; i<7; i++)  g_coef[i] *= radon.weights[i];
+
+  for (int i=0; i<3; ++i)
+  {
+    double g = 0;
+    for (int j=0; j<7; j++)  g += tri.weights[i][j] * g_coef[j];
+    g_values[i] = tri.area * g;
+  }
+}
+
 void BuildBEMatrixBase::make_auto_G_allocate(VMesh* hsurf, DenseMatrixHandle &h_GG_)
 {
   auto nnodes = numNodes(hsurf);
@@ -532,66 +675,32 @@ void BuildBEMatrixBaseCompute::make_auto_G_compute(VMesh* hsurf, MatrixType& aut
   //const double mult = 1/(2*M_PI)*((out_cond - in_cond)/op_cond);  // op_cond=out_cond for all the surfaces but the outermost surface which in op_cond=in_cond
   const double mult = 1/(4*M_PI)*(out_cond - in_cond);  // op_cond=out_cond for all the surfaces but the outermost surface which in op_cond=in_cond
 
-  VMesh::Node::array_type nodes;
-
-  VMesh::Node::iterator ni, nie;
-  VMesh::Face::iterator fi, fie;
-  DenseMatrix cruse_weights(3, 7);
-  DenseMatrix g_coef(1, 7);
-  DenseMatrix R_W(1,7); // Radon Points Weights
-  DenseMatrix temp(1,7);
-  DenseMatrix g_values(3, 1);
-
-  double area;
-
-  double sqrt15 = sqrt(15.0);
-  //R_W(0,0) = 9/40; // <- Burak! FIX ME!
-  R_W(0,0) = 9.0/40.0;
-  R_W(0,1) = (155 + sqrt15) / 1200;
-  R_W(0,2) = R_W(0,1);
-  R_W(0,3) = R_W(0,1);
-  R_W(0,4) = (155 - sqrt15) / 1200;
-  R_W(0,5) = R_W(0,4);
-  R_W(0,6) = R_W(0,4);
-
-  double s = (1 - sqrt15) / 7;
-  double r = (1 + sqrt15) / 7;
+  const FlatSurface surf(hsurf);
+  const RadonRule radon;
+  std::vector<CruseTriangle> cruse;
+  make_cruse_triangles(surf, avInn, radon, cruse);
 
-
-  hsurf->begin(fi); hsurf->end(fie);
-  for (; fi != fie; ++fi)
-  { //! find contributions from every triangle
-    hsurf->get_nodes(nodes, *fi);
-    Vector p1(hsurf->get_point(nodes[0]));
-    Vector p2(hsurf->get_point(nodes[1]));
-    Vector p3(hsurf->get_point(nodes[2]));
-
-    area = avInn[*fi];
-
-    get_cruse_weights(p1, p2, p3, s, r, area, cruse_weights);
-    Vector centroid = (p1 + p2 + p3) / 3.0;
-    hsurf->begin(ni); hsurf->end(nie);
-    for (; ni != nie; ++ni)
-    { //! for every node
-      VMesh::Node::index_type ppi = *ni;
-      Vector op(hsurf->get_point(ppi));
-
-      if (ppi == nodes[0])       bem_sing(p1, p2, p3, 0, g_values);
-      else if (ppi == nodes[1])       bem_sing(p1, p2, p3, 1, g_values);
-      else if (ppi == nodes[2])       bem_sing(p1, p2, p3, 2, g_values);
-      else
-      {
-        get_g_coef(p1, p2, p3, op, s, r, centroid, g_coef);
-
-        for (int i=0; i<7; i++)  temp(0,i) = g_coef(0,i)*R_W(0,i);
-
-        g_values = area * (cruse_weights * temp.transpose());
-      } // else
-
-      for (int i=0; i<3; ++i)
-        auto_G(static_cast<uint64_t>(ppi), static_cast<uint64_t>(nodes[i]))+=g_values(i,0)*mult;
+  Parallel::For(0, surf.points.size(), rowGrain, [&](size_t rbegin, size_t rend)
+  {
+    double g_values[3];
+    for (size_t t = 0; t < cruse.size(); ++t)
+    { //! find contributions from every triangle
+      const auto& nodes = surf.triangles[t];
+      const CruseTriangle& tri = cruse[t];
+      for (size_t row = rbegin; row < rend; ++row)
+      { //! for every node
+        const index_type ppi = static_cast<index_type>(row);
+
+        if (ppi == nodes[0])       bem_sing(tri.p1, tri.p2, tri.p3, 0, g_values);
+        else if (ppi == nodes[1])       bem_sing(tri.p1, tri.p2, tri.p3, 1, g_values);
+        else if (ppi == nodes[2])       bem_sing(tri.p1, tri.p2, tri.p3, 2, g_values);
+        else get_radon_g(tri, surf.points[row], radon, g_values);
+
+        for (int i=0; i<3; ++i)
+          auto_G(ppi, nodes[i])+=g_values[i]*mult;
+      }
     }
-  }
+  });
 }
 
 void BuildBEMatrixBase::make_cross_G_allocate(VMesh* hsurf1, VMesh* hsurf2, DenseMatrixHandle &h_GG_)
@@ -613,60 +722,27 @@ void BuildBEMatrixBaseCompute::make_cross_G_compute(VMesh* hsurf1, VMesh* hsurf2
   const double mult = 1/(4*M_PI)*(out_cond - in_cond);
   //   out_cond and in_cond belong to hsurf2 and op_cond is the out_cond of hsurf1 for all the surfaces but the outermost surface which in op_cond=in_cond
 
-  VMesh::Node::array_type nodes;
-
-  VMesh::Node::iterator  ni, nie;
-  VMesh::Face::iterator  fi, fie;
-
-  DenseMatrix cruse_weights(3, 7);
-  DenseMatrix g_coef(1, 7);
-  DenseMatrix R_W(1,7); // Radon Points Weights
-  DenseMatrix temp(1,7);
-  DenseMatrix g_values(3, 1);
-
-  double area;
-
-  double sqrt15 = sqrt(15.0);
-  //R_W(0,0) = 9/40; // <- Burak! FIX ME!
-  R_W(0,0) = 9.0/40.0;
-  R_W(0,1) = (155 + sqrt15) / 1200;
-  R_W(0,2) = R_W(0,1);
-  R_W(0,3) = R_W(0,1);
-  R_W(0,4) = (155 - sqrt15) / 1200;
-  R_W(0,5) = R_W(0,4);
-  R_W(0,6) = R_W(0,4);
-
-  double s = (1 - sqrt15) / 7;
-  double r = (1 + sqrt15) / 7;
-
-  hsurf2->begin(fi); hsurf2->end(fie);
-  for (; fi != fie; ++fi)
-  { //! find contributions from every triangle
-    hsurf2->get_nodes(nodes, *fi);
-    Vector p1(hsurf2->get_point(nodes[0]));
-    Vector p2(hsurf2->get_point(nodes[1]));
-    Vector p3(hsurf2->get_point(nodes[2]));
-
-    area = avInn[*fi];
-
-    get_cruse_weights(p1, p2, p3, s, r, area, cruse_weights);
-    Vector centroid = (p1 + p2 + p3) / 3.0;
-
-    hsurf1->begin(ni); hsurf1->end(nie);
-    for (; ni != nie; ++ni)
-    { //! for every node
-      VMesh::Node::index_type ppi = *ni;
-      Vector op(hsurf1->get_point(ppi));
-      get_g_coef(p1, p2, p3, op, s, r, centroid, g_coef);
-
-      for (int i=0; i<7; i++)  temp(0,i) = g_coef(0,i)*R_W(0,i);
+  const FlatSurface surf1(hsurf1);
+  const FlatSurface surf2(hsurf2);
+  const RadonRule radon;
+  std::vector<CruseTriangle> cruse;
+  make_cruse_triangles(surf2, avInn, radon, cruse);
 
-      g_values = area * (cruse_weights * temp.transpose());
+  Parallel::For(0, surf1.points.size(), rowGrain, [&](size_t rbegin, size_t rend)
+  {
+    double g_values[3];
+    for (size_t t = 0; t < cruse.size(); ++t)
+    { //! find contributions from every triangle
+      const auto& nodes = surf2.triangles[t];
+      for (size_t row = rbegin; row < rend; ++row)
+      { //! for every node
+        get_radon_g(cruse[t], surf1.points[row], radon, g_values);
 
-      for (int i=0; i<3; ++i)
-        cross_G(static_cast<uint64_t>(ppi), static_cast<uint64_t>(nodes[i]))+=g_values(i,0)*mult;
+        for (int i=0; i<3; ++i)
+          cross_G(static_cast<index_type>(row), nodes[i])+=g_values[i]*mult;
+      }
     }
-  }
+  });
 }
 
 void BuildBEMatrixBase::make_cross_P_allocate(VMesh* hsurf1, VMesh* hsurf2, DenseMatrixHandle &h_PP_)
@@ -686,34 +762,219 @@ void BuildBEMatrixBaseCompute::make_cross_P_compute(VMesh* hsurf1, VMesh* hsurf2
 {
   const double mult = 1/(4*M_PI)*(out_cond - in_cond);
   //   out_cond and in_cond belong to hsurf2 and op_cond is the out_cond of hsurf1 for all the surfaces but the outermost surface which in op_cond=in_cond
-  VMesh::Node::array_type nodes;
-  DenseMatrix coef(1, 3);
-  int i;
 
-  VMesh::Node::iterator  ni, nie;
-  VMesh::Face::iterator  fi, fie;
+  const FlatSurface surf1(hsurf1);
+  const FlatSurface surf2(hsurf2);
+
+  Parallel::For(0, surf1.points.size(), rowGrain, [&](size_t rbegin, size_t rend)
+  {
+    double coef[3];
+    for (size_t row = rbegin; row < rend; ++row)
+    { //! for every node
+      const index_type ppi = static_cast<index_type>(row);
+      const Vector& pp = surf1.points[row];
+
+      for (const auto& nodes : surf2.triangles)
+      { //! find contributions from every triangle
+        Vector v1 = surf2.points[nodes[0]] - pp;
+        Vector v2 = surf2.points[nodes[1]] - pp;
+        Vector v3 = surf2.points[nodes[2]] - pp;
+
+        getOmega(v1, v2, v3, coef);
+
+        for (int i=0; i<3; ++i)
+          cross_P(ppi, nodes[i])-=coef[i]*mult;
+      }
+    }
+  });
+}
 
-  hsurf1->begin(ni); hsurf1->end(nie);
-  for (; ni != nie; ++ni){ //! for every node
-    VMesh::Node::index_type ppi = *ni;
-    Point pp = hsurf1->get_point(ppi);
+void BuildBEMatrixBase::make_cross_G_lowrank(VMesh* hsurf1, VMesh* hsurf2, LowRankBlock& cross_G,
+  double in_cond, double out_cond, const std::vector<double>& avInn, double tolerance)
+{
+  BuildBEMatrixBaseCompute::make_cross_G_lowrank_compute(hsurf1, hsurf2, cross_G, in_cond, out_cond, avInn, tolerance);
+}
 
-    hsurf2->begin(fi); hsurf2->end(fie);
-    for (; fi != fie; ++fi){ //! find contributions from every triangle
+void BuildBEMatrixBase::make_cross_P_lowrank(VMesh* hsurf1, VMesh* hsurf2, LowRankBlock& cross_P,
+  double in_cond, double out_cond, double tolerance)
+{
+  BuildBEMatrixBaseCompute::make_cross_P_lowrank_compute(hsurf1, hsurf2, cross_P, in_cond, out_cond, tolerance);
+}
 
-      hsurf2->get_nodes(nodes, *fi);
-      Vector v1 = hsurf2->get_point(nodes[0]) - pp;
-      Vector v2 = hsurf2->get_point(nodes[1]) - pp;
-      Vector v3 = hsurf2->get_point(nodes[2]) - pp;
+void BuildBEMatrixBaseCompute::make_node_triangles(const FlatSurface& surf, NodeTriangles& nodeTriangles)
+{
+  nodeTriangles.assign(surf.points.size(), {});
+  for (size_t t = 0; t < surf.triangles.size(); ++t)
+    for (int i = 0; i < 3; ++i)
+      nodeTriangles[surf.triangles[t][i]].emplace_back(t, i);
+}
+
+void BuildBEMatrixBaseCompute::adaptive_cross_approximation(size_t rows, size_t cols,
+  const EntriesFunction& getRow, const EntriesFunction& getCol,
+  double tolerance, LowRankBlock& block)
+{
+  // Cross approximation with partial pivoting: every step evaluates one row and one
+  // column of the residual, so the block is never formed. The Frobenius norm of the
+  // approximation is updated incrementally and used for the stopping criterion.
+  std::vector<Eigen::VectorXd> us, vs;
+  std::vector<bool> usedRow(rows, false), usedCol(cols, false);
+  std::vector<double> entries;
+  double normSq = 0;
+  double lastTerm = 0;
+  size_t row = 0;
+  size_t numUsedRows = 0;
+
+  block.estimatedError = 0;
+  while (numUsedRows < rows && us.size() < std::min(rows, cols))
+  {
+    usedRow[row] = true;
+    ++numUsedRows;
 
-      getOmega(v1, v2, v3, coef);
+    getRow(row, entries);
+    Eigen::VectorXd v = Eigen::Map<Eigen::VectorXd>(entries.data(), cols);
+    for (size_t k = 0; k < us.size(); ++k)
+      v -= us[k](row) * vs[k];
 
-      for (i=0; i<3; ++i)
-        cross_P(static_cast<uint64_t>(ppi), static_cast<uint64_t>(nodes[i]))-=coef(0,i)*mult;
+    size_t col = cols;
+    for (size_t j = 0; j < cols; ++j)
+      if (!usedCol[j] && (col == cols || std::abs(v(j)) > std::abs(v(col))))
+        col = j;
+
+    if (col == cols || v(col) == 0.0)
+    {
+      // this row is already reproduced exactly; try the next unused one
+      row = std::find(usedRow.begin(), usedRow.end(), false) - usedRow.begin();
+      continue;
     }
+    usedCol[col] = true;
+    v /= v(col);
+
+    getCol(col, entries);
+    Eigen::VectorXd u = Eigen::Map<Eigen::VectorXd>(entries.data(), rows);
+    for (size_t k = 0; k < us.size(); ++k)
+      u -= vs[k](col) * us[k];
+
+    const double uNorm = u.norm();
+    const double vNorm = v.norm();
+    for (size_t k = 0; k < us.size(); ++k)
+      normSq += 2 * u.dot(us[k]) * v.dot(vs[k]);
+    normSq += uNorm * uNorm * vNorm * vNorm;
+    lastTerm = uNorm * vNorm;
+
+    us.push_back(u);
+    vs.push_back(v);
+
+    block.estimatedError = normSq > 0 ? lastTerm / std::sqrt(normSq) : 0;
+    if (block.estimatedError <= tolerance)
+      break;
+
+    row = rows;
+    for (size_t i = 0; i < rows; ++i)
+      if (!usedRow[i] && (row == rows || std::abs(u(i)) > std::abs(u(row))))
+        row = i;
+    if (row == rows)
+      break;
+  }
+
+  block.U.resize(rows, us.size());
+  block.V.resize(cols, vs.size());
+  for (size_t k = 0; k < us.size(); ++k)
+  {
+    block.U.col(k) = us[k];
+    block.V.col(k) = vs[k];
   }
 }
 
+void BuildBEMatrixBaseCompute::make_cross_G_lowrank_compute(VMesh* hsurf1, VMesh* hsurf2, LowRankBlock& cross_G,
+  double in_cond, double out_cond, const std::vector<double>& avInn, double tolerance)
+{
+  const double mult = 1/(4*M_PI)*(out_cond - in_cond);
+
+  const FlatSurface surf1(hsurf1);
+  const FlatSurface surf2(hsurf2);
+  const RadonRule radon;
+  std::vector<CruseTriangle> cruse;
+  make_cruse_triangles(surf2, avInn, radon, cruse);
+  NodeTriangles nodeTriangles;
+  make_node_triangles(surf2, nodeTriangles);
+
+  auto getRow = [&](size_t row, std::vector<double>& entries)
+  {
+    entries.assign(surf2.points.size(), 0.0);
+    double g_values[3];
+    for (size_t t = 0; t < cruse.size(); ++t)
+    {
+      get_radon_g(cruse[t], surf1.points[row], radon, g_values);
+      for (int i=0; i<3; ++i)
+        entries[surf2.triangles[t][i]] += g_values[i]*mult;
+    }
+  };
+
+  auto getCol = [&](size_t col, std::vector<double>& entries)
+  {
+    entries.assign(surf1.points.size(), 0.0);
+    Parallel::For(0, surf1.points.size(), rowGrain, [&](size_t rbegin, size_t rend)
+    {
+      double g_values[3];
+      for (size_t row = rbegin; row < rend; ++row)
+        for (const auto& tc : nodeTriangles[col])
+        {
+          get_radon_g(cruse[tc.first], surf1.points[row], radon, g_values);
+          entries[row] += g_values[tc.second]*mult;
+        }
+    });
+  };
+
+  adaptive_cross_approximation(surf1.points.size(), surf2.points.size(), getRow, getCol, tolerance, cross_G);
+}
+
+void BuildBEMatrixBaseCompute::make_cross_P_lowrank_compute(VMesh* hsurf1, VMesh* hsurf2, LowRankBlock& cross_P,
+  double in_cond, double out_cond, double tolerance)
+{
+  const double mult = 1/(4*M_PI)*(out_cond - in_cond);
+
+  const FlatSurface surf1(hsurf1);
+  const FlatSurface surf2(hsurf2);
+  NodeTriangles nodeTriangles;
+  make_node_triangles(surf2, nodeTriangles);
+
+  auto omega = [&](size_t row, size_t t, double (&coef)[3])
+  {
+    const Vector& pp = surf1.points[row];
+    const auto& nodes = surf2.triangles[t];
+    getOmega(surf2.points[nodes[0]] - pp, surf2.points[nodes[1]] - pp, surf2.points[nodes[2]] - pp, coef);
+  };
+
+  auto getRow = [&](size_t row, std::vector<double>& entries)
+  {
+    entries.assign(surf2.points.size(), 0.0);
+    double coef[3];
+    for (size_t t = 0; t < surf2.triangles.size(); ++t)
+    {
+      omega(row, t, coef);
+      for (int i=0; i<3; ++i)
+        entries[surf2.triangles[t][i]] -= coef[i]*mult;
+    }
+  };
+
+  auto getCol = [&](size_t col, std::vector<double>& entries)
+  {
+    entries.assign(surf1.points.size(), 0.0);
+    Parallel::For(0, surf1.points.size(), rowGrain, [&](size_t rbegin, size_t rend)
+    {
+      double coef[3];
+      for (size_t row = rbegin; row < rend; ++row)
+        for (const auto& tc : nodeTriangles[col])
+        {
+          omega(row, tc.first, coef);
+          entries[row] -= coef[tc.second]*mult;
+        }
+    });
+  };
+
+  adaptive_cross_approximation(surf1.points.size(), surf2.points.size(), getRow, getCol, tolerance, cross_P);
+}
+
 void BuildBEMatrixBase::make_auto_P_allocate(VMesh* hsurf, DenseMatrixHandle &h_PP_)
 {
   auto nnodes = numNodes(hsurf);
@@ -738,43 +999,36 @@ void BuildBEMatrixBaseCompute::make_auto_P_compute(VMesh* hsurf, MatrixType& aut
   auto nnodes = auto_P.rows();
   const double mult = 1/(4*M_PI)*(out_cond - in_cond);
 
-  VMesh::Node::array_type nodes;
-  DenseMatrix coef(1, 3);
-
-  VMesh::Node::iterator ni, nie;
-  VMesh::Face::iterator fi, fie;
-
-  unsigned int i;
-
-  hsurf->begin(ni); hsurf->end(nie);
-
-  for (; ni != nie; ++ni)
-  { //! for every node
-    VMesh::Node::index_type ppi = *ni;
-    Point pp = hsurf->get_point(ppi);
+  const FlatSurface surf(hsurf);
 
-    hsurf->begin(fi); hsurf->end(fie);
+  Parallel::For(0, surf.points.size(), rowGrain, [&](size_t rbegin, size_t rend)
+  {
+    double coef[3];
+    for (size_t row = rbegin; row < rend; ++row)
+    { //! for every node
+      const index_type ppi = static_cast<index_type>(row);
+      const Vector& pp = surf.points[row];
 
-    for (; fi != fie; ++fi)
-    { //! find contributions from every triangle
-      hsurf->get_nodes(nodes, *fi);
-      if (ppi!=nodes[0] && ppi!=nodes[1] && ppi!=nodes[2])
-      {
-        Vector v1 = hsurf->get_point(nodes[0]) - pp;
-        Vector v2 = hsurf->get_point(nodes[1]) - pp;
-        Vector v3 = hsurf->get_point(nodes[2]) - pp;
+      for (const auto& nodes : surf.triangles)
+      { //! find contributions from every triangle
+        if (ppi!=nodes[0] && ppi!=nodes[1] && ppi!=nodes[2])
+        {
+          Vector v1 = surf.points[nodes[0]] - pp;
+          Vector v2 = surf.points[nodes[1]] - pp;
+          Vector v3 = surf.points[nodes[2]] - pp;
 
-        getOmega(v1, v2, v3, coef);
+          getOmega(v1, v2, v3, coef);
 
-        for (i=0; i<3; ++i)
-          auto_P(static_cast<uint64_t>(ppi), static_cast<uint64_t>(nodes[i]))-=coef(0,i)*mult;
+          for (int i=0; i<3; ++i)
+            auto_P(ppi, nodes[i])-=coef[i]*mult;
+        }
       }
     }
-  }
+  });
 
   //! accounting for autosolid angle
   auto sumOfRows = auto_P.rowwise().sum().eval();
-  for (i=0; i<nnodes; ++i)
+  for (int i=0; i<nnodes; ++i)
   {
     auto_P(i,i) = out_cond - sumOfRows(i);
   }
@@ -942,10 +1196,17 @@ public:
 class SurfaceToSurface : public BEMAlgoImpl, public BuildBEMatrixBaseCompute
 {
 public:
+  explicit SurfaceToSurface(double crossBlockTolerance) : crossBlockTolerance_(crossBlockTolerance) {}
   MatrixHandle compute(const bemfield_vector& fields) const override;
+private:
+  /// compute() with the cross-surface blocks kept in low rank form
+  MatrixHandle compute_low_rank(const bemfield_vector& fields, const std::vector<int>& sourcefieldindices,
+    const std::vector<int>& measurementfieldindices) const;
+
+  double crossBlockTolerance_;
 };
 
-BEMAlgoPtr BEMAlgoImplFactory::create(const bemfield_vector& fields)
+BEMAlgoPtr BEMAlgoImplFactory::create(const bemfield_vector& fields, double crossBlockTolerance)
 {
   ///////////////////////////////////////////////////////////////////////////////////////////////////
   // Check for special case where the potentials need to be evaluated at the nodes of a lead
@@ -1013,7 +1274,7 @@ BEMAlgoPtr BEMAlgoImplFactory::create(const bemfield_vector& fields)
   // if all fields are surfaces, there exists a measurement and a source surface, then use the surface-to-surface algorithm... else fail
   if (allsurfaces && hasmeasurementsurf && hassourcesurf)
   {
-    return makeShared<SurfaceToSurface>();
+    return makeShared<SurfaceToSurface>(crossBlockTolerance);
   }
   else
   {
@@ -1030,6 +1291,106 @@ static void printInfo(const DenseMatrix&, const std::string&)
 #endif
 }
 
+namespace
+{
+  void printLowRankInfo(const LowRankBlock& lowRank, const char* name, int i, int j)
+  {
+    logInfo("BEM cross {} block ({},{}): rank {}, {} of {} entries stored, estimated relative error {}",
+      name, i, j, lowRank.rank(), lowRank.compressedSize(), lowRank.denseSize(), lowRank.estimatedError);
+  }
+
+  /// A matrix split into blocks per surface, with dense blocks for a surface with
+  /// itself and low rank blocks between different surfaces. Products go block by
+  /// block, so the low rank blocks are never expanded.
+  class SurfaceBlockMatrix
+  {
+  public:
+    SurfaceBlockMatrix(const std::vector<int>& rowSizes, const std::vector<int>& colSizes) :
+      rowOffsets_(offsets(rowSizes)), colOffsets_(offsets(colSizes)) {}
+
+    size_t rows() const { return rowOffsets_.back(); }
+    size_t cols() const { return colOffsets_.back(); }
+
+    DenseMatrix::EigenBase& dense(int i, int j)
+    {
+      auto& block = dense_[std::make_pair(i, j)];
+      block = DenseMatrix::EigenBase::Zero(rowOffsets_[i + 1] - rowOffsets_[i], colOffsets_[j + 1] - colOffsets_[j]);
+      return block;
+    }
+
+    LowRankBlock& lowRank(int i, int j) { return lowRank_[std::make_pair(i, j)]; }
+
+    DenseMatrix::EigenBase multiply(const DenseMatrix::EigenBase& x) const
+    {
+      DenseMatrix::EigenBase y = DenseMatrix::EigenBase::Zero(rows(), x.cols());
+      for (const auto& b : dense_)
+        y.middleRows(rowOffsets_[b.first.first], b.second.rows()) +=
+          b.second * x.middleRows(colOffsets_[b.first.second], b.second.cols());
+      for (const auto& b : lowRank_)
+        y.middleRows(rowOffsets_[b.first.first], b.second.rows()) +=
+          b.second.multiply(x.middleRows(colOffsets_[b.first.second], b.second.cols()));
+      return y;
+    }
+
+    /// All low rank blocks as a single U*V^T of the full size
+    LowRankBlock lowRankPart() const
+    {
+      size_t rank = 0;
+      for (const auto& b : lowRank_)
+        rank += b.second.rank();
+
+      LowRankBlock part;
+      part.U = DenseMatrix::EigenBase::Zero(rows(), rank);
+      part.V = DenseMatrix::EigenBase::Zero(cols(), rank);
+      size_t k = 0;
+      for (const auto& b : lowRank_)
+      {
+        part.U.block(rowOffsets_[b.first.first], k, b.second.rows(), b.second.rank()) = b.second.U;
+        part.V.block(colOffsets_[b.first.second], k, b.second.cols(), b.second.rank()) = b.second.V;
+        k += b.second.rank();
+      }
+      return part;
+    }
+
+    /// LU factors of the dense diagonal blocks of a square block matrix
+    class DiagonalSolver
+    {
+    public:
+      explicit DiagonalSolver(const SurfaceBlockMatrix& m) : offsets_(m.rowOffsets_)
+      {
+        for (size_t i = 0; i + 1 < offsets_.size(); ++i)
+          lu_.emplace_back(m.dense_.at(std::make_pair(int(i), int(i))));
+      }
+
+      DenseMatrix::EigenBase solve(const DenseMatrix::EigenBase& b) const
+      {
+        DenseMatrix::EigenBase x(b.rows(), b.cols());
+        for (size_t i = 0; i < lu_.size(); ++i)
+          x.middleRows(offsets_[i], offsets_[i + 1] - offsets_[i]) =
+            lu_[i].solve(b.middleRows(offsets_[i], offsets_[i + 1] - offsets_[i]));
+        return x;
+      }
+
+    private:
+      std::vector<size_t> offsets_;
+      std::vector<Eigen::PartialPivLU<DenseMatrix::EigenBase> > lu_;
+    };
+
+  private:
+    static std::vector<size_t> offsets(const std::vector<int>& sizes)
+    {
+      std::vector<size_t> result(1, 0);
+      for (auto size : sizes)
+        result.push_back(result.back() + size);
+      return result;
+    }
+
+    std::vector<size_t> rowOffsets_, colOffsets_;
+    std::map<std::pair<int, int>, DenseMatrix::EigenBase> dense_;
+    std::map<std::pair<int, int>, LowRankBlock> lowRank_;
+  };
+}
+
 MatrixHandle SurfaceToSurface::compute(const bemfield_vector& fields) const
 {
   // Math for surface-to-surface BEM algorithm (based on Jeroen Stinstra's BEM Matlab code that's part of SCIRun)
@@ -1081,6 +1442,9 @@ MatrixHandle SurfaceToSurface::compute(const bemfield_vector& fields) const
     }
   }
 
+  if (crossBlockTolerance_ > 0)
+    return compute_low_rank(fields, sourcefieldindices, measurementfieldindices);
+
   std::vector<int> fieldNodeSize(fields.size());
   std::transform(fields.begin(), fields.end(), fieldNodeSize.begin(), [](const bemfield& f) { return numNodes(f.field_); } );
   DenseBlockMatrix EE(fieldNodeSize, fieldNodeSize);
@@ -1232,15 +1596,116 @@ MatrixHandle SurfaceToSurface::compute(const bemfield_vector& fields) const
   // Compute T here (see math in comments above)
   // TransferMatrix = T = inv(Pmm - Gms*iGss*Psm)*(Gms*iGss*Pss - Pms) = inv(C)*D
 
-  auto Y = Gms.matrix() * Gss.matrix().inverse();
-  auto C = Pmm.matrix() - Y * Psm.matrix();
-  auto D = Y * Pss.matrix() - Pms.matrix();
+  // Neither inverse is formed explicitly: Gss is factored once and solved for Psm and Pss
+  // together, then C = Pmm - Gms*iGss*Psm is factored and solved for D = Gms*iGss*Pss - Pms.
+  const auto nm = Psm.matrix().cols();
+  const auto ns = Pss.matrix().cols();
+  DenseMatrix::EigenBase PsmPss(Gss.matrix().rows(), nm + ns);
+  PsmPss << Psm.matrix(), Pss.matrix();
+
+  const Eigen::PartialPivLU<DenseMatrix::EigenBase> luGss(Gss.matrix());
+  const DenseMatrix::EigenBase Y = Gms.matrix() * luGss.solve(PsmPss); // Y = Gms*iGss*[Psm Pss]
+
+  const DenseMatrix::EigenBase C = Pmm.matrix() - Y.leftCols(nm);
+  const DenseMatrix::EigenBase D = Y.rightCols(ns) - Pms.matrix();
+
+  return makeShared<DenseMatrix>(C.partialPivLu().solve(D)); // T = inv(C)*D
+}
+
+MatrixHandle SurfaceToSurface::compute_low_rank(const bemfield_vector& fields,
+  const std::vector<int>& sourcefieldindices, const std::vector<int>& measurementfieldindices) const
+{
+  // Same T as compute(), but only the blocks of a surface with itself are dense and
+  // every product goes through the blocks. Gss is split into its dense diagonal
+  // blocks plus one low rank term and solved with Sherman-Morrison-Woodbury:
+  //
+  // iGss*X = (Dg + Ug*Vg') \ X
+  // D = Gms*iGss*Pss - Pms
+  // C = Pmm - Gms*iGss*Psm = Pmm - (Gms*iGss*Usm)*Vsm'
+  // T = C \ D
+  //
+  // Psm only couples different surfaces, so it is entirely low rank. C is factored
+  // directly: the auto P block of the outermost surface is singular by itself.
+
+  auto nodeSizes = [&fields](const std::vector<int>& indices)
+  {
+    std::vector<int> sizes;
+    for (auto index : indices)
+      sizes.push_back(numNodes(fields[index].field_));
+    return sizes;
+  };
+
+  auto makeP = [&](const std::vector<int>& rowFields, const std::vector<int>& colFields)
+  {
+    SurfaceBlockMatrix P(nodeSizes(rowFields), nodeSizes(colFields));
+    for (size_t i = 0; i < rowFields.size(); i++)
+    {
+      for (size_t j = 0; j < colFields.size(); j++)
+      {
+        const bemfield& rowField = fields[rowFields[i]];
+        const bemfield& colField = fields[colFields[j]];
+        if (rowFields[i] == colFields[j])
+        {
+          make_auto_P_compute(rowField.field_->vmesh(), P.dense(i, j), rowField.insideconductivity, rowField.outsideconductivity);
+        }
+        else
+        {
+          auto& block = P.lowRank(i, j);
+          make_cross_P_lowrank(rowField.field_->vmesh(), colField.field_->vmesh(), block, colField.insideconductivity, colField.outsideconductivity, crossBlockTolerance_);
+          printLowRankInfo(block, "P", rowFields[i], colFields[j]);
+        }
+      }
+    }
+    return P;
+  };
+
+  const SurfaceBlockMatrix Pmm = makeP(measurementfieldindices, measurementfieldindices);
+  const SurfaceBlockMatrix Pss = makeP(sourcefieldindices, sourcefieldindices);
+  const SurfaceBlockMatrix Pms = makeP(measurementfieldindices, sourcefieldindices);
+  const SurfaceBlockMatrix Psm = makeP(sourcefieldindices, measurementfieldindices);
+
+  // Columns of EJ are the source surfaces; the conductivities follow compute()
+  SurfaceBlockMatrix Gms(nodeSizes(measurementfieldindices), nodeSizes(sourcefieldindices));
+  SurfaceBlockMatrix Gss(nodeSizes(sourcefieldindices), nodeSizes(sourcefieldindices));
+  for (size_t j = 0; j < sourcefieldindices.size(); j++)
+  {
+    const bemfield& source = fields[sourcefieldindices[j]];
+    std::vector<double> triangleareas;
+    pre_calc_tri_areas(source.field_->vmesh(), triangleareas);
+
+    auto fillColumn = [&](SurfaceBlockMatrix& G, const std::vector<int>& rowFields)
+    {
+      for (size_t i = 0; i < rowFields.size(); i++)
+      {
+        const bemfield& rowField = fields[rowFields[i]];
+        if (rowFields[i] == sourcefieldindices[j])
+        {
+          make_auto_G_compute(rowField.field_->vmesh(), G.dense(i, j), rowField.insideconductivity, rowField.outsideconductivity, triangleareas);
+        }
+        else
+        {
+          auto& block = G.lowRank(i, j);
+          make_cross_G_lowrank(rowField.field_->vmesh(), source.field_->vmesh(), block, fields[j].insideconductivity, fields[j].outsideconductivity, triangleareas, crossBlockTolerance_);
+          printLowRankInfo(block, "G", rowFields[i], j);
+        }
+      }
+    };
+    fillColumn(Gms, measurementfieldindices);
+    fillColumn(Gss, sourcefieldindices);
+  }
+
+  const SurfaceBlockMatrix::DiagonalSolver diagonalGss(Gss);
+  const LowRankBlock offDiagonalGss = Gss.lowRankPart();
+  auto solveGss = [&](const DenseMatrix::EigenBase& x) { return offDiagonalGss.solveUpdated(diagonalGss, x); };
+
+  const DenseMatrix::EigenBase identity = DenseMatrix::EigenBase::Identity(Pss.cols(), Pss.cols());
+  const DenseMatrix::EigenBase D = Gms.multiply(solveGss(Pss.multiply(identity))) - Pms.multiply(identity);
 
-  auto T = C.inverse() * D; // T = inv(C)*D
-  return makeShared<DenseMatrix>(T);
+  const LowRankBlock lowRankPsm = Psm.lowRankPart();
+  const DenseMatrix::EigenBase W = Gms.multiply(solveGss(lowRankPsm.U));
+  const DenseMatrix::EigenBase C = Pmm.multiply(DenseMatrix::EigenBase::Identity(Pmm.cols(), Pmm.cols())) - W * lowRankPsm.V.transpose();
 
-  //This could be done on one line (see below), but Y (see above) would need to be calculated twice:
-  //MatrixHandle TransferMatrix1 = inv(Pmm - Gms * Gss * Psm) * (Gms * Gss * Pss - Pms);
+  return makeShared<DenseMatrix>(C.partialPivLu().solve(D)); // T = inv(C)*D
 }
 
 
@@ -1311,5 +1776,7 @@ MatrixHandle SurfaceAndPoints::compute(const bemfield_vector& fields) const
   make_auto_G( surface, Gss, 1.0, 0.0, area );
   make_cross_G( nodes, surface, Gns, 1.0, 0.0, area );
 
-  return makeShared<DenseMatrix>(*Pns - (*Gns * Gss->inverse() * *Pss));
+  // inv(G_surf_surf) * P_surf_surf is computed as a solve against the LU factors of G_surf_surf
+  const Eigen::PartialPivLU<DenseMatrix::EigenBase> luGss(*Gss);
+  return makeShared<DenseMatrix>(*Pns - (*Gns * luGss.solve(*Pss)));
 }
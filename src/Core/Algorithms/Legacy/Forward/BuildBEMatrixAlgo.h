@@ -39,6 +39,8 @@
 #define CORE_ALGORITHMS_LEGACY_FORWARD_BUILDBEMATRIXALGO_H
 
 #include <Core/Datatypes/MatrixFwd.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
 #include <Core/GeometryPrimitives/GeomFwd.h>
 #include <Core/Datatypes/Legacy/Field/FieldFwd.h>
 #include <Core/Algorithms/Base/AlgorithmBase.h>
@@ -54,9 +56,53 @@ namespace SCIRun {
         ALGORITHM_PARAMETER_DECL(BoundaryConditionList);
         ALGORITHM_PARAMETER_DECL(InsideConductivityList);
         ALGORITHM_PARAMETER_DECL(OutsideConductivityList);
+        ALGORITHM_PARAMETER_DECL(CrossBlockTolerance);
 
         typedef std::vector<std::string> FieldTypeListType;
 
+        /// A block of a BEM matrix stored as U * V^T. The kernels coupling two
+        /// well separated surfaces are smooth, so cross-surface blocks are close
+        /// to low rank and need (rows + cols) * rank doubles instead of rows * cols.
+        class SCISHARE LowRankBlock
+        {
+        public:
+          size_t rows() const { return U.rows(); }
+          size_t cols() const { return V.rows(); }
+          size_t rank() const { return U.cols(); }
+
+          /// Number of doubles held by the compressed and by the dense representation
+          size_t compressedSize() const { return (rows() + cols()) * rank(); }
+          size_t denseSize() const { return rows() * cols(); }
+
+          /// U*V^T*x and V*U^T*x for one or more vectors x
+          Datatypes::DenseMatrix::EigenBase multiply(const Datatypes::DenseMatrix::EigenBase& x) const;
+          Datatypes::DenseMatrix::EigenBase multiplyTranspose(const Datatypes::DenseMatrix::EigenBase& x) const;
+          Datatypes::DenseMatrix toDense() const;
+
+          /// Solve (A + U*V^T) x = b for a square block, given a factorization of A
+          /// (anything with solve(), e.g. Eigen::PartialPivLU), without expanding
+          /// U*V^T (Sherman-Morrison-Woodbury).
+          template <class Solver>
+          Datatypes::DenseMatrix::EigenBase solveUpdated(const Solver& solverA,
+            const Datatypes::DenseMatrix::EigenBase& b) const
+          {
+            // x = iA*b - iA*U * inv(I + V'*iA*U) * V'*iA*b
+            const Datatypes::DenseMatrix::EigenBase y = solverA.solve(b);
+            if (rank() == 0)
+              return y;
+
+            const Datatypes::DenseMatrix::EigenBase Z = solverA.solve(U);
+            Datatypes::DenseMatrix::EigenBase capacitance = V.transpose() * Z;
+            capacitance.diagonal().array() += 1.0;
+            return y - Z * capacitance.partialPivLu().solve(V.transpose() * y);
+          }
+
+          Datatypes::DenseMatrix U;
+          Datatypes::DenseMatrix V;
+          /// Relative Frobenius error estimated by the cross approximation when it stopped
+          double estimatedError = 0;
+        };
+
         class SCISHARE BuildBEMatrixBase
         {
         protected:
@@ -67,7 +113,7 @@ namespace SCIRun {
             double,
             double,
             const Geometry::Vector&,
-            Datatypes::DenseMatrix&);
+            double (&)[7]);
 
           static void get_cruse_weights( const Geometry::Vector&,
             const Geometry::Vector&,
@@ -75,12 +121,12 @@ namespace SCIRun {
             double,
             double,
             double,
-            Datatypes::DenseMatrix& );
+            double (&)[3][7] );
 
           static void getOmega( const Geometry::Vector&,
             const Geometry::Vector&,
             const Geometry::Vector&,
-            Datatypes::DenseMatrix& );
+            double (&)[3] );
 
           static double do_radon_g( const Geometry::Vector&,
             const Geometry::Vector&,
@@ -88,22 +134,22 @@ namespace SCIRun {
             const Geometry::Vector&,
             double,
             double,
-            Datatypes::DenseMatrix& );
+            const double (&)[7] );
 
           static void get_auto_g( const Geometry::Vector&,
             const Geometry::Vector&,
             const Geometry::Vector&,
             unsigned int,
-            Datatypes::DenseMatrix&,
+            double (&)[3],
             double,
             double,
-            Datatypes::DenseMatrix& );
+            const double (&)[7] );
 
           static void bem_sing( const Geometry::Vector&,
             const Geometry::Vector&,
             const Geometry::Vector&,
             unsigned int,
-            Datatypes::DenseMatrix& );
+            double (&)[3] );
 
           static double get_new_auto_g( const Geometry::Vector&,
             const Geometry::Vector&,
@@ -146,6 +192,23 @@ namespace SCIRun {
           static void make_cross_P_allocate( VMesh*,
             VMesh*, Datatypes::DenseMatrixHandle&);
 
+          /// Build cross_G and cross_P by adaptive cross approximation, stopping once the
+          /// estimated relative error drops below the tolerance.
+          static void make_cross_G_lowrank( VMesh*,
+            VMesh*,
+            LowRankBlock&,
+            double,
+            double,
+            const std::vector<double>&,
+            double tolerance );
+
+          static void make_cross_P_lowrank( VMesh*,
+            VMesh*,
+            LowRankBlock&,
+            double,
+            double,
+            double tolerance );
+
           static void pre_calc_tri_areas(VMesh*, std::vector<double>&);
 
           static int compute_parent(const std::vector<VMesh*> &meshes, int index);
@@ -218,7 +281,8 @@ namespace SCIRun {
         class SCISHARE BEMAlgoImplFactory
         {
         public:
-          static BEMAlgoPtr create(const bemfield_vector& fields);
+          /// A positive crossBlockTolerance builds the cross-surface blocks by adaptive cross approximation
+          static BEMAlgoPtr create(const bemfield_vector& fields, double crossBlockTolerance = 0);
         };
 
       }}}}
@@ -0,0 +1,195 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <gtest/gtest.h>
+#include <Core/Algorithms/Legacy/Forward/BuildBEMatrixAlgo.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/MatrixTypeConversions.h>
+#include <Core/GeometryPrimitives/Point.h>
+#include <cmath>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms::Forward;
+
+namespace
+{
+  // Latitude-longitude sphere around the origin
+  FieldHandle sphere(double radius, int nlat, int nlon)
+  {
+    FieldInformation fi(mesh_info_type::TRISURFMESH_E, databasis_info_type::LINEARDATA_E, data_info_type::DOUBLE_E);
+    auto field = CreateField(fi);
+    auto vmesh = field->vmesh();
+
+    vmesh->add_point(Point(0, 0, radius));
+    for (int i = 1; i < nlat; ++i)
+    {
+      const double theta = M_PI * i / nlat;
+      for (int j = 0; j < nlon; ++j)
+      {
+        const double phi = 2 * M_PI * j / nlon;
+        vmesh->add_point(Point(radius * sin(theta) * cos(phi), radius * sin(theta) * sin(phi), radius * cos(theta)));
+      }
+    }
+    vmesh->add_point(Point(0, 0, -radius));
+
+    const index_type south = 1 + (nlat - 1) * nlon;
+    auto node = [=](int ring, int j) { return index_type(1 + ring * nlon + (j % nlon)); };
+    VMesh::Node::array_type tri(3);
+    for (int j = 0; j < nlon; ++j)
+    {
+      tri[0] = 0; tri[1] = node(0, j); tri[2] = node(0, j + 1);
+      vmesh->add_elem(tri);
+      for (int ring = 0; ring + 1 < nlat - 1; ++ring)
+      {
+        tri[0] = node(ring, j); tri[1] = node(ring + 1, j); tri[2] = node(ring + 1, j + 1);
+        vmesh->add_elem(tri);
+        tri[0] = node(ring, j); tri[1] = node(ring + 1, j + 1); tri[2] = node(ring, j + 1);
+        vmesh->add_elem(tri);
+      }
+      tri[0] = south; tri[1] = node(nlat - 2, j + 1); tri[2] = node(nlat - 2, j);
+      vmesh->add_elem(tri);
+    }
+    field->vfield()->resize_values();
+    return field;
+  }
+
+  bemfield surface(double radius, double inside, double outside, bool source)
+  {
+    bemfield f(sphere(radius, 12, 20));
+    f.surface = true;
+    f.insideconductivity = inside;
+    f.outsideconductivity = outside;
+    if (source)
+      f.set_source_dirichlet();
+    else
+      f.set_measurement_neumann();
+    return f;
+  }
+
+  double relativeError(const DenseMatrix::EigenBase& approx, const DenseMatrix::EigenBase& exact)
+  {
+    return (approx - exact).norm() / exact.norm();
+  }
+}
+
+TEST(BuildBEMatrixLowRankTests, ProductsAndSolveMatchDenseBlock)
+{
+  std::srand(7);
+  LowRankBlock block;
+  block.U = DenseMatrix::EigenBase::Random(40, 5);
+  block.V = DenseMatrix::EigenBase::Random(30, 5);
+  const DenseMatrix::EigenBase dense = block.toDense();
+  ASSERT_EQ(40u, block.rows());
+  ASSERT_EQ(30u, block.cols());
+  EXPECT_EQ(350u, block.compressedSize());
+  EXPECT_EQ(1200u, block.denseSize());
+
+  const DenseMatrix::EigenBase x = DenseMatrix::EigenBase::Random(30, 3);
+  const DenseMatrix::EigenBase y = DenseMatrix::EigenBase::Random(40, 3);
+  EXPECT_LT(relativeError(block.multiply(x), dense * x), 1e-14);
+  EXPECT_LT(relativeError(block.multiplyTranspose(y), dense.transpose() * y), 1e-14);
+
+  // (A + U*V^T) x = b against the dense LU
+  LowRankBlock update;
+  update.U = DenseMatrix::EigenBase::Random(40, 5);
+  update.V = DenseMatrix::EigenBase::Random(40, 5);
+  DenseMatrix::EigenBase A = DenseMatrix::EigenBase::Random(40, 40);
+  A.diagonal().array() += 40.0;
+  const DenseMatrix::EigenBase b = DenseMatrix::EigenBase::Random(40, 3);
+
+  const Eigen::PartialPivLU<DenseMatrix::EigenBase> luA(A);
+  const DenseMatrix::EigenBase expected = (A + update.toDense()).partialPivLu().solve(b);
+  EXPECT_LT(relativeError(update.solveUpdated(luA, b), expected), 1e-12);
+
+  LowRankBlock empty;
+  empty.U.resize(40, 0);
+  empty.V.resize(40, 0);
+  EXPECT_LT(relativeError(empty.solveUpdated(luA, b), luA.solve(b)), 1e-14);
+}
+
+TEST(BuildBEMatrixLowRankTests, CrossApproximationMatchesDenseBlocks)
+{
+  auto inner = sphere(1.0, 20, 32), outer = sphere(3.0, 20, 32);
+  VMesh* innerMesh = inner->vmesh();
+  VMesh* outerMesh = outer->vmesh();
+
+  DenseMatrixHandle denseP;
+  BuildBEMatrixBase::make_cross_P(outerMesh, innerMesh, denseP, 1.0, 0.2);
+  for (double tolerance : { 1e-3, 1e-6 })
+  {
+    LowRankBlock lowRankP;
+    BuildBEMatrixBase::make_cross_P_lowrank(outerMesh, innerMesh, lowRankP, 1.0, 0.2, tolerance);
+    ASSERT_EQ(denseP->rows(), lowRankP.rows());
+    ASSERT_EQ(denseP->cols(), lowRankP.cols());
+    EXPECT_LT(relativeError(lowRankP.toDense(), *denseP), 10 * tolerance) << tolerance;
+    EXPECT_LT(lowRankP.compressedSize(), tolerance > 1e-4 ? lowRankP.denseSize() / 2 : lowRankP.denseSize()) << tolerance;
+  }
+
+  std::vector<double> areas;
+  BuildBEMatrixBase::pre_calc_tri_areas(innerMesh, areas);
+  DenseMatrixHandle denseG;
+  BuildBEMatrixBase::make_cross_G(outerMesh, innerMesh, denseG, 1.0, 0.2, areas);
+  for (double tolerance : { 1e-3, 1e-6 })
+  {
+    LowRankBlock lowRankG;
+    BuildBEMatrixBase::make_cross_G_lowrank(outerMesh, innerMesh, lowRankG, 1.0, 0.2, areas, tolerance);
+    EXPECT_LT(relativeError(lowRankG.toDense(), *denseG), 10 * tolerance) << tolerance;
+    EXPECT_LT(lowRankG.compressedSize(), tolerance > 1e-4 ? lowRankG.denseSize() / 2 : lowRankG.denseSize()) << tolerance;
+  }
+}
+
+TEST(BuildBEMatrixLowRankTests, TransferMatrixMatchesDensePath)
+{
+  // One source inside two measurement surfaces, and two sources inside one, so
+  // that both Pmm and Gss have low rank off-diagonal blocks. The outermost
+  // surface gets a nonzero outside conductivity: with zero the potentials are
+  // only defined up to a constant and T is not unique.
+  const std::vector<bemfield_vector> setups = {
+    { surface(1.0, 1.0, 0.5, true), surface(2.0, 0.5, 0.25, false), surface(3.0, 0.25, 0.1, false) },
+    { surface(1.0, 1.0, 0.5, true), surface(2.0, 0.5, 0.25, true), surface(3.0, 0.25, 0.1, false) }
+  };
+
+  for (size_t s = 0; s < setups.size(); ++s)
+  {
+    auto dense = BEMAlgoImplFactory::create(setups[s])->compute(setups[s]);
+    auto lowRank = BEMAlgoImplFactory::create(setups[s], 1e-8)->compute(setups[s]);
+    ASSERT_TRUE(dense != nullptr);
+    ASSERT_TRUE(lowRank != nullptr);
+    auto denseT = castMatrix::toDense(dense);
+    auto lowRankT = castMatrix::toDense(lowRank);
+    ASSERT_EQ(denseT->rows(), lowRankT->rows()) << s;
+    ASSERT_EQ(denseT->cols(), lowRankT->cols()) << s;
+    EXPECT_LT(relativeError(*lowRankT, *denseT), 1e-5) << s;
+  }
+}
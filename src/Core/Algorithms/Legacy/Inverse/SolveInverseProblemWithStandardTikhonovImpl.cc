@@ -38,8 +38,10 @@
 #include <Core/Datatypes/MatrixTypeConversions.h>
 
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+#include <Core/Thread/Parallel.h>
 
 #include <Core/Utils/Exception.h>
+#include <Eigen/Eigenvalues>
 
 using namespace SCIRun;
 using namespace Core;
@@ -47,6 +49,7 @@ using namespace Datatypes;
 using namespace Logging;
 using namespace Algorithms;
 using namespace Inverse;
+using namespace Thread;
 
 
 /////////////////////////
@@ -64,6 +67,13 @@ using namespace Inverse;
         //
         //      A^-1 = M3 * G^-1 * M4
         //...........................................................................................................
+        // reuse the diagonalization if an L-curve sweep already computed it
+        if (decomposed_)
+        {
+            const auto& spectral = spectralDecomposition();
+            return M3 * (spectral.V * (filterFactors(lambda).asDiagonal() * spectral.z));
+        }
+
         const int sizeB = M1.ncols();
         const int sizeSolution = M3.nrows();
         const int numTimeSamples = y.ncols();
@@ -90,6 +100,116 @@ using namespace Inverse;
 //////// fi compute inverse solution
 ////////////////////////
 
+/////// spectral decomposition for L-curve sweeps
+///////////////
+    const SolveInverseProblemWithStandardTikhonovImpl::SpectralDecomposition& SolveInverseProblemWithStandardTikhonovImpl::spectralDecomposition() const
+    {
+        std::call_once(decompositionFlag_, [this]()
+        {
+            bool converged;
+            if (M2.isIdentity())
+            {
+                Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eigen(M1);
+                converged = eigen.info() == Eigen::Success;
+                decomposition_.V = eigen.eigenvectors();
+                decomposition_.mu = eigen.eigenvalues();
+            }
+            else
+            {
+                Eigen::GeneralizedSelfAdjointEigenSolver<Eigen::MatrixXd> eigen(M1, M2);
+                converged = eigen.info() == Eigen::Success;
+                decomposition_.V = eigen.eigenvectors();
+                decomposition_.mu = eigen.eigenvalues();
+            }
+            if (!converged)
+                BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Tikhonov: diagonalization of the regularized system did not converge."));
+
+            // M1 is positive semidefinite; drop round-off below zero
+            decomposition_.mu = decomposition_.mu.cwiseMax(0.0);
+            decomposition_.z = decomposition_.V.transpose() * y;
+            decomposed_ = true;
+        });
+        return decomposition_;
+    }
+
+    Eigen::VectorXd SolveInverseProblemWithStandardTikhonovImpl::filterFactors(double lambda) const
+    {
+        return (decomposition_.mu.array() + lambda * lambda).inverse().matrix();
+    }
+
+    void SolveInverseProblemWithStandardTikhonovImpl::computeLcurveNorms(const std::vector<double>& lambdaArray,
+        const DenseMatrix& forwardMatrix, const DenseMatrix& measuredData,
+        const DenseMatrix* sourceWeighting, const DenseMatrix* sensorWeighting,
+        std::vector<double>& rho, std::vector<double>& eta) const
+    {
+        const auto& spectral = spectralDecomposition();
+        const size_t nLambda = lambdaArray.size();
+        rho.assign(nLambda, 0.0);
+        eta.assign(nLambda, 0.0);
+
+        // x(lambda) = B * D(lambda) * z,  A * x(lambda) = Q * D(lambda) * z
+        const DenseMatrix B = M3 * spectral.V;
+        const DenseMatrix Q = forwardMatrix * B;
+
+        if (sourceWeighting || sensorWeighting || !M2.isIdentity())
+        {
+            // weighted columns are not orthogonal: evaluate each solution from the
+            // decomposition, which needs products only and no factorization per lambda
+            const DenseMatrix RB = sourceWeighting ? DenseMatrix((*sourceWeighting) * B) : B;
+            const DenseMatrix CQ = sensorWeighting ? DenseMatrix((*sensorWeighting) * Q) : Q;
+            const DenseMatrix Cy = sensorWeighting ? DenseMatrix((*sensorWeighting) * measuredData) : measuredData;
+
+            Parallel::For(0, nLambda, 1, [&](size_t begin, size_t end)
+            {
+                for (size_t j = begin; j < end; ++j)
+                {
+                    const DenseMatrix Dz = filterFactors(lambdaArray[j]).asDiagonal() * spectral.z;
+                    eta[j] = (RB * Dz).norm();
+                    rho[j] = (CQ * Dz - Cy).norm();
+                }
+            });
+            return;
+        }
+
+        // Without weighting (and with M2 = I), B^T * B and Q^T * Q are diagonal for both the under- and the
+        // overdetermined formulation, so both norms reduce to sums over the eigenpairs:
+        //      eta^2 = sum_i |B_i|^2 * s_i * d_i^2
+        //      rho^2 = floor + sum_i |Q_i|^2 * s_i * (d_i - r_i)^2
+        // where s_i = |z_i|^2, r_i is the coefficient of the measurements along Q_i (relative
+        // to z_i) and floor is the part of the measurements no lambda can fit.
+        const int k = static_cast<int>(spectral.mu.size());
+        const Eigen::VectorXd bNorm = B.colwise().squaredNorm().transpose();
+        const Eigen::VectorXd qNorm = Q.colwise().squaredNorm().transpose();
+        const DenseMatrix Qty = Q.transpose() * measuredData;
+
+        Eigen::VectorXd s(k), r(Eigen::VectorXd::Zero(k));
+        double floor = measuredData.squaredNorm();
+        for (int i = 0; i < k; ++i)
+        {
+            s[i] = spectral.z.row(i).squaredNorm();
+            if (s[i] > 0 && qNorm[i] > 0)
+            {
+                const double c = spectral.z.row(i).dot(Qty.row(i)) / qNorm[i];
+                r[i] = c / s[i];
+                floor -= qNorm[i] * c * c / s[i];
+            }
+        }
+        const Eigen::VectorXd etaWeight = bNorm.cwiseProduct(s);
+        const Eigen::VectorXd rhoWeight = qNorm.cwiseProduct(s);
+
+        Parallel::For(0, nLambda, 64, [&](size_t begin, size_t end)
+        {
+            for (size_t j = begin; j < end; ++j)
+            {
+                const Eigen::VectorXd d = filterFactors(lambdaArray[j]);
+                eta[j] = std::sqrt(etaWeight.dot(d.cwiseAbs2()));
+                rho[j] = std::sqrt(std::max(0.0, floor + rhoWeight.dot((d - r).cwiseAbs2())));
+            }
+        });
+    }
+//////// fi spectral decomposition
+////////////////////////
+
 /////// precomputeInverseMatrices
 ///////////////
     void SolveInverseProblemWithStandardTikhonovImpl::preAllocateInverseMatrices(const DenseMatrix& forwardMatrix, const
@@ -35,6 +35,8 @@
 #include <Core/Algorithms/Legacy/Inverse/TikhonovAlgoAbstractBase.h>
 #include <Core/Datatypes/MatrixFwd.h>
 #include <Core/Algorithms/Legacy/Inverse/share.h>
+#include <atomic>
+#include <mutex>
 
 namespace SCIRun {
 namespace Core {
@@ -72,6 +74,30 @@ namespace Core {
             int regularizationResidualSubcase);
 
         Datatypes::DenseMatrix computeInverseSolution(double lambda, bool inverseCalculation) const override;
+
+        // Diagonalizes (M1, M2) once so every lambda of the sweep costs O(n) instead of a new
+        // factorization of M1 + lambda^2 * M2.
+        void computeLcurveNorms(const std::vector<double>& lambdaArray,
+            const Datatypes::DenseMatrix& forwardMatrix,
+            const Datatypes::DenseMatrix& measuredData,
+            const Datatypes::DenseMatrix* sourceWeighting,
+            const Datatypes::DenseMatrix* sensorWeighting,
+            std::vector<double>& rho, std::vector<double>& eta) const override;
+
+        // Simultaneous diagonalization V^T * M1 * V = diag(mu), V^T * M2 * V = I, so that
+        // (M1 + lambda^2 * M2)^-1 * y = V * diag(1 / (mu + lambda^2)) * z with z = V^T * y.
+        struct SpectralDecomposition
+        {
+          Datatypes::DenseMatrix V;
+          Eigen::VectorXd mu;
+          Datatypes::DenseMatrix z;
+        };
+        const SpectralDecomposition& spectralDecomposition() const;
+        Eigen::VectorXd filterFactors(double lambda) const;
+
+        mutable std::once_flag decompositionFlag_;
+        mutable std::atomic<bool> decomposed_ {false};
+        mutable SpectralDecomposition decomposition_;
       };
     }
   }
@@ -0,0 +1,113 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+#include <Core/Algorithms/Legacy/Inverse/SolveInverseProblemWithStandardTikhonovImpl.h>
+#include <cmath>
+
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Algorithms::Inverse;
+
+namespace
+{
+  DenseMatrix forwardMatrix(int rows, int cols)
+  {
+    DenseMatrix A(rows, cols);
+    for (int i = 0; i < rows; ++i)
+      for (int j = 0; j < cols; ++j)
+        A(i, j) = 1.0 / (1.0 + std::abs(i - j)) + 0.1 * std::sin(1.0 + i * j);
+    return A;
+  }
+
+  DenseMatrix measurements(int rows)
+  {
+    DenseMatrix y(rows, 2);
+    for (int i = 0; i < rows; ++i)
+    {
+      y(i, 0) = std::cos(0.3 * i);
+      y(i, 1) = 1.0 + 0.05 * i * i;
+    }
+    return y;
+  }
+
+  const std::vector<double> lambdas { 1e-4, 1e-3, 1e-2, 0.1, 1.0, 10.0 };
+
+  // The direct solve is used until an L-curve sweep computes the diagonalization, so one
+  // implementation yields both paths: the default sweep and solutions first, then the
+  // overridden sweep and the solutions it leaves behind.
+  void expectDecompositionMatchesDirectSolve(int rows, int cols,
+    TikhonovAlgoAbstractBase::AlgorithmChoice choice, const DenseMatrix* sensorWeighting)
+  {
+    const auto A = forwardMatrix(rows, cols);
+    const auto y = measurements(rows);
+    const DenseMatrix unused;
+    SolveInverseProblemWithStandardTikhonovImpl impl(A, y, unused, unused, choice, 0, 0);
+    TikhonovImpl& tikhonov = impl;
+
+    std::vector<double> directRho, directEta;
+    tikhonov.TikhonovImpl::computeLcurveNorms(lambdas, A, y, nullptr, sensorWeighting, directRho, directEta);
+    std::vector<DenseMatrix> directSolutions;
+    for (auto lambda : lambdas)
+      directSolutions.push_back(tikhonov.computeInverseSolution(lambda, false));
+
+    std::vector<double> rho, eta;
+    tikhonov.computeLcurveNorms(lambdas, A, y, nullptr, sensorWeighting, rho, eta);
+
+    // the residual of the underdetermined case vanishes with lambda, so it is compared
+    // relative to the measurements
+    const double rhoTolerance = 1e-8 * y.norm();
+    for (size_t j = 0; j < lambdas.size(); ++j)
+    {
+      EXPECT_NEAR(directRho[j], rho[j], rhoTolerance) << "lambda " << lambdas[j];
+      EXPECT_NEAR(directEta[j], eta[j], 1e-8 * directEta[j]) << "lambda " << lambdas[j];
+
+      const auto solution = tikhonov.computeInverseSolution(lambdas[j], false);
+      ASSERT_EQ(directSolutions[j].rows(), solution.rows());
+      ASSERT_EQ(directSolutions[j].cols(), solution.cols());
+      EXPECT_LE((solution - directSolutions[j]).norm(), 1e-8 * directSolutions[j].norm()) << "lambda " << lambdas[j];
+    }
+  }
+}
+
+TEST(TikhonovLcurveTests, UnderdeterminedDecompositionMatchesDirectSolve)
+{
+  expectDecompositionMatchesDirectSolve(8, 12, TikhonovAlgoAbstractBase::AlgorithmChoice::underdetermined, nullptr);
+}
+
+TEST(TikhonovLcurveTests, OverdeterminedDecompositionMatchesDirectSolve)
+{
+  expectDecompositionMatchesDirectSolve(12, 8, TikhonovAlgoAbstractBase::AlgorithmChoice::overdetermined, nullptr);
+}
+
+TEST(TikhonovLcurveTests, WeightedNormsMatchDirectSolve)
+{
+  DenseMatrix C = DenseMatrix::Identity(12, 12);
+  for (int i = 0; i < 12; ++i)
+    C(i, i) = 1.0 + 0.1 * i;
+  expectDecompositionMatchesDirectSolve(12, 8, TikhonovAlgoAbstractBase::AlgorithmChoice::overdetermined, &C);
+}
@@ -314,53 +314,28 @@ double TikhonovAlgoAbstractBase::computeLcurve(
 
   auto lambdaArray = algoImpl.computeLambdaArray(lambdaMin, lambdaMax, nLambda);
 
-  DenseMatrix CAx, Rx;
-  DenseMatrix solution;
-
   lambdaArray[0] = lambdaMin;
 
-  // for all lambdas
-  for (int j = 0; j < nLambda; j++)
-  {
-    solution = algoImpl.computeInverseSolution(lambdaArray[j], false);
-    lambdamatrix->put(j, 0, lambdaArray[j]);
-
-    // if using source regularization matrix, apply it to compute Rx (for the eta computations)
-    if (sourceWeighting)
-    {
-      if (solution.nrows() ==
-          sourceWeighting->ncols())  // check that regularization matrix and solution match sizes
-      {
-        auto sw = castMatrix::toDense(sourceWeighting);
-        Rx = (*sw) * solution;
-      }
-      else
-      {
-        BOOST_THROW_EXCEPTION(AlgorithmProcessingException()
-                              << ErrorMessage(" Solution weighting matrix unexpectedly does not "
-                                              "fit to compute the weighted solution norm. "));
-      }
-    }
-    else
-      Rx = solution;
+  // cast once for the whole sweep
+  auto forward = castMatrix::toDense(forwardMatrix);
+  auto measured = castMatrix::toDense(measuredData);
+  auto sourceW = sourceWeighting ? convertMatrix::toDense(sourceWeighting) : nullptr;
+  auto sensorW = sensorWeighting ? convertMatrix::toDense(sensorWeighting) : nullptr;
 
-    auto forward = castMatrix::toDense(forwardMatrix);
-    auto Ax = (*forward) * solution;
-    auto measured = castMatrix::toDense(measuredData);
-    auto residualSolution = Ax - (*measured);
+  // check that regularization matrix and solution match sizes
+  if (sourceW && sourceW->ncols() != forward->ncols())
+  {
+    BOOST_THROW_EXCEPTION(AlgorithmProcessingException()
+                          << ErrorMessage(" Solution weighting matrix unexpectedly does not "
+                                          "fit to compute the weighted solution norm. "));
+  }
 
-    // if using source regularization matrix, apply it to compute Rx (for the eta computations)
-    if (sensorWeighting)
-    {
-      auto sw = castMatrix::toDense(sensorWeighting);
-      CAx = (*sw) * residualSolution;
-    }
-    else
-      CAx = residualSolution;
+  // compute rho and eta for all lambdas. Using Frobenious norm when using matrices
+  algoImpl.computeLcurveNorms(lambdaArray, *forward, *measured, sourceW.get(), sensorW.get(), rho, eta);
 
-    // compute rho and eta. Using Frobenious norm when using matrices
-    rho[j] = CAx.norm();
-    eta[j] = Rx.norm();
+  for (int j = 0; j < nLambda; j++)
+  {
+    lambdamatrix->put(j, 0, lambdaArray[j]);
     lambdamatrix->put(j, 1, rho[j]);
     lambdamatrix->put(j, 2, eta[j]);
   }
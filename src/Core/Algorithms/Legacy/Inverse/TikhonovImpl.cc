@@ -30,6 +30,10 @@
 
 
 #include <Core/Algorithms/Legacy/Inverse/TikhonovImpl.h>
+#include <Core/Thread/Parallel.h>
+
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Thread;
 
 
 	// default lambda step. Can ve overriden if necessary (see TSVD as reference)
@@ -46,3 +50,26 @@
 
 		return lambdaArray;
 	}
+
+	// default L-curve sweep: one independent solve per lambda
+	void SCIRun::Core::Algorithms::Inverse::TikhonovImpl::computeLcurveNorms( const std::vector<double>& lambdaArray,
+		const DenseMatrix& forwardMatrix, const DenseMatrix& measuredData,
+		const DenseMatrix* sourceWeighting, const DenseMatrix* sensorWeighting,
+		std::vector<double>& rho, std::vector<double>& eta ) const
+	{
+		const size_t nLambda = lambdaArray.size();
+		rho.assign(nLambda, 0.0);
+		eta.assign(nLambda, 0.0);
+
+		Parallel::For(0, nLambda, 1, [&](size_t begin, size_t end)
+		{
+			for (size_t j = begin; j < end; ++j)
+			{
+				const DenseMatrix solution = computeInverseSolution(lambdaArray[j], false);
+				const DenseMatrix residual = forwardMatrix * solution - measuredData;
+
+				eta[j] = sourceWeighting ? ((*sourceWeighting) * solution).norm() : solution.norm();
+				rho[j] = sensorWeighting ? ((*sensorWeighting) * residual).norm() : residual.norm();
+			}
+		});
+	}
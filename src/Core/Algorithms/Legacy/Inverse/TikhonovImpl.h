@@ -57,6 +57,14 @@ namespace Inverse {
 		// default lambda step. Can ve overriden if necessary (see TSVD as reference)
 		virtual std::vector<double> computeLambdaArray( double lambdaMin, double lambdaMax, int nLambda ) const;
 
+		// residual norm (rho) and solution norm (eta) of every lambda in an L-curve sweep, each optionally weighted.
+		// Default solves once per lambda, in parallel. Can be overriden by implementations holding a
+		// lambda-independent factorization (see standard Tikhonov as reference)
+		virtual void computeLcurveNorms( const std::vector<double>& lambdaArray,
+			const SCIRun::Core::Datatypes::DenseMatrix& forwardMatrix, const SCIRun::Core::Datatypes::DenseMatrix& measuredData,
+			const SCIRun::Core::Datatypes::DenseMatrix* sourceWeighting, const SCIRun::Core::Datatypes::DenseMatrix* sensorWeighting,
+			std::vector<double>& rho, std::vector<double>& eta ) const;
+
 	};
 
 	}}}}
@@ -32,7 +32,10 @@
 
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/Math/LinearSystem/SolveLinearSystemAlgo.h>
+#include <Core/Algorithms/Math/LinearSystem/SolverStateCache.h>
+#include <Core/Algorithms/Math/LinearSystem/SparseDirectSolver.h>
 #include <Core/Algorithms/Math/ParallelAlgebra/ParallelLinearAlgebra.h>
+#include <Core/Algorithms/Math/ParallelAlgebra/ParallelPreconditioners.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/DenseColumnMatrix.h>
@@ -44,11 +47,14 @@ using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Algorithms::Math;
 using namespace SCIRun::Core::Datatypes;
 
+AlgorithmOutputName SolveLinearSystemAlgo::Residuals("Residuals");
+AlgorithmOutputName SolveLinearSystemAlgo::Iterations("Iterations");
+
 SolveLinearSystemAlgo::SolveLinearSystemAlgo()
 {
   // For solver
-  addOption(Variables::Method,"cg","jacobi|cg|bicg|minres");
-  addOption(Variables::Preconditioner,"Jacobi","None|Jacobi");
+  addOption(Variables::Method,"cg","jacobi|cg|pipelined_cg|bicg|minres|ldlt|lu");
+  addOption(Variables::Preconditioner,"Jacobi","None|Jacobi|IC0|ILU0|AMG");
 
   addParameter(Variables::TargetError, 1e-5);
   addParameter(Variables::MaxIterations, 500);
@@ -77,23 +83,54 @@ public:
 
   bool run(SparseRowMatrixHandle a, DenseColumnMatrixHandle b,
             DenseColumnMatrixHandle x0, DenseColumnMatrixHandle& x,
-            DenseColumnMatrixHandle& convergence) const;
+            DenseColumnMatrixHandle& convergence);
+
+  // Lets several solves share one preconditioner setup
+  void set_preconditioner(ParallelPreconditionerHandle preconditioner) { preconditioner_ = preconditioner; }
+
+  // Number of iterations the last solve took
+  int num_iterations() const { return num_iterations_; }
+
+  // Preconditioners are kept in the SolverStateCache between solves with the
+  // same matrix: make_preconditioner() takes a cached one if available and
+  // release_preconditioner() hands it back after the solve.
+  static ParallelPreconditionerHandle make_preconditioner(const AlgorithmBase* base, SparseRowMatrixHandle a);
+  static void release_preconditioner(const AlgorithmBase* base, SparseRowMatrixHandle a,
+                                     ParallelPreconditionerHandle preconditioner);
+
 protected:
+  // Sets up the preconditioner unless one was given, then runs parallel()
+  void start(SolverInputs& matrices);
+
+  // Fills DIAG for the Jacobi and None options; the other preconditioners
+  // are set up in run() before the threads start.
+  void setup_preconditioner(ParallelLinearAlgebra& PLA, ParallelLinearAlgebra::ParallelMatrix& A,
+                            ParallelLinearAlgebra::ParallelVector& DIAG) const;
+
+  // z = M^-1 r and z = M^-T r
+  void precondition(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelVector& DIAG,
+                    const ParallelLinearAlgebra::ParallelVector& r, ParallelLinearAlgebra::ParallelVector& z) const;
+  void precondition_trans(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelVector& DIAG,
+                          const ParallelLinearAlgebra::ParallelVector& r, ParallelLinearAlgebra::ParallelVector& z) const;
+
   const AlgorithmBase* algo_;
   std::string pre_conditioner_;
+  ParallelPreconditionerHandle preconditioner_;
   DenseColumnMatrixHandle convergence_;
+  mutable int num_iterations_;
 };
 
 SolveLinearSystemParallelAlgo::SolveLinearSystemParallelAlgo(const AlgorithmBase* base) : algo_(base),
   pre_conditioner_(base->getOption(Variables::Preconditioner)),
-  convergence_(new DenseColumnMatrix(base->get(Variables::MaxIterations).toInt()))
+  convergence_(new DenseColumnMatrix(base->get(Variables::MaxIterations).toInt())),
+  num_iterations_(0)
 {
 }
 
 bool
 SolveLinearSystemParallelAlgo::run(SparseRowMatrixHandle a, DenseColumnMatrixHandle b,
                                    DenseColumnMatrixHandle x0, DenseColumnMatrixHandle& x,
-                                   DenseColumnMatrixHandle& convergence) const
+                                   DenseColumnMatrixHandle& convergence)
 {
   SolverInputs matrices;
   matrices.A = a;
@@ -115,6 +152,54 @@ SolveLinearSystemParallelAlgo::run(SparseRowMatrixHandle a, DenseColumnMatrixHan
   algo->set_handle("convergence", convergence);
 #endif
 
+  start(matrices);
+
+  return (true);
+}
+
+namespace
+{
+  std::string preconditionerCacheKind(const AlgorithmBase* base)
+  {
+    const bool transpose = base->getOption(Variables::Method) == "bicg";
+    return "ParallelPreconditioner:" + base->getOption(Variables::Preconditioner) + (transpose ? ":transpose" : "");
+  }
+}
+
+ParallelPreconditionerHandle
+SolveLinearSystemParallelAlgo::make_preconditioner(const AlgorithmBase* base, SparseRowMatrixHandle a)
+{
+  const std::string method = base->getOption(Variables::Method);
+  if (method == "jacobi")
+    return nullptr;
+
+  auto preconditioner = SolverStateCache::instance().take<ParallelPreconditioner>(a, preconditionerCacheKind(base));
+  if (preconditioner)
+  {
+    base->remark("Reusing cached " + preconditioner->description());
+    return preconditioner;
+  }
+
+  preconditioner = ParallelPreconditioner::create(base->getOption(Variables::Preconditioner), *a, method == "bicg");
+  if (preconditioner)
+    base->remark("Using " + preconditioner->description());
+  return preconditioner;
+}
+
+void SolveLinearSystemParallelAlgo::release_preconditioner(const AlgorithmBase* base, SparseRowMatrixHandle a,
+                                                           ParallelPreconditionerHandle preconditioner)
+{
+  if (preconditioner)
+    SolverStateCache::instance().put(a, preconditionerCacheKind(base), preconditioner, preconditioner->memory_size());
+}
+
+void SolveLinearSystemParallelAlgo::start(SolverInputs& matrices)
+{
+  // a preconditioner given by the caller is also released by the caller
+  const bool owned = !preconditioner_;
+  if (owned)
+    preconditioner_ = make_preconditioner(algo_, matrices.A);
+
   if(!start_parallel(matrices))
   {
     const std::string msg = "Encountered an error while running parallel linear algebra";
@@ -122,7 +207,46 @@ SolveLinearSystemParallelAlgo::run(SparseRowMatrixHandle a, DenseColumnMatrixHan
     BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << SCIRun::Core::ErrorMessage(msg));
   }
 
-  return (true);
+  if (owned)
+    release_preconditioner(algo_, matrices.A, preconditioner_);
+}
+
+void SolveLinearSystemParallelAlgo::setup_preconditioner(ParallelLinearAlgebra& PLA,
+                                                         ParallelLinearAlgebra::ParallelMatrix& A,
+                                                         ParallelLinearAlgebra::ParallelVector& DIAG) const
+{
+  if (pre_conditioner_ == "Jacobi")
+  {
+    PLA.absdiag(A,DIAG);
+    double max = PLA.max(DIAG);
+    PLA.absthreshold_invert(DIAG,DIAG,1e-18*max);
+  }
+  else
+  {
+    PLA.ones(DIAG);
+  }
+}
+
+void SolveLinearSystemParallelAlgo::precondition(ParallelLinearAlgebra& PLA,
+                                                 const ParallelLinearAlgebra::ParallelVector& DIAG,
+                                                 const ParallelLinearAlgebra::ParallelVector& r,
+                                                 ParallelLinearAlgebra::ParallelVector& z) const
+{
+  if (preconditioner_)
+    preconditioner_->apply(PLA, r, z);
+  else
+    PLA.mult(r, DIAG, z);
+}
+
+void SolveLinearSystemParallelAlgo::precondition_trans(ParallelLinearAlgebra& PLA,
+                                                       const ParallelLinearAlgebra::ParallelVector& DIAG,
+                                                       const ParallelLinearAlgebra::ParallelVector& r,
+                                                       ParallelLinearAlgebra::ParallelVector& z) const
+{
+  if (preconditioner_)
+    preconditioner_->apply_trans(PLA, r, z);
+  else
+    PLA.mult(r, DIAG, z);
 }
 
 //------------------------------------------------------------------
@@ -189,16 +313,7 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
   PLA.copy(X0,XMIN);
 
   // Build a preconditioner
-  if (pre_conditioner_ == "Jacobi")
-  {
-    PLA.absdiag(A,DIAG);
-    double max = PLA.max(DIAG);
-    PLA.absthreshold_invert(DIAG,DIAG,1e-18*max);
-  }
-  else
-  {
-    PLA.ones(DIAG);
-  }
+  setup_preconditioner(PLA, A, DIAG);
 
   PLA.mult(A,X,R);
   PLA.sub(B,R,R);
@@ -256,7 +371,7 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
       return true;
     }
 
-    PLA.mult(R,DIAG,Z);
+    precondition(PLA, DIAG, R, Z);
     double bknum = PLA.dot(Z,R);
 
     if (niter == 0)
@@ -287,6 +402,7 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
       (*convergence_)[niter] = xmin;
 
     niter++;
+    if (PLA.first()) num_iterations_ = niter;
 
 #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
     callback_step_cnt++;
@@ -338,6 +454,185 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
 }
 
 
+//------------------------------------------------------------------
+// Pipelined CG (Ghysels and Vanroose). The recurrences are rearranged so
+// that every iteration needs a single reduction, done together with the
+// vector updates in one pass over the data. The extra recurrences for
+// s = A*p, q = M*s and z = A*q let the residual drift from b - A*x, so the
+// true residual is recomputed every replacementInterval iterations and
+// before accepting convergence.
+
+class SolveLinearSystemPipelinedCGAlgo : public SolveLinearSystemParallelAlgo
+{
+  public:
+    explicit SolveLinearSystemPipelinedCGAlgo(const AlgorithmBase* base) : SolveLinearSystemParallelAlgo(base) {}
+    bool parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const override;
+
+  private:
+    static const int replacementInterval = 50;
+};
+
+bool SolveLinearSystemPipelinedCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
+{
+  ParallelLinearAlgebra::ParallelMatrix A;
+  ParallelLinearAlgebra::ParallelVector B, X, X0, XMIN, DIAG, R, U, W, M, N, Z, Q, S, P;
+
+  double tolerance =     algo_->get(Variables::TargetError).toDouble();
+  int    max_iter =      algo_->get(Variables::MaxIterations).toInt();
+  int    niter = 0;
+
+  if ( !PLA.add_matrix(matrices.A, A) ||
+       !PLA.add_vector(matrices.b, B) ||
+       !PLA.add_vector(matrices.x0, X0) ||
+       !PLA.add_vector(matrices.x, XMIN))
+  {
+    if (PLA.first())
+      algo_->error("Could not link matrices");
+    PLA.wait();
+    return (false);
+  }
+  if ( !PLA.new_vector(X) ||
+       !PLA.new_vector(DIAG) ||
+       !PLA.new_vector(R) ||
+       !PLA.new_vector(U) ||
+       !PLA.new_vector(W) ||
+       !PLA.new_vector(M) ||
+       !PLA.new_vector(N) ||
+       !PLA.new_vector(Z) ||
+       !PLA.new_vector(Q) ||
+       !PLA.new_vector(S) ||
+       !PLA.new_vector(P))
+  {
+    if (PLA.first())
+      algo_->error("Could not allocate enough memory for algorithm");
+    PLA.wait();
+    return (false);
+  }
+
+  PLA.copy(X0,X);
+  PLA.copy(X0,XMIN);
+
+  // The first update after a restart scales these by beta = 0, so they must
+  // not hold whatever was left in the freshly allocated memory
+  PLA.zeros(Z);
+  PLA.zeros(Q);
+  PLA.zeros(S);
+  PLA.zeros(P);
+
+  // Build a preconditioner
+  setup_preconditioner(PLA, A, DIAG);
+
+  double bnorm = PLA.norm(B);
+  double gamma = 0.0, gamma_old = 0.0, delta = 0.0, rr = 0.0, alpha = 0.0;
+
+  // (Re)starts the recurrences from the true residual of X
+  auto restart = [&]()
+  {
+    PLA.mult(A,X,R);
+    PLA.sub(B,R,R);
+    precondition(PLA, DIAG, R, U);
+    PLA.mult(A,U,W);
+    PLA.cg_dots(R, U, W, gamma, delta, rr);
+  };
+
+  restart();
+  double error = sqrt(rr)/bnorm;
+  double xmin = error;
+  double orig = error;
+
+  if (error <= tolerance)
+  {
+    if (PLA.first())
+    {
+      std::ostringstream ostr;
+      ostr << "Solver found solution with error = " << error;
+      algo_->remark(ostr.str());
+    }
+    PLA.wait();
+
+    return (true);
+  }
+
+  int cnt = 0;
+  int since_restart = 0;
+  double log_target = log(tolerance);
+  double log_orig =  log(orig);
+  double log_scale = log_orig - log_target;
+
+  while (niter < max_iter)
+  {
+    if (error <= tolerance || since_restart == replacementInterval)
+    {
+      restart();
+      since_restart = 0;
+      error = sqrt(rr)/bnorm;
+      if (error <= tolerance)
+      {
+        PLA.copy(X,XMIN);
+
+        if (PLA.first())
+        {
+          std::ostringstream ostr;
+          ostr << "Solver converged after " << niter << " iterations with error " << error;
+          algo_->remark(ostr.str());
+        }
+
+        PLA.wait();
+        return true;
+      }
+    }
+
+    precondition(PLA, DIAG, W, M);
+    PLA.mult(A,M,N);
+
+    double beta = 0.0;
+    if (since_restart == 0)
+    {
+      alpha = gamma/delta;
+    }
+    else
+    {
+      beta = gamma/gamma_old;
+      alpha = gamma/(delta - beta*gamma/alpha);
+    }
+    gamma_old = gamma;
+
+    PLA.pipelined_cg_update(alpha, beta, M, N, Z, Q, S, P, X, R, U, W, gamma, delta, rr);
+    since_restart++;
+
+    error = sqrt(rr)/bnorm;
+    if (error < xmin)
+    {
+      PLA.copy(X,XMIN);
+      xmin = error;
+    }
+    if (PLA.first())
+      (*convergence_)[niter] = xmin;
+
+    niter++;
+    if (PLA.first()) num_iterations_ = niter;
+
+    cnt++;
+    if (cnt == 20)
+    {
+      cnt = 0;
+      algo_->update_progress((log_orig-log(error))/log_scale);
+    }
+  }
+
+  // Last iteration update
+  if (PLA.first())
+  {
+    std::ostringstream ostr;
+    ostr << "Solver stopped after " << niter << " iterations. Error was " << error;
+    algo_->remark(ostr.str());
+  }
+
+  PLA.wait();
+
+  return true;
+}
+
 //------------------------------------------------------------------
 // BICG Solver with simple preconditioner
 class SolveLinearSystemBICGAlgo : public SolveLinearSystemParallelAlgo
@@ -399,16 +694,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   PLA.copy(X0,XMIN);
 
   // Build a preconditioner
-  if (pre_conditioner_ == "Jacobi")
-  {
-    PLA.absdiag(A,DIAG);
-    double max = PLA.max(DIAG);
-    PLA.absthreshold_invert(DIAG,DIAG,1e-18*max);
-  }
-  else
-  {
-    PLA.ones(DIAG);
-  }
+  setup_preconditioner(PLA, A, DIAG);
 
   PLA.mult(A,X,R);
   PLA.sub(B,R,R);
@@ -460,8 +746,8 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
       return (true);
     }
 
-    PLA.mult(R,DIAG,Z);
-    PLA.mult(R1,DIAG,Z1);
+    precondition(PLA, DIAG, R, Z);
+    precondition_trans(PLA, DIAG, R1, Z1);
 
     double bknum = PLA.dot(Z,R1);
 
@@ -508,6 +794,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
     if (PLA.first()) (*convergence_)[niter] = xmin;
 
     niter++;
+    if (PLA.first()) num_iterations_ = niter;
 
     callback_step_cnt++;
 #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
@@ -573,7 +860,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   ParallelLinearAlgebra::ParallelMatrix A;
   ParallelLinearAlgebra::ParallelVector B, X, X0, XMIN;
   ParallelLinearAlgebra::ParallelVector DIAG, R, V, VOLD, VV;
-  ParallelLinearAlgebra::ParallelVector VOLDER, M, MOLD, MOLDER, XCG;
+  ParallelLinearAlgebra::ParallelVector VOLDER, M, MOLD, MOLDER, XCG, W;
 
   double tolerance =     algo_->get(Variables::TargetError).toDouble();
   int    max_iter =      algo_->get(Variables::MaxIterations).toInt();
@@ -598,7 +885,8 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
        !PLA.new_vector(M) ||
        !PLA.new_vector(MOLD) ||
        !PLA.new_vector(MOLDER) ||
-       !PLA.new_vector(XCG))
+       !PLA.new_vector(XCG) ||
+       !PLA.new_vector(W))
   {
     if (PLA.first())
     {
@@ -618,16 +906,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   PLA.copy(X0,XMIN);
 
   // Build a preconditioner
-  if (pre_conditioner_ == "Jacobi")
-  {
-    PLA.absdiag(A,DIAG);
-    double max = PLA.max(DIAG);
-    PLA.absthreshold_invert(DIAG,DIAG,1e-18*max);
-  }
-  else
-  {
-    PLA.ones(DIAG);
-  }
+  setup_preconditioner(PLA, A, DIAG);
 
   PLA.mult(A,X,R);
   PLA.sub(B,R,R);
@@ -656,7 +935,8 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   PLA.copy(R,VOLD);
   PLA.copy(R,V);
 
-  PLA.mult(DIAG,V,V);
+  precondition(PLA, DIAG, V, W);
+  PLA.copy(W,V);
 
   double beta1   = sqrt(PLA.dot(V,VOLD));
   double snprod  = beta1;
@@ -673,7 +953,8 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   PLA.copy(VOLD,VOLDER);
   PLA.copy(V,VOLD);
 
-  PLA.mult(DIAG,V,V);
+  precondition(PLA, DIAG, V, W);
+  PLA.copy(W,V);
 
   double betaold = beta1;
   double beta = sqrt(PLA.dot(VOLD,V));
@@ -734,7 +1015,8 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
     PLA.copy(VOLD,VOLDER);
     PLA.copy(V,VOLD);
 
-    PLA.mult(DIAG,V,V);
+    precondition(PLA, DIAG, V, W);
+    PLA.copy(W,V);
 
     betaold = beta;
     beta = sqrt(PLA.dot(VOLD,V));
@@ -859,6 +1141,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
     if (PLA.first()) (*convergence_)[niter] = xmin;
 
     niter++;
+    if (PLA.first()) num_iterations_ = niter;
 
     callback_step_cnt++;
 #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
@@ -1021,6 +1304,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
     if (PLA.first()) (*convergence_)[niter] = xmin;
 
     niter++;
+    if (PLA.first()) num_iterations_ = niter;
 
     callback_step_cnt++;
 #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
@@ -1067,6 +1351,251 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   return (true);
 }
 
+//------------------------------------------------------------------
+// CG for several right-hand sides at once. Every column keeps its own CG
+// recurrence, but the matrix products and the reductions are done for all
+// unconverged columns together, so the matrix is read once per iteration.
+
+class SolveLinearSystemMultipleCGAlgo : public SolveLinearSystemParallelAlgo
+{
+public:
+  SolveLinearSystemMultipleCGAlgo(const AlgorithmBase* base,
+    const std::vector<DenseColumnMatrixHandle>& b,
+    const std::vector<DenseColumnMatrixHandle>& x0,
+    const std::vector<DenseColumnMatrixHandle>& x);
+
+  bool run(SparseRowMatrixHandle a);
+  bool parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const override;
+
+  const std::vector<int>& iterations() const { return iterations_; }
+
+private:
+  std::vector<DenseColumnMatrixHandle> b_, x0_, x_;
+  mutable std::vector<int> iterations_;
+};
+
+SolveLinearSystemMultipleCGAlgo::SolveLinearSystemMultipleCGAlgo(const AlgorithmBase* base,
+    const std::vector<DenseColumnMatrixHandle>& b,
+    const std::vector<DenseColumnMatrixHandle>& x0,
+    const std::vector<DenseColumnMatrixHandle>& x) :
+  SolveLinearSystemParallelAlgo(base), b_(b), x0_(x0), x_(x), iterations_(b.size(), 0)
+{
+}
+
+bool SolveLinearSystemMultipleCGAlgo::run(SparseRowMatrixHandle a)
+{
+  // the first column sizes the parallel run, parallel() links the others
+  SolverInputs matrices;
+  matrices.A = a;
+  matrices.b = b_[0];
+  matrices.x0 = x0_[0];
+  matrices.x = x_[0];
+
+  start(matrices);
+
+  return (true);
+}
+
+bool SolveLinearSystemMultipleCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
+{
+  typedef std::vector<ParallelLinearAlgebra::ParallelVector> ParallelVectors;
+
+  const size_t ncols = b_.size();
+  ParallelLinearAlgebra::ParallelMatrix A;
+  ParallelLinearAlgebra::ParallelVector DIAG, X0;
+  ParallelVectors B(ncols), X(ncols), R(ncols), Z(ncols), P(ncols), Q(ncols);
+
+  double tolerance =     algo_->get(Variables::TargetError).toDouble();
+  int    max_iter =      algo_->get(Variables::MaxIterations).toInt();
+  int    niter = 0;
+
+  bool linked = PLA.add_matrix(matrices.A, A);
+  for (size_t c = 0; c < ncols; ++c)
+  {
+    linked = linked && PLA.add_vector(b_[c], B[c]) &&
+      PLA.add_vector(x0_[c], X0) && PLA.add_vector(x_[c], X[c]);
+    if (linked)
+      PLA.copy(X0, X[c]);
+  }
+  if (!linked)
+  {
+    if (PLA.first())
+      algo_->error("Could not link matrices");
+    PLA.wait();
+    return (false);
+  }
+
+  bool allocated = PLA.new_vector(DIAG);
+  for (size_t c = 0; c < ncols; ++c)
+  {
+    allocated = allocated && PLA.new_vector(R[c]) && PLA.new_vector(Z[c]) &&
+      PLA.new_vector(P[c]) && PLA.new_vector(Q[c]);
+  }
+  if (!allocated)
+  {
+    if (PLA.first())
+      algo_->error("Could not allocate enough memory for algorithm");
+    PLA.wait();
+    return (false);
+  }
+
+  // Build a preconditioner
+  setup_preconditioner(PLA, A, DIAG);
+
+  PLA.mult(A, X, Q);
+  for (size_t c = 0; c < ncols; ++c)
+    PLA.sub(B[c], Q[c], R[c]);
+
+  std::vector<double> bnorm, error;
+  PLA.dot(B, B, bnorm);
+  PLA.dot(R, R, error);
+
+  // columns that still iterate
+  std::vector<size_t> active;
+  for (size_t c = 0; c < ncols; ++c)
+  {
+    bnorm[c] = sqrt(bnorm[c]);
+    error[c] = bnorm[c] > 0.0 ? sqrt(error[c])/bnorm[c] : 0.0;
+    if (error[c] > tolerance)
+      active.push_back(c);
+  }
+
+  auto select = [&active](const ParallelVectors& V)
+  {
+    ParallelVectors selected;
+    selected.reserve(active.size());
+    for (auto c : active)
+      selected.push_back(V[c]);
+    return selected;
+  };
+
+  std::vector<double> bkden(ncols, 0.0), bknum, akden, rnorm;
+  int cnt = 0;
+
+  while (!active.empty() && niter < max_iter)
+  {
+    for (auto c : active)
+      precondition(PLA, DIAG, R[c], Z[c]);
+    PLA.dot(select(Z), select(R), bknum);
+
+    for (size_t q = 0; q < active.size(); ++q)
+    {
+      const size_t c = active[q];
+      if (niter == 0)
+        PLA.copy(Z[c], P[c]);
+      else
+        PLA.scale_add(bknum[q]/bkden[c], P[c], Z[c], P[c]);
+      bkden[c] = bknum[q];
+    }
+
+    const ParallelVectors activeP = select(P);
+    ParallelVectors activeQ = select(Q);
+    PLA.mult(A, activeP, activeQ);
+    PLA.dot(activeP, activeQ, akden);
+
+    for (size_t q = 0; q < active.size(); ++q)
+    {
+      const size_t c = active[q];
+      double ak = bkden[c]/akden[q];
+      PLA.scale_add(ak, P[c], X[c], X[c]);
+      PLA.scale_add(-ak, Q[c], R[c], R[c]);
+    }
+
+    const ParallelVectors activeR = select(R);
+    PLA.dot(activeR, activeR, rnorm);
+    niter++;
+
+    std::vector<size_t> still_active;
+    for (size_t q = 0; q < active.size(); ++q)
+    {
+      const size_t c = active[q];
+      error[c] = sqrt(rnorm[q])/bnorm[c];
+      if (PLA.first())
+        iterations_[c] = niter;
+      if (error[c] > tolerance)
+        still_active.push_back(c);
+    }
+    active.swap(still_active);
+
+    cnt++;
+    if (cnt == 20)
+    {
+      cnt = 0;
+      algo_->update_progress(static_cast<double>(ncols - active.size())/ncols);
+    }
+  }
+
+  if (PLA.first())
+  {
+    std::ostringstream ostr;
+    ostr << "Solver finished " << ncols << " right-hand sides after " << niter << " iterations, "
+      << active.size() << " did not reach the target error";
+    algo_->remark(ostr.str());
+  }
+
+  PLA.wait();
+
+  return true;
+}
+
+//------------------------------------------------------------------
+// Direct solves: the factorization is kept in the SolverStateCache, so
+// solving again with the same matrix only does the triangular solves.
+
+namespace
+{
+  typedef SparseDirectSolver<double> DirectSolver;
+
+  bool isDirectMethod(const std::string& method)
+  {
+    return method == "ldlt" || method == "lu";
+  }
+
+  DirectSolver::DenseBlock solveDirect(const AlgorithmBase* algo, SparseRowMatrixHandle A,
+                                       const DenseMatrix::EigenBase& B)
+  {
+    const std::string method = algo->getOption(Variables::Method);
+    const std::string kind = "SparseDirectSolver:" + method;
+
+    auto solver = SolverStateCache::instance().take<DirectSolver>(A, kind);
+    if (solver)
+      algo->remark("Reusing cached " + solver->description());
+    else
+    {
+      solver = makeShared<DirectSolver>(method == "ldlt" ? DirectSolver::LDLT : DirectSolver::LU);
+      DirectSolver::ColumnMajorMatrix columnMajor(*A);
+      columnMajor.makeCompressed();
+      if (solver->compute(columnMajor) != Eigen::Success)
+      {
+        BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << SCIRun::Core::ErrorMessage(
+          method == "ldlt" ? "Sparse LDLT factorization failed, the matrix is singular"
+                           : "Sparse LU factorization failed, the matrix is singular"));
+      }
+      algo->remark("Using " + solver->description());
+    }
+
+    auto X = solver->solve(B);
+    SolverStateCache::instance().put(A, kind, solver, solver->memory_size());
+
+    // LDLT silently gives a wrong answer for a nonsymmetric matrix
+    const double tolerance = algo->get(Variables::TargetError).toDouble();
+    for (int c = 0; c < B.cols(); ++c)
+    {
+      const double bnorm = B.col(c).norm();
+      const double error = bnorm > 0.0 ? (B.col(c) - (*A) * X.col(c)).norm() / bnorm : 0.0;
+      if (error > tolerance)
+      {
+        std::ostringstream ostr;
+        ostr << "Direct solve has relative residual " << error << " above the target error"
+          << (method == "ldlt" ? ", check that the matrix is symmetric" : "");
+        algo->warning(ostr.str());
+        break;
+      }
+    }
+    return X;
+  }
+}
+
 bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
                            DenseColumnMatrixHandle b,
                            DenseColumnMatrixHandle x0,
@@ -1156,6 +1685,14 @@ bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
       BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Conjugate Gradient method failed"));
     }
   }
+  else if (method == "pipelined_cg")
+  {
+    SolveLinearSystemPipelinedCGAlgo algo(this);
+    if(!algo.run(A,b,x0,x,conv))
+    {
+      BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Pipelined Conjugate Gradient method failed"));
+    }
+  }
   else if (method == "bicg")
   {
     SolveLinearSystemBICGAlgo algo(this);
@@ -1180,6 +1717,10 @@ bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
       BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("MINRES method failed"));
     }
   }
+  else if (isDirectMethod(method))
+  {
+    x = makeShared<DenseColumnMatrix>(solveDirect(this, A, *b).col(0));
+  }
   else
     BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Unknown solver method"));
 
@@ -1200,9 +1741,146 @@ bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
   return true;
 }
 
+bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
+                           DenseMatrixHandle B,
+                           DenseMatrixHandle X0,
+                           DenseMatrixHandle& X,
+                           DenseColumnMatrixHandle& residuals,
+                           DenseColumnMatrixHandle& iterations) const
+{
+  ScopedAlgorithmStatusReporter ssr(this, "SolveLinearSystem");
+  ENSURE_ALGORITHM_INPUT_NOT_NULL(A, "No matrix A is given");
+  ENSURE_ALGORITHM_INPUT_NOT_NULL(B, "No matrix B is given");
+
+  double tolerance = get(Variables::TargetError).toDouble();
+  int maxIterations = get(Variables::MaxIterations).toInt();
+  ENSURE_POSITIVE_DOUBLE(tolerance, "Tolerance out of range!");
+  ENSURE_POSITIVE_INT(maxIterations, "Max iterations out of range!");
+
+  if (A->nrows() != A->ncols())
+  {
+    THROW_ALGORITHM_INPUT_ERROR("Matrix A is not square");
+  }
+
+  if (A->nrows() != B->nrows())
+  {
+    THROW_ALGORITHM_INPUT_ERROR("Matrix A and B do not have the same number of rows");
+  }
+
+  if (X0 && (X0->nrows() != B->nrows() || X0->ncols() != B->ncols()))
+  {
+    THROW_ALGORITHM_INPUT_ERROR("Matrix X0 and B need to have the same size");
+  }
+
+  const size_t ncols = B->ncols();
+  if (ncols == 0)
+  {
+    THROW_ALGORITHM_INPUT_ERROR("Matrix B has no columns");
+  }
+
+  std::vector<DenseColumnMatrixHandle> b(ncols), x0(ncols), x(ncols);
+  for (size_t c = 0; c < ncols; ++c)
+  {
+    b[c] = makeShared<DenseColumnMatrix>(B->col(c));
+    x0[c] = X0 ? makeShared<DenseColumnMatrix>(X0->col(c)) : makeShared<DenseColumnMatrix>(DenseColumnMatrix::Zero(B->nrows()));
+    x[c] = makeShared<DenseColumnMatrix>(B->nrows());
+  }
+
+  std::string method = getOption(Variables::Method);
+  iterations = makeShared<DenseColumnMatrix>(DenseColumnMatrix::Zero(ncols));
+
+  if (isDirectMethod(method))
+  {
+    // all columns are solved with one factorization
+    auto solution = solveDirect(this, A, *B);
+    for (size_t c = 0; c < ncols; ++c)
+      *x[c] = solution.col(c);
+  }
+  else if (method == "cg")
+  {
+    SolveLinearSystemMultipleCGAlgo algo(this, b, x0, x);
+    if (!algo.run(A))
+    {
+      BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Conjugate Gradient method failed"));
+    }
+    for (size_t c = 0; c < ncols; ++c)
+      (*iterations)[c] = algo.iterations()[c];
+  }
+  else
+  {
+    // The other methods go column by column, but still share the preconditioner
+    auto preconditioner = SolveLinearSystemParallelAlgo::make_preconditioner(this, A);
+    for (size_t c = 0; c < ncols; ++c)
+    {
+      // A zero column has the zero solution; the solvers measure the error
+      // relative to ||b|| and would not see it converge
+      if (B->col(c).isZero(0.0))
+      {
+        x[c]->setZero();
+        continue;
+      }
+
+      std::unique_ptr<SolveLinearSystemParallelAlgo> algo;
+      if (method == "pipelined_cg")
+        algo.reset(new SolveLinearSystemPipelinedCGAlgo(this));
+      else if (method == "bicg")
+        algo.reset(new SolveLinearSystemBICGAlgo(this));
+      else if (method == "jacobi")
+        algo.reset(new SolveLinearSystemJACOBIAlgo(this));
+      else if (method == "minres")
+        algo.reset(new SolveLinearSystemMINRESAlgo(this));
+      else
+        BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Unknown solver method"));
+
+      algo->set_preconditioner(preconditioner);
+      DenseColumnMatrixHandle conv;
+      if (!algo->run(A, b[c], x0[c], x[c], conv))
+      {
+        BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Solver failed on right-hand side " + std::to_string(c)));
+      }
+      (*iterations)[c] = algo->num_iterations();
+    }
+    SolveLinearSystemParallelAlgo::release_preconditioner(this, A, preconditioner);
+  }
+
+  X = makeShared<DenseMatrix>(B->nrows(), ncols);
+  for (size_t c = 0; c < ncols; ++c)
+    X->col(c) = *x[c];
+
+  // relative residual of every column
+  residuals = makeShared<DenseColumnMatrix>(ncols);
+  const DenseMatrix::EigenBase R = *B - (*A) * (*X);
+  for (size_t c = 0; c < ncols; ++c)
+  {
+    const double bnorm = B->col(c).norm();
+    (*residuals)[c] = bnorm > 0.0 ? R.col(c).norm() / bnorm : 0.0;
+
+    std::ostringstream ostr;
+    ostr << "Right-hand side " << c << ": " << (*iterations)[c] << " iterations, relative residual " << (*residuals)[c];
+    remark(ostr.str());
+  }
+
+  return true;
+}
+
 AlgorithmOutput SolveLinearSystemAlgo::run(const AlgorithmInput& input) const
 {
   auto lhs = input.get<SparseRowMatrix>(Variables::LHS);
+
+  auto rhsColumns = input.get<DenseMatrix>(Variables::RHS);
+  if (rhsColumns)
+  {
+    DenseMatrixHandle solution;
+    DenseColumnMatrixHandle residuals, iterations;
+    run(lhs, rhsColumns, DenseMatrixHandle(), solution, residuals, iterations);
+
+    AlgorithmOutput output;
+    output[Variables::Solution] = solution;
+    output[Residuals] = residuals;
+    output[Iterations] = iterations;
+    return output;
+  }
+
   auto rhs = input.get<DenseColumnMatrix>(Variables::RHS);
 
   DenseColumnMatrixHandle solution;
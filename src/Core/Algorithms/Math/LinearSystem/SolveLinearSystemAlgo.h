@@ -61,7 +61,21 @@ class SCISHARE SolveLinearSystemAlgo : public AlgorithmBase
              Datatypes::DenseColumnMatrixHandle x0,
              Datatypes::DenseColumnMatrixHandle& x) const;
 
+    // Solve A*X = B for all columns of B, sharing the preconditioner and
+    // matrix passes between columns. residuals holds ||b - A*x||/||b|| and
+    // iterations the iteration count (zero for direct methods) per column.
+    bool run(Datatypes::SparseRowMatrixHandle A,
+             Datatypes::DenseMatrixHandle B,
+             Datatypes::DenseMatrixHandle X0,
+             Datatypes::DenseMatrixHandle& X,
+             Datatypes::DenseColumnMatrixHandle& residuals,
+             Datatypes::DenseColumnMatrixHandle& iterations) const;
+
     AlgorithmOutput run(const AlgorithmInput& input) const override;
+
+    // Extra outputs when RHS has several columns
+    static AlgorithmOutputName Residuals;
+    static AlgorithmOutputName Iterations;
 };
 
 
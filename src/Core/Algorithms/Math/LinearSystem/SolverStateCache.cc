@@ -0,0 +1,212 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Core/Algorithms/Math/LinearSystem/SolverStateCache.h>
+#include <Core/Thread/Parallel.h>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Thread;
+
+SolverStateCache& SolverStateCache::instance()
+{
+  static SolverStateCache cache;
+  return cache;
+}
+
+SolverStateCache::SolverStateCache(size_t memoryBudget) :
+  memoryBudget_(memoryBudget), memoryUsed_(0), lock_("SolverStateCache")
+{
+}
+
+bool SolverStateCache::Key::operator==(const Key& other) const
+{
+  return id == other.id && rows == other.rows && cols == other.cols &&
+    nonzeros == other.nonzeros && checksum == other.checksum && kind == other.kind;
+}
+
+namespace
+{
+  inline uint64_t mix(uint64_t h, uint64_t v)
+  {
+    h ^= v * 0x9E3779B97F4A7C15ULL;
+    h ^= h >> 29;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    return h ^ (h >> 32);
+  }
+
+  uint64_t hashChunk(const unsigned char* data, size_t bytes)
+  {
+    uint64_t h = bytes;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= bytes; i += sizeof(uint64_t))
+    {
+      uint64_t v;
+      std::memcpy(&v, data + i, sizeof(v));
+      h = mix(h, v);
+    }
+    for (; i < bytes; ++i)
+      h = mix(h, data[i]);
+    return h;
+  }
+}
+
+size_t SolverStateCache::hashBytes(const void* data, size_t bytes, size_t seed)
+{
+  // chunks are hashed in parallel and combined in order, so the result does
+  // not depend on the number of threads
+  const size_t chunk = size_t(1) << 20;
+  const size_t numChunks = (bytes + chunk - 1) / chunk;
+  const unsigned char* bytePtr = static_cast<const unsigned char*>(data);
+
+  std::vector<uint64_t> hashes(numChunks);
+  Parallel::For(0, numChunks, 1, [&](size_t begin, size_t end)
+  {
+    for (size_t c = begin; c < end; ++c)
+      hashes[c] = hashChunk(bytePtr + c * chunk, std::min(chunk, bytes - c * chunk));
+  });
+
+  uint64_t h = mix(seed, bytes);
+  for (auto v : hashes)
+    h = mix(h, v);
+  return static_cast<size_t>(h);
+}
+
+bool SolverStateCache::contains(int id, const std::string& kind) const
+{
+  Guard g(lock_);
+  for (const auto& entry : entries_)
+  {
+    if (entry.key.id == id && entry.key.kind == kind)
+      return true;
+  }
+  return false;
+}
+
+SolverStateCache::StateHandle SolverStateCache::take(const Key& key)
+{
+  Guard g(lock_);
+  remove_expired();
+
+  for (auto it = entries_.begin(); it != entries_.end(); ++it)
+  {
+    if (it->key == key && !it->matrix.expired())
+    {
+      auto state = it->state;
+      memoryUsed_ -= it->memory;
+      entries_.erase(it);
+      return state;
+    }
+  }
+  return StateHandle();
+}
+
+void SolverStateCache::put(const Key& key, const std::weak_ptr<const void>& matrix, StateHandle state, size_t memory)
+{
+  if (!state)
+    return;
+
+  Guard g(lock_);
+  remove_expired();
+
+  // state that does not fit is not kept
+  if (memory > memoryBudget_)
+    return;
+
+  for (auto it = entries_.begin(); it != entries_.end(); ++it)
+  {
+    if (it->key == key)
+    {
+      memoryUsed_ -= it->memory;
+      entries_.erase(it);
+      break;
+    }
+  }
+
+  evict(memoryBudget_ - memory);
+  entries_.push_front({ key, matrix, state, memory });
+  memoryUsed_ += memory;
+}
+
+void SolverStateCache::remove_expired()
+{
+  for (auto it = entries_.begin(); it != entries_.end();)
+  {
+    if (it->matrix.expired())
+    {
+      memoryUsed_ -= it->memory;
+      it = entries_.erase(it);
+    }
+    else
+      ++it;
+  }
+}
+
+void SolverStateCache::evict(size_t budget)
+{
+  while (!entries_.empty() && memoryUsed_ > budget)
+  {
+    memoryUsed_ -= entries_.back().memory;
+    entries_.pop_back();
+  }
+}
+
+void SolverStateCache::setMemoryBudget(size_t bytes)
+{
+  Guard g(lock_);
+  memoryBudget_ = bytes;
+  evict(memoryBudget_);
+}
+
+size_t SolverStateCache::memoryBudget() const
+{
+  Guard g(lock_);
+  return memoryBudget_;
+}
+
+size_t SolverStateCache::memoryUsed() const
+{
+  Guard g(lock_);
+  return memoryUsed_;
+}
+
+size_t SolverStateCache::size() const
+{
+  Guard g(lock_);
+  return entries_.size();
+}
+
+void SolverStateCache::clear()
+{
+  Guard g(lock_);
+  entries_.clear();
+  memoryUsed_ = 0;
+}
@@ -0,0 +1,140 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_ALGORITHMS_MATH_LINEARSYSTEM_SOLVERSTATECACHE_H
+#define CORE_ALGORITHMS_MATH_LINEARSYSTEM_SOLVERSTATECACHE_H
+
+#include <list>
+#include <string>
+#include <boost/noncopyable.hpp>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Thread/Mutex.h>
+#include <Core/Algorithms/Math/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Math {
+
+// Keeps expensive solver state (preconditioners, factorizations) built for a
+// matrix so that solving again with the same matrix and a new right-hand side
+// can skip the setup. Entries are found by the id of the matrix object and a
+// checksum of its contents, so a matrix that was changed in place is not
+// matched. The checksum reads the whole matrix, so only state that costs
+// clearly more than that to rebuild belongs here; it is only computed when an
+// entry with the same id and kind exists. State is handed out exclusively:
+// take() removes the entry and put() returns it when the solve is done, so
+// two solvers never share work buffers. When the memory budget is exceeded
+// the least recently used entries are dropped.
+class SCISHARE SolverStateCache : boost::noncopyable
+{
+public:
+  typedef SharedPointer<void> StateHandle;
+
+  static SolverStateCache& instance();
+
+  explicit SolverStateCache(size_t memoryBudget = defaultMemoryBudget);
+
+  template <class T, class MatrixType>
+  SharedPointer<T> take(const SharedPointer<MatrixType>& matrix, const std::string& kind)
+  {
+    if (!contains(matrix->id(), kind))
+      return nullptr;
+    return std::static_pointer_cast<T>(take(makeKey(*matrix, kind)));
+  }
+
+  // memory is the approximate size of the state in bytes
+  template <class MatrixType>
+  void put(const SharedPointer<MatrixType>& matrix, const std::string& kind,
+           StateHandle state, size_t memory)
+  {
+    put(makeKey(*matrix, kind), matrix, state, memory);
+  }
+
+  void setMemoryBudget(size_t bytes);
+  size_t memoryBudget() const;
+  size_t memoryUsed() const;
+  size_t size() const;
+  void clear();
+
+  static const size_t defaultMemoryBudget = size_t(2) << 30;
+
+private:
+  struct Key
+  {
+    int id;
+    size_t rows, cols, nonzeros;
+    size_t checksum;
+    std::string kind;
+    bool operator==(const Key& other) const;
+  };
+
+  struct Entry
+  {
+    Key key;
+    std::weak_ptr<const void> matrix;
+    StateHandle state;
+    size_t memory;
+  };
+
+  template <typename T>
+  static Key makeKey(const Datatypes::SparseRowMatrixGeneric<T>& matrix, const std::string& kind)
+  {
+    size_t checksum = hashBytes(matrix.outerIndexPtr(), (matrix.rows() + 1) * sizeof(index_type), 0);
+    checksum = hashBytes(matrix.innerIndexPtr(), matrix.nonZeros() * sizeof(index_type), checksum);
+    checksum = hashBytes(matrix.valuePtr(), matrix.nonZeros() * sizeof(T), checksum);
+    return { matrix.id(), size_t(matrix.rows()), size_t(matrix.cols()), size_t(matrix.nonZeros()), checksum, kind };
+  }
+
+  template <typename T>
+  static Key makeKey(const Datatypes::DenseMatrixGeneric<T>& matrix, const std::string& kind)
+  {
+    const size_t checksum = hashBytes(matrix.data(), matrix.size() * sizeof(T), 0);
+    return { matrix.id(), size_t(matrix.rows()), size_t(matrix.cols()), size_t(matrix.size()), checksum, kind };
+  }
+
+  static size_t hashBytes(const void* data, size_t bytes, size_t seed);
+
+  bool contains(int id, const std::string& kind) const;
+  StateHandle take(const Key& key);
+  void put(const Key& key, const std::weak_ptr<const void>& matrix, StateHandle state, size_t memory);
+
+  void remove_expired();
+  void evict(size_t budget);
+
+  // most recently used entries are at the front
+  std::list<Entry> entries_;
+  size_t memoryBudget_;
+  size_t memoryUsed_;
+  mutable Thread::Mutex lock_;
+};
+
+}}}}
+
+#endif
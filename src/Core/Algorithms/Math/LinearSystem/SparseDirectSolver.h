@@ -0,0 +1,123 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_ALGORITHMS_MATH_LINEARSYSTEM_SPARSEDIRECTSOLVER_H
+#define CORE_ALGORITHMS_MATH_LINEARSYSTEM_SPARSEDIRECTSOLVER_H
+
+#include <sstream>
+#include <string>
+#include <boost/noncopyable.hpp>
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+#include <Eigen/SparseLU>
+#include <Eigen/OrderingMethods>
+#include <Core/Thread/Parallel.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Math {
+
+// Sparse direct solver built on Eigen's sparse factorizations. LDLT uses an
+// approximate minimum degree ordering and only reads the lower triangle, so
+// the matrix has to be symmetric (Hermitian for complex values). LU uses a
+// column approximate minimum degree ordering and works for any nonsingular
+// matrix. Once factored, the solver can be reused for any number of
+// right-hand sides; several columns are solved in parallel.
+template <typename T>
+class SparseDirectSolver : boost::noncopyable
+{
+public:
+  enum FactorType { LDLT, LU };
+
+  typedef Eigen::SparseMatrix<T, Eigen::ColMajor, index_type> ColumnMajorMatrix;
+  typedef Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> DenseBlock;
+
+  explicit SparseDirectSolver(FactorType type) : type_(type), size_(0) {}
+
+  FactorType type() const { return type_; }
+
+  Eigen::ComputationInfo compute(const ColumnMajorMatrix& A)
+  {
+    size_ = A.rows();
+    if (type_ == LDLT)
+    {
+      ldlt_.compute(A);
+      return ldlt_.info();
+    }
+
+    lu_.analyzePattern(A);
+    lu_.factorize(A);
+    return lu_.info();
+  }
+
+  template <class Rhs>
+  DenseBlock solve(const Eigen::MatrixBase<Rhs>& B) const
+  {
+    DenseBlock X(B.rows(), B.cols());
+    Thread::Parallel::For(0, B.cols(), 1, [&](size_t begin, size_t end)
+    {
+      for (size_t c = begin; c < end; ++c)
+      {
+        if (type_ == LDLT)
+          X.col(c) = ldlt_.solve(B.col(c));
+        else
+          X.col(c) = lu_.solve(B.col(c));
+      }
+    });
+    return X;
+  }
+
+  // Approximate memory held by the factors in bytes
+  size_t memory_size() const
+  {
+    const size_t entry = sizeof(T) + sizeof(index_type);
+    const size_t nonzeros = type_ == LDLT ? ldlt_.matrixL().nestedExpression().nonZeros() : lu_.nnzL() + lu_.nnzU();
+    return nonzeros * entry + size_ * (sizeof(T) + 3 * sizeof(index_type));
+  }
+
+  std::string description() const
+  {
+    std::ostringstream ostr;
+    if (type_ == LDLT)
+      ostr << "sparse LDLT factorization (AMD ordering, " << ldlt_.matrixL().nestedExpression().nonZeros() << " nonzeros in L)";
+    else
+      ostr << "sparse LU factorization (COLAMD ordering, " << lu_.nnzL() + lu_.nnzU() << " nonzeros in L and U)";
+    return ostr.str();
+  }
+
+private:
+  FactorType type_;
+  size_t size_;
+  Eigen::SimplicialLDLT<ColumnMajorMatrix, Eigen::Lower, Eigen::AMDOrdering<index_type>> ldlt_;
+  Eigen::SparseLU<ColumnMajorMatrix, Eigen::COLAMDOrdering<index_type>> lu_;
+};
+
+}}}}
+
+#endif
@@ -33,6 +33,7 @@
 ///////////////////////////
 
 #include <cfloat>
+#include <algorithm>
 
 #include <Core/Datatypes/Matrix.h>
 #include <Core/Datatypes/DenseColumnMatrix.h>
@@ -650,6 +651,126 @@ void ParallelLinearAlgebra::mult(const ParallelMatrix& a, const ParallelVector&
   }
 }
 
+void ParallelLinearAlgebra::mult(const ParallelMatrix& a, const std::vector<ParallelVector>& b, std::vector<ParallelVector>& r)
+{
+  wait();
+
+  const size_t k = b.size();
+  std::vector<const double*> idata(k);
+  std::vector<double*> odata(k);
+  for (size_t c = 0; c < k; c++)
+  {
+    idata[c] = b[c].data_;
+    odata[c] = r[c].data_;
+  }
+  std::vector<double> sum(k);
+
+  double* data = a.data_;
+  auto rows = a.rows_;
+  auto columns = a.columns_;
+
+  for(size_t i=start_;i<end_;i++)
+  {
+    std::fill(sum.begin(), sum.end(), 0.0);
+    index_type row_idx = rows[i];
+    index_type next_idx = rows[i+1];
+    for(index_type j=row_idx;j<next_idx;j++)
+    {
+      const double value = data[j];
+      const index_type column = columns[j];
+      for (size_t c = 0; c < k; c++)
+        sum[c] += value*idata[c][column];
+    }
+    for (size_t c = 0; c < k; c++)
+      odata[c][i] = sum[c];
+  }
+}
+
+void ParallelLinearAlgebra::dot(const std::vector<ParallelVector>& a, const std::vector<ParallelVector>& b, std::vector<double>& r)
+{
+  const size_t k = a.size();
+  r.assign(k, 0.0);
+  for (size_t c = 0; c < k; c++)
+  {
+    const double* a_ptr = a[c].data_+start_;
+    const double* b_ptr = b[c].data_+start_;
+    double val = 0.0;
+    for (size_t j = 0; j < local_size_; j++)
+      val += a_ptr[j]*b_ptr[j];
+    r[c] = val;
+  }
+  reduce_sum(r);
+}
+
+void ParallelLinearAlgebra::cg_dots(const ParallelVector& r, const ParallelVector& u, const ParallelVector& w,
+                                    double& gamma, double& delta, double& rr)
+{
+  const double* r_ptr = r.data_+start_;
+  const double* u_ptr = u.data_+start_;
+  const double* w_ptr = w.data_+start_;
+
+  double vals[3] = { 0.0, 0.0, 0.0 };
+  for (size_t j = 0; j < local_size_; j++)
+  {
+    vals[0] += r_ptr[j]*u_ptr[j];
+    vals[1] += w_ptr[j]*u_ptr[j];
+    vals[2] += r_ptr[j]*r_ptr[j];
+  }
+
+  reduce_sum(vals, 3);
+  gamma = vals[0];
+  delta = vals[1];
+  rr = vals[2];
+}
+
+void ParallelLinearAlgebra::pipelined_cg_update(double alpha, double beta,
+                                                const ParallelVector& m, const ParallelVector& n,
+                                                ParallelVector& z, ParallelVector& q, ParallelVector& s, ParallelVector& p,
+                                                ParallelVector& x, ParallelVector& r, ParallelVector& u, ParallelVector& w,
+                                                double& gamma, double& delta, double& rr)
+{
+  const double* m_ptr = m.data_+start_;
+  const double* n_ptr = n.data_+start_;
+  double* z_ptr = z.data_+start_;
+  double* q_ptr = q.data_+start_;
+  double* s_ptr = s.data_+start_;
+  double* p_ptr = p.data_+start_;
+  double* x_ptr = x.data_+start_;
+  double* r_ptr = r.data_+start_;
+  double* u_ptr = u.data_+start_;
+  double* w_ptr = w.data_+start_;
+
+  double vals[3] = { 0.0, 0.0, 0.0 };
+  for (size_t j = 0; j < local_size_; j++)
+  {
+    const double zj = n_ptr[j] + beta*z_ptr[j];
+    const double qj = m_ptr[j] + beta*q_ptr[j];
+    const double sj = w_ptr[j] + beta*s_ptr[j];
+    const double pj = u_ptr[j] + beta*p_ptr[j];
+    z_ptr[j] = zj;
+    q_ptr[j] = qj;
+    s_ptr[j] = sj;
+    p_ptr[j] = pj;
+
+    x_ptr[j] += alpha*pj;
+    const double rj = r_ptr[j] - alpha*sj;
+    const double uj = u_ptr[j] - alpha*qj;
+    const double wj = w_ptr[j] - alpha*zj;
+    r_ptr[j] = rj;
+    u_ptr[j] = uj;
+    w_ptr[j] = wj;
+
+    vals[0] += rj*uj;
+    vals[1] += wj*uj;
+    vals[2] += rj*rj;
+  }
+
+  reduce_sum(vals, 3);
+  gamma = vals[0];
+  delta = vals[1];
+  rr = vals[2];
+}
+
 void ParallelLinearAlgebra::mult_trans(ParallelMatrix& a, ParallelVector& b, ParallelVector& r)
 {
   wait();
@@ -722,31 +843,67 @@ void ParallelLinearAlgebra::absdiag(const ParallelMatrix& a, ParallelVector& r)
 }
 
 double ParallelLinearAlgebra::reduce_sum(double val)
+{
+  reduce_sum(&val, 1);
+  return (val);
+}
+
+void ParallelLinearAlgebra::reduce_sum(double* vals, int count)
 {
   int buffer = reduce_buffer_;
-  reduce_[buffer][proc_] = val;
+  for (int c=0; c<count; c++) reduce_[buffer][proc_].values[c] = vals[c];
   if (reduce_buffer_)
     reduce_buffer_ = 0;
   else
     reduce_buffer_ = 1;
   wait();
 
-  double ret = 0.0; for (int j=0; j<nproc_;j++) ret += reduce_[buffer][j];
-  return (ret);
+  for (int c=0; c<count; c++)
+  {
+    double ret = 0.0; for (int j=0; j<nproc_;j++) ret += reduce_[buffer][j].values[c];
+    vals[c] = ret;
+  }
+}
+
+void ParallelLinearAlgebra::reduce_sum(std::vector<double>& vals)
+{
+  const size_t k = vals.size();
+  auto& buffer = data_.reduceBufferMultiple();
+
+  // every thread writes its own block, padded to whole cache lines
+  const size_t stride = (k + 7) & ~size_t(7);
+
+  // the first wait also makes sure everyone has read the previous result
+  wait();
+  if (first() && buffer.size() < stride*nproc_)
+    buffer.resize(stride*nproc_);
+  wait();
+
+  for (size_t c = 0; c < k; c++)
+    buffer[proc_*stride+c] = vals[c];
+  wait();
+
+  for (size_t c = 0; c < k; c++)
+  {
+    double ret = 0.0;
+    for (int j = 0; j < nproc_; j++)
+      ret += buffer[j*stride+c];
+    vals[c] = ret;
+  }
 }
 
 /// @todo: std::max_element
 double ParallelLinearAlgebra::reduce_max(double val)
 {
   int buffer = reduce_buffer_;
-  reduce_[buffer][proc_] = val;
+  reduce_[buffer][proc_].values[0] = val;
   if (reduce_buffer_)
     reduce_buffer_ = 0;
   else
     reduce_buffer_ = 1;
   wait();
 
-  double ret = -(DBL_MAX); for (int j=0; j<nproc_;j++) if (reduce_[buffer][j] > ret) ret = reduce_[buffer][j];
+  double ret = -(DBL_MAX); for (int j=0; j<nproc_;j++) if (reduce_[buffer][j].values[0] > ret) ret = reduce_[buffer][j].values[0];
   return (ret);
 }
 
@@ -754,14 +911,14 @@ double ParallelLinearAlgebra::reduce_max(double val)
 double ParallelLinearAlgebra::reduce_min(double val)
 {
   int buffer = reduce_buffer_;
-  reduce_[buffer][proc_] = val;
+  reduce_[buffer][proc_].values[0] = val;
   if (reduce_buffer_)
     reduce_buffer_ = 0;
   else
     reduce_buffer_ = 1;
   wait();
 
-  double ret = DBL_MAX; for (int j=0; j<nproc_;j++) if (reduce_[buffer][j] < ret) ret = reduce_[buffer][j];
+  double ret = DBL_MAX; for (int j=0; j<nproc_;j++) if (reduce_[buffer][j].values[0] < ret) ret = reduce_[buffer][j].values[0];
   return (ret);
 }
 
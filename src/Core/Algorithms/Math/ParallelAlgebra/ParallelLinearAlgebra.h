@@ -64,6 +64,14 @@ namespace Math {
     }
   };
 
+  // Per-thread slot for the reductions. Each thread writes its own cache
+  // line, so threads do not invalidate each other's lines while reducing.
+  struct ReduceSlot
+  {
+    static const int size = 4;
+    alignas(64) double values[size];
+  };
+
   class SCISHARE ParallelLinearAlgebraSharedData : boost::noncopyable
   {
   public:
@@ -93,8 +101,9 @@ namespace Math {
 
     SolverInputs& inputs() { return imatrices_; }
 
-    double* reduceBuffer1() { return &reduce1_[0]; }
-    double* reduceBuffer2() { return &reduce2_[0]; }
+    ReduceSlot* reduceBuffer1() { return &reduce1_[0]; }
+    ReduceSlot* reduceBuffer2() { return &reduce2_[0]; }
+    std::vector<double>& reduceBufferMultiple() { return reduce_multiple_; }
 
   private:
     size_t size_;
@@ -105,8 +114,9 @@ namespace Math {
     SCIRun::Core::Thread::Barrier barrier_;
     int numProcs_;
     /// classes for communication
-    std::vector<double> reduce1_;
-    std::vector<double> reduce2_;
+    std::vector<ReduceSlot> reduce1_;
+    std::vector<ReduceSlot> reduce2_;
+    std::vector<double> reduce_multiple_;
   };
 
 // The algorithm that uses this should derive from this class
@@ -185,6 +195,26 @@ public:
 
   void mult(const ParallelMatrix& a, const ParallelVector& b, ParallelVector& r);
 
+  // r[c] = a*b[c] for every c, reading the matrix only once for all vectors
+  void mult(const ParallelMatrix& a, const std::vector<ParallelVector>& b, std::vector<ParallelVector>& r);
+
+  // r[c] = dot(a[c],b[c]) for every c, with a single reduction
+  void dot(const std::vector<ParallelVector>& a, const std::vector<ParallelVector>& b, std::vector<double>& r);
+
+  // gamma = dot(r,u), delta = dot(w,u) and rr = dot(r,r) with one reduction
+  void cg_dots(const ParallelVector& r, const ParallelVector& u, const ParallelVector& w,
+               double& gamma, double& delta, double& rr);
+
+  // The vector update of one pipelined CG iteration in a single pass:
+  //   z = n + beta*z, q = m + beta*q, s = w + beta*s, p = u + beta*p,
+  //   x += alpha*p, r -= alpha*s, u -= alpha*q, w -= alpha*z
+  // followed by cg_dots() of the new r, u and w, all with one reduction.
+  void pipelined_cg_update(double alpha, double beta,
+                           const ParallelVector& m, const ParallelVector& n,
+                           ParallelVector& z, ParallelVector& q, ParallelVector& s, ParallelVector& p,
+                           ParallelVector& x, ParallelVector& r, ParallelVector& u, ParallelVector& w,
+                           double& gamma, double& delta, double& rr);
+
   void absdiag(const ParallelMatrix& a, ParallelVector& r);
 
   void ones(ParallelVector& r);
@@ -199,6 +229,9 @@ private:
   double reduce_sum(double val);
   double reduce_min(double val);
   double reduce_max(double val);
+  void reduce_sum(std::vector<double>& vals);
+  // sums count <= ReduceSlot::size values with a single barrier
+  void reduce_sum(double* vals, int count);
 
   ParallelLinearAlgebraSharedData& data_;
 
@@ -211,7 +244,7 @@ private:
   size_t start_;
   size_t end_;
 
-  double* reduce_[2];
+  ReduceSlot* reduce_[2];
   int     reduce_buffer_;
 
 
@@ -0,0 +1,671 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cmath>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <sstream>
+#include <Eigen/Eigenvalues>
+#include <Core/Algorithms/Math/ParallelAlgebra/ParallelPreconditioners.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+#include <Core/Thread/Parallel.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core;
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  typedef ParallelPreconditioner::SparseMatrix SparseMatrix;
+
+  // Rows of an n-row vector handled by this thread
+  void thread_range(ParallelLinearAlgebra& PLA, size_t n, size_t& begin, size_t& end)
+  {
+    begin = (n * PLA.proc()) / PLA.nproc();
+    end = (n * (PLA.proc() + 1)) / PLA.nproc();
+  }
+
+  // y = A*x for rows [begin, end)
+  void mult(const SparseMatrix& A, const double* x, double* y, size_t begin, size_t end)
+  {
+    const auto rows = A.outerIndexPtr();
+    const auto columns = A.innerIndexPtr();
+    const auto data = A.valuePtr();
+    for (size_t i = begin; i < end; ++i)
+    {
+      double sum = 0.0;
+      for (index_type j = rows[i]; j < rows[i + 1]; ++j)
+        sum += data[j] * x[columns[j]];
+      y[i] = sum;
+    }
+  }
+
+  // r = b - A*x for rows [begin, end)
+  void residual(const SparseMatrix& A, const double* b, const double* x, double* r, size_t begin, size_t end)
+  {
+    const auto rows = A.outerIndexPtr();
+    const auto columns = A.innerIndexPtr();
+    const auto data = A.valuePtr();
+    for (size_t i = begin; i < end; ++i)
+    {
+      double sum = b[i];
+      for (index_type j = rows[i]; j < rows[i + 1]; ++j)
+        sum -= data[j] * x[columns[j]];
+      r[i] = sum;
+    }
+  }
+
+  // Position of the diagonal entry in each row of a compressed matrix
+  std::vector<index_type> diagonal_positions(const SparseMatrix& A)
+  {
+    const auto rows = A.outerIndexPtr();
+    const auto columns = A.innerIndexPtr();
+    const auto data = A.valuePtr();
+    std::vector<index_type> diag(A.rows());
+    for (index_type i = 0; i < A.rows(); ++i)
+    {
+      const auto pos = std::lower_bound(columns + rows[i], columns + rows[i + 1], i);
+      if (pos == columns + rows[i + 1] || *pos != i || data[pos - columns] == 0.0)
+      {
+        BOOST_THROW_EXCEPTION(AlgorithmProcessingException()
+          << ErrorMessage("Incomplete factorization needs a nonzero diagonal, row " + std::to_string(i) + " has none"));
+      }
+      diag[i] = pos - columns;
+    }
+    return diag;
+  }
+
+  // Largest eigenvalue of D^-1 A by power iteration
+  double spectral_radius(const SparseMatrix& A, const std::vector<double>& inv_diag)
+  {
+    const size_t n = A.rows();
+    std::vector<double> v(n), w(n);
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (auto& vi : v)
+      vi = dist(gen);
+
+    double rho = 0.0;
+    for (int iter = 0; iter < 15; ++iter)
+    {
+      mult(A, v.data(), w.data(), 0, n);
+      double norm = 0.0;
+      for (size_t i = 0; i < n; ++i)
+      {
+        w[i] *= inv_diag[i];
+        norm += w[i] * w[i];
+      }
+      norm = std::sqrt(norm);
+      if (norm == 0.0)
+        break;
+      double vnorm = 0.0;
+      for (size_t i = 0; i < n; ++i)
+        vnorm += v[i] * v[i];
+      rho = norm / std::sqrt(vnorm);
+      for (size_t i = 0; i < n; ++i)
+        v[i] = w[i] / norm;
+    }
+    return rho > 0.0 ? rho : 1.0;
+  }
+}
+
+ParallelPreconditionerHandle ParallelPreconditioner::create(const std::string& name, const SparseRowMatrix& A, bool transpose)
+{
+  if (name == "AMG")
+    return makeShared<AggregationAMGPreconditioner>(A);
+  if (name == "IC0")
+    return makeShared<IncompleteFactorPreconditioner>(A, IncompleteFactorPreconditioner::IC0, transpose);
+  if (name == "ILU0")
+    return makeShared<IncompleteFactorPreconditioner>(A, IncompleteFactorPreconditioner::ILU0, transpose);
+  return nullptr;
+}
+
+//------------------------------------------------------------------
+// IC(0) / ILU(0)
+
+IncompleteFactorPreconditioner::IncompleteFactorPreconditioner(const SparseRowMatrix& A, FactorType type, bool transpose)
+  : type_(type)
+{
+  if (A.rows() != A.cols())
+    BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Incomplete factorization needs a square matrix"));
+
+  SparseMatrix LU(A);
+  LU.makeCompressed();
+  const auto diag = diagonal_positions(LU);
+
+  // The factorization of a row needs the rows in its lower triangle, which is
+  // the same dependency as in the forward solve: factor level by level.
+  lower_.strict = LU.triangularView<Eigen::StrictlyLower>();
+  make_levels(lower_, true);
+
+  if (type_ == IC0)
+    factor_ic0(LU, diag);
+  else
+    factor_ilu0(LU, diag);
+
+  const index_type n = LU.rows();
+  const auto values = LU.valuePtr();
+  lower_.strict = LU.triangularView<Eigen::StrictlyLower>();
+  lower_.inv_diag.resize(n);
+  upper_.inv_diag.resize(n);
+  if (type_ == IC0)
+  {
+    // M = L L^T
+    for (index_type i = 0; i < n; ++i)
+      lower_.inv_diag[i] = 1.0 / values[diag[i]];
+    upper_.strict = lower_.strict.transpose();
+    upper_.inv_diag = lower_.inv_diag;
+  }
+  else
+  {
+    // M = L U with unit diagonal in L
+    for (index_type i = 0; i < n; ++i)
+    {
+      lower_.inv_diag[i] = 1.0;
+      upper_.inv_diag[i] = 1.0 / values[diag[i]];
+    }
+    upper_.strict = LU.triangularView<Eigen::StrictlyUpper>();
+  }
+  make_levels(upper_, false);
+
+  if (transpose && type_ == ILU0)
+  {
+    lower_trans_.strict = upper_.strict.transpose();
+    lower_trans_.inv_diag = upper_.inv_diag;
+    make_levels(lower_trans_, true);
+    upper_trans_.strict = lower_.strict.transpose();
+    upper_trans_.inv_diag = lower_.inv_diag;
+    make_levels(upper_trans_, false);
+  }
+}
+
+void IncompleteFactorPreconditioner::factor_ic0(SparseMatrix& LU, const std::vector<index_type>& diag) const
+{
+  const auto rows = LU.outerIndexPtr();
+  const auto columns = LU.innerIndexPtr();
+  const auto values = LU.valuePtr();
+
+  auto factor_row = [&](index_type i)
+  {
+    for (index_type p = rows[i]; p < diag[i]; ++p)
+    {
+      // L_ij = (a_ij - sum_k<j L_ik L_jk) / L_jj
+      const index_type j = columns[p];
+      double sum = values[p];
+      index_type pi = rows[i], pj = rows[j];
+      while (pi < p && pj < diag[j])
+      {
+        if (columns[pi] < columns[pj]) ++pi;
+        else if (columns[pi] > columns[pj]) ++pj;
+        else sum -= values[pi++] * values[pj++];
+      }
+      values[p] = sum / values[diag[j]];
+    }
+    double d = values[diag[i]];
+    for (index_type p = rows[i]; p < diag[i]; ++p)
+      d -= values[p] * values[p];
+    // on breakdown keep the original diagonal for this row
+    values[diag[i]] = d > 0.0 ? std::sqrt(d) : std::sqrt(std::fabs(values[diag[i]]));
+  };
+
+  for (size_t l = 0; l + 1 < lower_.level_start.size(); ++l)
+  {
+    Parallel::For(lower_.level_start[l], lower_.level_start[l + 1], 128, [&](size_t begin, size_t end)
+    {
+      for (size_t q = begin; q < end; ++q)
+        factor_row(lower_.level_rows[q]);
+    });
+  }
+}
+
+void IncompleteFactorPreconditioner::factor_ilu0(SparseMatrix& LU, const std::vector<index_type>& diag) const
+{
+  const auto rows = LU.outerIndexPtr();
+  const auto columns = LU.innerIndexPtr();
+  const auto values = LU.valuePtr();
+
+  auto factor_row = [&](index_type i)
+  {
+    const double aii = values[diag[i]];
+    for (index_type p = rows[i]; p < diag[i]; ++p)
+    {
+      // L_ik = a_ik / U_kk, then a_ij -= L_ik U_kj for j > k in the pattern of row i
+      const index_type k = columns[p];
+      const double lik = values[p] / values[diag[k]];
+      values[p] = lik;
+      index_type pi = p + 1, pk = diag[k] + 1;
+      while (pi < rows[i + 1] && pk < rows[k + 1])
+      {
+        if (columns[pi] < columns[pk]) ++pi;
+        else if (columns[pi] > columns[pk]) ++pk;
+        else values[pi++] -= lik * values[pk++];
+      }
+    }
+    // on breakdown keep the original diagonal for this row
+    if (values[diag[i]] == 0.0)
+      values[diag[i]] = aii;
+  };
+
+  for (size_t l = 0; l + 1 < lower_.level_start.size(); ++l)
+  {
+    Parallel::For(lower_.level_start[l], lower_.level_start[l + 1], 128, [&](size_t begin, size_t end)
+    {
+      for (size_t q = begin; q < end; ++q)
+        factor_row(lower_.level_rows[q]);
+    });
+  }
+}
+
+void IncompleteFactorPreconditioner::make_levels(TriangularFactor& f, bool lower)
+{
+  const index_type n = f.strict.rows();
+  const auto rows = f.strict.outerIndexPtr();
+  const auto columns = f.strict.innerIndexPtr();
+
+  std::vector<index_type> level(n, 0);
+  index_type num_levels = 0;
+  for (index_type q = 0; q < n; ++q)
+  {
+    const index_type i = lower ? q : n - 1 - q;
+    index_type li = 0;
+    for (index_type j = rows[i]; j < rows[i + 1]; ++j)
+      li = std::max(li, level[columns[j]] + 1);
+    level[i] = li;
+    num_levels = std::max(num_levels, li + 1);
+  }
+
+  // bucket the rows by level, keeping them in solve order within a level
+  f.level_start.assign(num_levels + 1, 0);
+  for (index_type i = 0; i < n; ++i)
+    f.level_start[level[i] + 1]++;
+  for (index_type l = 0; l < num_levels; ++l)
+    f.level_start[l + 1] += f.level_start[l];
+
+  f.level_rows.resize(n);
+  std::vector<index_type> next(f.level_start.begin(), f.level_start.end() - 1);
+  for (index_type q = 0; q < n; ++q)
+  {
+    const index_type i = lower ? q : n - 1 - q;
+    f.level_rows[next[level[i]]++] = i;
+  }
+}
+
+void IncompleteFactorPreconditioner::solve(ParallelLinearAlgebra& PLA, const TriangularFactor& f,
+                                           const double* b, double* x)
+{
+  const auto rows = f.strict.outerIndexPtr();
+  const auto columns = f.strict.innerIndexPtr();
+  const auto data = f.strict.valuePtr();
+  const auto inv_diag = f.inv_diag.data();
+  const auto level_rows = f.level_rows.data();
+
+  auto solve_rows = [&](index_type begin, index_type end)
+  {
+    for (index_type q = begin; q < end; ++q)
+    {
+      const index_type i = level_rows[q];
+      double sum = b[i];
+      for (index_type j = rows[i]; j < rows[i + 1]; ++j)
+        sum -= data[j] * x[columns[j]];
+      x[i] = sum * inv_diag[i];
+    }
+  };
+
+  const index_type n = f.strict.rows();
+  const size_t num_levels = f.level_start.size() - 1;
+
+  // Levels with only a few rows are not worth a barrier each: let the first
+  // thread do the whole solve in that case.
+  if (n < static_cast<index_type>(64 * num_levels))
+  {
+    if (PLA.first())
+      solve_rows(0, n);
+    PLA.wait();
+    return;
+  }
+
+  const int proc = PLA.proc(), nproc = PLA.nproc();
+  for (size_t l = 0; l < num_levels; ++l)
+  {
+    const index_type first = f.level_start[l];
+    const index_type count = f.level_start[l + 1] - first;
+    solve_rows(first + (count * proc) / nproc, first + (count * (proc + 1)) / nproc);
+    PLA.wait();
+  }
+}
+
+void IncompleteFactorPreconditioner::apply(ParallelLinearAlgebra& PLA,
+                                           const ParallelLinearAlgebra::ParallelVector& r,
+                                           ParallelLinearAlgebra::ParallelVector& z) const
+{
+  PLA.wait();
+  solve(PLA, lower_, r.data_, z.data_);
+  solve(PLA, upper_, z.data_, z.data_);
+}
+
+void IncompleteFactorPreconditioner::apply_trans(ParallelLinearAlgebra& PLA,
+                                                 const ParallelLinearAlgebra::ParallelVector& r,
+                                                 ParallelLinearAlgebra::ParallelVector& z) const
+{
+  if (lower_trans_.level_start.empty())
+  {
+    apply(PLA, r, z);
+    return;
+  }
+  PLA.wait();
+  solve(PLA, lower_trans_, r.data_, z.data_);
+  solve(PLA, upper_trans_, z.data_, z.data_);
+}
+
+std::string IncompleteFactorPreconditioner::description() const
+{
+  std::ostringstream ostr;
+  ostr << (type_ == IC0 ? "IC(0)" : "ILU(0)") << " preconditioner with " << num_levels()
+    << " forward and " << upper_.level_start.size() - 1 << " backward levels";
+  return ostr.str();
+}
+
+namespace
+{
+  size_t sparse_memory_size(const ParallelPreconditioner::SparseMatrix& m)
+  {
+    return (m.outerSize() + 1) * sizeof(index_type) + m.nonZeros() * (sizeof(index_type) + sizeof(double));
+  }
+}
+
+size_t IncompleteFactorPreconditioner::TriangularFactor::memory_size() const
+{
+  return sparse_memory_size(strict) + inv_diag.size() * sizeof(double) +
+    (level_rows.size() + level_start.size()) * sizeof(index_type);
+}
+
+size_t IncompleteFactorPreconditioner::memory_size() const
+{
+  return lower_.memory_size() + upper_.memory_size() +
+    lower_trans_.memory_size() + upper_trans_.memory_size();
+}
+
+//------------------------------------------------------------------
+// Smoothed aggregation AMG
+
+AggregationAMGPreconditioner::AggregationAMGPreconditioner(const SparseRowMatrix& A)
+{
+  if (A.rows() != A.cols())
+    BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("AMG preconditioner needs a square matrix"));
+
+  SparseMatrix current(A);
+  current.makeCompressed();
+  double epsilon = 0.08;
+
+  while (true)
+  {
+    levels_.emplace_back();
+    Level& level = levels_.back();
+    level.A.swap(current);
+
+    const index_type n = level.A.rows();
+    const auto rows = level.A.outerIndexPtr();
+    const auto columns = level.A.innerIndexPtr();
+    const auto values = level.A.valuePtr();
+
+    std::vector<double> diag(n, 0.0), inv_diag(n, 0.0);
+    for (index_type i = 0; i < n; ++i)
+    {
+      for (index_type j = rows[i]; j < rows[i + 1]; ++j)
+        if (columns[j] == i) diag[i] = values[j];
+      if (diag[i] != 0.0) inv_diag[i] = 1.0 / diag[i];
+    }
+
+    // damped Jacobi with weight 4/3 over the spectral radius of D^-1 A,
+    // used both for smoothing and for smoothing the prolongation
+    const double omega = 4.0 / (3.0 * spectral_radius(level.A, inv_diag));
+    level.omega_inv_diag.resize(n);
+    for (index_type i = 0; i < n; ++i)
+      level.omega_inv_diag[i] = omega * inv_diag[i];
+    level.r.resize(n);
+    if (levels_.size() > 1)
+    {
+      level.x.resize(n);
+      level.b.resize(n);
+    }
+
+    if (n <= coarseSize || levels_.size() == maxLevels)
+      break;
+
+    // Aggregation on the strong connections |a_ij| > epsilon sqrt(|a_ii a_jj|).
+    // Nodes without strong connections stay out of all aggregates and are
+    // handled by the smoother alone.
+    auto for_strong = [&](index_type i, const std::function<void(index_type)>& f)
+    {
+      for (index_type j = rows[i]; j < rows[i + 1]; ++j)
+      {
+        const index_type c = columns[j];
+        if (c != i && values[j] * values[j] > epsilon * epsilon * std::fabs(diag[i] * diag[c]))
+          f(c);
+      }
+    };
+
+    const index_type unassigned = -1, isolated = -2;
+    std::vector<index_type> aggregate(n, unassigned);
+    index_type num_aggregates = 0;
+
+    // pass 1: nodes whose strong neighbourhood is still free start an aggregate
+    for (index_type i = 0; i < n; ++i)
+    {
+      if (aggregate[i] != unassigned)
+        continue;
+      bool free = true, connected = false;
+      for_strong(i, [&](index_type c) { connected = true; if (aggregate[c] >= 0) free = false; });
+      if (!connected)
+      {
+        aggregate[i] = isolated;
+        continue;
+      }
+      if (!free)
+        continue;
+      aggregate[i] = num_aggregates;
+      for_strong(i, [&](index_type c) { aggregate[c] = num_aggregates; });
+      num_aggregates++;
+    }
+
+    // pass 2: join a neighbouring aggregate from pass 1
+    const std::vector<index_type> first_pass(aggregate);
+    for (index_type i = 0; i < n; ++i)
+    {
+      if (aggregate[i] != unassigned)
+        continue;
+      for_strong(i, [&](index_type c) { if (aggregate[i] == unassigned && first_pass[c] >= 0) aggregate[i] = first_pass[c]; });
+    }
+
+    // pass 3: whatever is left forms aggregates with its free neighbours
+    for (index_type i = 0; i < n; ++i)
+    {
+      if (aggregate[i] != unassigned)
+        continue;
+      aggregate[i] = num_aggregates;
+      for_strong(i, [&](index_type c) { if (aggregate[c] == unassigned) aggregate[c] = num_aggregates; });
+      num_aggregates++;
+    }
+
+    if (num_aggregates == 0 || num_aggregates >= n)
+      break;
+
+    // tentative prolongation: normalized constant on each aggregate
+    std::vector<double> aggregate_size(num_aggregates, 0.0);
+    for (index_type i = 0; i < n; ++i)
+      if (aggregate[i] >= 0) aggregate_size[aggregate[i]] += 1.0;
+
+    std::vector<Eigen::Triplet<double>> triplets;
+    triplets.reserve(n);
+    for (index_type i = 0; i < n; ++i)
+      if (aggregate[i] >= 0)
+        triplets.emplace_back(i, aggregate[i], 1.0 / std::sqrt(aggregate_size[aggregate[i]]));
+    SparseMatrix P0(n, num_aggregates);
+    P0.setFromTriplets(triplets.begin(), triplets.end());
+
+    // P = (I - omega D^-1 A) P0
+    SparseMatrix AP0 = level.A * P0;
+    for (index_type i = 0; i < n; ++i)
+      for (SparseMatrix::InnerIterator it(AP0, i); it; ++it)
+        it.valueRef() *= level.omega_inv_diag[i];
+    level.P = P0 - AP0;
+    level.P.makeCompressed();
+    level.R = level.P.transpose();
+    level.R.makeCompressed();
+
+    current = level.R * (level.A * level.P);
+    current.makeCompressed();
+    epsilon *= 0.5;
+  }
+
+  // Coarsest level is solved with a pseudo-inverse, so that singular
+  // (pure Neumann) systems still give a usable coarse correction. When
+  // coarsening stopped early, for instance because the matrix is too weakly
+  // coupled to aggregate, the coarsest level can still be large; it is then
+  // only smoothed, see cycle().
+  const SparseMatrix& coarse = levels_.back().A;
+  if (coarse.rows() > coarseSize)
+    return;
+
+  const DenseMatrix::EigenBase dense(coarse);
+  Eigen::SelfAdjointEigenSolver<DenseMatrix::EigenBase> eigen(dense);
+  const auto& lambda = eigen.eigenvalues();
+  const double cutoff = 1e-12 * lambda.cwiseAbs().maxCoeff();
+  Eigen::VectorXd inv_lambda(lambda.size());
+  for (index_type i = 0; i < lambda.size(); ++i)
+    inv_lambda[i] = std::fabs(lambda[i]) > cutoff ? 1.0 / lambda[i] : 0.0;
+  coarse_inverse_ = DenseMatrix(eigen.eigenvectors() * inv_lambda.asDiagonal() * eigen.eigenvectors().transpose());
+}
+
+void AggregationAMGPreconditioner::apply(ParallelLinearAlgebra& PLA,
+                                         const ParallelLinearAlgebra::ParallelVector& r,
+                                         ParallelLinearAlgebra::ParallelVector& z) const
+{
+  PLA.wait();
+  cycle(PLA, 0, r.data_, z.data_);
+  PLA.wait();
+}
+
+void AggregationAMGPreconditioner::cycle(ParallelLinearAlgebra& PLA, size_t l, const double* b, double* x) const
+{
+  const Level& level = levels_[l];
+  size_t begin, end;
+  thread_range(PLA, level.A.rows(), begin, end);
+
+  if (l + 1 == levels_.size() && coarse_inverse_.rows() > 0)
+  {
+    PLA.wait();
+    const size_t n = level.A.rows();
+    for (size_t i = begin; i < end; ++i)
+    {
+      double sum = 0.0;
+      for (size_t j = 0; j < n; ++j)
+        sum += coarse_inverse_(i, j) * b[j];
+      x[i] = sum;
+    }
+    return;
+  }
+
+  double* res = level.r.data();
+  const double* omega_inv_diag = level.omega_inv_diag.data();
+  auto smooth = [&]()
+  {
+    PLA.wait();
+    residual(level.A, b, x, res, begin, end);
+    PLA.wait();
+    for (size_t i = begin; i < end; ++i)
+      x[i] += omega_inv_diag[i] * res[i];
+  };
+
+  // pre-smoothing, starting from zero
+  for (size_t i = begin; i < end; ++i)
+    x[i] = omega_inv_diag[i] * b[i];
+  for (int s = 1; s < smoothingSteps; ++s)
+    smooth();
+
+  // a coarsest level without a pseudo-inverse gets more damped Jacobi steps,
+  // which keeps the cycle symmetric
+  if (l + 1 == levels_.size())
+  {
+    for (int s = smoothingSteps; s < coarseSmoothingSteps; ++s)
+      smooth();
+    return;
+  }
+
+  // restrict the residual and solve the coarse problem
+  const Level& coarse = levels_[l + 1];
+  size_t coarse_begin, coarse_end;
+  thread_range(PLA, coarse.A.rows(), coarse_begin, coarse_end);
+  PLA.wait();
+  residual(level.A, b, x, res, begin, end);
+  PLA.wait();
+  mult(level.R, res, coarse.b.data(), coarse_begin, coarse_end);
+  cycle(PLA, l + 1, coarse.b.data(), coarse.x.data());
+
+  // prolongate the correction
+  PLA.wait();
+  const auto rows = level.P.outerIndexPtr();
+  const auto columns = level.P.innerIndexPtr();
+  const auto data = level.P.valuePtr();
+  const double* xc = coarse.x.data();
+  for (size_t i = begin; i < end; ++i)
+  {
+    double sum = 0.0;
+    for (index_type j = rows[i]; j < rows[i + 1]; ++j)
+      sum += data[j] * xc[columns[j]];
+    x[i] += sum;
+  }
+
+  // post-smoothing, same number of steps to keep the cycle symmetric
+  for (int s = 0; s < smoothingSteps; ++s)
+    smooth();
+}
+
+std::string AggregationAMGPreconditioner::description() const
+{
+  std::ostringstream ostr;
+  ostr << "AMG preconditioner with " << levels_.size() << " levels (";
+  for (size_t l = 0; l < levels_.size(); ++l)
+    ostr << (l > 0 ? ", " : "") << levels_[l].A.rows();
+  ostr << " rows)";
+  return ostr.str();
+}
+
+size_t AggregationAMGPreconditioner::memory_size() const
+{
+  size_t size = coarse_inverse_.size() * sizeof(double);
+  for (const auto& level : levels_)
+  {
+    size += sparse_memory_size(level.A) + sparse_memory_size(level.P) + sparse_memory_size(level.R);
+    size += (level.omega_inv_diag.size() + level.x.size() + level.b.size() + level.r.size()) * sizeof(double);
+  }
+  return size;
+}
@@ -0,0 +1,170 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef CORE_ALGORITHMS_MATH_PARALLELALGEBRA_PARALLELPRECONDITIONERS_H
+#define CORE_ALGORITHMS_MATH_PARALLELALGEBRA_PARALLELPRECONDITIONERS_H
+
+#include <string>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Algorithms/Math/ParallelAlgebra/ParallelLinearAlgebra.h>
+#include <Core/Algorithms/Math/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Math {
+
+// Preconditioners z = M^-1 r for the ParallelLinearAlgebra solvers. They are
+// set up once from the matrix before the solver threads start; apply() is then
+// called by every thread of the parallel run, like the other PLA operations.
+class SCISHARE ParallelPreconditioner : boost::noncopyable
+{
+public:
+  typedef Datatypes::SparseRowMatrix::EigenBase SparseMatrix;
+
+  virtual ~ParallelPreconditioner() {}
+
+  virtual void apply(ParallelLinearAlgebra& PLA,
+                     const ParallelLinearAlgebra::ParallelVector& r,
+                     ParallelLinearAlgebra::ParallelVector& z) const = 0;
+
+  // z = M^-T r, needed by BiCG. Symmetric preconditioners use apply().
+  virtual void apply_trans(ParallelLinearAlgebra& PLA,
+                           const ParallelLinearAlgebra::ParallelVector& r,
+                           ParallelLinearAlgebra::ParallelVector& z) const
+  {
+    apply(PLA, r, z);
+  }
+
+  virtual std::string description() const = 0;
+
+  // Approximate memory held by the preconditioner in bytes
+  virtual size_t memory_size() const = 0;
+
+  // Returns a null pointer for the options handled by the solvers themselves
+  // (None and Jacobi). transpose asks for apply_trans support.
+  static SharedPointer<ParallelPreconditioner> create(const std::string& name,
+                                                      const Datatypes::SparseRowMatrix& A,
+                                                      bool transpose);
+};
+
+typedef SharedPointer<ParallelPreconditioner> ParallelPreconditionerHandle;
+
+// Incomplete Cholesky IC(0) or incomplete LU ILU(0) on the sparsity pattern of A.
+// IC(0) only reads the lower triangle and assumes A is symmetric. Rows that do
+// not depend on each other are grouped into levels, and both the factorization
+// and the triangular solves run level by level across the threads.
+class SCISHARE IncompleteFactorPreconditioner : public ParallelPreconditioner
+{
+public:
+  enum FactorType { IC0, ILU0 };
+
+  IncompleteFactorPreconditioner(const Datatypes::SparseRowMatrix& A, FactorType type, bool transpose);
+
+  void apply(ParallelLinearAlgebra& PLA,
+             const ParallelLinearAlgebra::ParallelVector& r,
+             ParallelLinearAlgebra::ParallelVector& z) const override;
+  void apply_trans(ParallelLinearAlgebra& PLA,
+                   const ParallelLinearAlgebra::ParallelVector& r,
+                   ParallelLinearAlgebra::ParallelVector& z) const override;
+  std::string description() const override;
+  size_t memory_size() const override;
+
+  size_t num_levels() const { return lower_.level_start.size() - 1; }
+
+private:
+  // Triangular matrix stored as its strict part plus the inverted diagonal
+  struct TriangularFactor
+  {
+    SparseMatrix strict;
+    std::vector<double> inv_diag;
+    std::vector<index_type> level_rows;
+    std::vector<index_type> level_start;
+
+    size_t memory_size() const;
+  };
+
+  void factor_ic0(SparseMatrix& LU, const std::vector<index_type>& diag) const;
+  void factor_ilu0(SparseMatrix& LU, const std::vector<index_type>& diag) const;
+
+  static void make_levels(TriangularFactor& f, bool lower);
+  static void solve(ParallelLinearAlgebra& PLA, const TriangularFactor& f,
+                    const double* b, double* x);
+
+  FactorType type_;
+  TriangularFactor lower_;
+  TriangularFactor upper_;
+  // factors of M^T = U^T L^T, only built for ILU(0) when transpose is requested
+  TriangularFactor lower_trans_;
+  TriangularFactor upper_trans_;
+};
+
+// Smoothed aggregation algebraic multigrid, applied as one V-cycle with damped
+// Jacobi smoothing. The cycle is symmetric, so it can be used with CG and MINRES
+// for symmetric positive (semi-)definite matrices such as FEM stiffness matrices.
+class SCISHARE AggregationAMGPreconditioner : public ParallelPreconditioner
+{
+public:
+  explicit AggregationAMGPreconditioner(const Datatypes::SparseRowMatrix& A);
+
+  void apply(ParallelLinearAlgebra& PLA,
+             const ParallelLinearAlgebra::ParallelVector& r,
+             ParallelLinearAlgebra::ParallelVector& z) const override;
+  std::string description() const override;
+  size_t memory_size() const override;
+
+  size_t num_levels() const { return levels_.size(); }
+  size_t size(size_t level) const { return levels_[level].A.rows(); }
+
+private:
+  struct Level
+  {
+    SparseMatrix A;
+    SparseMatrix P;  // prolongation from the next coarser level
+    SparseMatrix R;  // restriction, P^T
+    std::vector<double> omega_inv_diag;
+    // work vectors; x and b of the finest level are the solver vectors
+    mutable std::vector<double> x, b, r;
+  };
+
+  void cycle(ParallelLinearAlgebra& PLA, size_t level, const double* b, double* x) const;
+
+  std::vector<Level> levels_;
+  Datatypes::DenseMatrix coarse_inverse_;
+
+  static const int smoothingSteps = 2;
+  static const int coarseSmoothingSteps = 10;
+  static const index_type coarseSize = 400;
+  static const size_t maxLevels = 12;
+};
+
+}}}}
+
+#endif
@@ -28,11 +28,14 @@
 
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/Math/SolveLinearSystemWithEigen.h>
+#include <Core/Algorithms/Math/LinearSystem/SolverStateCache.h>
+#include <Core/Algorithms/Math/LinearSystem/SparseDirectSolver.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/DenseColumnMatrix.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/MatrixTypeConversions.h>
 #include <Eigen/Sparse>
+#include <typeinfo>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Algorithms::Math;
@@ -53,11 +56,13 @@ namespace
 
     using SolutionType = ColumnMatrixType;
 
+    // compute() only sets up the diagonal preconditioner, which is cheaper
+    // than looking the solver up in the SolverStateCache, so it is not cached.
     template <class MatrixType>
-    typename ColumnMatrixType::EigenBase solveWithEigen(const MatrixType& lhs)
+    typename ColumnMatrixType::EigenBase solveWithEigen(const SharedPointer<MatrixType>& lhs)
     {
       SolverType<typename MatrixType::EigenBase> solver;
-      solver.compute(lhs);
+      solver.compute(*lhs);
 
       if (solver.info() != Eigen::Success)
         BOOST_THROW_EXCEPTION(AlgorithmInputException()
@@ -77,6 +82,62 @@ namespace
   private:
     SharedPointer<ColumnMatrixType> rhs_;
   };
+
+  // Same interface for the sparse direct solvers; tolerance_ returns the
+  // relative residual and maxIterations_ is zero.
+  template <class ColumnMatrixType, typename SparseDirectSolver<typename ColumnMatrixType::value_type>::FactorType Type>
+  class SolveLinearSystemAlgorithmEigenDirectImpl
+  {
+  public:
+    SolveLinearSystemAlgorithmEigenDirectImpl(SharedPointer<ColumnMatrixType> rhs, double tolerance, int) :
+        tolerance_(tolerance), maxIterations_(0), rhs_(rhs) {}
+
+    using SolutionType = ColumnMatrixType;
+    using Solver = SparseDirectSolver<typename ColumnMatrixType::value_type>;
+
+    template <class MatrixType>
+    typename ColumnMatrixType::EigenBase solveWithEigen(const SharedPointer<MatrixType>& lhs)
+    {
+      const std::string kind = std::string("EigenDirect:") + typeid(Solver).name() + (Type == Solver::LDLT ? ":LDLT" : ":LU");
+
+      auto solver = SolverStateCache::instance().take<Solver>(lhs, kind);
+      if (!solver)
+      {
+        solver = makeShared<Solver>(Type);
+        typename Solver::ColumnMajorMatrix columnMajor = toColumnMajor(*lhs);
+        columnMajor.makeCompressed();
+        auto info = solver->compute(columnMajor);
+
+        if (info != Eigen::Success)
+          BOOST_THROW_EXCEPTION(AlgorithmInputException()
+            << LinearAlgebraErrorMessage("Eigen sparse factorization was unsuccessful")
+            << EigenComputationInfo(info));
+      }
+
+      typename ColumnMatrixType::EigenBase solution = solver->solve(*rhs_).col(0);
+      SolverStateCache::instance().put(lhs, kind, solver, solver->memory_size());
+
+      const double bnorm = rhs_->norm();
+      tolerance_ = bnorm > 0 ? (*rhs_ - (*lhs) * solution).norm() / bnorm : 0.0;
+      return solution;
+    }
+
+    double tolerance_;
+    int maxIterations_;
+  private:
+    template <typename T>
+    static typename Solver::ColumnMajorMatrix toColumnMajor(const SparseRowMatrixGeneric<T>& m)
+    {
+      return typename Solver::ColumnMajorMatrix(m);
+    }
+    template <typename T>
+    static typename Solver::ColumnMajorMatrix toColumnMajor(const DenseMatrixGeneric<T>& m)
+    {
+      return m.sparseView();
+    }
+
+    SharedPointer<ColumnMatrixType> rhs_;
+  };
 }
 
 SolveLinearSystemAlgorithm::Outputs SolveLinearSystemAlgorithm::run(const Inputs& input, const Parameters& params) const
@@ -117,11 +178,17 @@ Out SolveLinearSystemAlgorithm::runImpl(const In& input, const Parameters& param
   using SolutionType = DenseColumnMatrixGeneric<typename std::tuple_element<0, In>::type::element_type::value_type>;
   using AlgoTypeCG = SolveLinearSystemAlgorithmEigenCGImpl<SolutionType, CG>;
   using AlgoTypeBiCG = SolveLinearSystemAlgorithmEigenCGImpl<SolutionType, BiCG>;
+  using AlgoTypeLDLT = SolveLinearSystemAlgorithmEigenDirectImpl<SolutionType, SparseDirectSolver<typename SolutionType::value_type>::LDLT>;
+  using AlgoTypeLU = SolveLinearSystemAlgorithmEigenDirectImpl<SolutionType, SparseDirectSolver<typename SolutionType::value_type>::LU>;
 
   if ("cg" == method)
     return solve<AlgoTypeCG, In, Out>(input, params);
   else if ("bicg" == method)
     return solve<AlgoTypeBiCG, In, Out>(input, params);
+  else if ("ldlt" == method)
+    return solve<AlgoTypeLDLT, In, Out>(input, params);
+  else if ("lu" == method)
+    return solve<AlgoTypeLU, In, Out>(input, params);
   else
   {
     BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Need to upgrade Eigen for LSCG."));
@@ -142,12 +209,12 @@ Out SolveLinearSystemAlgorithm::solve(const In& input, const Parameters& params)
   if (matrixIs::dense(A))
   {
     auto dense = castMatrix::toDense(A);
-    x = impl.solveWithEigen(*dense);
+    x = impl.solveWithEigen(dense);
   }
   else if (matrixIs::sparse(A))
   {
     auto sparse = castMatrix::toSparse(A);
-    x = impl.solveWithEigen(*sparse);
+    x = impl.solveWithEigen(sparse);
   }
   else
     BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("solveWithEigen can only handle dense and sparse matrices."));
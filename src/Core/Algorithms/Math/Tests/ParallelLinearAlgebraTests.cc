@@ -976,3 +976,56 @@ TEST(ParallelArithmeticTests, CanComputeDotProductMulti)
   EXPECT_EQ(-9 , v23);
   EXPECT_EQ(9 , v13);
 }
+
+struct cgDotsMult
+{
+  cgDotsMult(ParallelLinearAlgebraSharedData& data, int proc, DenseColumnMatrixHandle r,
+    DenseColumnMatrixHandle u, DenseColumnMatrixHandle w) :
+      data_(data), proc_(proc), r_(r), u_(u), w_(w) {}
+
+  ParallelLinearAlgebraSharedData& data_;
+  int proc_;
+  DenseColumnMatrixHandle r_, u_, w_;
+  double gamma_, delta_, rr_, dot_;
+
+  void operator()()
+  {
+    ParallelLinearAlgebra pla(data_, proc_);
+    ParallelLinearAlgebra::ParallelVector r, u, w;
+    pla.add_vector(r_, r);
+    pla.add_vector(u_, u);
+    pla.add_vector(w_, w);
+
+    // alternate with a plain reduction to exercise both reduce buffers
+    pla.cg_dots(r, u, w, gamma_, delta_, rr_);
+    dot_ = pla.dot(r, u);
+    pla.cg_dots(r, u, w, gamma_, delta_, rr_);
+  }
+};
+
+TEST(ParallelArithmeticTests, CanComputeFusedCGDotProductsMulti)
+{
+  const int numProcs = 4;
+  ParallelLinearAlgebraSharedData data(getDummySystem(), numProcs);
+
+  auto vec1 = vector1();
+  auto vec2 = vector2();
+  auto vec3 = vector3();
+
+  std::vector<cgDotsMult> runs;
+  for (int p = 0; p < numProcs; ++p)
+    runs.emplace_back(data, p, vec1, vec2, vec3);
+  std::vector<std::thread> threads;
+  for (auto& run : runs)
+    threads.emplace_back(std::ref(run));
+  for (auto& t : threads)
+    t.join();
+
+  for (const auto& run : runs)
+  {
+    EXPECT_EQ(-22, run.gamma_);
+    EXPECT_EQ(-9, run.delta_);
+    EXPECT_EQ(22, run.rr_);
+    EXPECT_EQ(-22, run.dot_);
+  }
+}
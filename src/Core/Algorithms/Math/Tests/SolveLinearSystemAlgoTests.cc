@@ -31,6 +31,7 @@
 #include <fstream>
 #include <boost/filesystem.hpp>
 #include <Core/Algorithms/Math/LinearSystem/SolveLinearSystemAlgo.h>
+#include <Core/Algorithms/Math/ParallelAlgebra/ParallelPreconditioners.h>
 #include <Core/Algorithms/DataIO/ReadMatrix.h>
 #include <Core/Algorithms/DataIO/WriteMatrix.h>
 #include <Core/Datatypes/DenseMatrix.h>
@@ -147,3 +148,222 @@ TEST(SolveLinearSystemTests, DISABLED_CanSolveDarrell_MINRES)
   double solutionError = 2.4;
   CanSolveDarrellWithMethod("minres", solutionError);
 }
+
+namespace
+{
+  // 7-point Laplacian on an n^3 grid with Dirichlet boundary, optionally with
+  // a first order convection term that makes it nonsymmetric
+  SparseRowMatrixHandle gridLaplacian(int n, double convection = 0.0)
+  {
+    const int size = n * n * n;
+    std::vector<SparseRowMatrix::Triplet> triplets;
+    auto index = [n](int i, int j, int k) { return (k * n + j) * n + i; };
+    for (int k = 0; k < n; ++k)
+      for (int j = 0; j < n; ++j)
+        for (int i = 0; i < n; ++i)
+        {
+          const int row = index(i, j, k);
+          triplets.emplace_back(row, row, 6.0);
+          if (i > 0) triplets.emplace_back(row, index(i - 1, j, k), -1.0 - convection);
+          if (i < n - 1) triplets.emplace_back(row, index(i + 1, j, k), -1.0 + convection);
+          if (j > 0) triplets.emplace_back(row, index(i, j - 1, k), -1.0);
+          if (j < n - 1) triplets.emplace_back(row, index(i, j + 1, k), -1.0);
+          if (k > 0) triplets.emplace_back(row, index(i, j, k - 1), -1.0);
+          if (k < n - 1) triplets.emplace_back(row, index(i, j, k + 1), -1.0);
+        }
+    auto A = makeShared<SparseRowMatrix>(size, size);
+    A->setFromTriplets(triplets.begin(), triplets.end());
+    return A;
+  }
+
+  double relativeResidual(const SparseRowMatrix& A, const DenseColumnMatrix& b, const DenseColumnMatrix& x)
+  {
+    DenseColumnMatrix r = b - A * x;
+    return r.norm() / b.norm();
+  }
+
+  double solveGridLaplacian(const std::string& method, const std::string& preconditioner,
+    int maxIterations, double convection = 0.0)
+  {
+    auto A = gridLaplacian(20, convection);
+    auto b = makeShared<DenseColumnMatrix>(A->nrows());
+    for (size_t i = 0; i < b->nrows(); ++i)
+      (*b)[i] = 1.0 + (i % 7);
+
+    SolveLinearSystemAlgo algo;
+    algo.set(Variables::MaxIterations, maxIterations);
+    algo.set(Variables::TargetError, 1e-10);
+    algo.setOption(Variables::Method, method);
+    algo.setOption(Variables::Preconditioner, preconditioner);
+    algo.setUpdaterFunc([](double) {});
+
+    DenseColumnMatrixHandle x0, solution;
+    EXPECT_TRUE(algo.run(A, b, x0, solution));
+    return relativeResidual(*A, *b, *solution);
+  }
+}
+
+TEST(SolveLinearSystemTests, PreconditionersSolveGridLaplacianWithCG)
+{
+  for (const auto& preconditioner : { "None", "Jacobi", "IC0", "ILU0", "AMG" })
+  {
+    EXPECT_LT(solveGridLaplacian("cg", preconditioner, 500), 1e-9) << preconditioner;
+  }
+}
+
+TEST(SolveLinearSystemTests, PreconditionersSolveGridLaplacianWithPipelinedCG)
+{
+  for (const std::string preconditioner : { "None", "Jacobi", "IC0", "AMG" })
+  {
+    EXPECT_LT(solveGridLaplacian("pipelined_cg", preconditioner, 500), 1e-9) << preconditioner;
+  }
+}
+
+TEST(SolveLinearSystemTests, PreconditionersSolveGridLaplacianWithMINRES)
+{
+  for (const auto& preconditioner : { "Jacobi", "IC0", "AMG" })
+  {
+    EXPECT_LT(solveGridLaplacian("minres", preconditioner, 500), 1e-9) << preconditioner;
+  }
+}
+
+TEST(SolveLinearSystemTests, ILU0SolvesNonsymmetricSystemWithBICG)
+{
+  EXPECT_LT(solveGridLaplacian("bicg", "ILU0", 500, 0.4), 1e-9);
+}
+
+TEST(SolveLinearSystemTests, IncompleteFactorAndAMGNeedFewerIterationsThanJacobi)
+{
+  const int iterations = 20;
+  const double jacobi = solveGridLaplacian("cg", "Jacobi", iterations);
+  EXPECT_LT(solveGridLaplacian("cg", "IC0", iterations), jacobi);
+  EXPECT_LT(solveGridLaplacian("cg", "AMG", iterations), 1e-3 * jacobi);
+}
+
+TEST(SolveLinearSystemTests, AMGDoesNotDensifyWeaklyCoupledMatrix)
+{
+  // diagonally dominant chain, too weakly coupled for any aggregate to form,
+  // so coarsening stops at the finest level
+  const int size = 5000;
+  std::vector<SparseRowMatrix::Triplet> triplets;
+  for (int i = 0; i < size; ++i)
+  {
+    triplets.emplace_back(i, i, 10.0);
+    if (i > 0) triplets.emplace_back(i, i - 1, -0.1);
+    if (i < size - 1) triplets.emplace_back(i, i + 1, -0.1);
+  }
+  auto A = makeShared<SparseRowMatrix>(size, size);
+  A->setFromTriplets(triplets.begin(), triplets.end());
+
+  AggregationAMGPreconditioner amg(*A);
+  EXPECT_EQ(1, amg.num_levels());
+  EXPECT_LT(amg.memory_size(), 100 * size * sizeof(double));
+
+  auto b = makeShared<DenseColumnMatrix>(size);
+  for (int i = 0; i < size; ++i)
+    (*b)[i] = 1.0 + (i % 7);
+
+  SolveLinearSystemAlgo algo;
+  algo.set(Variables::MaxIterations, 50);
+  algo.set(Variables::TargetError, 1e-10);
+  algo.setOption(Variables::Method, "cg");
+  algo.setOption(Variables::Preconditioner, "AMG");
+  algo.setUpdaterFunc([](double) {});
+
+  DenseColumnMatrixHandle x0, solution;
+  ASSERT_TRUE(algo.run(A, b, x0, solution));
+  EXPECT_LT(relativeResidual(*A, *b, *solution), 1e-9);
+}
+
+TEST(SolveLinearSystemTests, DirectMethodsSolveGridLaplacian)
+{
+  EXPECT_LT(solveGridLaplacian("ldlt", "None", 1), 1e-12);
+  EXPECT_LT(solveGridLaplacian("lu", "None", 1), 1e-12);
+}
+
+TEST(SolveLinearSystemTests, SparseLUSolvesNonsymmetricSystem)
+{
+  EXPECT_LT(solveGridLaplacian("lu", "None", 1, 0.4), 1e-12);
+}
+
+TEST(SolveLinearSystemTests, MultipleRightHandSidesMatchSingleColumnSolves)
+{
+  auto A = gridLaplacian(12);
+  const int ncols = 5;
+  auto B = makeShared<DenseMatrix>(A->nrows(), ncols);
+  for (size_t i = 0; i < B->nrows(); ++i)
+    for (int c = 0; c < ncols; ++c)
+      (*B)(i, c) = c == 3 ? 0.0 : 1.0 + ((i + 3 * c) % (c + 2));
+
+  for (const std::string method : { "cg", "pipelined_cg", "bicg", "minres", "ldlt", "lu" })
+  {
+    for (const std::string preconditioner : { "Jacobi", "IC0", "AMG" })
+    {
+      SolveLinearSystemAlgo algo;
+      algo.set(Variables::MaxIterations, 500);
+      algo.set(Variables::TargetError, 1e-10);
+      algo.setOption(Variables::Method, method);
+      algo.setOption(Variables::Preconditioner, preconditioner);
+      algo.setUpdaterFunc([](double) {});
+
+      DenseMatrixHandle X;
+      DenseColumnMatrixHandle residuals, iterations;
+      ASSERT_TRUE(algo.run(A, B, DenseMatrixHandle(), X, residuals, iterations));
+      ASSERT_EQ(ncols, X->ncols());
+      ASSERT_EQ(ncols, residuals->nrows());
+      ASSERT_EQ(ncols, iterations->nrows());
+
+      const bool direct = method == "ldlt" || method == "lu";
+      for (int c = 0; c < ncols; ++c)
+      {
+        EXPECT_LT((*residuals)[c], 1e-9) << method << " " << preconditioner << " " << c;
+        if (direct || c == 3)
+          EXPECT_EQ(0, (*iterations)[c]) << method << " " << preconditioner << " " << c;
+        else
+          EXPECT_GT((*iterations)[c], 0) << method << " " << preconditioner << " " << c;
+
+        auto b = makeShared<DenseColumnMatrix>(B->col(c));
+        DenseColumnMatrixHandle x0, x;
+        ASSERT_TRUE(algo.run(A, b, x0, x));
+        EXPECT_LT((X->col(c) - *x).norm(), 1e-8 * std::max(1.0, x->norm())) << method << " " << preconditioner << " " << c;
+      }
+      EXPECT_EQ(0.0, X->col(3).norm());
+    }
+  }
+}
+
+TEST(SolveLinearSystemTests, MultipleRightHandSidesThroughAlgorithmInput)
+{
+  auto A = gridLaplacian(8);
+  auto B = makeShared<DenseMatrix>(A->nrows(), 3);
+  B->setRandom();
+
+  SolveLinearSystemAlgo algo;
+  algo.set(Variables::MaxIterations, 500);
+  algo.set(Variables::TargetError, 1e-10);
+  algo.setOption(Variables::Method, "cg");
+  algo.setUpdaterFunc([](double) {});
+
+  AlgorithmInput input;
+  input[Variables::LHS] = A;
+  input[Variables::RHS] = B;
+  auto output = algo.run(input);
+  auto X = output.get<DenseMatrix>(Variables::Solution);
+  ASSERT_TRUE(X != nullptr);
+  DenseMatrix R = *B - *A * *X;
+  EXPECT_LT(R.norm() / B->norm(), 1e-9);
+
+  auto residuals = output.get<DenseColumnMatrix>(SolveLinearSystemAlgo::Residuals);
+  auto iterations = output.get<DenseColumnMatrix>(SolveLinearSystemAlgo::Iterations);
+  ASSERT_TRUE(residuals != nullptr);
+  ASSERT_TRUE(iterations != nullptr);
+  ASSERT_EQ(3, residuals->nrows());
+  ASSERT_EQ(3, iterations->nrows());
+  for (int c = 0; c < 3; ++c)
+  {
+    EXPECT_NEAR(R.col(c).norm() / B->col(c).norm(), (*residuals)[c], 1e-12);
+    EXPECT_LT((*residuals)[c], 1e-9);
+    EXPECT_GT((*iterations)[c], 0);
+    EXPECT_LE((*iterations)[c], 500);
+  }
+}
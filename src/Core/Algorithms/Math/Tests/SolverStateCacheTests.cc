@@ -0,0 +1,180 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <Core/Algorithms/Math/LinearSystem/SolverStateCache.h>
+#include <Core/Algorithms/Math/LinearSystem/SolveLinearSystemAlgo.h>
+#include <Core/Algorithms/Math/SolveLinearSystemWithEigen.h>
+#include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Math;
+
+namespace
+{
+  SparseRowMatrixHandle tridiagonal(int n)
+  {
+    std::vector<SparseRowMatrix::Triplet> triplets;
+    for (int i = 0; i < n; ++i)
+    {
+      triplets.emplace_back(i, i, 4.0);
+      if (i > 0) triplets.emplace_back(i, i - 1, -1.0);
+      if (i < n - 1) triplets.emplace_back(i, i + 1, -1.0);
+    }
+    auto A = makeShared<SparseRowMatrix>(n, n);
+    A->setFromTriplets(triplets.begin(), triplets.end());
+    return A;
+  }
+}
+
+TEST(SolverStateCacheTests, TakeReturnsStoredStateOnce)
+{
+  SolverStateCache cache;
+  auto A = tridiagonal(10);
+  auto state = makeShared<int>(42);
+
+  cache.put(A, "test", state, 100);
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_EQ(100u, cache.memoryUsed());
+
+  EXPECT_FALSE(cache.take<int>(A, "other"));
+  auto taken = cache.take<int>(A, "test");
+  ASSERT_TRUE(taken != nullptr);
+  EXPECT_EQ(42, *taken);
+
+  // the state is lent out until it is put back
+  EXPECT_FALSE(cache.take<int>(A, "test"));
+  EXPECT_EQ(0u, cache.memoryUsed());
+}
+
+TEST(SolverStateCacheTests, DoesNotMatchOtherOrModifiedMatrices)
+{
+  SolverStateCache cache;
+  auto A = tridiagonal(10);
+  auto copy = makeShared<SparseRowMatrix>(*A);
+
+  cache.put(A, "test", makeShared<int>(1), 100);
+  EXPECT_FALSE(cache.take<int>(copy, "test"));
+
+  A->coeffRef(3, 3) = 5.0;
+  EXPECT_FALSE(cache.take<int>(A, "test"));
+}
+
+TEST(SolverStateCacheTests, DropsStateOfDeletedMatrices)
+{
+  SolverStateCache cache;
+  auto A = tridiagonal(10);
+  cache.put(A, "test", makeShared<int>(1), 100);
+  A.reset();
+
+  auto B = tridiagonal(5);
+  cache.put(B, "test", makeShared<int>(2), 100);
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_EQ(100u, cache.memoryUsed());
+}
+
+TEST(SolverStateCacheTests, EvictsLeastRecentlyUsedStateOverBudget)
+{
+  SolverStateCache cache(250);
+  auto A = tridiagonal(10), B = tridiagonal(11), C = tridiagonal(12);
+
+  cache.put(A, "test", makeShared<int>(1), 100);
+  cache.put(B, "test", makeShared<int>(2), 100);
+  cache.put(A, "test", cache.take<int>(A, "test"), 100);
+  cache.put(C, "test", makeShared<int>(3), 100);
+
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_TRUE(cache.take<int>(A, "test") != nullptr);
+  EXPECT_FALSE(cache.take<int>(B, "test"));
+  EXPECT_TRUE(cache.take<int>(C, "test") != nullptr);
+
+  // state larger than the budget is not kept
+  cache.put(A, "test", makeShared<int>(1), 1000);
+  EXPECT_EQ(0u, cache.size());
+
+  cache.put(A, "test", makeShared<int>(1), 100);
+  cache.setMemoryBudget(0);
+  EXPECT_EQ(0u, cache.size());
+}
+
+TEST(SolverStateCacheTests, SolveLinearSystemReusesPreconditioner)
+{
+  auto& cache = SolverStateCache::instance();
+  cache.clear();
+
+  auto A = tridiagonal(500);
+  SolveLinearSystemAlgo algo;
+  algo.set(Variables::MaxIterations, 500);
+  algo.set(Variables::TargetError, 1e-12);
+  algo.setOption(Variables::Method, "cg");
+  algo.setOption(Variables::Preconditioner, "IC0");
+  algo.setUpdaterFunc([](double) {});
+
+  DenseColumnMatrixHandle x0, x1, x2;
+  auto b1 = makeShared<DenseColumnMatrix>(DenseColumnMatrix::Ones(500));
+  ASSERT_TRUE(algo.run(A, b1, x0, x1));
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_GT(cache.memoryUsed(), 0u);
+
+  auto b2 = makeShared<DenseColumnMatrix>(DenseColumnMatrix::LinSpaced(500, 0.0, 1.0));
+  ASSERT_TRUE(algo.run(A, b2, x0, x2));
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_LT((*b2 - *A * *x2).norm(), 1e-10 * b2->norm());
+
+  A.reset();
+  cache.clear();
+}
+
+TEST(SolverStateCacheTests, OnlyFactorizationsOfEigenSolversAreCached)
+{
+  auto& cache = SolverStateCache::instance();
+  cache.clear();
+
+  auto A = tridiagonal(100);
+  auto b = makeShared<DenseColumnMatrix>(DenseColumnMatrix::Ones(100));
+  SolveLinearSystemAlgorithm algo;
+
+  // the iterative solvers only set up a diagonal preconditioner
+  for (const std::string method : { "cg", "bicg" })
+  {
+    auto x = std::get<0>(algo.run(std::make_tuple(A, b), std::make_tuple(1e-12, 500, method)));
+    ASSERT_TRUE(x != nullptr);
+    EXPECT_LT((*b - *A * *x).norm(), 1e-10 * b->norm()) << method;
+    EXPECT_EQ(0u, cache.size()) << method;
+  }
+
+  auto x = std::get<0>(algo.run(std::make_tuple(A, b), std::make_tuple(1e-12, 500, std::string("ldlt"))));
+  ASSERT_TRUE(x != nullptr);
+  EXPECT_LT((*b - *A * *x).norm(), 1e-10 * b->norm());
+  EXPECT_EQ(1u, cache.size());
+
+  A.reset();
+  cache.clear();
+}
@@ -155,6 +155,14 @@ public:
   void set_nodes(VMesh::Node::array_type&,
                          VMesh::Cell::index_type) override;
 
+  void locate_many(const std::vector<Point>& points,
+                   std::vector<VMesh::Elem::index_type>& elems,
+                   std::vector<VMesh::coords_type>& coords) const override;
+
+  void get_interpolate_weights_many(const std::vector<Point>& points,
+                                    VMesh::MultiElemInterpolate& ei,
+                                    int basis_order) const override;
+
   VMesh::index_type* get_elems_pointer() const override;
 };
 
@@ -569,6 +577,27 @@ VHexVolMesh<MESH>::get_edge(VMesh::Edge::index_type& edge,
   return(this->mesh_->get_edge_from_nodes(edge,nodes));
 }
 
+template <class MESH>
+void
+VHexVolMesh<MESH>::locate_many(const std::vector<Point>& points,
+                               std::vector<VMesh::Elem::index_type>& elems,
+                               std::vector<VMesh::coords_type>& coords) const
+{
+  this->mesh_->locate_elems(elems,coords,points);
+}
+
+template <class MESH>
+void
+VHexVolMesh<MESH>::get_interpolate_weights_many(const std::vector<Point>& points,
+                                                VMesh::MultiElemInterpolate& ei,
+                                                int basis_order) const
+{
+  std::vector<VMesh::Elem::index_type> elems;
+  std::vector<VMesh::coords_type> coords;
+  this->mesh_->locate_elems(elems,coords,points);
+  this->fill_interpolate_weights(elems,coords,ei,basis_order);
+}
+
 
 
 
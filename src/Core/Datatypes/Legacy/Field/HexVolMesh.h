@@ -51,6 +51,8 @@
 #include <Core/Datatypes/Legacy/Field/FieldIterator.h>
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/MeshLocateMany.h>
+#include <Core/Datatypes/Legacy/Field/MeshTableBuilder.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Mesh/VirtualMeshFacade.h>
 
@@ -1808,7 +1810,7 @@ protected:
       "HexVolMesh: Must call synchronize EDGES_E first");
 
     // Get all the nodes that share an edge with this node
-    const std::vector<typename Cell::index_type>& neighbors = node_neighbors_[idx];
+    const NodeNeighborTable::Range neighbors = node_neighbors_[idx];
 
     array.clear();
     array.reserve(neighbors.size());
@@ -1890,7 +1892,7 @@ protected:
       "HexVolMesh: Must call synchronize FACES_E first");
 
     array.clear();
-    const std::vector<typename Cell::index_type>& neighbors = node_neighbors_[idx];
+    const NodeNeighborTable::Range neighbors = node_neighbors_[idx];
 
     // Iterate through all those edges
     for (size_t n = 0; n < neighbors.size(); n++)
@@ -2364,6 +2366,26 @@ protected:
     return (false);
   }
 
+  /// Batched version of locate_elem for mapping large sets of points. The
+  /// queries are spread over threads in search grid order, using the last
+  /// element found as the first guess for the next point; elems is set to
+  /// -1 for points outside the mesh.
+  template <class INDEX, class ARRAY>
+  void locate_elems(std::vector<INDEX> &elems, std::vector<ARRAY> &coords,
+                    const std::vector<Core::Geometry::Point> &points) const
+  {
+    const bool linear = (basis_.polynomial_order() <= 1);
+    const SearchGridT<index_type>* grid =
+      (linear && (synchronized_ & Mesh::ELEM_LOCATE_E)) ? elem_grid_.get() : nullptr;
+
+    locateElemsInSpatialOrder(grid, points, elems, coords,
+      [this, linear](INDEX &elem, ARRAY &c, const Core::Geometry::Point &p)
+      {
+        // elem_locate does not compute the local coordinates
+        return (locate_elem(elem, c, p) && (linear || get_coords(c, p, elem)));
+      });
+  }
+
   template <class INDEX>
   inline void get_node_center(Core::Geometry::Point &p, INDEX idx) const
   {
@@ -2436,6 +2458,8 @@ protected:
   void compute_elem_grid();
   void compute_bounding_box();
 
+  Core::Geometry::BBox elem_grid_bbox(typename Elem::index_type ci) const;
+
   void insert_elem_into_grid(typename Elem::index_type ci);
   void remove_elem_from_grid(typename Elem::index_type ci);
   void insert_node_into_grid(typename Node::index_type ci);
@@ -2774,15 +2798,6 @@ protected:
   edge_ct edges_;
   edge_nt edge_table_;
 
-  inline
-  void hash_edge(typename Node::index_type n1, typename Node::index_type n2,
-                 index_type combind_index, edge_ht &table) const;
-
-  inline
-  void hash_face(typename Node::index_type n1, typename Node::index_type n2,
-                 typename Node::index_type n3, typename Node::index_type n4,
-                 index_type combined_index, face_ht &table) const;
-
   template <class INDEX>
   bool order_face_nodes(INDEX& n1, INDEX& n2, INDEX& n3, INDEX& n4) const
   {
@@ -2852,7 +2867,7 @@ protected:
     typename Node::array_type   nodes_;
   };
 
-  std::vector<std::vector<typename Cell::index_type> > node_neighbors_;
+  NodeNeighborTable node_neighbors_;
   std::vector<unsigned char> boundary_faces_;
 
   /// This grid is used as an acceleration structure to expedite calls
@@ -3210,184 +3225,149 @@ HexVolMesh<Basis>::transform(const Core::Geometry::Transform &t)
   synchronize_lock_.unlock();
 }
 
-template <class Basis>
-void
-HexVolMesh<Basis>::hash_face(typename Node::index_type n1,
-                             typename Node::index_type n2,
-                             typename Node::index_type n3,
-                             typename Node::index_type n4,
-                             index_type combined_index,
-                             face_ht &table) const
-{
-  // Reorder nodes while maintaining CCW or CW orientation
-  // Check for degenerate faces, if faces has degeneracy it
-  // will be ignored (e.g. nodes on opposite corners are equal,
-  // or more then two nodes are equal)
-
-  if (!(order_face_nodes(n1,n2,n3,n4))) return;
-  PFace f(n1, n2, n3, n4);
-
-
-  typename face_ht::iterator iter = table.find(f);
-
-  if (iter == table.end())
-  {
-    f.cells_[0] = combined_index;
-    table[f] = 0; // insert for the first time
-  }
-  else
-  {
-    PFace f = (*iter).first;
-    if (f.cells_[1] != MESH_NO_NEIGHBOR)
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "HexVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>3) << ", #" << (f.cells_[1]>>3) << ", and #" << (combined_index>>3)
-           << " are illegally adjacent." << std::endl;*/
-    }
-    else if ((f.cells_[0]>>3) == (combined_index>>3))
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "HexVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>3) << ", #" << (f.cells_[1]>>3) << ", and #" << (combined_index>>3)
-           << " are the same." << std::endl;
-           */
-    }
-    else
-    {
-      f.cells_[1] = combined_index; // add this cell
-      table.erase(iter);
-      table[f] = 0;
-    }
-  }
-}
-
 template <class Basis>
 void
 HexVolMesh<Basis>::compute_faces()
 {
-  face_table_.clear();
+  const size_type num_cells = static_cast<size_type>(cells_.size() >> 3);
 
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  typename Node::array_type arr(8);
-
-  face_ht table;
+  faces_.clear();
+  face_table_.clear();
+  boundary_faces_.assign(num_cells, 0);
+
+  // 6 faces -- each is entered CCW from outside looking in
+  auto emit_faces = [this](index_type cell, MeshIncidence<4>* out)
+  {
+    static const int face_nodes[6][4] = { {0, 1, 2, 3}, {7, 6, 5, 4}, {0, 4, 5, 1},
+                                          {2, 6, 7, 3}, {3, 7, 4, 0}, {1, 5, 6, 2} };
+    const under_type* nodes = &cells_[cell * 8];
+    size_t count = 0;
+    for (int f = 0; f < 6; f++)
+    {
+      index_type n1 = nodes[face_nodes[f][0]];
+      index_type n2 = nodes[face_nodes[f][1]];
+      index_type n3 = nodes[face_nodes[f][2]];
+      index_type n4 = nodes[face_nodes[f][3]];
+
+      // Reorder nodes while maintaining CCW or CW orientation. Degenerate
+      // faces (opposite corners equal, or more than two nodes equal) are
+      // ignored. The key then drops the orientation, matching PFaceNode's
+      // notion of equality.
+      if (!(order_face_nodes(n1, n2, n3, n4))) continue;
+      if (n3 == n4)
+        out[count].key = {{ n1, std::min(n2, n3), std::max(n2, n3), std::max(n2, n3) }};
+      else
+        out[count].key = {{ n1, std::min(n2, n4), n3, std::max(n2, n4) }};
+      out[count].combined = (cell << 3) + f;
+      count++;
+    }
+    return count;
+  };
 
-  while (ci != cie)
+  auto add_faces = [this](const std::vector<MeshIncidence<4> >& sorted,
+                          const std::vector<size_t>& groups)
   {
-    get_nodes(arr, *ci);
-    // 6 faces -- each is entered CCW from outside looking in
-    index_type cell_index = (*ci)<<3;
-    hash_face(arr[0], arr[1], arr[2], arr[3], cell_index, table);
-    hash_face(arr[7], arr[6], arr[5], arr[4], cell_index + 1, table);
-    hash_face(arr[0], arr[4], arr[5], arr[1], cell_index + 2, table);
-    hash_face(arr[2], arr[6], arr[7], arr[3], cell_index + 3, table);
-    hash_face(arr[3], arr[7], arr[4], arr[0], cell_index + 4, table);
-    hash_face(arr[1], arr[5], arr[6], arr[2], cell_index + 5, table);
-
-    ++ci;
-  }
-
-  faces_.resize(table.size());
-  boundary_faces_.resize(cells_.size()>>3);
+    const size_t first = faces_.size();
+    const size_t count = groups.size() - 1;
+    faces_.resize(first + count);
 
-  typename face_ht::iterator ht_iter = table.begin();
-  typename face_ht::iterator ht_iter_end = table.end();
-
-  index_type uidx = 0;
-  while (ht_iter != ht_iter_end)
-  {
-    const PFace& pface = (*ht_iter).first;
-    faces_[uidx].cells_[0] = pface.cells_[0];
-    faces_[uidx].cells_[1] = pface.cells_[1];
-    face_table_[PFaceNode(pface.nodes_[0],pface.nodes_[1],pface.nodes_[2],pface.nodes_[3])] = uidx;
+    Core::Thread::Parallel::For(0, count, 4096, [&](size_t begin, size_t end)
+    {
+      for (size_t g = begin; g < end; g++)
+      {
+        PFaceCell& face = faces_[first + g];
+        face.cells_[0] = sorted[groups[g]].combined;
+        // A third cell on a face, or a cell touching itself, means the mesh
+        // has problems; those occurrences are ignored.
+        for (size_t i = groups[g] + 1; i < groups[g + 1]; i++)
+        {
+          if (face.cells_[1] == MESH_NO_NEIGHBOR &&
+              (sorted[i].combined >> 3) != (face.cells_[0] >> 3))
+            face.cells_[1] = sorted[i].combined;
+        }
+      }
+    });
 
-    if (pface.cells_[1] == -1)
+    face_table_.reserve(face_table_.size() + count);
+    for (size_t g = 0; g < count; g++)
     {
-      index_type cell = (pface.cells_[0]) >> 3;
-      index_type face = (pface.cells_[0]) & 0x7;
-      boundary_faces_[cell] |= 1 << face;
+      const MeshIncidence<4>& f = sorted[groups[g]];
+      const index_type uidx = static_cast<index_type>(first + g);
+      face_table_.emplace(PFaceNode(f.key[0], f.key[1], f.key[2], f.key[3]), uidx);
+
+      if (faces_[uidx].cells_[1] == MESH_NO_NEIGHBOR)
+      {
+        index_type cell = (faces_[uidx].cells_[0]) >> 3;
+        index_type face = (faces_[uidx].cells_[0]) & 0x7;
+        boundary_faces_[cell] |= 1 << face;
+      }
     }
+  };
 
-    ++ht_iter; uidx++;
-  }
+  buildSortedMeshTable<4>(num_cells, static_cast<size_type>(points_.size()), 6,
+                          emit_faces, add_faces);
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::FACES_E;
   synchronize_lock_.unlock();
 }
 
-template <class Basis>
-void
-HexVolMesh<Basis>::hash_edge(typename Node::index_type n1,
-                             typename Node::index_type n2,
-                             index_type combined_index,
-                             edge_ht &table) const
-{
-  if (n1 == n2) return;
-  PEdge e(n1, n2);
-  typename edge_ht::iterator iter = table.find(e);
-  if (iter == table.end())
-  {
-    e.cells_.push_back(combined_index); // add this cell
-    table[e] = 0; // insert for the first time
-  }
-  else
-  {
-    PEdge e = (*iter).first;
-    e.cells_.push_back(combined_index); // add this cell
-    table.erase(iter);
-    table[e] = 0;
-  }
-}
-
 template <class Basis>
 void
 HexVolMesh<Basis>::compute_edges()
 {
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  edge_ht table;
-  typename Node::array_type arr;
-  while (ci != cie)
-  {
-    get_nodes(arr, *ci);
-    index_type cell_index = (*ci)<<4;
-    hash_edge(arr[0], arr[1], cell_index  , table);
-    hash_edge(arr[1], arr[2], cell_index+1, table);
-    hash_edge(arr[2], arr[3], cell_index+2, table);
-    hash_edge(arr[3], arr[0], cell_index+3, table);
-
-    hash_edge(arr[4], arr[5], cell_index+4, table);
-    hash_edge(arr[5], arr[6], cell_index+5, table);
-    hash_edge(arr[6], arr[7], cell_index+6, table);
-    hash_edge(arr[7], arr[4], cell_index+7, table);
-
-    hash_edge(arr[0], arr[4], cell_index+8, table);
-    hash_edge(arr[5], arr[1], cell_index+9, table);
-    hash_edge(arr[2], arr[6], cell_index+10,table);
-    hash_edge(arr[7], arr[3], cell_index+11,table);
-    ++ci;
-  }
+  edges_.clear();
+  edge_table_.clear();
+
+  auto emit_edges = [this](index_type cell, MeshIncidence<2>* out)
+  {
+    static const int edge_nodes[12][2] = { {0, 1}, {1, 2}, {2, 3}, {3, 0},
+                                           {4, 5}, {5, 6}, {6, 7}, {7, 4},
+                                           {0, 4}, {5, 1}, {2, 6}, {7, 3} };
+    const under_type* nodes = &cells_[cell * 8];
+    size_t count = 0;
+    for (int e = 0; e < 12; e++)
+    {
+      const index_type n1 = nodes[edge_nodes[e][0]];
+      const index_type n2 = nodes[edge_nodes[e][1]];
+      if (n1 == n2) continue;
+      out[count].key = {{ std::min(n1, n2), std::max(n1, n2) }};
+      out[count].combined = (cell << 4) + e;
+      count++;
+    }
+    return count;
+  };
 
   // dump edges into the edges_ container.
+  auto add_edges = [this](const std::vector<MeshIncidence<2> >& sorted,
+                          const std::vector<size_t>& groups)
+  {
+    const size_t first = edges_.size();
+    const size_t count = groups.size() - 1;
+    edges_.resize(first + count);
 
-  edges_.resize(table.size());
+    Core::Thread::Parallel::For(0, count, 4096, [&](size_t begin, size_t end)
+    {
+      for (size_t g = begin; g < end; g++)
+      {
+        std::vector<index_type>& cells = edges_[first + g].cells_;
+        cells.reserve(groups[g + 1] - groups[g]);
+        for (size_t i = groups[g]; i < groups[g + 1]; i++)
+          cells.push_back(sorted[i].combined);
+      }
+    });
 
-  typename edge_ht::iterator ht_iter = table.begin();
-  typename edge_ht::iterator ht_iter_end = table.end();
+    edge_table_.reserve(edge_table_.size() + count);
+    for (size_t g = 0; g < count; g++)
+    {
+      const MeshIncidence<2>& e = sorted[groups[g]];
+      edge_table_.emplace(PEdgeNode(e.key[0], e.key[1]), static_cast<index_type>(first + g));
+    }
+  };
 
-  index_type uidx = 0;
-  while (ht_iter != ht_iter_end)
-  {
-    const PEdge& pedge = (*ht_iter).first;
-    edges_[uidx].cells_ = pedge.cells_;
-    edge_table_[PEdgeNode(pedge.nodes_[0],pedge.nodes_[1])] = uidx;
-    ++ht_iter; uidx++;
-  }
+  buildSortedMeshTable<2>(static_cast<size_type>(cells_.size() >> 3),
+                          static_cast<size_type>(points_.size()), 12,
+                          emit_edges, add_edges);
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::EDGES_E;
@@ -3677,13 +3657,9 @@ template <class Basis>
 void
 HexVolMesh<Basis>::compute_node_neighbors()
 {
-  node_neighbors_.clear();
-  node_neighbors_.resize(points_.size());
-  index_type i, num_cells = cells_.size();
-  for (i = 0; i < num_cells; i++)
-  {
-    node_neighbors_[cells_[i]].push_back(i);
-  }
+  node_neighbors_.build(points_.size(), cells_.size(),
+    [this](size_t i) { return cells_[i]; },
+    [](size_t i) { return static_cast<index_type>(i); });
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::NODE_NEIGHBORS_E;
@@ -3726,12 +3702,9 @@ HexVolMesh<Basis>::get_weights(const Core::Geometry::Point &p, typename Cell::ar
 }
 
 template <class Basis>
-void
-HexVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+Core::Geometry::BBox
+HexVolMesh<Basis>::elem_grid_bbox(typename Elem::index_type ci) const
 {
-  /// @todo:  This can crash if you insert a new cell outside of the grid.
-  // Need to recompute grid at that point.
-
   const index_type idx = ci*8;
   Core::Geometry::BBox box;
   box.extend(points_[cells_[idx]]);
@@ -3743,26 +3716,24 @@ HexVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
   box.extend(points_[cells_[idx+6]]);
   box.extend(points_[cells_[idx+7]]);
   box.extend(epsilon_);
+  return box;
+}
 
-  elem_grid_->insert(ci, box);
+
+template <class Basis>
+void
+HexVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+{
+  /// @todo:  This can crash if you insert a new cell outside of the grid.
+  // Need to recompute grid at that point.
+  elem_grid_->insert(ci, elem_grid_bbox(ci));
 }
 
 template <class Basis>
 void
 HexVolMesh<Basis>::remove_elem_from_grid(typename Elem::index_type ci)
 {
-  const index_type idx = ci*8;
-  Core::Geometry::BBox box;
-  box.extend(points_[cells_[idx]]);
-  box.extend(points_[cells_[idx+1]]);
-  box.extend(points_[cells_[idx+2]]);
-  box.extend(points_[cells_[idx+3]]);
-  box.extend(points_[cells_[idx+4]]);
-  box.extend(points_[cells_[idx+5]]);
-  box.extend(points_[cells_[idx+6]]);
-  box.extend(points_[cells_[idx+7]]);
-  box.extend(epsilon_);
-  elem_grid_->remove(ci, box);
+  elem_grid_->remove(ci, elem_grid_bbox(ci));
 }
 
 template <class Basis>
@@ -3803,13 +3774,8 @@ HexVolMesh<Basis>::compute_elem_grid()
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
     elem_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Elem::iterator ci, cie;
-    begin(ci); end(cie);
-    while(ci != cie)
-    {
-      insert_elem_into_grid(*ci);
-      ++ci;
-    }
+    elem_grid_->insert_boxes(esz, [this](index_type ci)
+      { return elem_grid_bbox(typename Elem::index_type(ci)); });
   }
 
   synchronize_lock_.lock();
@@ -3840,13 +3806,8 @@ HexVolMesh<Basis>::compute_node_grid()
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
     node_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Node::iterator ni, nie;
-    begin(ni); end(nie);
-    while(ni != nie)
-    {
-      insert_node_into_grid(*ni);
-      ++ni;
-    }
+    node_grid_->insert_points(static_cast<size_type>(points_.size()),
+      [this](index_type ni) { return points_[ni]; });
   }
 
   synchronize_lock_.lock();
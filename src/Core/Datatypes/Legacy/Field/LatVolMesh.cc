@@ -30,6 +30,7 @@
 #include <Core/Datatypes/Legacy/Field/VMeshShared.h>
 #include <Core/Datatypes/Legacy/Field/StructHexVolMesh.h>
 #include <Core/Basis/HexElementWeights.h>
+#include <Core/Thread/Parallel.h>
 
 using namespace SCIRun::Core::Geometry;
 using namespace SCIRun::Core::Basis;
@@ -183,6 +184,10 @@ public:
 
   bool locate(VMesh::Elem::array_type &i, const BBox &bbox) const override;
 
+  void locate_many(const std::vector<Point>& points,
+                   std::vector<VMesh::Elem::index_type>& elems,
+                   std::vector<VMesh::coords_type>& coords) const override;
+
   bool get_coords(VMesh::coords_type &coords,
                           const Point &point,
                           VMesh::Elem::index_type i) const override;
@@ -279,6 +284,10 @@ public:
                                        VMesh::ElemInterpolate& ei,
                                        int basis_order) const override;
 
+  void get_interpolate_weights_many(const std::vector<Point>& points,
+                                    VMesh::MultiElemInterpolate& ei,
+                                    int basis_order) const override;
+
   void get_minterpolate_weights(const std::vector<Point>& point,
                                        VMesh::MultiElemInterpolate& ei,
                                        int basis_order) const override;
@@ -1694,6 +1703,25 @@ VLatVolMesh<MESH>::locate(VMesh::Elem::index_type &i,
   return(this->elem_locate(i,coords,point));
 }
 
+/// Locating a point in a regular grid does not need a search, so the points
+/// are simply split over the available threads.
+template <class MESH>
+void
+VLatVolMesh<MESH>::locate_many(const std::vector<Point>& points,
+                               std::vector<VMesh::Elem::index_type>& elems,
+                               std::vector<VMesh::coords_type>& coords) const
+{
+  elems.resize(points.size());
+  coords.resize(points.size());
+  Core::Thread::Parallel::For(0, points.size(), 4096, [&](size_t begin, size_t end)
+  {
+    for (size_t i=begin; i<end; i++)
+    {
+      if (!(elem_locate(elems[i],coords[i],points[i]))) elems[i] = -1;
+    }
+  });
+}
+
 template <class MESH>
 bool
 VLatVolMesh<MESH>::get_coords(VMesh::coords_type &coords,
@@ -2388,6 +2416,33 @@ VLatVolMesh<MESH>::get_interpolate_weights(const VMesh::coords_type& coords,
 }
 
 
+template <class MESH>
+void
+VLatVolMesh<MESH>::get_interpolate_weights_many(const std::vector<Point>& points,
+                                                VMesh::MultiElemInterpolate& ei,
+                                                int basis_order) const
+{
+  ei.resize(points.size());
+  Core::Thread::Parallel::For(0, points.size(), 4096, [&](size_t begin, size_t end)
+  {
+    VMesh::Elem::index_type elem;
+    StackVector<double,3> coords;
+    for (size_t i=begin; i<end; i++)
+    {
+      if (elem_locate(elem,coords,points[i]))
+      {
+        VLatVolMesh<MESH>::get_interpolate_weights(coords,elem,ei[i],basis_order);
+      }
+      else
+      {
+        ei[i].basis_order = basis_order;
+        ei[i].elem_index = -1;
+      }
+    }
+  });
+}
+
+
 template <class MESH>
 void
 VLatVolMesh<MESH>::get_minterpolate_weights(const std::vector<Point>& point,
@@ -2961,6 +3016,10 @@ public:
 
   bool locate(VMesh::Elem::array_type &i, const BBox &bbox) const override;
 
+  void locate_many(const std::vector<Point>& points,
+                   std::vector<VMesh::Elem::index_type>& elems,
+                   std::vector<VMesh::coords_type>& coords) const override;
+
   bool find_closest_node(double& pdist,
                                  Point& result,
                                  VMesh::Node::index_type& elem,
@@ -3035,6 +3094,10 @@ public:
                                        VMesh::ElemInterpolate& ei,
                                        int basis_order) const override;
 
+  void get_interpolate_weights_many(const std::vector<Point>& points,
+                                    VMesh::MultiElemInterpolate& ei,
+                                    int basis_order) const override;
+
   void get_minterpolate_weights(const std::vector<Point>& point,
                                        VMesh::MultiElemInterpolate& ei,
                                        int basis_order) const override;
@@ -3348,6 +3411,26 @@ VStructHexVolMesh<MESH>::locate(VMesh::Elem::index_type &vi, const Point &point)
   return (ret);
 }
 
+/// The elements are not aligned with the grid, so use the generic
+/// implementations rather than the ones of VLatVolMesh
+template <class MESH>
+void
+VStructHexVolMesh<MESH>::locate_many(const std::vector<Point>& points,
+                                     std::vector<VMesh::Elem::index_type>& elems,
+                                     std::vector<VMesh::coords_type>& coords) const
+{
+  VMesh::locate_many(points,elems,coords);
+}
+
+template <class MESH>
+void
+VStructHexVolMesh<MESH>::get_interpolate_weights_many(const std::vector<Point>& points,
+                                                      VMesh::MultiElemInterpolate& ei,
+                                                      int basis_order) const
+{
+  VMesh::get_interpolate_weights_many(points,ei,basis_order);
+}
+
 template <class MESH>
 bool
 VStructHexVolMesh<MESH>::locate(VMesh::Elem::array_type &va, const BBox &bbox) const
@@ -0,0 +1,87 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_DATATYPES_MESHLOCATEMANY_H
+#define CORE_DATATYPES_MESHLOCATEMANY_H 1
+
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/Thread/Parallel.h>
+
+#include <numeric>
+#include <vector>
+
+namespace SCIRun {
+
+/// Locates a batch of points in a mesh. locateElem(elem, coords, point) is
+/// the mesh's own single point locate: it tests elem as an estimate first and
+/// falls back to its search structure. The points are walked in the bin order
+/// of grid, if given, so consecutive queries tend to fall in the same or a
+/// neighboring element, and every thread reuses its last hit as the estimate
+/// for its next point. Points that are not inside the mesh get element -1.
+/// locateElem is called concurrently.
+template <class GRID, class INDEX, class ARRAY, class LocateElem>
+void locateElemsInSpatialOrder(const GRID* grid,
+  const std::vector<Core::Geometry::Point>& points,
+  std::vector<INDEX>& elems, std::vector<ARRAY>& coords,
+  const LocateElem& locateElem)
+{
+  const size_t numPoints = points.size();
+  elems.assign(numPoints, INDEX(-1));
+  coords.resize(numPoints);
+
+  std::vector<index_type> order;
+  if (grid)
+  {
+    grid->spatial_order(points, order);
+  }
+  else
+  {
+    order.resize(numPoints);
+    std::iota(order.begin(), order.end(), index_type(0));
+  }
+
+  Core::Thread::Parallel::For(0, numPoints, 1024, [&](size_t begin, size_t end)
+  {
+    INDEX seed(-1);
+    for (size_t m = begin; m < end; m++)
+    {
+      const index_type n = order[m];
+      INDEX elem = seed;
+      if (locateElem(elem, coords[n], points[n]))
+      {
+        elems[n] = elem;
+        seed = elem;
+      }
+    }
+  });
+}
+
+} // namespace SCIRun
+
+#endif
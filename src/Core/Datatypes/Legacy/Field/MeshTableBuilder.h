@@ -0,0 +1,377 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_DATATYPES_MESHTABLEBUILDER_H
+#define CORE_DATATYPES_MESHTABLEBUILDER_H 1
+
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/Thread/Parallel.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace SCIRun {
+
+/// One occurrence of an edge or face in a cell: a canonical node key, whose
+/// first entry must be a node of the mesh, and the combined cell/local index
+/// the occurrence was generated from.
+template <size_t N>
+struct MeshIncidence
+{
+  std::array<index_type, N> key;
+  index_type combined;
+
+  bool operator<(const MeshIncidence& other) const
+  {
+    return key < other.key || (key == other.key && combined < other.combined);
+  }
+};
+
+namespace detail {
+
+  /// Sorts chunks in parallel and merges them pairwise.
+  template <class T>
+  void parallelSort(std::vector<T>& values)
+  {
+    const size_t minChunk = 1 << 16;
+    size_t chunks = 1;
+    while (chunks * 2 <= static_cast<size_t>(Core::Thread::Parallel::NumCores()) &&
+           chunks * 2 * minChunk <= values.size())
+      chunks *= 2;
+
+    std::vector<size_t> bounds(chunks + 1);
+    for (size_t i = 0; i <= chunks; ++i)
+      bounds[i] = values.size() * i / chunks;
+
+    Core::Thread::Parallel::For(0, chunks, 1, [&](size_t begin, size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+        std::sort(values.begin() + bounds[i], values.begin() + bounds[i + 1]);
+    });
+
+    for (size_t width = 1; width < chunks; width *= 2)
+    {
+      Core::Thread::Parallel::For(0, chunks / (2 * width), 1, [&](size_t begin, size_t end)
+      {
+        for (size_t j = begin; j < end; ++j)
+        {
+          const size_t first = 2 * width * j;
+          std::inplace_merge(values.begin() + bounds[first],
+            values.begin() + bounds[first + width], values.begin() + bounds[first + 2 * width]);
+        }
+      });
+    }
+  }
+}
+
+/// Builds unique edge or face tables by sort-and-unique rather than hashing
+/// every occurrence.
+///
+/// emitCell(cell, out) writes at most maxPerCell incidences of a cell to out
+/// and returns how many it wrote; it is called concurrently. The incidences
+/// are sorted by key and handed to consumeBatch(sorted, groups), where
+/// groups holds the start of every run of equal keys plus a final sentinel.
+/// Runs are ordered by key and the incidences within a run by their combined
+/// index, i.e. in cell order, so the result does not depend on scheduling.
+///
+/// Once the mesh would produce more than maxBatch incidences they are
+/// partitioned on their first key node and sorted one partition at a time,
+/// which bounds the peak memory of the build.
+template <size_t N, class EmitCell, class ConsumeBatch>
+void buildSortedMeshTable(size_type numCells, size_type numNodes, size_t maxPerCell,
+  const EmitCell& emitCell, const ConsumeBatch& consumeBatch,
+  size_t maxBatch = size_t(1) << 23)
+{
+  using Incidence = MeshIncidence<N>;
+  using Core::Thread::Parallel;
+  const size_t cellGrain = 4096;
+  const size_t numBuckets = 4096;
+
+  if (numCells <= 0 || numNodes <= 0)
+    return;
+
+  const size_t cells = static_cast<size_t>(numCells);
+  const size_t nodes = static_cast<size_t>(numNodes);
+  auto bucketOf = [nodes, numBuckets](index_type node)
+  {
+    return static_cast<size_t>(node) * numBuckets / nodes;
+  };
+
+  // Partition [bucket ranges) so that no batch exceeds maxBatch, unless a single
+  // bucket does.
+  std::vector<size_t> partitions{ 0, numBuckets };
+  std::vector<size_t> bucketCounts;
+  if (cells * maxPerCell > maxBatch)
+  {
+    bucketCounts.assign(numBuckets, 0);
+    std::mutex countLock;
+    Parallel::For(0, cells, cellGrain, [&](size_t begin, size_t end)
+    {
+      std::vector<size_t> local(numBuckets, 0);
+      std::vector<Incidence> scratch(maxPerCell);
+      for (size_t c = begin; c < end; ++c)
+      {
+        const size_t count = emitCell(static_cast<index_type>(c), scratch.data());
+        for (size_t i = 0; i < count; ++i)
+          ++local[bucketOf(scratch[i].key[0])];
+      }
+      std::lock_guard<std::mutex> lock(countLock);
+      for (size_t b = 0; b < numBuckets; ++b)
+        bucketCounts[b] += local[b];
+    });
+
+    partitions.assign(1, 0);
+    size_t inPartition = 0;
+    for (size_t b = 0; b < numBuckets; ++b)
+    {
+      if (inPartition > 0 && inPartition + bucketCounts[b] > maxBatch)
+      {
+        partitions.push_back(b);
+        inPartition = 0;
+      }
+      inPartition += bucketCounts[b];
+    }
+    partitions.push_back(numBuckets);
+  }
+
+  std::vector<Incidence> batch;
+  std::vector<size_t> groups;
+  for (size_t p = 0; p + 1 < partitions.size(); ++p)
+  {
+    const size_t lo = partitions[p];
+    const size_t hi = partitions[p + 1];
+    const bool filter = partitions.size() > 2;
+
+    size_t capacity = cells * maxPerCell;
+    if (filter)
+    {
+      capacity = 0;
+      for (size_t b = lo; b < hi; ++b)
+        capacity += bucketCounts[b];
+    }
+
+    batch.clear();
+    batch.shrink_to_fit();
+    batch.resize(capacity);
+    std::atomic<size_t> cursor(0);
+
+    Parallel::For(0, cells, cellGrain, [&](size_t begin, size_t end)
+    {
+      std::vector<Incidence> local;
+      local.reserve((end - begin) * maxPerCell);
+      std::vector<Incidence> scratch(maxPerCell);
+      for (size_t c = begin; c < end; ++c)
+      {
+        const size_t count = emitCell(static_cast<index_type>(c), scratch.data());
+        for (size_t i = 0; i < count; ++i)
+        {
+          if (filter)
+          {
+            const size_t bucket = bucketOf(scratch[i].key[0]);
+            if (bucket < lo || bucket >= hi)
+              continue;
+          }
+          local.push_back(scratch[i]);
+        }
+      }
+      const size_t offset = cursor.fetch_add(local.size());
+      std::copy(local.begin(), local.end(), batch.begin() + offset);
+    });
+    batch.resize(cursor.load());
+
+    detail::parallelSort(batch);
+
+    groups.clear();
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+      if (i == 0 || batch[i].key != batch[i - 1].key)
+        groups.push_back(i);
+    }
+    groups.push_back(batch.size());
+
+    consumeBatch(static_cast<const std::vector<Incidence>&>(batch), static_cast<const std::vector<size_t>&>(groups));
+  }
+}
+
+/// Node to element adjacency stored as two flat arrays (compressed rows):
+/// the entries of node n are entries_[offsets_[n], offsets_[n+1]). Once the
+/// table is edited it keeps one list per node until it is built again.
+class NodeNeighborTable
+{
+public:
+  /// The entries of a single node.
+  class Range
+  {
+  public:
+    Range(const index_type* begin, const index_type* end) : begin_(begin), end_(end) {}
+
+    size_t size() const { return static_cast<size_t>(end_ - begin_); }
+    bool empty() const { return begin_ == end_; }
+    const index_type& operator[](size_t i) const { return begin_[i]; }
+    const index_type* begin() const { return begin_; }
+    const index_type* end() const { return end_; }
+
+  private:
+    const index_type* begin_;
+    const index_type* end_;
+  };
+
+  /// Number of nodes in the table.
+  size_t size() const
+  {
+    if (edited_) return lists_.size();
+    return offsets_.empty() ? 0 : offsets_.size() - 1;
+  }
+
+  Range operator[](index_type node) const
+  {
+    if (edited_)
+    {
+      const std::vector<index_type>& list = lists_[node];
+      return Range(list.data(), list.data() + list.size());
+    }
+    return Range(entries_.data() + offsets_[node], entries_.data() + offsets_[node + 1]);
+  }
+
+  /// Releases all storage.
+  void clear()
+  {
+    std::vector<index_type>().swap(offsets_);
+    std::vector<index_type>().swap(entries_);
+    std::vector<std::vector<index_type> >().swap(lists_);
+    edited_ = false;
+  }
+
+  /// Builds the table from numEntries entries, where entry i belongs to node
+  /// nodeOf(i) and stores valueOf(i). valueOf must not decrease with i, so
+  /// every node lists its entries in the order a serial pass would add them.
+  template <class NodeOf, class ValueOf>
+  void build(size_t numNodes, size_t numEntries, const NodeOf& nodeOf, const ValueOf& valueOf)
+  {
+    using Core::Thread::Parallel;
+    const size_t grain = 1 << 14;
+
+    std::vector<std::vector<index_type> >().swap(lists_);
+    edited_ = false;
+
+    std::vector<std::atomic<index_type> > cursor(numNodes);
+    Parallel::For(0, numNodes, grain, [&](size_t begin, size_t end)
+    {
+      for (size_t n = begin; n < end; ++n)
+        cursor[n].store(0, std::memory_order_relaxed);
+    });
+    Parallel::For(0, numEntries, grain, [&](size_t begin, size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+        cursor[nodeOf(i)].fetch_add(1, std::memory_order_relaxed);
+    });
+
+    offsets_.resize(numNodes + 1);
+    offsets_[0] = 0;
+    for (size_t n = 0; n < numNodes; ++n)
+    {
+      offsets_[n + 1] = offsets_[n] + cursor[n].load(std::memory_order_relaxed);
+      cursor[n].store(offsets_[n], std::memory_order_relaxed);
+    }
+
+    entries_.resize(numEntries);
+    Parallel::For(0, numEntries, grain, [&](size_t begin, size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+        entries_[cursor[nodeOf(i)].fetch_add(1, std::memory_order_relaxed)] = valueOf(i);
+    });
+
+    // Concurrent fills land in any order within a node.
+    Parallel::For(0, numNodes, grain, [&](size_t begin, size_t end)
+    {
+      for (size_t n = begin; n < end; ++n)
+        std::sort(entries_.begin() + offsets_[n], entries_.begin() + offsets_[n + 1]);
+    });
+  }
+
+  /// Appends a node without entries.
+  void add_node()
+  {
+    if (edited_)
+    {
+      lists_.emplace_back();
+      return;
+    }
+    if (offsets_.empty()) offsets_.push_back(0);
+    offsets_.push_back(offsets_.back());
+  }
+
+  /// Appends value to the entries of node.
+  void push_back(index_type node, index_type value)
+  {
+    edit();
+    lists_[node].push_back(value);
+  }
+
+  /// Removes the first occurrence of value from the entries of node, and
+  /// returns false if there is none.
+  bool erase(index_type node, index_type value)
+  {
+    edit();
+    std::vector<index_type>& list = lists_[node];
+    auto it = std::find(list.begin(), list.end(), value);
+    if (it == list.end()) return false;
+
+    list.erase(it);
+    return true;
+  }
+
+private:
+  /// Inserting into the flat arrays would shift every later node, so the
+  /// first edit moves the table into one list per node and later edits only
+  /// touch the lists of the nodes involved. The next build flattens it again.
+  void edit()
+  {
+    if (edited_) return;
+    const size_t numNodes = size();
+    lists_.resize(numNodes);
+    for (size_t n = 0; n < numNodes; ++n)
+      lists_[n].assign(entries_.begin() + offsets_[n], entries_.begin() + offsets_[n + 1]);
+    std::vector<index_type>().swap(offsets_);
+    std::vector<index_type>().swap(entries_);
+    edited_ = true;
+  }
+
+  std::vector<index_type> offsets_;
+  std::vector<index_type> entries_;
+  std::vector<std::vector<index_type> > lists_;
+  bool edited_ = false;
+};
+
+} // namespace SCIRun
+
+#endif
@@ -51,6 +51,7 @@
 #include <Core/Datatypes/Legacy/Field/FieldIterator.h>
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/MeshTableBuilder.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 
 #include <Core/Utils/Legacy/CheckSum.h>
@@ -2169,6 +2170,8 @@ protected:
   void compute_elem_grid();
   void compute_bounding_box();
 
+  Core::Geometry::BBox elem_grid_bbox(typename Elem::index_type ci) const;
+
   void insert_elem_into_grid(typename Elem::index_type ci);
   void remove_elem_from_grid(typename Elem::index_type ci);
   void insert_node_into_grid(typename Node::index_type ci);
@@ -2496,15 +2499,6 @@ protected:
   std::vector<PEdge>            edges_;
   edge_ht                  edge_table_;
 
-  inline
-  void hash_edge(typename Node::index_type n1, typename Node::index_type n2,
-                 typename Cell::index_type ci, edge_ht &table) const;
-
-  inline
-  void hash_face(typename Node::index_type n1, typename Node::index_type n2,
-                 typename Node::index_type n3, typename Node::index_type n4,
-                 index_type combined_index, face_ht &table) const;
-
   template <class INDEX>
   bool order_face_nodes(INDEX& n1, INDEX& n2, INDEX& n3, INDEX& n4) const
   {
@@ -2884,168 +2878,162 @@ PrismVolMesh<Basis>::transform(const Core::Geometry::Transform &t)
   synchronize_lock_.unlock();
 }
 
-template <class Basis>
-void
-PrismVolMesh<Basis>::hash_face(typename Node::index_type n1,
-			       typename Node::index_type n2,
-			       typename Node::index_type n3,
-			       typename Node::index_type n4,
-			       index_type combined_index,
-			       face_ht &table) const
-{
-  // Reorder nodes while maintaining CCW or CW orientation
-  // Check for degenerate faces, if faces has degeneracy it
-  // will be ignored (e.g. nodes on opposite corners are equal,
-  // or more then two nodes are equal)
-
-  if (!(order_face_nodes(n1,n2,n3,n4))) return;
-  PFace f(n1, n2, n3, n4);
-
-  typename face_ht::iterator iter = table.find(f);
-  if (iter == table.end())
-  {
-    f.cells_[0] = combined_index;
-    table[f] = 0; // insert for the first time
-  }
-  else
-  {
-    PFace f = (*iter).first;
-    if (f.cells_[1] != MESH_NO_NEIGHBOR)
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "PrismVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>3) << ", #" << (f.cells_[1]>>3) << ", and #" << (combined_index >> 3)
-           << " are illegally adjacent." << std::endl;*/
-    }
-    else if ((f.cells_[0]>>3) == (combined_index>>3))
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "PrismVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>3) << " and #" << (combined_index>>3)
-           << " are the same." << std::endl;
-           */
-    }
-    else
-    {
-      f.cells_[1] = combined_index; // add this cell
-      table.erase(iter);
-      table[f] = 0;
-    }
-  }
-}
-
 template <class Basis>
 void
 PrismVolMesh<Basis>::compute_faces()
 {
+  faces_.clear();
   face_table_.clear();
+  boundary_faces_.assign(cells_.size() / 6, 0);
+
+  // 5 faces -- each is entered CCW from outside looking in. Reorder nodes
+  // while maintaining CCW or CW orientation; degenerate faces (e.g. nodes on
+  // opposite corners are equal, or more then two nodes are equal) are
+  // ignored.
+  auto oriented_face = [this](index_type combined, PFace& face)
+  {
+    static const int face_nodes[5][4] = { {0, 1, 2, -1}, {5, 4, 3, -1}, {1, 4, 5, 2},
+                                          {2, 5, 3, 0}, {0, 3, 4, 1} };
+    const int* local = face_nodes[combined & 0x7];
+    const under_type* nodes = &cells_[(combined >> 3) * 6];
+    for (int i = 0; i < 4; i++)
+      face.nodes_[i] = (local[i] < 0) ? PRISM_DUMMY_NODE_INDEX :
+        typename Node::index_type(nodes[local[i]]);
+    return order_face_nodes(face.nodes_[0], face.nodes_[1], face.nodes_[2], face.nodes_[3]);
+  };
 
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  typename Node::array_type arr(6);
-  while (ci != cie)
+  // Triangles are keyed by their nodes as entered, quads without their
+  // orientation, which is what PFace considers equal.
+  auto emit_faces = [&oriented_face](index_type cell, MeshIncidence<4>* out)
   {
-    get_nodes(arr, *ci);
-    // 5 faces -- each is entered CCW from outside looking in
-    index_type cell_index = (*ci)<<3;
-    hash_face(arr[0], arr[1], arr[2], PRISM_DUMMY_NODE_INDEX, cell_index, face_table_);
-    hash_face(arr[5], arr[4], arr[3], PRISM_DUMMY_NODE_INDEX, cell_index + 1, face_table_);
-    hash_face(arr[1], arr[4], arr[5], arr[2], cell_index + 2, face_table_);
-    hash_face(arr[2], arr[5], arr[3], arr[0], cell_index + 3, face_table_);
-    hash_face(arr[0], arr[3], arr[4], arr[1], cell_index + 4, face_table_);
-
-    ++ci;
-  }
-
-  // dump edges into the edges_ container.
-  faces_.resize(face_table_.size());
-  typename std::vector<PFace>::iterator f_iter = faces_.begin();
-  typename face_ht::iterator ht_iter = face_table_.begin();
+    size_t count = 0;
+    for (int f = 0; f < 5; f++)
+    {
+      PFace face;
+      const index_type combined = (cell << 3) + f;
+      if (!oriented_face(combined, face)) continue;
 
-  boundary_faces_.resize(cells_.size() /6);
+      const index_type n1 = face.nodes_[0], n2 = face.nodes_[1];
+      const index_type n3 = face.nodes_[2], n4 = face.nodes_[3];
+      if (f < 2)
+        out[count].key = {{ n1, n2, n3, n4 }};
+      else if (n3 == n4)
+        out[count].key = {{ n1, std::min(n2, n3), std::max(n2, n3), std::max(n2, n3) }};
+      else
+        out[count].key = {{ n1, std::min(n2, n4), n3, std::max(n2, n4) }};
+      out[count].combined = combined;
+      count++;
+    }
+    return count;
+  };
 
-  index_type i = 0;
-  while (ht_iter != face_table_.end())
+  auto add_faces = [this, &oriented_face](const std::vector<MeshIncidence<4> >& sorted,
+                                          const std::vector<size_t>& groups)
   {
-    *f_iter = (*ht_iter).first;
-    (*ht_iter).second = i;
+    const size_t first = faces_.size();
+    const size_t count = groups.size() - 1;
+    faces_.resize(first + count);
+
+    Core::Thread::Parallel::For(0, count, 4096, [&](size_t begin, size_t end)
+    {
+      for (size_t g = begin; g < end; g++)
+      {
+        PFace& face = faces_[first + g];
+        oriented_face(sorted[groups[g]].combined, face);
+        face.cells_[0] = sorted[groups[g]].combined;
+        // A third cell on a face, or a cell touching itself, means the mesh
+        // has problems; those occurrences are ignored.
+        for (size_t i = groups[g] + 1; i < groups[g + 1]; i++)
+        {
+          if (face.cells_[1] == MESH_NO_NEIGHBOR &&
+              (sorted[i].combined >> 3) != (face.cells_[0] >> 3))
+            face.cells_[1] = sorted[i].combined;
+        }
+      }
+    });
 
-    if ((*f_iter).cells_[1] == -1)
+    face_table_.reserve(face_table_.size() + count);
+    for (size_t g = 0; g < count; g++)
     {
-      index_type cell = ((*f_iter).cells_[0]) >> 3;
-      index_type face = ((*f_iter).cells_[0]) & 0x7;
-      boundary_faces_[cell] |= 1 << face;
+      const index_type uidx = static_cast<index_type>(first + g);
+      face_table_.emplace(faces_[uidx], uidx);
+
+      if (faces_[uidx].cells_[1] == MESH_NO_NEIGHBOR)
+      {
+        index_type cell = (faces_[uidx].cells_[0]) >> 3;
+        index_type face = (faces_[uidx].cells_[0]) & 0x7;
+        boundary_faces_[cell] |= 1 << face;
+      }
     }
-    ++f_iter; ++ht_iter; i++;
-  }
+  };
+
+  buildSortedMeshTable<4>(static_cast<size_type>(cells_.size() / 6),
+                          static_cast<size_type>(points_.size()), 5,
+                          emit_faces, add_faces);
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::FACES_E;
   synchronize_lock_.unlock();
 }
 
-template <class Basis>
-void
-PrismVolMesh<Basis>::hash_edge(typename Node::index_type n1,
-			       typename Node::index_type n2,
-			       typename Cell::index_type ci,
-			       edge_ht &table) const
-{
-  if (n1 == n2) return;
-  PEdge e(n1, n2);
-  typename edge_ht::iterator iter = table.find(e);
-  if (iter == table.end())
-  {
-    e.cells_.push_back(ci); // add this cell
-    table[e] = 0; // insert for the first time
-  }
-  else
-  {
-    PEdge e = (*iter).first;
-    e.cells_.push_back(ci); // add this cell
-    table.erase(iter);
-    table[e] = 0;
-  }
-}
-
 template <class Basis>
 void
 PrismVolMesh<Basis>::compute_edges()
 {
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  typename Node::array_type arr;
-  while (ci != cie)
-  {
-    get_nodes(arr, *ci);
-    hash_edge(arr[0], arr[1], *ci, edge_table_);
-    hash_edge(arr[1], arr[2], *ci, edge_table_);
-    hash_edge(arr[2], arr[0], *ci, edge_table_);
-
-    hash_edge(arr[3], arr[4], *ci, edge_table_);
-    hash_edge(arr[4], arr[5], *ci, edge_table_);
-    hash_edge(arr[5], arr[3], *ci, edge_table_);
+  edges_.clear();
+  edge_table_.clear();
 
-    hash_edge(arr[0], arr[3], *ci, edge_table_);
-    hash_edge(arr[4], arr[1], *ci, edge_table_);
-    hash_edge(arr[2], arr[5], *ci, edge_table_);
-    ++ci;
-  }
+  auto emit_edges = [this](index_type cell, MeshIncidence<2>* out)
+  {
+    static const int edge_nodes[9][2] = { {0, 1}, {1, 2}, {2, 0},
+                                          {3, 4}, {4, 5}, {5, 3},
+                                          {0, 3}, {4, 1}, {2, 5} };
+    const under_type* nodes = &cells_[cell * 6];
+    size_t count = 0;
+    for (int e = 0; e < 9; e++)
+    {
+      const index_type n1 = nodes[edge_nodes[e][0]];
+      const index_type n2 = nodes[edge_nodes[e][1]];
+      if (n1 == n2) continue;
+      out[count].key = {{ std::min(n1, n2), std::max(n1, n2) }};
+      out[count].combined = (cell << 4) + e;
+      count++;
+    }
+    return count;
+  };
 
   // dump edges into the edges_ container.
+  auto add_edges = [this](const std::vector<MeshIncidence<2> >& sorted,
+                          const std::vector<size_t>& groups)
+  {
+    const size_t first = edges_.size();
+    const size_t count = groups.size() - 1;
+    edges_.resize(first + count);
 
-  edges_.resize(edge_table_.size());
+    Core::Thread::Parallel::For(0, count, 4096, [&](size_t begin, size_t end)
+    {
+      for (size_t g = begin; g < end; g++)
+      {
+        PEdge& edge = edges_[first + g];
+        edge.nodes_[0] = sorted[groups[g]].key[0];
+        edge.nodes_[1] = sorted[groups[g]].key[1];
+        edge.cells_.reserve(groups[g + 1] - groups[g]);
+        for (size_t i = groups[g]; i < groups[g + 1]; i++)
+          edge.cells_.push_back(sorted[i].combined >> 4);
+      }
+    });
 
-  typename std::vector<PEdge>::iterator e_iter = edges_.begin();
-  typename edge_ht::iterator ht_iter = edge_table_.begin();
-  while (ht_iter != edge_table_.end()) {
-    *e_iter = (*ht_iter).first;
-    (*ht_iter).second = static_cast<typename Edge::index_type>(
-                                                      e_iter - edges_.begin());
-    ++e_iter; ++ht_iter;
-  }
+    edge_table_.reserve(edge_table_.size() + count);
+    for (size_t g = 0; g < count; g++)
+    {
+      const index_type uidx = static_cast<index_type>(first + g);
+      edge_table_.emplace(edges_[uidx], uidx);
+    }
+  };
+
+  buildSortedMeshTable<2>(static_cast<size_type>(cells_.size() / 6),
+                          static_cast<size_type>(points_.size()), 9,
+                          emit_edges, add_edges);
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::EDGES_E;
@@ -3384,12 +3372,9 @@ PrismVolMesh<Basis>::get_weights(const Core::Geometry::Point &p, typename Cell::
 }
 
 template <class Basis>
-void
-PrismVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+Core::Geometry::BBox
+PrismVolMesh<Basis>::elem_grid_bbox(typename Elem::index_type ci) const
 {
-  /// @todo:  This can crash if you insert a new cell outside of the grid.
-  // Need to recompute grid at that point.
-
   const index_type idx = ci*6;
   Core::Geometry::BBox box;
   box.extend(points_[cells_[idx]]);
@@ -3399,23 +3384,24 @@ PrismVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
   box.extend(points_[cells_[idx+4]]);
   box.extend(points_[cells_[idx+5]]);
   box.extend(epsilon_);
-  elem_grid_->insert(ci, box);
+  return box;
+}
+
+
+template <class Basis>
+void
+PrismVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+{
+  /// @todo:  This can crash if you insert a new cell outside of the grid.
+  // Need to recompute grid at that point.
+  elem_grid_->insert(ci, elem_grid_bbox(ci));
 }
 
 template <class Basis>
 void
 PrismVolMesh<Basis>::remove_elem_from_grid(typename Elem::index_type ci)
 {
-  const index_type idx = ci*6;
-  Core::Geometry::BBox box;
-  box.extend(points_[cells_[idx]]);
-  box.extend(points_[cells_[idx+1]]);
-  box.extend(points_[cells_[idx+2]]);
-  box.extend(points_[cells_[idx+3]]);
-  box.extend(points_[cells_[idx+4]]);
-  box.extend(points_[cells_[idx+5]]);
-  box.extend(epsilon_);
-  elem_grid_->remove(ci, box);
+  elem_grid_->remove(ci, elem_grid_bbox(ci));
 }
 
 template <class Basis>
@@ -3456,13 +3442,8 @@ PrismVolMesh<Basis>::compute_elem_grid()
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
     elem_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Elem::iterator ci, cie;
-    begin(ci); end(cie);
-    while(ci != cie)
-    {
-      insert_elem_into_grid(*ci);
-      ++ci;
-    }
+    elem_grid_->insert_boxes(esz, [this](index_type ci)
+      { return elem_grid_bbox(typename Elem::index_type(ci)); });
   }
 
   synchronize_lock_.lock();
@@ -3493,13 +3474,8 @@ PrismVolMesh<Basis>::compute_node_grid()
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
     node_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Node::iterator ni, nie;
-    begin(ni); end(nie);
-    while(ni != nie)
-    {
-      insert_node_into_grid(*ni);
-      ++ni;
-    }
+    node_grid_->insert_points(static_cast<size_type>(points_.size()),
+      [this](index_type ni) { return points_[ni]; });
   }
 
   synchronize_lock_.lock();
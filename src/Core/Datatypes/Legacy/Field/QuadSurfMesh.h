@@ -2157,6 +2157,7 @@ protected:
   void compute_bounding_box();
 
   /// Used to recompute data for individual cells.
+  Core::Geometry::BBox elem_grid_bbox(typename Elem::index_type ci) const;
   void insert_elem_into_grid(typename Elem::index_type ci);
   void remove_elem_from_grid(typename Elem::index_type ci);
 
@@ -2938,11 +2939,9 @@ QuadSurfMesh<Basis>::compute_node_neighbors()
 
 
 template <class Basis>
-void
-QuadSurfMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+Core::Geometry::BBox
+QuadSurfMesh<Basis>::elem_grid_bbox(typename Elem::index_type ci) const
 {
-  /// @todo:  This can crash if you insert a new cell outside of the grid.
-  // Need to recompute grid at that point.
   const index_type idx = ci*4;
   Core::Geometry::BBox box;
   box.extend(points_[faces_[idx]]);
@@ -2950,7 +2949,17 @@ QuadSurfMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
   box.extend(points_[faces_[idx+2]]);
   box.extend(points_[faces_[idx+3]]);
   box.extend(epsilon_);
-  elem_grid_->insert(ci, box);
+  return box;
+}
+
+
+template <class Basis>
+void
+QuadSurfMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+{
+  /// @todo:  This can crash if you insert a new cell outside of the grid.
+  // Need to recompute grid at that point.
+  elem_grid_->insert(ci, elem_grid_bbox(ci));
 }
 
 
@@ -2958,14 +2967,7 @@ template <class Basis>
 void
 QuadSurfMesh<Basis>::remove_elem_from_grid(typename Elem::index_type ci)
 {
-  const index_type idx = ci*4;
-  Core::Geometry::BBox box;
-  box.extend(points_[faces_[idx]]);
-  box.extend(points_[faces_[idx+1]]);
-  box.extend(points_[faces_[idx+2]]);
-  box.extend(points_[faces_[idx+3]]);
-  box.extend(epsilon_);
-  elem_grid_->remove(ci, box);
+  elem_grid_->remove(ci, elem_grid_bbox(ci));
 }
 
 
@@ -3010,13 +3012,8 @@ QuadSurfMesh<Basis>::compute_node_grid()
     b.extend(10*epsilon_);
     node_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Node::iterator ni, nie;
-    begin(ni); end(nie);
-    while(ni != nie)
-    {
-      insert_node_into_grid(*ni);
-      ++ni;
-    }
+    node_grid_->insert_points(static_cast<size_type>(points_.size()),
+      [this](index_type ni) { return points_[ni]; });
   }
 
   synchronize_lock_.lock();
@@ -3047,13 +3044,8 @@ QuadSurfMesh<Basis>::compute_elem_grid()
     b.extend(10*epsilon_);
     elem_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Elem::iterator ci, cie;
-    begin(ci); end(cie);
-    while(ci != cie)
-    {
-      insert_elem_into_grid(*ci);
-      ++ci;
-    }
+    elem_grid_->insert_boxes(esz, [this](index_type ci)
+      { return elem_grid_bbox(typename Elem::index_type(ci)); });
   }
 
   synchronize_lock_.lock();
@@ -240,3 +240,45 @@ TEST_F(LatticeVolumeMeshTests, CubeIterationTest)
       ostr.str());
   }
 }
+
+TEST_F(LatticeVolumeMeshTests, LocateManyMatchesLocate)
+{
+  auto latVolVMesh = mesh_->vmesh();
+
+  std::vector<Point> points;
+  for (int i = 0; i < 20; i++)
+    points.push_back(Point(-0.2 + 0.07*i, 0.5 - 0.02*i, 0.1 + 0.04*i));
+
+  std::vector<VMesh::Elem::index_type> elems;
+  std::vector<VMesh::coords_type> coords;
+  latVolVMesh->locate_many(points, elems, coords);
+
+  VMesh::MultiElemInterpolate ei;
+  latVolVMesh->get_interpolate_weights_many(points, ei, 1);
+
+  ASSERT_EQ(points.size(), elems.size());
+  ASSERT_EQ(points.size(), ei.size());
+  for (size_t n = 0; n < points.size(); n++)
+  {
+    VMesh::Elem::index_type elem;
+    VMesh::coords_type c;
+    if (latVolVMesh->locate(elem, c, points[n]))
+    {
+      EXPECT_EQ(elem, elems[n]);
+      EXPECT_EQ(elem, ei[n].elem_index);
+      for (int d = 0; d < 3; d++)
+        EXPECT_DOUBLE_EQ(c[d], coords[n][d]);
+
+      VMesh::ElemInterpolate single;
+      latVolVMesh->get_interpolate_weights(points[n], single, 1);
+      ASSERT_EQ(single.weights.size(), ei[n].weights.size());
+      for (size_t w = 0; w < single.weights.size(); w++)
+        EXPECT_DOUBLE_EQ(single.weights[w], ei[n].weights[w]);
+    }
+    else
+    {
+      EXPECT_EQ(-1, elems[n]);
+      EXPECT_EQ(-1, ei[n].elem_index);
+    }
+  }
+}
@@ -0,0 +1,187 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Datatypes/Legacy/Field/MeshTableBuilder.h>
+
+#include <gtest/gtest.h>
+#include <map>
+
+using namespace SCIRun;
+
+namespace
+{
+  // Edges of a strip of quads: cell c has nodes {c, c + 1, c + n, c + n + 1}.
+  const size_type stripLength = 1000;
+
+  size_t emitQuadEdges(index_type cell, MeshIncidence<2>* out)
+  {
+    const index_type n[4] = { cell, cell + 1, cell + stripLength + 2, cell + stripLength + 1 };
+    for (int e = 0; e < 4; ++e)
+    {
+      index_type a = n[e], b = n[(e + 1) % 4];
+      out[e].key = { std::min(a, b), std::max(a, b) };
+      out[e].combined = (cell << 2) | e;
+    }
+    return 4;
+  }
+
+  std::map<std::array<index_type, 2>, std::vector<index_type>> buildTable(size_t maxBatch)
+  {
+    std::map<std::array<index_type, 2>, std::vector<index_type>> table;
+    std::vector<std::array<index_type, 2>> order;
+    buildSortedMeshTable<2>(stripLength, 2 * stripLength + 2, 4, emitQuadEdges,
+      [&](const std::vector<MeshIncidence<2>>& sorted, const std::vector<size_t>& groups)
+      {
+        for (size_t g = 0; g + 1 < groups.size(); ++g)
+        {
+          order.push_back(sorted[groups[g]].key);
+          for (size_t i = groups[g]; i < groups[g + 1]; ++i)
+            table[sorted[i].key].push_back(sorted[i].combined);
+        }
+      }, maxBatch);
+    EXPECT_TRUE(std::is_sorted(order.begin(), order.end()));
+    EXPECT_EQ(order.size(), table.size());
+    return table;
+  }
+}
+
+TEST(MeshTableBuilderTests, GroupsEveryIncidenceOfAKeyInCellOrder)
+{
+  auto table = buildTable(size_t(1) << 23);
+
+  EXPECT_EQ(3 * stripLength + 1, table.size());
+  for (const auto& entry : table)
+  {
+    const auto& cells = entry.second;
+    EXPECT_TRUE(cells.size() == 1 || cells.size() == 2);
+    EXPECT_TRUE(std::is_sorted(cells.begin(), cells.end()));
+  }
+  // the edge between the first two quads
+  const std::array<index_type, 2> shared = { 1, stripLength + 2 };
+  ASSERT_EQ(2, table[shared].size());
+  EXPECT_EQ((0 << 2) | 1, table[shared][0]);
+  EXPECT_EQ((1 << 2) | 3, table[shared][1]);
+}
+
+TEST(MeshTableBuilderTests, PartitionedBuildMatchesSingleBatch)
+{
+  EXPECT_EQ(buildTable(size_t(1) << 23), buildTable(64));
+}
+
+TEST(MeshTableBuilderTests, NodeNeighborTableListsCornersInCellOrder)
+{
+  // corners of the quad strip, as in a cells_ array
+  std::vector<index_type> corners;
+  for (index_type cell = 0; cell < stripLength; ++cell)
+  {
+    corners.push_back(cell);
+    corners.push_back(cell + 1);
+    corners.push_back(cell + stripLength + 2);
+    corners.push_back(cell + stripLength + 1);
+  }
+
+  NodeNeighborTable table;
+  table.build(2 * stripLength + 2, corners.size(),
+    [&](size_t i) { return corners[i]; },
+    [](size_t i) { return static_cast<index_type>(i); });
+
+  ASSERT_EQ(2 * stripLength + 2, table.size());
+  for (index_type node = 0; node < static_cast<index_type>(table.size()); ++node)
+  {
+    auto entries = table[node];
+    EXPECT_TRUE(std::is_sorted(entries.begin(), entries.end()));
+    for (auto corner : entries)
+      EXPECT_EQ(node, corners[corner]);
+  }
+  ASSERT_EQ(2, table[1].size());
+  EXPECT_EQ(1, table[1][0]);
+  EXPECT_EQ(4, table[1][1]);
+
+  table.add_node();
+  table.push_back(1, 42);
+  EXPECT_EQ(3, table[1].size());
+  EXPECT_EQ(42, table[1][2]);
+  EXPECT_TRUE(table.erase(1, 1));
+  EXPECT_FALSE(table.erase(1, 1));
+  EXPECT_EQ(4, table[1][0]);
+  EXPECT_EQ(2, table[2].size());
+  EXPECT_TRUE(table[2 * stripLength + 2].empty());
+}
+
+TEST(MeshTableBuilderTests, NodeNeighborTableEditsMatchListsPerNode)
+{
+  const size_t numNodes = 50;
+  std::vector<std::vector<index_type> > expected(numNodes);
+  std::vector<index_type> owner;
+  for (size_t i = 0; i < 4 * numNodes; ++i)
+  {
+    owner.push_back(static_cast<index_type>((i * 7) % numNodes));
+    expected[owner.back()].push_back(static_cast<index_type>(i));
+  }
+
+  NodeNeighborTable table;
+  table.build(numNodes, owner.size(),
+    [&](size_t i) { return owner[i]; },
+    [](size_t i) { return static_cast<index_type>(i); });
+
+  // interleave removals and appends as refinement does with set_nodes
+  for (size_t round = 0; round < 3 * numNodes; ++round)
+  {
+    const index_type node = static_cast<index_type>((round * 13) % numNodes);
+    if (round % 3 == 0 && !expected[node].empty())
+    {
+      const index_type value = expected[node][expected[node].size() / 2];
+      expected[node].erase(std::find(expected[node].begin(), expected[node].end(), value));
+      EXPECT_TRUE(table.erase(node, value));
+    }
+    else
+    {
+      expected[node].push_back(static_cast<index_type>(1000 + round));
+      table.push_back(node, static_cast<index_type>(1000 + round));
+    }
+  }
+  table.add_node();
+  expected.emplace_back();
+  table.push_back(static_cast<index_type>(numNodes), 7);
+  expected[numNodes].push_back(7);
+
+  ASSERT_EQ(expected.size(), table.size());
+  for (size_t n = 0; n < expected.size(); ++n)
+  {
+    auto entries = table[static_cast<index_type>(n)];
+    EXPECT_EQ(expected[n], std::vector<index_type>(entries.begin(), entries.end())) << "node " << n;
+  }
+
+  // building again returns to the flat layout
+  table.build(numNodes, owner.size(),
+    [&](size_t i) { return owner[i]; },
+    [](size_t i) { return static_cast<index_type>(i); });
+  ASSERT_EQ(numNodes, table.size());
+  EXPECT_EQ(4u, table[0].size());
+}
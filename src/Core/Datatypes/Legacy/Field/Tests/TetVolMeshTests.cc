@@ -68,3 +68,57 @@ TEST(TetVolMeshTest, CheckMeshIteratorTetVolMesh)
   ASSERT_EQ(c, 6);
 
 }
+
+TEST(TetVolMeshTest, LocateManyMatchesLocate)
+{
+  auto tetmesh = CubeTetVolLinearBasis(data_info_type::NONE_E);
+  auto mesh = tetmesh->vmesh();
+  mesh->synchronize(Mesh::ELEM_LOCATE_E);
+
+  // A lattice of points partly sticking out of the unit cube
+  std::vector<Point> points;
+  for (int i = 0; i < 12; i++)
+    for (int j = 0; j < 12; j++)
+      for (int k = 0; k < 12; k++)
+        points.push_back(Point(-0.07 + 0.1*i + 0.003*j, -0.05 + 0.1*j + 0.002*k, -0.03 + 0.1*k + 0.001*i));
+
+  std::vector<VMesh::Elem::index_type> elems;
+  std::vector<VMesh::coords_type> coords;
+  mesh->locate_many(points, elems, coords);
+
+  VMesh::MultiElemInterpolate ei;
+  mesh->get_interpolate_weights_many(points, ei, 1);
+
+  ASSERT_EQ(points.size(), elems.size());
+  ASSERT_EQ(points.size(), coords.size());
+  ASSERT_EQ(points.size(), ei.size());
+
+  size_t found = 0;
+  for (size_t n = 0; n < points.size(); n++)
+  {
+    VMesh::Elem::index_type elem;
+    VMesh::coords_type c;
+    const bool inside = mesh->locate(elem, c, points[n]);
+    ASSERT_EQ(inside, elems[n] >= 0) << n;
+    ASSERT_EQ(inside, ei[n].elem_index >= 0) << n;
+    if (!inside) continue;
+    found++;
+
+    // A point on a shared face may be reported in either element, so check
+    // that the local coordinates and weights map back onto the point.
+    Point p;
+    mesh->interpolate(p, coords[n], elems[n]);
+    EXPECT_NEAR(0.0, (p - points[n]).length(), 1e-10);
+
+    Point q(0, 0, 0);
+    for (size_t w = 0; w < ei[n].node_index.size(); w++)
+    {
+      Point node;
+      mesh->get_point(node, VMesh::Node::index_type(ei[n].node_index[w]));
+      q += ei[n].weights[w] * node;
+    }
+    EXPECT_NEAR(0.0, (q - points[n]).length(), 1e-10);
+  }
+  EXPECT_LT(0u, found);
+  EXPECT_GT(points.size(), found);
+}
@@ -145,6 +145,14 @@ public:
                                      VMesh::Elem::index_type  elem,
                                      Point& point) override;
 
+  void locate_many(const std::vector<Point>& points,
+                   std::vector<VMesh::Elem::index_type>& elems,
+                   std::vector<VMesh::coords_type>& coords) const override;
+
+  void get_interpolate_weights_many(const std::vector<Point>& points,
+                                    VMesh::MultiElemInterpolate& ei,
+                                    int basis_order) const override;
+
   VMesh::index_type* get_elems_pointer() const override;
 
   double inscribed_circumscribed_radius_metric(VMesh::Elem::index_type idx) const override;
@@ -544,6 +552,27 @@ VTetVolMesh<MESH>::insert_node_into_elem(VMesh::Elem::array_type& newelems,
   newnode = VMesh::Node::index_type(index);
 }
 
+template <class MESH>
+void
+VTetVolMesh<MESH>::locate_many(const std::vector<Point>& points,
+                               std::vector<VMesh::Elem::index_type>& elems,
+                               std::vector<VMesh::coords_type>& coords) const
+{
+  this->mesh_->locate_elems(elems,coords,points);
+}
+
+template <class MESH>
+void
+VTetVolMesh<MESH>::get_interpolate_weights_many(const std::vector<Point>& points,
+                                                VMesh::MultiElemInterpolate& ei,
+                                                int basis_order) const
+{
+  std::vector<VMesh::Elem::index_type> elems;
+  std::vector<VMesh::coords_type> coords;
+  this->mesh_->locate_elems(elems,coords,points);
+  this->fill_interpolate_weights(elems,coords,ei,basis_order);
+}
+
 
 } // namespace SCIRun
 
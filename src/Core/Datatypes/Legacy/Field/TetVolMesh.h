@@ -51,6 +51,8 @@
 #include <Core/Datatypes/Legacy/Field/FieldIterator.h>
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/MeshLocateMany.h>
+#include <Core/Datatypes/Legacy/Field/MeshTableBuilder.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Mesh/VirtualMeshFacade.h>
 #include <Core/Math/MiscMath.h>
@@ -1719,7 +1721,7 @@ protected:
       "HexVolMesh: Must call synchronize EDGES_E first");
 
     // Get all the nodes that share an edge with this node
-    const std::vector<typename Cell::index_type>& neighbors = node_neighbors_[idx];
+    const NodeNeighborTable::Range neighbors = node_neighbors_[idx];
 
     array.clear();
     array.reserve(neighbors.size());
@@ -1795,7 +1797,7 @@ protected:
       "TetVolMesh: Must call synchronize FACES_E first");
 
     // Get all the nodes that share an edge with this node
-    const std::vector<typename Cell::index_type>& neighbors = node_neighbors_[idx];
+    const NodeNeighborTable::Range neighbors = node_neighbors_[idx];
 
     array.clear();
     array.reserve(neighbors.size());
@@ -2206,6 +2208,26 @@ protected:
     return (false);
   }
 
+  /// Batched version of locate_elem for mapping large sets of points. The
+  /// queries are spread over threads in search grid order, using the last
+  /// element found as the first guess for the next point; elems is set to
+  /// -1 for points outside the mesh.
+  template <class INDEX, class ARRAY>
+  void locate_elems(std::vector<INDEX> &elems, std::vector<ARRAY> &coords,
+                    const std::vector<Core::Geometry::Point> &points) const
+  {
+    const bool linear = (basis_.polynomial_order() <= 1);
+    const SearchGridT<index_type>* grid =
+      (linear && (synchronized_ & Mesh::ELEM_LOCATE_E)) ? elem_grid_.get() : nullptr;
+
+    locateElemsInSpatialOrder(grid, points, elems, coords,
+      [this, linear](INDEX &elem, ARRAY &c, const Core::Geometry::Point &p)
+      {
+        // elem_locate does not compute the local coordinates
+        return (locate_elem(elem, c, p) && (linear || get_coords(c, p, elem)));
+      });
+  }
+
   template <class INDEX>
   inline void get_node_center(Core::Geometry::Point &p, INDEX idx) const
   {
@@ -2263,6 +2285,8 @@ protected:
   void compute_elem_grid();
   void compute_bounding_box();
 
+  Core::Geometry::BBox elem_grid_bbox(typename Elem::index_type ci) const;
+
   void insert_elem_into_grid(typename Elem::index_type ci);
   void remove_elem_from_grid(typename Elem::index_type ci);
   void insert_node_into_grid(typename Node::index_type ci);
@@ -2572,11 +2596,6 @@ protected:
 			  typename Cell::index_type ci,
 			  bool table_only = false);
 
-  inline void hash_edge(typename Node::index_type n1,
-                        typename Node::index_type n2,
-                        index_type combined_index,
-                        edge_ht& table);
-
   inline void add_edge(typename Node::index_type n1,
                         typename Node::index_type n2,
                         index_type combined_index);
@@ -2586,16 +2605,12 @@ protected:
                           typename Node::index_type n3,
                           typename Cell::index_type ci,
                           bool table_only = false);
-  inline void hash_face(typename Node::index_type n1,
-                        typename Node::index_type n2,
-                        typename Node::index_type n3,
-                        index_type ci, face_ht& table);
   inline void add_face(typename Node::index_type n1,
                        typename Node::index_type n2,
                        typename Node::index_type n3,
                        index_type combined_index);
 
-  std::vector<std::vector<typename Cell::index_type> > node_neighbors_;
+  NodeNeighborTable node_neighbors_;
   std::vector<unsigned char> boundary_faces_;
 
   /// This grid is used as an acceleration structure to expedite calls
@@ -2949,101 +2964,74 @@ TetVolMesh<Basis>::remove_face(typename Node::index_type n1,
 
 template <class Basis>
 void
-TetVolMesh<Basis>::hash_face(typename Node::index_type n1,
-                             typename Node::index_type n2,
-                             typename Node::index_type n3,
-                             index_type combined_index,
-                             face_ht& table)
+TetVolMesh<Basis>::compute_faces()
 {
-  PFace f(n1, n2, n3);
+  const size_type num_cells = static_cast<size_type>(cells_.size() >> 2);
 
-  typename face_ht::iterator iter = table.find(f);
-  if (iter == table.end())
-  {
-    f.cells_[0] = combined_index;
-    table[f] = 0; // insert for the first time
-  }
-  else
+  faces_.clear();
+  face_table_.clear();
+  boundary_faces_.assign(num_cells, 0);
+
+  // 4 faces -- each is entered CCW from outside looking in
+  auto emit_faces = [this](index_type cell, MeshIncidence<3>* out)
   {
-    PFace f = (*iter).first;
-    if (f.cells_[1] != MESH_NO_NEIGHBOR)
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "TetVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>2) << ", #" << (f.cells_[1]>>2) << ", and #"
-           << (combined_index>>2) << " are illegally adjacent." << std::endl;
-           */
-    }
-    else if ((f.cells_[0]>>2) == (combined_index>>2))
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "TetVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>2) << " and #" << (combined_index>>2)
-           << " are the same." << std::endl;*/
-    }
-    else
+    static const int face_nodes[4][3] = { {0, 2, 1}, {1, 2, 3}, {0, 1, 3}, {0, 3, 2} };
+    const under_type* nodes = &cells_[cell * 4];
+    for (int f = 0; f < 4; f++)
     {
-      f.cells_[1] = combined_index; // add this cell
-      table.erase(iter);
-      table[f] = 0;
+      PFaceNode face(nodes[face_nodes[f][0]], nodes[face_nodes[f][1]], nodes[face_nodes[f][2]]);
+      out[f].key = {{ face.nodes_[0], face.nodes_[1], face.nodes_[2] }};
+      out[f].combined = (cell << 2) + f;
     }
-  }
-}
-
-template <class Basis>
-void
-TetVolMesh<Basis>::compute_faces()
-{
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  typename Node::array_type arr(4);
-
-  face_ht table;
+    return size_t(4);
+  };
 
-  while (ci != cie)
+  auto add_faces = [this](const std::vector<MeshIncidence<3> >& sorted,
+                          const std::vector<size_t>& groups)
   {
-    get_nodes(arr, *ci);
-    // 4 faces -- each is entered CCW from outside looking in
-
-    index_type cell_index = (*ci)<<2;
-    hash_face(arr[0], arr[2], arr[1], cell_index, table);
-    hash_face(arr[1], arr[2], arr[3], cell_index + 1, table);
-    hash_face(arr[0], arr[1], arr[3], cell_index + 2, table);
-    hash_face(arr[0], arr[3], arr[2], cell_index + 3, table);
-    ++ci;
-  }
-
-  faces_.resize(table.size());
-
-  typename face_ht::iterator ht_iter = table.begin();
-  typename face_ht::iterator ht_iter_end = table.end();
+    const size_t first = faces_.size();
+    const size_t count = groups.size() - 1;
+    faces_.resize(first + count);
 
-  boundary_faces_.resize(cells_.size() >> 2);
-
-  index_type uidx = 0;
-  while (ht_iter != ht_iter_end)
-  {
-    const PFace& pface = (*ht_iter).first;
-    faces_[uidx].cells_[0] = pface.cells_[0];
-    faces_[uidx].cells_[1] = pface.cells_[1];
-    face_table_[PFaceNode(pface.nodes_[0],pface.nodes_[1],pface.nodes_[2])] = uidx;
+    Core::Thread::Parallel::For(0, count, 4096, [&](size_t begin, size_t end)
+    {
+      for (size_t g = begin; g < end; g++)
+      {
+        PFaceCell& face = faces_[first + g];
+        face.cells_[0] = sorted[groups[g]].combined;
+        // A third cell on a face, or a cell touching itself, means the mesh
+        // has problems; those occurrences are ignored.
+        for (size_t i = groups[g] + 1; i < groups[g + 1]; i++)
+        {
+          if (face.cells_[1] == MESH_NO_NEIGHBOR &&
+              (sorted[i].combined >> 2) != (face.cells_[0] >> 2))
+            face.cells_[1] = sorted[i].combined;
+        }
+      }
+    });
 
-    if (pface.cells_[1] == -1)
+    face_table_.reserve(face_table_.size() + count);
+    for (size_t g = 0; g < count; g++)
     {
-      index_type cell = (pface.cells_[0]) >> 2;
-      index_type face = (pface.cells_[0]) & 0x3;
-      boundary_faces_[cell] |= 1 << face;
+      const MeshIncidence<3>& f = sorted[groups[g]];
+      const index_type uidx = static_cast<index_type>(first + g);
+      face_table_.emplace(PFaceNode(f.key[0], f.key[1], f.key[2]), uidx);
+
+      if (faces_[uidx].cells_[1] == MESH_NO_NEIGHBOR)
+      {
+        index_type cell = (faces_[uidx].cells_[0]) >> 2;
+        index_type face = (faces_[uidx].cells_[0]) & 0x3;
+        boundary_faces_[cell] |= 1 << face;
+      }
     }
-    ++ht_iter; uidx++;
-  }
+  };
+
+  buildSortedMeshTable<3>(num_cells, static_cast<size_type>(points_.size()), 4,
+                          emit_faces, add_faces);
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::FACES_E;
   synchronize_lock_.unlock();
-
-
 }
 
 
@@ -3083,64 +3071,57 @@ TetVolMesh<Basis>::add_face(typename Node::index_type n1,
 
 template <class Basis>
 void
-TetVolMesh<Basis>::hash_edge(typename Node::index_type n1,
-                             typename Node::index_type n2,
-                             index_type combined_index,
-                             edge_ht& table)
+TetVolMesh<Basis>::compute_edges()
 {
-  if (n1 == n2) return;
-  PEdge e(n1, n2);
-  typename edge_ht::iterator iter = table.find(e);
+  edges_.clear();
+  edge_table_.clear();
 
-  if (iter == table.end())
-  {
-    e.cells_.push_back(combined_index); // add this cell
-    table[e] = 0; // insert for the first time
-  }
-  else
+  auto emit_edges = [this](index_type cell, MeshIncidence<2>* out)
   {
-    PEdge e = (*iter).first;
-    e.cells_.push_back(combined_index); // add this cell
-    table.erase(iter);
-    table[e] = 0;
-  }
-}
-
-template <class Basis>
-void
-TetVolMesh<Basis>::compute_edges()
-{
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  edge_ht table;
+    static const int edge_nodes[6][2] = { {0, 1}, {1, 2}, {2, 0}, {3, 0}, {3, 1}, {3, 2} };
+    const under_type* nodes = &cells_[cell * 4];
+    size_t count = 0;
+    for (int e = 0; e < 6; e++)
+    {
+      const index_type n1 = nodes[edge_nodes[e][0]];
+      const index_type n2 = nodes[edge_nodes[e][1]];
+      if (n1 == n2) continue;
+      out[count].key = {{ std::min(n1, n2), std::max(n1, n2) }};
+      out[count].combined = (cell << 3) + e;
+      count++;
+    }
+    return count;
+  };
 
-  typename Node::array_type arr;
-  while (ci != cie)
+  auto add_edges = [this](const std::vector<MeshIncidence<2> >& sorted,
+                          const std::vector<size_t>& groups)
   {
-    get_nodes(arr, *ci);
-    index_type cell_index = (*ci)<<3;
-    hash_edge(arr[0], arr[1], cell_index  ,table);
-    hash_edge(arr[1], arr[2], cell_index+1,table);
-    hash_edge(arr[2], arr[0], cell_index+2,table);
-    hash_edge(arr[3], arr[0], cell_index+3,table);
-    hash_edge(arr[3], arr[1], cell_index+4,table);
-    hash_edge(arr[3], arr[2], cell_index+5,table);
-    ++ci;
-  }
+    const size_t first = edges_.size();
+    const size_t count = groups.size() - 1;
+    edges_.resize(first + count);
 
-  edges_.resize(table.size());
+    Core::Thread::Parallel::For(0, count, 4096, [&](size_t begin, size_t end)
+    {
+      for (size_t g = begin; g < end; g++)
+      {
+        std::vector<index_type>& cells = edges_[first + g].cells_;
+        cells.reserve(groups[g + 1] - groups[g]);
+        for (size_t i = groups[g]; i < groups[g + 1]; i++)
+          cells.push_back(sorted[i].combined);
+      }
+    });
 
-  typename edge_ht::iterator ht_iter = table.begin();
-  typename edge_ht::iterator ht_iter_end = table.end();
+    edge_table_.reserve(edge_table_.size() + count);
+    for (size_t g = 0; g < count; g++)
+    {
+      const MeshIncidence<2>& e = sorted[groups[g]];
+      edge_table_.emplace(PEdgeNode(e.key[0], e.key[1]), static_cast<index_type>(first + g));
+    }
+  };
 
-  index_type uidx = 0;
-  while (ht_iter != ht_iter_end)
-  {
-    const PEdge& pedge = (*ht_iter).first;
-    edges_[uidx].cells_ = pedge.cells_;
-    edge_table_[PEdgeNode(pedge.nodes_[0],pedge.nodes_[1])] = uidx;
-    ++ht_iter; uidx++;
-  }
+  buildSortedMeshTable<2>(static_cast<size_type>(cells_.size() >> 2),
+                          static_cast<size_type>(points_.size()), 6,
+                          emit_edges, add_edges);
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::EDGES_E;
@@ -3541,7 +3522,7 @@ TetVolMesh<Basis>::create_cell_node_neighbors(typename Cell::index_type c)
 {
   for (index_type i = c*4; i < c*4+4; ++i)
   {
-    node_neighbors_[cells_[i]].push_back(i);
+    node_neighbors_.push_back(cells_[i], i);
   }
 }
 
@@ -3552,17 +3533,11 @@ TetVolMesh<Basis>::delete_cell_node_neighbors(typename Cell::index_type c)
 {
   for (index_type i = c*4; i < c*4+4; ++i)
   {
-    const index_type n = cells_[i];
-    typename std::vector<typename Cell::index_type>::iterator node_cells_end =
-      node_neighbors_[n].end();
-    typename std::vector<typename Cell::index_type>::iterator cell =
-      node_neighbors_[n].begin();
-    while (cell != node_cells_end && (*cell) != i) ++cell;
-
     /// ASSERT that the node_neighbors_ structure contains this cell
-    ASSERT(cell != node_cells_end);
-
-    node_neighbors_[n].erase(cell);
+    if (!node_neighbors_.erase(cells_[i], i))
+    {
+      ASSERTFAIL("delete cell node neighbors: cell is not in node_neighbors_");
+    }
   }
 }
 
@@ -3670,13 +3645,9 @@ template <class Basis>
 void
 TetVolMesh<Basis>::compute_node_neighbors()
 {
-  node_neighbors_.clear();
-  node_neighbors_.resize(points_.size());
-  index_type i, num_cells = cells_.size();
-  for (i = 0; i < num_cells; i++)
-  {
-    node_neighbors_[cells_[i]].push_back(i);
-  }
+  node_neighbors_.build(points_.size(), cells_.size(),
+    [this](size_t i) { return cells_[i]; },
+    [](size_t i) { return static_cast<index_type>(i); });
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::NODE_NEIGHBORS_E;
@@ -3719,12 +3690,9 @@ TetVolMesh<Basis>::get_weights(const Core::Geometry::Point &p, typename Node::ar
 }
 
 template <class Basis>
-void
-TetVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+Core::Geometry::BBox
+TetVolMesh<Basis>::elem_grid_bbox(typename Elem::index_type ci) const
 {
-  /// @todo:  This can crash if you insert a new cell outside of the grid.
-  // Need to recompute grid at that point.
-
   const index_type idx = ci*4;
   Core::Geometry::BBox box;
   box.extend(points_[cells_[idx]]);
@@ -3732,7 +3700,17 @@ TetVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
   box.extend(points_[cells_[idx+2]]);
   box.extend(points_[cells_[idx+3]]);
   box.extend(epsilon_);
-  elem_grid_->insert(ci, box);
+  return box;
+}
+
+
+template <class Basis>
+void
+TetVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+{
+  /// @todo:  This can crash if you insert a new cell outside of the grid.
+  // Need to recompute grid at that point.
+  elem_grid_->insert(ci, elem_grid_bbox(ci));
 }
 
 
@@ -3740,14 +3718,7 @@ template <class Basis>
 void
 TetVolMesh<Basis>::remove_elem_from_grid(typename Elem::index_type ci)
 {
-  const index_type idx = ci*4;
-  Core::Geometry::BBox box;
-  box.extend(points_[cells_[idx]]);
-  box.extend(points_[cells_[idx+1]]);
-  box.extend(points_[cells_[idx+2]]);
-  box.extend(points_[cells_[idx+3]]);
-  box.extend(epsilon_);
-  elem_grid_->remove(ci, box);
+  elem_grid_->remove(ci, elem_grid_bbox(ci));
 }
 
 template <class Basis>
@@ -3788,13 +3759,8 @@ TetVolMesh<Basis>::compute_elem_grid()
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
     elem_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Elem::iterator ci, cie;
-    begin(ci); end(cie);
-    while(ci != cie)
-    {
-      insert_elem_into_grid(*ci);
-      ++ci;
-    }
+    elem_grid_->insert_boxes(esz, [this](index_type ci)
+      { return elem_grid_bbox(typename Elem::index_type(ci)); });
   }
 
   synchronize_lock_.lock();
@@ -3825,13 +3791,8 @@ TetVolMesh<Basis>::compute_node_grid()
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
     node_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Node::iterator ni, nie;
-    begin(ni); end(nie);
-    while(ni != nie)
-    {
-      insert_node_into_grid(*ni);
-      ++ni;
-    }
+    node_grid_->insert_points(static_cast<size_type>(points_.size()),
+      [this](index_type ni) { return points_[ni]; });
   }
 
   synchronize_lock_.lock();
@@ -3888,7 +3849,7 @@ TetVolMesh<Basis>::add_find_point(const Core::Geometry::Point &p, double /*err*/
     if (synchronized_ & Mesh::NODE_NEIGHBORS_E)
     {
       synchronize_lock_.lock();
-      node_neighbors_.push_back(std::vector<typename Cell::index_type>());
+      node_neighbors_.add_node();
       synchronize_lock_.unlock();
     }
     return static_cast<typename Node::index_type>(points_.size() - 1);
@@ -120,6 +120,14 @@ public:
                                      VMesh::Elem::index_type  elem,
                                      Point& point) override;
 
+  void locate_many(const std::vector<Point>& points,
+                   std::vector<VMesh::Elem::index_type>& elems,
+                   std::vector<VMesh::coords_type>& coords) const override;
+
+  void get_interpolate_weights_many(const std::vector<Point>& points,
+                                    VMesh::MultiElemInterpolate& ei,
+                                    int basis_order) const override;
+
   VMesh::index_type* get_elems_pointer() const override;
   SharedPointer<SearchGridT<typename SCIRun::index_type> > get_elem_search_grid() override { return this->mesh_->elem_grid_; }
   SharedPointer<SearchGridT<typename SCIRun::index_type> > get_node_search_grid() override { return this->mesh_->node_grid_; }
@@ -408,6 +416,27 @@ VTriSurfMesh<MESH>::insert_node_into_elem(VMesh::Elem::array_type& newelems,
   newnode = VMesh::Node::index_type(index);
 }
 
+template <class MESH>
+void
+VTriSurfMesh<MESH>::locate_many(const std::vector<Point>& points,
+                                std::vector<VMesh::Elem::index_type>& elems,
+                                std::vector<VMesh::coords_type>& coords) const
+{
+  this->mesh_->locate_elems(elems,coords,points);
+}
+
+template <class MESH>
+void
+VTriSurfMesh<MESH>::get_interpolate_weights_many(const std::vector<Point>& points,
+                                                 VMesh::MultiElemInterpolate& ei,
+                                                 int basis_order) const
+{
+  std::vector<VMesh::Elem::index_type> elems;
+  std::vector<VMesh::coords_type> coords;
+  this->mesh_->locate_elems(elems,coords,points);
+  this->fill_interpolate_weights(elems,coords,ei,basis_order);
+}
+
 
 }// namespace SCIRun
 
@@ -52,6 +52,8 @@
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Legacy/Field/FieldIterator.h>
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
+#include <Core/Datatypes/Legacy/Field/MeshLocateMany.h>
+#include <Core/Datatypes/Legacy/Field/MeshTableBuilder.h>
 #include <Core/Datatypes/Legacy/Base/Types.h>
 
 #include <Core/Thread/Mutex.h>
@@ -1582,7 +1584,7 @@ protected:
               "Must call synchronize NODE_NEIGHBORS_E on TriSurfMesh first");
 
     // Get the table of faces that are connected to the two nodes
-    const std::vector<index_type>& faces  = node_neighbors_[idx];
+    const NodeNeighborTable::Range faces = node_neighbors_[idx];
     array.clear();
 
     typename ARRAY::value_type edge;
@@ -1710,7 +1712,7 @@ protected:
     array.clear();
 
     // Get all the neighboring elements
-    const std::vector<index_type>& faces  = node_neighbors_[idx];
+    const NodeNeighborTable::Range faces = node_neighbors_[idx];
     // Make a conservative estimate of the number of node neighbors
     array.reserve(2*faces.size());
 
@@ -1964,6 +1966,26 @@ protected:
     return (false);
   }
 
+  /// Batched version of locate_elem for mapping large sets of points. The
+  /// queries are spread over threads in search grid order, using the last
+  /// element found as the first guess for the next point; elems is set to
+  /// -1 for points outside the mesh.
+  template <class INDEX, class ARRAY>
+  void locate_elems(std::vector<INDEX> &elems, std::vector<ARRAY> &coords,
+                    const std::vector<Core::Geometry::Point> &points) const
+  {
+    const bool linear = (basis_.polynomial_order() <= 1);
+    const SearchGridT<index_type>* grid =
+      (linear && (synchronized_ & Mesh::ELEM_LOCATE_E)) ? elem_grid_.get() : nullptr;
+
+    locateElemsInSpatialOrder(grid, points, elems, coords,
+      [this, linear](INDEX &elem, ARRAY &c, const Core::Geometry::Point &p)
+      {
+        // elem_locate does not compute the local coordinates
+        return (locate_elem(elem, c, p) && (linear || get_coords(c, p, elem)));
+      });
+  }
+
 
 
   template <class INDEX>
@@ -2013,6 +2035,7 @@ protected:
   void compute_bounding_box();
 
   /// Used to recompute data for individual cells.
+  Core::Geometry::BBox elem_grid_bbox(typename Elem::index_type ci) const;
   void insert_elem_into_grid(typename Elem::index_type ci);
   void remove_elem_from_grid(typename Elem::index_type ci);
 
@@ -2033,7 +2056,7 @@ protected:
   std::vector<index_type>    faces_;               // Connectivity of this mesh
   std::vector<index_type>    edge_neighbors_;      // Neighbor connectivity
   std::vector<Core::Geometry::Vector>        normals_;             // normalized per node normal.
-  std::vector<std::vector<index_type> > node_neighbors_; // Node neighbor connectivity
+  NodeNeighborTable node_neighbors_; // Node neighbor connectivity
   std::vector<std::vector<index_type> > edge_on_node_; // Edges emanating from a node
 
   SharedPointer<SearchGridT<index_type> > node_grid_; // Lookup table for nodes
@@ -2109,7 +2132,7 @@ TriSurfMesh<Basis>::TriSurfMesh()
   : points_(0),
     faces_(0),
     edge_neighbors_(0),
-    node_neighbors_(0),
+    node_neighbors_(),
     synchronize_lock_("TriSurfMesh lock"),
     synchronize_cond_("TriSurfMesh condition variable"),
     synchronized_(Mesh::NODES_E | Mesh::FACES_E | Mesh::CELLS_E),
@@ -2133,7 +2156,7 @@ TriSurfMesh<Basis>::TriSurfMesh(const TriSurfMesh &copy)
     faces_(0),
     edge_neighbors_(0),
     normals_(0),
-    node_neighbors_(0),
+    node_neighbors_(),
     synchronize_lock_("TriSurfMesh lock"),
     synchronize_cond_("TriSurfMesh condition variable"),
     synchronized_(Mesh::NODES_E | Mesh::FACES_E | Mesh::CELLS_E),
@@ -3172,13 +3195,9 @@ template <class Basis>
 void
 TriSurfMesh<Basis>::compute_node_neighbors()
 {
-  node_neighbors_.clear();
-  node_neighbors_.resize(points_.size());
-  size_type nfaces = static_cast<size_type>(faces_.size());
-  for (index_type f = 0; f < nfaces; ++f)
-  {
-    node_neighbors_[faces_[f]].push_back(f/3);
-  }
+  node_neighbors_.build(points_.size(), faces_.size(),
+    [this](size_t f) { return faces_[f]; },
+    [](size_t f) { return static_cast<index_type>(f / 3); });
   synchronize_lock_.lock();
   synchronized_ |= Mesh::NODE_NEIGHBORS_E;
   synchronize_lock_.unlock();
@@ -3296,7 +3315,7 @@ TriSurfMesh<Basis>::add_find_point(const Core::Geometry::Point &p, double err)
   {
     synchronize_lock_.lock();
     points_.push_back(p);
-    node_neighbors_.push_back(std::vector<under_type>());
+    node_neighbors_.add_node();
     synchronize_lock_.unlock();
     return static_cast<typename Node::index_type>(points_.size() - 1);
   }
@@ -3586,18 +3605,26 @@ TriSurfMesh<Basis>::compute_edge_neighbors()
 
 
 template <class Basis>
-void
-TriSurfMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+Core::Geometry::BBox
+TriSurfMesh<Basis>::elem_grid_bbox(typename Elem::index_type ci) const
 {
-  /// @todo:  This can crash if you insert a new cell outside of the grid.
-  // Need to recompute grid at that point.
   const index_type idx = ci*3;
   Core::Geometry::BBox box;
   box.extend(points_[faces_[idx]]);
   box.extend(points_[faces_[idx+1]]);
   box.extend(points_[faces_[idx+2]]);
   box.extend(epsilon_);
-  elem_grid_->insert(ci, box);
+  return box;
+}
+
+
+template <class Basis>
+void
+TriSurfMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+{
+  /// @todo:  This can crash if you insert a new cell outside of the grid.
+  // Need to recompute grid at that point.
+  elem_grid_->insert(ci, elem_grid_bbox(ci));
 }
 
 
@@ -3605,13 +3632,7 @@ template <class Basis>
 void
 TriSurfMesh<Basis>::remove_elem_from_grid(typename Elem::index_type ci)
 {
-  const index_type idx = ci*3;
-  Core::Geometry::BBox box;
-  box.extend(points_[faces_[idx]]);
-  box.extend(points_[faces_[idx+1]]);
-  box.extend(points_[faces_[idx+2]]);
-  box.extend(epsilon_);
-  elem_grid_->remove(ci, box);
+  elem_grid_->remove(ci, elem_grid_bbox(ci));
 }
 
 
@@ -3655,13 +3676,8 @@ TriSurfMesh<Basis>::compute_elem_grid()
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
     elem_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Elem::iterator ci, cie;
-    begin(ci); end(cie);
-    while(ci != cie)
-    {
-      insert_elem_into_grid(*ci);
-      ++ci;
-    }
+    elem_grid_->insert_boxes(esz, [this](index_type ci)
+      { return elem_grid_bbox(typename Elem::index_type(ci)); });
   }
 
   synchronize_lock_.lock();
@@ -3692,14 +3708,8 @@ TriSurfMesh<Basis>::compute_node_grid()
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
     node_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Node::iterator ni, nie;
-    begin(ni); end(nie);
-
-    while(ni != nie)
-    {
-      insert_node_into_grid(*ni);
-      ++ni;
-    }
+    node_grid_->insert_points(static_cast<size_type>(points_.size()),
+      [this](index_type ni) { return points_[ni]; });
   }
 
   synchronize_lock_.lock();
@@ -459,6 +459,19 @@ public:
     vfdata_->minterpolate(val,ei, static_cast<typename ARRAY::value_type>(def_value));
   }
 
+  /// Same as minterpolate, but for points spread over the whole mesh: they
+  /// are located with get_interpolate_weights_many, which sorts and threads
+  /// the searches. Points outside the mesh get def_value.
+  template<class ARRAY, class DATA>
+  inline void minterpolate_many(ARRAY& val,
+                                const std::vector<Core::Geometry::Point>& points,
+                                DATA def_value,
+                                VMesh::MultiElemInterpolate& ei) const
+  {
+    vmesh_->get_interpolate_weights_many(points,ei,basis_order_);
+    vfdata_->minterpolate(val,ei, static_cast<typename ARRAY::value_type>(def_value));
+  }
+
   template<class T>
   inline bool interpolate(T& val,const  Core::Geometry::Point& point, T def_value = (static_cast<T>(0))) const
   {
@@ -544,6 +544,26 @@ VMesh::mlocate(std::vector<Elem::index_type> &, const std::vector<Point> &) cons
   ASSERTFAIL("VMesh interface: mlocate(std::vector<Elem::index_type>,Point) has not been implemented");
 }
 
+void
+VMesh::locate_many(const std::vector<Point>& points,
+                   std::vector<Elem::index_type>& elems,
+                   std::vector<coords_type>& coords) const
+{
+  elems.assign(points.size(), Elem::index_type(-1));
+  coords.resize(points.size());
+
+  Elem::index_type seed(-1);
+  for (size_t i=0; i<points.size(); i++)
+  {
+    Elem::index_type elem = seed;
+    if (locate(elem,coords[i],points[i]))
+    {
+      elems[i] = elem;
+      seed = elem;
+    }
+  }
+}
+
 
 bool
 VMesh::find_closest_node(double&, Point&, VMesh::Node::index_type&, const Point &) const
@@ -874,6 +894,23 @@ VMesh::get_interpolate_weights(const Point&, ElemInterpolate&, int) const
   ASSERTFAIL("VMesh interface: get_interpolate_weights has not yet been implemented");
 }
 
+void
+VMesh::get_interpolate_weights_many(const std::vector<Point>& points,
+                                    MultiElemInterpolate& ei,
+                                    int basis_order) const
+{
+  ei.resize(points.size());
+
+  index_type seed = -1;
+  for (size_t i=0; i<points.size(); i++)
+  {
+    ei[i].elem_index = seed;
+    ei[i].basis_order = basis_order;
+    get_interpolate_weights(points[i],ei[i],basis_order);
+    if (ei[i].elem_index >= 0) seed = ei[i].elem_index;
+  }
+}
+
 
 void
 VMesh::get_minterpolate_weights(const std::vector<coords_type>&,
@@ -502,6 +502,14 @@ public:
                                        ElemInterpolate& ei,
                                        int basis_order) const;
 
+  /// Batched version of get_interpolate_weights(p,ei,basis_order): ei[n]
+  /// holds the interpolation weights for points[n], with elem_index set to
+  /// -1 if the point is not inside the mesh. Unlike get_minterpolate_weights
+  /// the points do not need to be close together.
+  virtual void get_interpolate_weights_many(const std::vector<Core::Geometry::Point>& points,
+                                            MultiElemInterpolate& ei,
+                                            int basis_order) const;
+
   virtual void get_minterpolate_weights(const std::vector<Core::Geometry::Point>& p,
                                         MultiElemInterpolate& ei,
                                         int basis_order) const;
@@ -584,6 +592,15 @@ public:
   virtual void mlocate(std::vector<Elem::index_type> &i,
                        const std::vector<Core::Geometry::Point> &point) const;
 
+  /// Batched locate for mapping many points at once. elems[n] and coords[n]
+  /// receive the element containing points[n] and the local coordinates in
+  /// it, elems[n] is -1 if the point is not inside the mesh. The TetVol,
+  /// HexVol, TriSurf and LatVol meshes do this without a virtual call per
+  /// point, sort the queries spatially and spread them over threads.
+  virtual void locate_many(const std::vector<Core::Geometry::Point>& points,
+                           std::vector<Elem::index_type>& elems,
+                           std::vector<coords_type>& coords) const;
+
   /// Find elements that are inside or close to the bounding box. This function
   /// uses the underlying search structure to find candidates that are close.
   /// This functionality is general intended to speed up searching for elements
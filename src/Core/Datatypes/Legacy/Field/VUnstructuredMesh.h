@@ -30,6 +30,7 @@
 #define CORE_DATATYPES_VUNSTRUCTUREDMESH_H
 
 #include <Core/Datatypes/Legacy/Field/VMeshShared.h>
+#include <Core/Thread/Parallel.h>
 
 /// Include needed for Windows: declares SCISHARE
 #include <Core/Datatypes/Legacy/Field/share.h>
@@ -235,6 +236,14 @@ public:
                                   VMesh::Elem::array_type &i,
                                   const Core::Geometry::Point &point) const override;
 
+protected:
+  /// Fill out the interpolation weights for points that have already been
+  /// located with locate_many. Used by the meshes that implement a batched
+  /// locate; the weights are computed concurrently.
+  void fill_interpolate_weights(const std::vector<VMesh::Elem::index_type>& elems,
+                                const std::vector<VMesh::coords_type>& coords,
+                                VMesh::MultiElemInterpolate& ei,
+                                int basis_order) const;
 };
 
 
@@ -867,6 +876,30 @@ get_interpolate_weights(const VMesh::coords_type& coords,
   ASSERTFAIL("Interpolation of unknown order requested");
 }
 
+template <class MESH>
+void
+VUnstructuredMesh<MESH>::
+fill_interpolate_weights(const std::vector<VMesh::Elem::index_type>& elems,
+                         const std::vector<VMesh::coords_type>& coords,
+                         VMesh::MultiElemInterpolate& ei,
+                         int basis_order) const
+{
+  ei.resize(elems.size());
+  Core::Thread::Parallel::For(0, elems.size(), 1024, [&](size_t begin, size_t end)
+  {
+    for (size_t i=begin; i<end; i++)
+    {
+      if (elems[i] < 0)
+      {
+        ei[i].basis_order = basis_order;
+        ei[i].elem_index = -1;
+      }
+      else
+        VUnstructuredMesh<MESH>::get_interpolate_weights(coords[i],elems[i],ei[i],basis_order);
+    }
+  });
+}
+
 
 template <class MESH>
 void
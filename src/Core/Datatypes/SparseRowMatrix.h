@@ -55,54 +55,122 @@ namespace Datatypes {
     SparseRowMatrixGeneric(int nrows, int ncols) : EigenBase(nrows, ncols) {}
 
     ///Legacy construction compatibility. Useful for converting old code, but should be avoided in new code.
+    ///Well-formed CSR arrays are copied straight into the compressed storage; see setFromCompressed().
     SparseRowMatrixGeneric(int nrows, int ncols, const index_type* rowCounter, const index_type* columnCounter, size_t nnz) : EigenBase(nrows, ncols)
     {
+      setFromCompressed(rowCounter, columnCounter, nullptr, nnz);
+    }
+
+    SparseRowMatrixGeneric(int nrows, int ncols, const index_type* rowCounter, const index_type* columnCounter, const T* data, size_t nnz) : EigenBase(nrows, ncols)
+    {
+      setFromCompressed(rowCounter, columnCounter, data, nnz);
+    }
+
+    /// Copies CSR arrays into the compressed storage of this matrix without going through
+    /// triplets. Rows with unsorted columns are sorted in place; only rows with repeated
+    /// columns, which need their values summed, take the slower setFromTriplets path.
+    /// data may be null, in which case all values are zero.
+    void setFromCompressed(const index_type* rowCounter, const index_type* columnCounter, const T* data, size_t nnz)
+    {
+      const index_type nrows = this->rows();
       if (rowCounter[nrows] != static_cast<index_type>(nnz))
         THROW_INVALID_ARGUMENT("Invalid sparse row matrix array: row accumulator array does not match number of non-zero elements.");
-      std::vector<Triplet> triplets;
-      triplets.reserve(nnz);
 
-      int i = 0;
-      int j = 0;
-      while (i < nrows)
+      switch (checkCompressedRows(rowCounter, columnCounter, this->cols(), 0, nrows))
       {
-        while (j < rowCounter[i + 1])
+      case CompressedRowsInvalid:
+        THROW_INVALID_ARGUMENT("Invalid sparse row matrix array: column index out of bounds.");
+      case CompressedRowsMalformed:
+        // the triplet path reads every column entry, including ones no row range covers
+        if (std::any_of(columnCounter, columnCounter + nnz,
+          [this](index_type c) { return c < 0 || c >= this->cols(); }))
+          THROW_INVALID_ARGUMENT("Invalid sparse row matrix array: column index out of bounds.");
+        setFromCompressedTriplets(rowCounter, columnCounter, data, nnz);
+        return;
+      default:
+        break;
+      }
+
+      this->resizeNonZeros(nnz);
+      std::copy(rowCounter, rowCounter + nrows + 1, this->outerIndexPtr());
+      std::copy(columnCounter, columnCounter + nnz, this->innerIndexPtr());
+      if (data)
+        std::copy(data, data + nnz, this->valuePtr());
+      else
+        std::fill(this->valuePtr(), this->valuePtr() + nnz, T(0));
+
+      std::vector<std::pair<index_type, T>> row;
+      for (index_type i = 0; i < nrows; ++i)
+      {
+        const index_type begin = rowCounter[i], end = rowCounter[i + 1];
+        if (std::is_sorted(columnCounter + begin, columnCounter + end))
+          continue;
+
+        row.clear();
+        for (index_type j = begin; j < end; ++j)
+          row.emplace_back(this->innerIndexPtr()[j], this->valuePtr()[j]);
+        std::sort(row.begin(), row.end(), [](const std::pair<index_type, T>& a, const std::pair<index_type, T>& b) { return a.first < b.first; });
+        for (index_type j = begin; j < end; ++j)
         {
-          index_type column = columnCounter[j];
-          if (column >= ncols)
-            THROW_INVALID_ARGUMENT("Invalid sparse row matrix array: column index out of bounds.");
-          triplets.push_back(Triplet(i, columnCounter[j], 0));
-          j++;
+          this->innerIndexPtr()[j] = row[j - begin].first;
+          this->valuePtr()[j] = row[j - begin].second;
         }
-        i++;
       }
-      this->setFromTriplets(triplets.begin(), triplets.end());
     }
 
-    SparseRowMatrixGeneric(int nrows, int ncols, const index_type* rowCounter, const index_type* columnCounter, const T* data, size_t nnz) : EigenBase(nrows, ncols)
+    enum CompressedRowsCheck
     {
-      if (rowCounter[nrows] != static_cast<index_type>(nnz))
-        THROW_INVALID_ARGUMENT("Invalid sparse row matrix array: row accumulator array does not match number of non-zero elements.");
-      std::vector<Triplet> triplets;
-      triplets.reserve(nnz);
+      CompressedRowsSorted,   // valid, columns increasing in every row
+      CompressedRowsUnsorted, // valid, but some rows need sorting
+      CompressedRowsMalformed, // decreasing row offsets or repeated columns in a row
+      CompressedRowsInvalid   // column index out of bounds
+    };
 
-      int i = 0;
-      int j = 0;
-      while (i < nrows)
+    /// Checks rows [rowBegin, rowEnd) of CSR arrays. Disjoint row ranges can be checked in parallel.
+    /// Every row is bounds checked, so an out of bounds column is reported as invalid even if an
+    /// earlier row is already malformed.
+    static CompressedRowsCheck checkCompressedRows(const index_type* rowCounter, const index_type* columnCounter,
+      index_type ncols, index_type rowBegin, index_type rowEnd)
+    {
+      bool malformed = rowBegin == 0 && rowEnd > 0 && rowCounter[0] != 0;
+      bool sorted = true;
+      for (index_type i = rowBegin; i < rowEnd; ++i)
       {
-        while (j < rowCounter[i + 1])
+        const index_type begin = rowCounter[i], end = rowCounter[i + 1];
+        if (end < begin)
         {
-          index_type column = columnCounter[j];
-          if (column >= ncols)
-            THROW_INVALID_ARGUMENT("Invalid sparse row matrix array: column index out of bounds.");
-          triplets.push_back(Triplet(i, columnCounter[j], data[j]));
-          j++;
+          malformed = true;
+          continue;
+        }
+        bool rowSorted = true;
+        for (index_type j = begin; j < end; ++j)
+        {
+          if (columnCounter[j] < 0 || columnCounter[j] >= ncols)
+            return CompressedRowsInvalid;
+          if (j > begin && columnCounter[j] <= columnCounter[j - 1])
+            rowSorted = false;
+        }
+        if (!rowSorted)
+        {
+          std::vector<index_type> columns(columnCounter + begin, columnCounter + end);
+          std::sort(columns.begin(), columns.end());
+          if (std::adjacent_find(columns.begin(), columns.end()) != columns.end())
+            malformed = true;
+          sorted = false;
         }
-        i++;
       }
-      this->setFromTriplets(triplets.begin(), triplets.end());
-      this->reserve(nnz);
+      if (malformed)
+        return CompressedRowsMalformed;
+      return sorted ? CompressedRowsSorted : CompressedRowsUnsorted;
+    }
+
+    /// Allocates compressed storage for nnz entries. The caller then fills in get_rows(),
+    /// get_cols() and valuePtr() directly, for instance from several threads, with columns
+    /// sorted and unique within each row and get_rows()[nrows()] == nnz.
+    void allocateCompressed(size_t nnz)
+    {
       this->makeCompressed();
+      this->resizeNonZeros(nnz);
     }
 
     /// This constructor allows you to construct SparseRowMatrixGeneric from Eigen expressions
@@ -333,6 +401,26 @@ namespace Datatypes {
     {
       o << static_cast<const EigenBase&>(*this);
     }
+
+    // Original construction path, which sums repeated entries.
+    void setFromCompressedTriplets(const index_type* rowCounter, const index_type* columnCounter, const T* data, size_t nnz)
+    {
+      std::vector<Triplet> triplets;
+      triplets.reserve(nnz);
+
+      const index_type nrows = this->rows();
+      index_type j = 0;
+      for (index_type i = 0; i < nrows; ++i)
+      {
+        while (j < rowCounter[i + 1])
+        {
+          triplets.push_back(Triplet(i, columnCounter[j], data ? data[j] : T(0)));
+          j++;
+        }
+      }
+      this->setFromTriplets(triplets.begin(), triplets.end());
+      this->makeCompressed();
+    }
   };
 
   template <typename T>
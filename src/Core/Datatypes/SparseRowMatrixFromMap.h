@@ -97,40 +97,71 @@ namespace SCIRun
           if (rows < static_cast<size_type>(sparse.nrows()) || cols < static_cast<size_type>(sparse.ncols()))
             THROW_INVALID_ARGUMENT("new matrix needs to be at least the size of old matrix");
 
-          const size_type nnz = get_nnz(additionalValues) + sparse.nonZeros();
+          if (!additionalValues.empty() && (additionalValues.rbegin()->first >= rows))
+            THROW_INVALID_ARGUMENT("additional values lie outside the new matrix");
 
-          using Triplet = Eigen::Triplet<T>;
-          std::vector<Triplet> tripletList;
-          tripletList.reserve(nnz);
+          // Both the rows of the sparse matrix and the additional rows are sorted by column,
+          // so each row of the result is a merge of the two, where additional values replace
+          // existing entries. The first pass counts the entries, the second one fills them in.
+          auto mat(makeShared<SparseRowMatrixGeneric<T>>(static_cast<int>(rows), static_cast<int>(cols)));
+          auto outRows = mat->get_rows();
+          index_type* outCols = nullptr;
+          T* outValues = nullptr;
 
-          for (int k = 0; k < sparse.outerSize(); ++k)
+          for (int pass = 0; pass < 2; ++pass)
           {
-            for (typename SparseRowMatrixGeneric<T>::InnerIterator it(sparse, k); it; ++it)
+            index_type nnz = 0;
+            auto extra = additionalValues.begin();
+            for (index_type r = 0; r < rows; ++r)
             {
-              auto row = additionalValues.find(it.row());
-              if (row != additionalValues.end())
+              if (pass == 0)
+                outRows[r] = nnz;
+
+              const Row* added = nullptr;
+              if (extra != additionalValues.end() && extra->first == r)
+                added = &(extra++)->second;
+              if (added && !added->empty() && added->rbegin()->first >= cols)
+                THROW_INVALID_ARGUMENT("additional values lie outside the new matrix");
+
+              auto addPos = added ? added->begin() : typename Row::const_iterator();
+              auto append = [&](index_type col, T value)
+              {
+                if (pass == 1)
+                {
+                  outCols[nnz] = col;
+                  outValues[nnz] = value;
+                }
+                ++nnz;
+              };
+
+              if (r < sparse.outerSize())
               {
-                auto col = row->second.find(it.col());
-                if (col == row->second.end())
+                for (typename SparseRowMatrixGeneric<T>::InnerIterator it(sparse, r); it; ++it)
                 {
-                  tripletList.emplace_back(it.row(), it.col(), it.value());
+                  for (; added && addPos != added->end() && addPos->first < it.col(); ++addPos)
+                    append(addPos->first, addPos->second);
+
+                  if (added && addPos != added->end() && addPos->first == it.col())
+                  {
+                    append(addPos->first, addPos->second);
+                    ++addPos;
+                  }
+                  else
+                    append(it.col(), it.value());
                 }
               }
-              else
-                tripletList.emplace_back(it.row(), it.col(), it.value());
+              for (; added && addPos != added->end(); ++addPos)
+                append(addPos->first, addPos->second);
             }
-          }
 
-          for (auto row = additionalValues.begin(); row != additionalValues.end(); ++row)
-          {
-            auto rowIndex = static_cast<typename SparseRowMatrixGeneric<T>::StorageIndex>(row->first);
-            for (auto colVal = row->second.begin(); colVal != row->second.end(); ++colVal)
+            if (pass == 0)
             {
-              tripletList.emplace_back(rowIndex, static_cast<typename SparseRowMatrixGeneric<T>::StorageIndex>(colVal->first), colVal->second);
+              outRows[rows] = nnz;
+              mat->allocateCompressed(nnz);
+              outCols = mat->get_cols();
+              outValues = mat->valuePtr();
             }
           }
-          auto mat(makeShared<SparseRowMatrixGeneric<T>>(static_cast<int>(rows), static_cast<int>(cols)));
-          mat->setFromTriplets(tripletList.begin(), tripletList.end());
 
           return mat;
         }
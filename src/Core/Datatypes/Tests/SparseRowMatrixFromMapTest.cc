@@ -231,6 +231,45 @@ TEST(SparseMatrixFromMapTest, CanExtendSparseMatrixWithAdditionalValuesWithOverl
   EXPECT_MATRIX_EQ(*actual, expected);
 }
 
+TEST(SparseMatrixFromMapTest, ExtendedSparseMatrixKeepsStructureOfOriginal)
+{
+  SparseRowMatrixFromMap::Values data;
+  data[0][0] = 1;
+  data[0][2] = 0;
+  data[1][1] = -1;
+  data[2][0] = 4;
+  data[2][2] = 5;
+  auto sparseFromMap = SparseRowMatrixFromMap::make(3, 3, data);
+
+  SparseRowMatrixFromMap::Values additionalData;
+  additionalData[0][1] = 7;
+  additionalData[2][3] = -3;
+  additionalData[3][2] = -3;
+  additionalData[2][2] = 6;
+
+  auto largerSparse = SparseRowMatrixFromMap::appendToSparseMatrix(4, 4, *sparseFromMap, additionalData);
+
+  ASSERT_TRUE(largerSparse->isCompressed());
+  // explicit zero of the original is kept, the overlapping value is only stored once
+  EXPECT_EQ(8, largerSparse->nonZeros());
+
+  const index_type expectedRows[] = { 0, 3, 4, 7, 8 };
+  const index_type expectedCols[] = { 0, 1, 2, 1, 0, 2, 3, 2 };
+  for (int i = 0; i < 5; ++i)
+    EXPECT_EQ(expectedRows[i], largerSparse->get_rows()[i]);
+  for (int i = 0; i < 8; ++i)
+    EXPECT_EQ(expectedCols[i], largerSparse->get_cols()[i]);
+
+  DenseMatrix expected = MAKE_DENSE_MATRIX(
+    (1,7,0,0)
+    (0,-1,0,0)
+    (4,0,6,-3)
+    (0,0,-3,0));
+
+  DenseMatrixHandle actual = makeDense(*largerSparse);
+  EXPECT_MATRIX_EQ(*actual, expected);
+}
+
 //bad test/code: uses addition of different-sized sparse matrices. Crashes on Mac, but only Win32+Debug. Disabling for now, I should just delete the function.
 TEST(SparseMatrixFromMapTest, DISABLED_CanExtendSparseMatrixWithAdditionalValuesWithOverlapSumming)
 {
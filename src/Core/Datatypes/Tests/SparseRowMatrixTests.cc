@@ -650,6 +650,76 @@ TEST(SparseRowMatrixTest, TestLegacyConstructorWithValuesFixesBugWithBuildMappin
   EXPECT_MATRIX_EQ_TOLERANCE(expected, *convertMatrix::toDense(m), 1e-15);
 }
 
+TEST(SparseRowMatrixTest, TestLegacyConstructorCopiesSortedArraysDirectly)
+{
+  index_type rows[] = {0, 2, 3, 5};
+  index_type cols[] = {0, 2, 1, 0, 2};
+  double vals[] = {1, 2, 3, 4, 5};
+
+  SparseRowMatrix m(3, 3, rows, cols, vals, 5);
+  EXPECT_TRUE(m.isCompressed());
+  EXPECT_EQ(5, m.nonZeros());
+  EXPECT_TRUE(std::equal(rows, rows + 4, m.get_rows()));
+  EXPECT_TRUE(std::equal(cols, cols + 5, m.get_cols()));
+  EXPECT_TRUE(std::equal(vals, vals + 5, m.valuePtr()));
+}
+
+TEST(SparseRowMatrixTest, TestLegacyConstructorSumsRepeatedColumns)
+{
+  index_type rows[] = {0, 3, 4};
+  index_type cols[] = {1, 0, 1, 0};
+  double vals[] = {1, 2, 3, 4};
+
+  SparseRowMatrix m(2, 2, rows, cols, vals, 4);
+  EXPECT_EQ(3, m.nonZeros());
+  EXPECT_EQ(2, m.coeff(0, 0));
+  EXPECT_EQ(4, m.coeff(0, 1));
+  EXPECT_EQ(4, m.coeff(1, 0));
+}
+
+TEST(SparseRowMatrixTest, TestLegacyConstructorThrowsOnInvalidArrays)
+{
+  index_type rows[] = {0, 1, 2};
+  index_type cols[] = {0, 2};
+  double vals[] = {1, 2};
+
+  EXPECT_THROW(SparseRowMatrix(2, 2, rows, cols, vals, 2), SCIRun::Core::InvalidArgumentException);
+  EXPECT_THROW(SparseRowMatrix(2, 2, rows, cols, vals, 3), SCIRun::Core::InvalidArgumentException);
+}
+
+TEST(SparseRowMatrixTest, TestLegacyConstructorThrowsOnInvalidColumnAfterMalformedRow)
+{
+  // row 0 repeats a column, row 1 is out of bounds
+  index_type rows[] = {0, 2, 3};
+  index_type cols[] = {1, 1, 5};
+  double vals[] = {1, 2, 3};
+
+  EXPECT_EQ(SparseRowMatrix::CompressedRowsInvalid, SparseRowMatrix::checkCompressedRows(rows, cols, 2, 0, 2));
+  EXPECT_THROW(SparseRowMatrix(2, 2, rows, cols, vals, 3), SCIRun::Core::InvalidArgumentException);
+
+  // the first entry is outside of every row range, only the triplet fallback reads it
+  index_type offsetRows[] = {1, 1, 3};
+  index_type offsetCols[] = {5, 0, 1};
+  EXPECT_EQ(SparseRowMatrix::CompressedRowsMalformed, SparseRowMatrix::checkCompressedRows(offsetRows, offsetCols, 2, 0, 2));
+  EXPECT_THROW(SparseRowMatrix(2, 2, offsetRows, offsetCols, vals, 3), SCIRun::Core::InvalidArgumentException);
+}
+
+TEST(SparseRowMatrixTest, CanFillAllocatedCompressedStorage)
+{
+  SparseRowMatrix m(3, 3);
+  m.allocateCompressed(4);
+  index_type rows[] = {0, 1, 3, 4};
+  index_type cols[] = {0, 0, 2, 1};
+  std::copy(rows, rows + 4, m.get_rows());
+  std::copy(cols, cols + 4, m.get_cols());
+  std::fill(m.valuePtr(), m.valuePtr() + 4, 7.0);
+
+  EXPECT_EQ(SparseRowMatrix::CompressedRowsSorted, SparseRowMatrix::checkCompressedRows(m.get_rows(), m.get_cols(), 3, 0, 3));
+  EXPECT_EQ(4, m.nonZeros());
+  EXPECT_EQ(7, m.coeff(1, 2));
+  EXPECT_EQ(0, m.coeff(2, 2));
+}
+
 TEST(SparseRowMatrixTest, CopyBlock)
 {
   auto m = MAKE_SPARSE_MATRIX_HANDLE(
@@ -35,14 +35,21 @@
 #include <Core/GeometryPrimitives/BBox.h>
 #include <Core/GeometryPrimitives/Transform.h>
 #include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/Thread/Parallel.h>
 
 #include <algorithm>
+#include <atomic>
 #include <vector>
 
 #include <Core/GeometryPrimitives/share.h>
 
 namespace SCIRun {
 
+/// Uniform grid of bins over a bounding box. The bins are stored flattened:
+/// all values live in one array and every bin is a contiguous slice of it, so
+/// a lookup touches a single block of memory. Grids filled with insert_boxes
+/// or insert_points are packed without gaps; single inserts grow a bin by
+/// moving it to the end of the array.
 template<class INDEX>
 class SearchGridT
 {
@@ -150,12 +157,40 @@ class SearchGridT
         {
           for (index_type k = mink; k <= maxk; k++)
           {
-            bin_[linearize(i, j, k)].push_back(val);
+            push_back(linearize(i, j, k), val);
           }
         }
       }
     }
 
+    /// Inserts the values 0 to count-1 at once, where box_of(v) returns the
+    /// bounding box of value v. Bins are counted and filled in parallel and
+    /// end up listing their values in increasing order, exactly as inserting
+    /// them one by one would.
+    template <class BOXOF>
+    void insert_boxes(size_type count, const BOXOF &box_of)
+    {
+      bulk_insert(count, [this, &box_of](index_type v, index_type *range)
+      {
+        const Core::Geometry::BBox bbox = box_of(v);
+        range[0] = range[1] = range[2] = range[3] = range[4] = range[5] = 0;
+        locate(range[0], range[1], range[2], bbox.get_min());
+        locate(range[3], range[4], range[5], bbox.get_max());
+      });
+    }
+
+    /// Inserts the values 0 to count-1 at once, where point_of(v) returns the
+    /// location of value v.
+    template <class POINTOF>
+    void insert_points(size_type count, const POINTOF &point_of)
+    {
+      bulk_insert(count, [this, &point_of](index_type v, index_type *range)
+      {
+        unsafe_locate(range[0], range[1], range[2], point_of(v));
+        range[3] = range[0]; range[4] = range[1]; range[5] = range[2];
+      });
+    }
+
     void remove(INDEX val, const Core::Geometry::BBox &bbox)
     {
       index_type mini, minj, mink, maxi, maxj, maxk;
@@ -169,8 +204,7 @@ class SearchGridT
         {
           for (index_type k = mink; k <= maxk; k++)
           {
-            index_type q = linearize(i, j, k);
-            std::remove(bin_[q].begin(),bin_[q].end(),val);
+            erase(linearize(i, j, k), val);
           }
         }
       }
@@ -180,15 +214,14 @@ class SearchGridT
     {
       index_type i, j, k;
       unsafe_locate(i, j, k, point);
-      bin_[linearize(i, j, k)].push_back(val);
+      push_back(linearize(i, j, k), val);
     }
 
     void remove(INDEX val, const Core::Geometry::Point &point)
     {
       index_type i, j, k;
       unsafe_locate(i, j, k, point);
-      index_type q = linearize(i, j, k);
-      std::remove(bin_[q].begin(),bin_[q].end(),val);
+      erase(linearize(i, j, k), val);
     }
 
     inline bool lookup(iterator &begin, iterator &end, const Core::Geometry::Point &p)
@@ -197,8 +230,8 @@ class SearchGridT
       if (locate(i, j, k, p))
       {
         index_type q = linearize(i, j, k);
-        begin = bin_[q].begin();
-        end   = bin_[q].end();
+        begin = values_.begin() + bin_[q].offset;
+        end   = begin + bin_[q].size;
         return (true);
       }
       return (false);
@@ -208,8 +241,50 @@ class SearchGridT
                     size_type k)
     {
       index_type q = linearize(i, j, k);
-      begin = bin_[q].begin();
-      end   = bin_[q].end();
+      begin = values_.begin() + bin_[q].offset;
+      end   = begin + bin_[q].size;
+    }
+
+    /// Looks up a batch of points. visit(n, begin, end) is called once for
+    /// every point n with the values of the bin it falls in, or with
+    /// begin == end if it lies outside the grid. Points are visited bin by
+    /// bin, so queries landing in the same bin reuse its values while they
+    /// are in cache. visit may be called concurrently from several threads.
+    template <class VISIT>
+    void lookup_many(const std::vector<Core::Geometry::Point> &points,
+                     const VISIT &visit) const
+    {
+      const index_type outside = static_cast<index_type>(bin_.size());
+      std::vector<index_type> bin_of, order;
+      sort_by_bin(points, bin_of, order);
+
+      Core::Thread::Parallel::For(0, points.size(), 1024, [&](size_t begin, size_t end)
+      {
+        for (size_t m = begin; m < end; m++)
+        {
+          const index_type n = order[m];
+          const index_type q = bin_of[n];
+          if (q == outside)
+          {
+            visit(n, static_cast<const INDEX*>(nullptr), static_cast<const INDEX*>(nullptr));
+          }
+          else
+          {
+            const INDEX* first = values_.data() + bin_[q].offset;
+            visit(n, first, first + bin_[q].size);
+          }
+        }
+      });
+    }
+
+    /// Returns the indices of points ordered bin by bin, with the points
+    /// outside the grid last. Walking a batch of queries in this order keeps
+    /// consecutive queries close together in space.
+    void spatial_order(const std::vector<Core::Geometry::Point> &points,
+                       std::vector<index_type> &order) const
+    {
+      std::vector<index_type> bin_of;
+      sort_by_bin(points, bin_of, order);
     }
 
 
@@ -241,6 +316,122 @@ class SearchGridT
     index_type linearize(index_type i, index_type j, index_type k) const
       { return (((i * nj_) + j) * nk_ + k); }
 
+    // Computes the bin of every point (bin_.size() if outside the grid) and
+    // a counting sort of the points by that bin.
+    void sort_by_bin(const std::vector<Core::Geometry::Point> &points,
+                     std::vector<index_type> &bin_of,
+                     std::vector<index_type> &order) const
+    {
+      const size_t num_points = points.size();
+      const index_type outside = static_cast<index_type>(bin_.size());
+
+      bin_of.resize(num_points);
+      Core::Thread::Parallel::For(0, num_points, 4096, [&](size_t begin, size_t end)
+      {
+        for (size_t n = begin; n < end; n++)
+        {
+          index_type i, j, k;
+          bin_of[n] = locate(i, j, k, points[n]) ? linearize(i, j, k) : outside;
+        }
+      });
+
+      std::vector<index_type> start(bin_.size() + 2, 0);
+      for (size_t n = 0; n < num_points; n++) start[bin_of[n] + 1]++;
+      for (size_t q = 1; q < start.size(); q++) start[q] += start[q - 1];
+      order.resize(num_points);
+      for (size_t n = 0; n < num_points; n++) order[start[bin_of[n]]++] = n;
+    }
+
+    void push_back(index_type q, INDEX val)
+    {
+      Bin &b = bin_[q];
+      if (b.size == b.capacity)
+      {
+        // Move the bin to the end of the value array with room to grow.
+        const index_type capacity = std::max<index_type>(4, 2 * b.capacity);
+        const index_type offset = static_cast<index_type>(values_.size());
+        values_.resize(values_.size() + capacity);
+        std::copy(values_.begin() + b.offset, values_.begin() + b.offset + b.size,
+                  values_.begin() + offset);
+        b.offset = offset;
+        b.capacity = capacity;
+      }
+      values_[b.offset + b.size++] = val;
+    }
+
+    void erase(index_type q, INDEX val)
+    {
+      Bin &b = bin_[q];
+      iterator begin = values_.begin() + b.offset;
+      b.size = static_cast<index_type>(std::remove(begin, begin + b.size, val) - begin);
+    }
+
+    /// range_of(v, range) stores the inclusive bin range {mini, minj, mink,
+    /// maxi, maxj, maxk} that value v covers.
+    template <class RANGEOF>
+    void bulk_insert(size_type count, const RANGEOF &range_of)
+    {
+      using Core::Thread::Parallel;
+      const size_t num_values = static_cast<size_t>(count);
+
+      if (!values_.empty())
+      {
+        index_type r[6];
+        for (size_t v = 0; v < num_values; v++)
+        {
+          range_of(static_cast<index_type>(v), r);
+          for (index_type i = r[0]; i <= r[3]; i++)
+            for (index_type j = r[1]; j <= r[4]; j++)
+              for (index_type k = r[2]; k <= r[5]; k++)
+                push_back(linearize(i, j, k), static_cast<INDEX>(v));
+        }
+        return;
+      }
+
+      std::vector<std::atomic<index_type> > cursor(bin_.size());
+      for (auto &c : cursor) c.store(0, std::memory_order_relaxed);
+
+      auto for_each_bin = [&](const auto &f)
+      {
+        Parallel::For(0, num_values, 4096, [&](size_t begin, size_t end)
+        {
+          index_type r[6];
+          for (size_t v = begin; v < end; v++)
+          {
+            range_of(static_cast<index_type>(v), r);
+            for (index_type i = r[0]; i <= r[3]; i++)
+              for (index_type j = r[1]; j <= r[4]; j++)
+                for (index_type k = r[2]; k <= r[5]; k++)
+                  f(linearize(i, j, k), static_cast<index_type>(v));
+          }
+        });
+      };
+
+      for_each_bin([&](index_type q, index_type)
+        { cursor[q].fetch_add(1, std::memory_order_relaxed); });
+
+      index_type offset = 0;
+      for (size_t q = 0; q < bin_.size(); q++)
+      {
+        const index_type size = cursor[q].load(std::memory_order_relaxed);
+        bin_[q].offset = offset;
+        bin_[q].size = bin_[q].capacity = size;
+        cursor[q].store(offset, std::memory_order_relaxed);
+        offset += size;
+      }
+
+      values_.resize(offset);
+      for_each_bin([&](index_type q, index_type v)
+        { values_[cursor[q].fetch_add(1, std::memory_order_relaxed)] = static_cast<INDEX>(v); });
+
+      Parallel::For(0, bin_.size(), 1024, [&](size_t begin, size_t end)
+      {
+        for (size_t q = begin; q < end; q++)
+          std::sort(values_.begin() + bin_[q].offset,
+                    values_.begin() + bin_[q].offset + bin_[q].size);
+      });
+    }
+
 
   private:
     /// Size of the search grid
@@ -248,8 +439,18 @@ class SearchGridT
     /// Transformation to unitary coordinate system
     Core::Geometry::Transform transform_;
 
+    /// A bin is the slice [offset, offset + size) of values_, with room
+    /// for capacity values before it has to move.
+    struct Bin
+    {
+      index_type offset = 0;
+      index_type size = 0;
+      index_type capacity = 0;
+    };
+
     /// Where to store the lookup table
-    std::vector<std::vector<INDEX> > bin_;
+    std::vector<Bin> bin_;
+    std::vector<INDEX> values_;
 };
 
 
@@ -0,0 +1,114 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <Core/GeometryPrimitives/SearchGridT.h>
+#include <mutex>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+
+namespace
+{
+  const int numBoxes = 20000;
+
+  // Deterministic pseudo-random boxes, safe to generate from any thread.
+  BBox randomBox(index_type v)
+  {
+    unsigned long long r = static_cast<unsigned long long>(v) * 6364136223846793005ULL + 1442695040888963407ULL;
+    auto next = [&r](int range) { r = r * 6364136223846793005ULL + 1442695040888963407ULL; return static_cast<double>((r >> 33) % range); };
+    Point p(next(100), next(100), next(100));
+    BBox box;
+    box.extend(p);
+    box.extend(p + Vector(next(7), next(7), next(7)));
+    return box;
+  }
+
+  std::vector<index_type> bin(SearchGridT<index_type>& grid, size_type i, size_type j, size_type k)
+  {
+    SearchGridT<index_type>::iterator begin, end;
+    grid.lookup_ijk(begin, end, i, j, k);
+    return std::vector<index_type>(begin, end);
+  }
+}
+
+TEST(SearchGridTTests, InsertBoxesMatchesSingleInserts)
+{
+  SearchGridT<index_type> single(9, 8, 7, Point(0, 0, 0), Point(110, 110, 110));
+  SearchGridT<index_type> packed(9, 8, 7, Point(0, 0, 0), Point(110, 110, 110));
+
+  for (index_type v = 0; v < numBoxes; ++v)
+    single.insert(v, randomBox(v));
+  packed.insert_boxes(numBoxes, randomBox);
+
+  for (size_type i = 0; i < 9; ++i)
+    for (size_type j = 0; j < 8; ++j)
+      for (size_type k = 0; k < 7; ++k)
+        EXPECT_EQ(bin(single, i, j, k), bin(packed, i, j, k));
+}
+
+TEST(SearchGridTTests, PackedBinsGrowAndShrink)
+{
+  SearchGridT<index_type> grid(2, 2, 2, Point(0, 0, 0), Point(2, 2, 2));
+  grid.insert_points(8, [](index_type v) { return Point(v % 2 + 0.5, (v / 2) % 2 + 0.5, v / 4 + 0.5); });
+
+  EXPECT_EQ(std::vector<index_type>{ 3 }, bin(grid, 1, 1, 0));
+  for (index_type v = 10; v < 20; ++v)
+    grid.insert(v, Point(1.5, 1.5, 0.5));
+  grid.remove(3, Point(1.5, 1.5, 0.5));
+  grid.remove(12, Point(1.5, 1.5, 0.5));
+
+  EXPECT_EQ((std::vector<index_type>{ 10, 11, 13, 14, 15, 16, 17, 18, 19 }), bin(grid, 1, 1, 0));
+  EXPECT_EQ(std::vector<index_type>{ 2 }, bin(grid, 0, 1, 0));
+  EXPECT_EQ(std::vector<index_type>{ 7 }, bin(grid, 1, 1, 1));
+}
+
+TEST(SearchGridTTests, LookupManyVisitsEveryPointWithItsBin)
+{
+  SearchGridT<index_type> grid(9, 8, 7, Point(0, 0, 0), Point(110, 110, 110));
+  grid.insert_boxes(numBoxes, randomBox);
+
+  std::vector<Point> points;
+  for (int n = 0; n < 5000; ++n)
+    points.push_back(Point((n * 37) % 130 - 10, (n * 11) % 115, (n * 7) % 112));
+
+  std::vector<int> visits(points.size(), 0);
+  std::mutex lock;
+  grid.lookup_many(points, [&](index_type n, const index_type* begin, const index_type* end)
+  {
+    SearchGridT<index_type>::iterator b, e;
+    const bool inside = grid.lookup(b, e, points[n]);
+    std::lock_guard<std::mutex> guard(lock);
+    ++visits[n];
+    EXPECT_EQ(inside ? std::vector<index_type>(b, e) : std::vector<index_type>(),
+      std::vector<index_type>(begin, end));
+  });
+
+  EXPECT_EQ(std::vector<int>(points.size(), 1), visits);
+}
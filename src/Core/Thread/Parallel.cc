@@ -27,7 +27,10 @@
 
 
 #include <Core/Thread/Parallel.h>
+#include <Core/Thread/WorkStealingPool.h>
 #include <Core/Logging/Log.h>
+#include <algorithm>
+#include <atomic>
 #include <vector>
 #include <iostream>
 
@@ -36,22 +39,40 @@ using namespace SCIRun::Core::Logging;
 
 void Parallel::RunTasks(IndexedTask task, int numProcs)
 {
-  ThreadGroup threads;
+  if (numProcs <= 0)
+    return;
 
-  for (unsigned int i = 0; i < capByUserCoreCount(numProcs); ++i)
+  WorkStealingPool::instance().runConcurrently(task, static_cast<int>(capByUserCoreCount(numProcs)));
+}
+
+void Parallel::For(size_t begin, size_t end, size_t grain, const RangeTask& task)
+{
+  if (end <= begin)
+    return;
+
+  grain = std::max<size_t>(grain, 1);
+  const size_t numChunks = (end - begin + grain - 1) / grain;
+  const size_t numRunners = std::min<size_t>(numChunks, NumCores());
+  if (numRunners <= 1)
   {
-    threads.create_thread(task, i);
+    task(begin, end);
+    return;
   }
 
-  //try
-  //{
-    threads.join_all();
-  //}
-  //catch (std::thread_interrupted&)
-  //{
-  //  threads.interrupt_all();
-  //  throw;
-  //}
+  std::atomic<size_t> nextChunk(0);
+  auto runner = [&]()
+  {
+    for (size_t chunk = nextChunk++; chunk < numChunks; chunk = nextChunk++)
+    {
+      const size_t chunkBegin = begin + chunk * grain;
+      task(chunkBegin, std::min(end, chunkBegin + grain));
+    }
+  };
+
+  TaskGroup group;
+  for (size_t i = 0; i < numRunners; ++i)
+    group.run(runner);
+  group.wait();
 }
 
 unsigned int Parallel::NumCores()
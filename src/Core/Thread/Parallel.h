@@ -33,6 +33,7 @@
 #include <thread>
 #include <vector>
 #include <functional>
+#include <cstddef>
 #include <Core/Thread/share.h>
 
 namespace SCIRun
@@ -45,7 +46,13 @@ namespace Thread
   {
   public:
     typedef std::function<void(int)> IndexedTask;
+    typedef std::function<void(size_t, size_t)> RangeTask;
+    /// Runs task(0..numProcs-1) concurrently on reusable pool threads; tasks may synchronize
+    /// with each other (e.g. through a Barrier).
     static void RunTasks(IndexedTask task, int numProcs);
+    /// Splits [begin, end) into chunks of at most grain indices and runs task(chunkBegin, chunkEnd)
+    /// on the work-stealing pool, using at most NumCores() threads. Safe to nest.
+    static void For(size_t begin, size_t end, size_t grain, const RangeTask& task);
     static unsigned int NumCores();
     static void SetMaximumCores(unsigned int max);
   private:
@@ -31,6 +31,9 @@
 #include <fstream>
 
 #include <Core/Thread/Parallel.h>
+#include <Core/Thread/Barrier.h>
+#include <Core/Thread/WorkStealingPool.h>
+#include <atomic>
 #include <boost/filesystem/path.hpp>
 #include <Testing/Utils/SCIRunUnitTests.h>
 
@@ -52,6 +55,62 @@ TEST(ParallelTests, CanDoubleNumberInParallel)
   EXPECT_EQ(expectedSum * 2, std::accumulate(nums.begin(), nums.end(), 0, std::plus<int>()));
 }
 
+TEST(ParallelTests, RunTasksReusesThreadsAcrossCalls)
+{
+  const int size = std::max(2u, Parallel::NumCores());
+  for (int rep = 0; rep < 50; ++rep)
+  {
+    Barrier barrier("RunTasksReuse", size);
+    std::atomic<int> count(0);
+    Parallel::RunTasks([&](int) { ++count; barrier.wait(); EXPECT_EQ(size, count.load()); }, size);
+    EXPECT_EQ(size, count.load());
+  }
+}
+
+TEST(ParallelTests, RunTasksRethrowsTaskException)
+{
+  EXPECT_THROW(Parallel::RunTasks([](int i) { if (i == 1) throw std::runtime_error("task"); }, 2), std::runtime_error);
+}
+
+TEST(ParallelTests, ParallelForCoversRangeExactlyOnce)
+{
+  const size_t size = 100003;
+  std::vector<int> hits(size, 0);
+  Parallel::For(0, size, 1000, [&](size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; ++i)
+      hits[i]++;
+  });
+  EXPECT_EQ(size, std::count(hits.begin(), hits.end(), 1));
+}
+
+TEST(ParallelTests, NestedParallelForCompletes)
+{
+  std::atomic<size_t> total(0);
+  Parallel::For(0, 64, 1, [&](size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; ++i)
+      Parallel::For(0, 1000, 10, [&](size_t b, size_t e) { total += e - b; });
+  });
+  EXPECT_EQ(64u * 1000u, total.load());
+}
+
+TEST(ParallelTests, TaskGroupWaitsForAllTasks)
+{
+  WorkStealingPool pool(3);
+  std::atomic<int> count(0);
+  {
+    TaskGroup group(pool);
+    for (int i = 0; i < 1000; ++i)
+      group.run([&]() { ++count; });
+    group.wait();
+    EXPECT_EQ(1000, count.load());
+  }
+  TaskGroup failing(pool);
+  failing.run([]() { throw std::runtime_error("task"); });
+  EXPECT_THROW(failing.wait(), std::runtime_error);
+}
+
 /// @todo
 #if 0
 TEST(ParallelTests, CanDoubleNumberWithParallelForEach)
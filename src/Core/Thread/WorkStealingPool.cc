@@ -0,0 +1,328 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Core/Thread/WorkStealingPool.h>
+#include <algorithm>
+
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  thread_local WorkStealingPool* currentPool = nullptr;
+  thread_local int currentWorker = -1;
+}
+
+struct WorkStealingPool::Latch
+{
+  explicit Latch(int count) : remaining(count) {}
+
+  void countDown()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--remaining == 0)
+      done.notify_all();
+  }
+
+  void setException(std::exception_ptr e)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!exception)
+      exception = e;
+  }
+
+  void wait()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this]() { return remaining == 0; });
+  }
+
+  std::mutex mutex;
+  std::condition_variable done;
+  int remaining;
+  std::exception_ptr exception;
+};
+
+struct WorkStealingPool::ParkedThread
+{
+  std::thread thread;
+  std::mutex mutex;
+  std::condition_variable ready;
+  Task job;
+  Latch* latch {nullptr};
+  bool stop {false};
+};
+
+WorkStealingPool::WorkStealingPool(unsigned int numWorkers)
+{
+  for (unsigned int i = 0; i < numWorkers; ++i)
+    queues_.emplace_back(new TaskQueue);
+  for (unsigned int i = 0; i < numWorkers; ++i)
+    workers_.emplace_back([this, i]() { workerLoop(static_cast<int>(i)); });
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+  stop_ = true;
+  notifyWaiters();
+  for (auto& w : workers_)
+  {
+    if (w.joinable())
+      w.join();
+  }
+
+  std::vector<std::unique_ptr<ParkedThread>> parked;
+  {
+    std::lock_guard<std::mutex> lock(parkedMutex_);
+    parked.swap(parkedThreads_);
+  }
+  for (auto& p : parked)
+  {
+    {
+      std::lock_guard<std::mutex> pl(p->mutex);
+      p->stop = true;
+    }
+    p->ready.notify_one();
+    if (p->thread.joinable())
+      p->thread.join();
+  }
+}
+
+WorkStealingPool& WorkStealingPool::instance()
+{
+  // Intentionally leaked: worker threads must outlive any static object that runs tasks.
+  static auto* pool = new WorkStealingPool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+  return *pool;
+}
+
+void WorkStealingPool::submit(Task task)
+{
+  auto& queue = (currentPool == this && currentWorker >= 0) ? *queues_[currentWorker] : globalQueue_;
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+    ++queued_;
+  }
+  {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(std::move(task));
+  }
+  wake_.notify_one();
+}
+
+bool WorkStealingPool::popTask(TaskQueue& queue, bool back, Task& task)
+{
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (queue.tasks.empty())
+    return false;
+  if (back)
+  {
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+  }
+  else
+  {
+    task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+  }
+  --queued_;
+  return true;
+}
+
+bool WorkStealingPool::runPendingTask()
+{
+  if (queued_ == 0)
+    return false;
+
+  Task task;
+  const int self = currentPool == this ? currentWorker : -1;
+  bool found = self >= 0 && popTask(*queues_[self], true, task);
+  if (!found)
+    found = popTask(globalQueue_, false, task);
+
+  const auto n = queues_.size();
+  const auto start = self >= 0 ? static_cast<size_t>(self) + 1 : 0;
+  for (size_t k = 0; !found && k < n; ++k)
+  {
+    const auto victim = (start + k) % n;
+    if (static_cast<int>(victim) != self)
+      found = popTask(*queues_[victim], false, task);
+  }
+
+  if (found)
+    task();
+  return found;
+}
+
+void WorkStealingPool::helpWhile(const std::function<bool()>& keepWaiting)
+{
+  while (keepWaiting())
+  {
+    if (runPendingTask())
+      continue;
+    std::unique_lock<std::mutex> lock(sleepMutex_);
+    wake_.wait(lock, [&]() { return queued_ > 0 || stop_ || !keepWaiting(); });
+    if (stop_)
+      return;
+  }
+}
+
+void WorkStealingPool::notifyWaiters()
+{
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+  }
+  wake_.notify_all();
+}
+
+void WorkStealingPool::workerLoop(int index)
+{
+  currentPool = this;
+  currentWorker = index;
+  helpWhile([this]() { return !stop_; });
+}
+
+WorkStealingPool::ParkedThread* WorkStealingPool::acquireParkedThread()
+{
+  std::lock_guard<std::mutex> lock(parkedMutex_);
+  if (!idleParked_.empty())
+  {
+    auto* parked = idleParked_.back();
+    idleParked_.pop_back();
+    return parked;
+  }
+  parkedThreads_.emplace_back(new ParkedThread);
+  auto* parked = parkedThreads_.back().get();
+  parked->thread = std::thread([this, parked]() { parkedLoop(*parked); });
+  return parked;
+}
+
+void WorkStealingPool::parkedLoop(ParkedThread& parked)
+{
+  for (;;)
+  {
+    Task job;
+    Latch* latch;
+    {
+      std::unique_lock<std::mutex> lock(parked.mutex);
+      parked.ready.wait(lock, [&parked]() { return parked.job || parked.stop; });
+      if (!parked.job)
+        return;
+      job = std::move(parked.job);
+      parked.job = nullptr;
+      latch = parked.latch;
+    }
+    try
+    {
+      job();
+    }
+    catch (...)
+    {
+      latch->setException(std::current_exception());
+    }
+    // Park before signalling so a caller looping on runConcurrently reuses this thread.
+    {
+      std::lock_guard<std::mutex> lock(parkedMutex_);
+      idleParked_.push_back(&parked);
+    }
+    latch->countDown();
+  }
+}
+
+void WorkStealingPool::runConcurrently(const IndexedTask& task, int numThreads)
+{
+  if (numThreads <= 0)
+    return;
+
+  Latch latch(numThreads - 1);
+  for (int i = 1; i < numThreads; ++i)
+  {
+    auto* parked = acquireParkedThread();
+    {
+      std::lock_guard<std::mutex> lock(parked->mutex);
+      parked->job = [&task, i]() { task(i); };
+      parked->latch = &latch;
+    }
+    parked->ready.notify_one();
+  }
+
+  try
+  {
+    task(0);
+  }
+  catch (...)
+  {
+    latch.setException(std::current_exception());
+  }
+  latch.wait();
+
+  if (latch.exception)
+    std::rethrow_exception(latch.exception);
+}
+
+TaskGroup::TaskGroup(WorkStealingPool& pool) : pool_(pool)
+{
+}
+
+TaskGroup::~TaskGroup()
+{
+  pool_.helpWhile([this]() { return pending_ > 0; });
+}
+
+void TaskGroup::run(WorkStealingPool::Task task)
+{
+  ++pending_;
+  pool_.submit([this, task = std::move(task)]()
+  {
+    try
+    {
+      task();
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(exceptionMutex_);
+      if (!exception_)
+        exception_ = std::current_exception();
+    }
+    // The group may be destroyed as soon as pending_ reaches zero.
+    auto& pool = pool_;
+    if (--pending_ == 0)
+      pool.notifyWaiters();
+  });
+}
+
+void TaskGroup::wait()
+{
+  pool_.helpWhile([this]() { return pending_ > 0; });
+
+  std::exception_ptr e;
+  {
+    std::lock_guard<std::mutex> lock(exceptionMutex_);
+    std::swap(e, exception_);
+  }
+  if (e)
+    std::rethrow_exception(e);
+}
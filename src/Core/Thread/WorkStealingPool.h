@@ -0,0 +1,126 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_THREAD_WORKSTEALINGPOOL_H
+#define CORE_THREAD_WORKSTEALINGPOOL_H
+
+#include <boost/noncopyable.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <Core/Thread/share.h>
+
+namespace SCIRun
+{
+namespace Core
+{
+namespace Thread
+{
+  /// Process-wide pool of persistent threads. Composable work (TaskGroup, Parallel::For) is
+  /// queued on per-worker deques and balanced by stealing; threads waiting on a group help
+  /// execute queued tasks, so nested parallelism never adds threads. Legacy barrier-style
+  /// tasks (Parallel::RunTasks) need every index running at once, so they are handed to a
+  /// separate cache of parked threads that is reused across calls instead of respawned.
+  class SCISHARE WorkStealingPool : public boost::noncopyable
+  {
+  public:
+    using Task = std::function<void()>;
+    using IndexedTask = std::function<void(int)>;
+
+    explicit WorkStealingPool(unsigned int numWorkers);
+    ~WorkStealingPool();
+
+    static WorkStealingPool& instance();
+
+    unsigned int numWorkers() const { return static_cast<unsigned int>(workers_.size()); }
+
+    /// Queue a task; from a worker thread it goes on that worker's own deque.
+    void submit(Task task);
+    /// Pop or steal one queued task and run it on the calling thread.
+    bool runPendingTask();
+    /// Run queued tasks on the calling thread until keepWaiting() is false, sleeping when idle.
+    void helpWhile(const std::function<bool()>& keepWaiting);
+    /// Wake threads sleeping in helpWhile so they re-check their condition.
+    void notifyWaiters();
+
+    /// Run task(0..numThreads-1) concurrently, task(0) on the calling thread. Blocks until
+    /// all return and rethrows the first exception thrown by any of them.
+    void runConcurrently(const IndexedTask& task, int numThreads);
+
+  private:
+    struct TaskQueue
+    {
+      std::mutex mutex;
+      std::deque<Task> tasks;
+    };
+    struct Latch;
+    struct ParkedThread;
+
+    bool popTask(TaskQueue& queue, bool back, Task& task);
+    void workerLoop(int index);
+    ParkedThread* acquireParkedThread();
+    void parkedLoop(ParkedThread& parked);
+
+    std::vector<std::unique_ptr<TaskQueue>> queues_;
+    TaskQueue globalQueue_;
+    std::vector<std::thread> workers_;
+    std::atomic<size_t> queued_ {0};
+    std::atomic<bool> stop_ {false};
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+
+    std::mutex parkedMutex_;
+    std::vector<std::unique_ptr<ParkedThread>> parkedThreads_;
+    std::vector<ParkedThread*> idleParked_;
+  };
+
+  /// Set of tasks run on a WorkStealingPool. wait() helps run queued work and rethrows the
+  /// first exception thrown by a task of this group.
+  class SCISHARE TaskGroup : public boost::noncopyable
+  {
+  public:
+    explicit TaskGroup(WorkStealingPool& pool = WorkStealingPool::instance());
+    ~TaskGroup();
+    void run(WorkStealingPool::Task task);
+    void wait();
+  private:
+    WorkStealingPool& pool_;
+    std::atomic<size_t> pending_ {0};
+    std::mutex exceptionMutex_;
+    std::exception_ptr exception_;
+  };
+
+}}}
+
+#endif
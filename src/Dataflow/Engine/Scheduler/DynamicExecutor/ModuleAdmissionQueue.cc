@@ -26,39 +26,33 @@
 */
 
 
-#ifndef ENGINE_SCHEDULER_DYNAMICEXECUTOR_WORKUNITEXECUTOR_H
-#define ENGINE_SCHEDULER_DYNAMICEXECUTOR_WORKUNITEXECUTOR_H
-
-#include <Dataflow/Engine/Scheduler/DynamicExecutor/WorkUnitProducerInterface.h>
-#include <Dataflow/Network/NetworkInterface.h>
-#include <Dataflow/Engine/Scheduler/share.h>
-
-namespace SCIRun {
-  namespace Dataflow {
-    namespace Engine {
-      namespace DynamicExecutor {
-
-        struct SCISHARE ModuleExecutor
-        {
-          ModuleExecutor(Networks::ModuleHandle mod, const Networks::ExecutableLookup* lookup, ProducerInterfacePtr producer) :
-            module_(mod), lookup_(lookup), producer_(producer)
-          {
-          }
-          void run() const
-          {
-            auto* exec = lookup_->lookupExecutable(module_->id());
-            boost::signals2::scoped_connection s(exec->connectExecuteEnds([this](double, const Networks::ModuleId&) { producer_->enqueueReadyModules(); }));
-            exec->executeWithSignals();
-          }
-
-          Networks::ModuleHandle module_;
-          const Networks::ExecutableLookup* lookup_;
-          ProducerInterfacePtr producer_;
-        };
-
-
-      }}
-
-  }}
-
-#endif
+#include <Dataflow/Engine/Scheduler/DynamicExecutor/ModuleAdmissionQueue.h>
+#include <algorithm>
+
+using namespace SCIRun::Dataflow::Engine::DynamicExecutor;
+
+ModuleAdmissionQueue::ModuleAdmissionQueue(int slotCapacity) : capacity_(std::max(1, slotCapacity)), inUse_(0)
+{
+}
+
+void ModuleAdmissionQueue::push(int vertex, int slots)
+{
+  waiting_.push_back({ vertex, std::min(std::max(1, slots), capacity_) });
+}
+
+bool ModuleAdmissionQueue::tryAdmit(int& vertex, int& slots)
+{
+  if (waiting_.empty() || waiting_.front().slots > capacity_ - inUse_)
+    return false;
+
+  vertex = waiting_.front().vertex;
+  slots = waiting_.front().slots;
+  waiting_.pop_front();
+  inUse_ += slots;
+  return true;
+}
+
+void ModuleAdmissionQueue::release(int slots)
+{
+  inUse_ -= slots;
+}
@@ -0,0 +1,75 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef ENGINE_SCHEDULER_DYNAMICEXECUTOR_MODULEADMISSIONQUEUE_H
+#define ENGINE_SCHEDULER_DYNAMICEXECUTOR_MODULEADMISSIONQUEUE_H
+
+#include <boost/noncopyable.hpp>
+#include <deque>
+#include <Dataflow/Engine/Scheduler/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Engine {
+namespace DynamicExecutor {
+
+  /// Ready modules waiting for execution slots. Each module claims a number of slots (one for
+  /// light modules, all of them for internally parallel ones) so the threads started by running
+  /// modules stay near the slot capacity. Modules are admitted in ready order; a module that
+  /// does not fit blocks those behind it so wide modules are not starved by light ones.
+  /// Not synchronized: the executor serializes calls under its own lock.
+  class SCISHARE ModuleAdmissionQueue : boost::noncopyable
+  {
+  public:
+    explicit ModuleAdmissionQueue(int slotCapacity);
+
+    int slotCapacity() const { return capacity_; }
+    int slotsInUse() const { return inUse_; }
+    bool empty() const { return waiting_.empty(); }
+
+    /// Queues a ready module; slots are clamped to [1, capacity].
+    void push(int vertex, int slots);
+    /// Claims slots for the next admissible module. Returns false if none fits right now.
+    bool tryAdmit(int& vertex, int& slots);
+    /// Returns the slots claimed by a finished module.
+    void release(int slots);
+
+  private:
+    struct ReadyModule
+    {
+      int vertex;
+      int slots;
+    };
+    int capacity_;
+    int inUse_;
+    std::deque<ReadyModule> waiting_;
+  };
+
+}}}}
+
+#endif
@@ -0,0 +1,62 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Dataflow/Engine/Scheduler/DynamicExecutor/ModuleDependencyTracker.h>
+
+using namespace SCIRun::Dataflow::Engine::DynamicExecutor;
+using namespace SCIRun::Dataflow::Engine::NetworkGraph;
+
+ModuleDependencyTracker::ModuleDependencyTracker(int moduleCount, const EdgeVector& edges) :
+  successorStart_(moduleCount + 1, 0),
+  successors_(edges.size()),
+  remainingInputs_(moduleCount, 0),
+  completed_(0)
+{
+  for (const auto& edge : edges)
+  {
+    successorStart_[edge.first + 1]++;
+    remainingInputs_[edge.second]++;
+  }
+  for (int i = 0; i < moduleCount; ++i)
+    successorStart_[i + 1] += successorStart_[i];
+
+  auto fill = successorStart_;
+  for (const auto& edge : edges)
+    successors_[fill[edge.first]++] = edge.second;
+}
+
+std::vector<int> ModuleDependencyTracker::initiallyReady() const
+{
+  std::vector<int> ready;
+  for (int i = 0; i < moduleCount(); ++i)
+  {
+    if (remainingInputs_[i] == 0)
+      ready.push_back(i);
+  }
+  return ready;
+}
@@ -0,0 +1,76 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef ENGINE_SCHEDULER_DYNAMICEXECUTOR_MODULEDEPENDENCYTRACKER_H
+#define ENGINE_SCHEDULER_DYNAMICEXECUTOR_MODULEDEPENDENCYTRACKER_H
+
+#include <Dataflow/Engine/Scheduler/GraphNetworkAnalyzer.h>
+#include <Dataflow/Engine/Scheduler/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Engine {
+namespace DynamicExecutor {
+
+  /// Per-execution in-degree counters over the module graph. A module becomes ready when its
+  /// last upstream module completes, so the whole execution costs O(modules + connections).
+  /// Not synchronized: the executor serializes calls under its own lock.
+  class SCISHARE ModuleDependencyTracker : boost::noncopyable
+  {
+  public:
+    ModuleDependencyTracker(int moduleCount, const NetworkGraph::EdgeVector& edges);
+
+    int moduleCount() const { return static_cast<int>(remainingInputs_.size()); }
+    int completedCount() const { return completed_; }
+    bool allCompleted() const { return completed_ == moduleCount(); }
+
+    /// Modules with no upstream dependency in the graph.
+    std::vector<int> initiallyReady() const;
+    /// Marks a module finished and appends downstream modules that just became ready.
+    template <class Container>
+    void markCompleted(int vertex, Container& newlyReady)
+    {
+      ++completed_;
+      for (int e = successorStart_[vertex]; e < successorStart_[vertex + 1]; ++e)
+      {
+        const auto next = successors_[e];
+        if (--remainingInputs_[next] == 0)
+          newlyReady.push_back(next);
+      }
+    }
+
+  private:
+    std::vector<int> successorStart_;
+    std::vector<int> successors_;
+    std::vector<int> remainingInputs_;
+    int completed_;
+  };
+
+}}}}
+
+#endif
@@ -26,12 +26,13 @@
 */
 
 
-#include <Dataflow/Engine/Scheduler/DynamicExecutor/WorkQueue.h>
-#include <Dataflow/Engine/Scheduler/DynamicExecutor/WorkUnitConsumer.h>
-#include <Dataflow/Engine/Scheduler/DynamicExecutor/WorkUnitExecutor.h>
-#include <Dataflow/Engine/Scheduler/DynamicExecutor/WorkUnitProducer.h>
-
+#include <Dataflow/Engine/Scheduler/DynamicExecutor/ModuleAdmissionQueue.h>
+#include <Dataflow/Engine/Scheduler/DynamicExecutor/ModuleDependencyTracker.h>
 #include <Dataflow/Engine/Scheduler/DynamicMultithreadedNetworkExecutor.h>
+#include <Dataflow/Engine/Scheduler/GraphNetworkAnalyzer.h>
+#include <Dataflow/Network/NetworkInterface.h>
+#include <Core/Thread/ConditionVariable.h>
+#include <Core/Thread/Parallel.h>
 
 using namespace SCIRun::Dataflow::Engine;
 using namespace SCIRun::Dataflow::Networks;
@@ -41,33 +42,22 @@ using namespace SCIRun::Core::Logging;
 namespace SCIRun {
   namespace Dataflow {
     namespace Engine {
-      namespace DynamicExecutor
-      {
-        //Logger2 ModuleConsumer::log_ = spdlog::stdout_color_mt("consumer");
-        //Logger2 ModuleProducer::log_ = spdlog::stdout_color_mt("producer");
-        //Logger2 ModuleExecutor::log_ = spdlog::stdout_color_mt("executor");
-      }
 
-      /// @todo: templatize along with producer/consumer
-      class DynamicMultithreadedNetworkExecutorImpl : public WaitsForStartupInitialization//, boost::noncopyable
+      class DynamicMultithreadedNetworkExecutorImpl : public WaitsForStartupInitialization, boost::noncopyable
       {
       public:
         DynamicMultithreadedNetworkExecutorImpl(const ExecutionContext& context, const NetworkStateInterface* network,
-          Mutex* lock, size_t numModules, Mutex* executionLock, DynamicExecutor::ExecutionThreadGroupPtr threadGroup) :
-          executeThreads_(threadGroup),
+          Mutex* executionLock) :
           lookup_(context.lookup()),
           bounds_(&context.bounds()),
-          work_(new DynamicExecutor::ModuleWorkQueue(numModules)),
-          producer_(new DynamicExecutor::ModuleProducer(context.addAdditionalFilter(ModuleWaitingFilter::Instance()),
-            network, lock, work_, numModules)),
-            consumer_(new DynamicExecutor::ModuleConsumer(work_, lookup_, producer_, executeThreads_)),
+          filter_(context.addAdditionalFilter(ModuleWaitingFilter::Instance())),
           network_(network),
-          executionLock_(executionLock)
+          executionLock_(executionLock),
+          running_(0)
         {
         }
-        ~DynamicMultithreadedNetworkExecutorImpl() = default;
 
-        int run() const
+        int run()
         {
           Guard g(executionLock_->get());
 
@@ -75,40 +65,103 @@ namespace SCIRun {
 
           waitForStartupInit(*network_);
 
-          std::thread consume(std::ref(*consumer_));
-          std::thread produce(std::ref(*producer_));
-          consume.join();
-          produce.join();
-          executeThreads_->joinAll();
+          NetworkGraphAnalyzer analyzer(*network_, filter_, false);
+          const auto edges = analyzer.constructEdgeListFromNetwork();
+          const auto moduleCount = analyzer.moduleCount();
+          const int slotCapacity = std::max(2u, Parallel::NumCores());
+          for (int i = 0; i < moduleCount; ++i)
+          {
+            moduleIds_.push_back(analyzer.moduleAt(i));
+            const auto cost = network_->lookupModule(moduleIds_.back())->executionCost();
+            moduleSlots_.push_back(cost == ModuleExecutionCost::InternallyParallel ? slotCapacity : 1);
+          }
+
+          tracker_.reset(new DynamicExecutor::ModuleDependencyTracker(moduleCount, edges));
+          admission_.reset(new DynamicExecutor::ModuleAdmissionQueue(slotCapacity));
+          enqueue(tracker_->initiallyReady());
+
+          // Every module claims at least one slot, so more workers than slots would only idle.
+          const auto numWorkers = std::min(moduleCount, slotCapacity);
+          ThreadGroup workers;
+          for (int i = 0; i < numWorkers; ++i)
+            workers.create_thread([this]() { executeReadyModules(); });
+          workers.join_all();
+
+          if (!tracker_->allCompleted())
+            logCritical("Dynamic executor stopped with {} of {} modules executed; the network may contain a cycle.",
+              tracker_->completedCount(), moduleCount);
 
           return lookup_->errorCode();
         }
 
       private:
-        mutable DynamicExecutor::ExecutionThreadGroupPtr executeThreads_;
+        void executeReadyModules()
+        {
+          std::vector<int> newlyReady;
+          for (;;)
+          {
+            int vertex, slots;
+            {
+              UniqueLock lock(queueLock_);
+              while (!admission_->tryAdmit(vertex, slots))
+              {
+                if (isFinished())
+                  return;
+                moduleFinished_.wait(lock);
+              }
+              ++running_;
+            }
+
+            lookup_->lookupExecutable(moduleIds_[vertex])->executeWithSignals();
+
+            {
+              UniqueLock lock(queueLock_);
+              --running_;
+              admission_->release(slots);
+              newlyReady.clear();
+              tracker_->markCompleted(vertex, newlyReady);
+              enqueue(newlyReady);
+            }
+            moduleFinished_.notify_all();
+          }
+        }
+
+        void enqueue(const std::vector<int>& vertices)
+        {
+          for (auto v : vertices)
+            admission_->push(v, moduleSlots_[v]);
+        }
+
+        // Also true when nothing is running or waiting but modules remain, so workers cannot hang.
+        bool isFinished() const
+        {
+          return tracker_->allCompleted() || (running_ == 0 && admission_->empty());
+        }
+
         const ExecutableLookup* lookup_;
         const ExecutionBounds* bounds_;
-        DynamicExecutor::ModuleWorkQueuePtr work_;
-        DynamicExecutor::ModuleProducerPtr producer_;
-        DynamicExecutor::ModuleConsumerPtr consumer_;
+        ModuleFilter filter_;
         const NetworkStateInterface* network_;
         Mutex* executionLock_;
+
+        std::vector<ModuleId> moduleIds_;
+        std::vector<int> moduleSlots_;
+        std::unique_ptr<DynamicExecutor::ModuleDependencyTracker> tracker_;
+        std::unique_ptr<DynamicExecutor::ModuleAdmissionQueue> admission_;
+        int running_;
+        std::mutex queueLock_;
+        std::condition_variable moduleFinished_;
       };
 }}}
 
 DynamicMultithreadedNetworkExecutor::DynamicMultithreadedNetworkExecutor(const NetworkStateInterface& network) :
-  network_(network),
-  threadGroup_(new DynamicExecutor::ExecutionThreadGroup)
+  network_(network)
 {
 }
 
-std::future<int> DynamicMultithreadedNetworkExecutor::execute(const ExecutionContext& context, ParallelModuleExecutionOrder order, Mutex& executionLock)
+std::future<int> DynamicMultithreadedNetworkExecutor::execute(const ExecutionContext& context, ParallelModuleExecutionOrder, Mutex& executionLock)
 {
-  static Mutex lock("live-scheduler");
-
-  threadGroup_->clear();
-
-  auto runner = makeShared<DynamicMultithreadedNetworkExecutorImpl>(context, &network_, &lock, order.size(), &executionLock, threadGroup_);
+  auto runner = makeShared<DynamicMultithreadedNetworkExecutorImpl>(context, &network_, &executionLock);
   std::packaged_task<int()> task([runner] { return runner->run(); });
   auto value = task.get_future();
   std::thread t(std::move(task));
@@ -39,11 +39,11 @@ namespace SCIRun {
 namespace Dataflow {
   namespace Engine {
 
-    namespace DynamicExecutor
-    {
-      class ExecutionThreadGroup;
-    }
-
+  /// Runs each module as soon as all of its upstream modules have completed. Readiness is tracked
+  /// with per-module in-degree counters and ready modules are handed to a bounded set of worker
+  /// threads that block on a condition variable between modules. Admission is limited to
+  /// Parallel::NumCores() slots: light modules take one slot each, while modules declaring
+  /// ModuleExecutionCost::InternallyParallel take all of them and run alone.
   class SCISHARE DynamicMultithreadedNetworkExecutor : public NetworkExecutor<ParallelModuleExecutionOrder>
   {
   public:
@@ -51,7 +51,6 @@ namespace Dataflow {
     std::future<int> execute(const ExecutionContext& context, ParallelModuleExecutionOrder order, Core::Thread::Mutex& executionLock) override;
   private:
     const Networks::NetworkStateInterface& network_;
-    SharedPointer<DynamicExecutor::ExecutionThreadGroup> threadGroup_;
   };
 
 }}}
@@ -31,7 +31,7 @@
 
 #include <Dataflow/Network/NetworkInterface.h>
 #include <Dataflow/Engine/Scheduler/SchedulerInterfaces.h>
-#include <Dataflow/Engine/Scheduler/DynamicExecutor/WorkQueue.h>
+#include <boost/lockfree/spsc_queue.hpp>
 #include <boost/atomic.hpp>
 #include <Core/Thread/ConditionVariable.h>
 #include <Core/Thread/Interruptible.h>
@@ -111,7 +111,7 @@ namespace Engine {
     void startExecution();
     void enqueueContext(ExecutionContextHandle context);
     
-    typedef DynamicExecutor::WorkQueue<ExecutionContextHandle> ExecutionContextQueue;
+    typedef boost::lockfree::spsc_queue<ExecutionContextHandle> ExecutionContextQueue;
     ExecutionContextQueue contexts_;
     ThreadPtr executionLaunchThread_;
     
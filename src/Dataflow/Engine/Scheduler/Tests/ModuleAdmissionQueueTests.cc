@@ -0,0 +1,77 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+#include <Dataflow/Engine/Scheduler/DynamicExecutor/ModuleAdmissionQueue.h>
+
+using namespace SCIRun::Dataflow::Engine::DynamicExecutor;
+
+TEST(ModuleAdmissionQueueTests, LightModulesShareSlots)
+{
+  ModuleAdmissionQueue queue(2);
+  queue.push(0, 1);
+  queue.push(1, 1);
+  queue.push(2, 1);
+
+  int vertex, slots;
+  EXPECT_TRUE(queue.tryAdmit(vertex, slots));
+  EXPECT_EQ(0, vertex);
+  EXPECT_TRUE(queue.tryAdmit(vertex, slots));
+  EXPECT_EQ(1, vertex);
+  EXPECT_FALSE(queue.tryAdmit(vertex, slots));
+  EXPECT_EQ(2, queue.slotsInUse());
+
+  queue.release(1);
+  EXPECT_TRUE(queue.tryAdmit(vertex, slots));
+  EXPECT_EQ(2, vertex);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(ModuleAdmissionQueueTests, ParallelModuleRunsAloneAndIsNotStarved)
+{
+  ModuleAdmissionQueue queue(4);
+  queue.push(0, 1);
+  queue.push(1, 100);
+  queue.push(2, 1);
+
+  int vertex, slots;
+  EXPECT_TRUE(queue.tryAdmit(vertex, slots));
+  EXPECT_EQ(0, vertex);
+  // Module 1 needs the whole machine, so module 2 waits behind it.
+  EXPECT_FALSE(queue.tryAdmit(vertex, slots));
+
+  queue.release(1);
+  EXPECT_TRUE(queue.tryAdmit(vertex, slots));
+  EXPECT_EQ(1, vertex);
+  EXPECT_EQ(4, slots);
+  EXPECT_FALSE(queue.tryAdmit(vertex, slots));
+
+  queue.release(slots);
+  EXPECT_TRUE(queue.tryAdmit(vertex, slots));
+  EXPECT_EQ(2, vertex);
+}
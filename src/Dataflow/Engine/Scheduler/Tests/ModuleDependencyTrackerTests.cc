@@ -0,0 +1,81 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+#include <Dataflow/Engine/Scheduler/DynamicExecutor/ModuleDependencyTracker.h>
+#include <algorithm>
+
+using namespace SCIRun::Dataflow::Engine::DynamicExecutor;
+using namespace SCIRun::Dataflow::Engine::NetworkGraph;
+
+TEST(ModuleDependencyTrackerTests, DiamondReleasesJoinAfterBothBranches)
+{
+  // 0 -> 1, 0 -> 2, 1 -> 3, 2 -> 3
+  EdgeVector edges { {0, 1}, {0, 2}, {1, 3}, {2, 3} };
+  ModuleDependencyTracker tracker(4, edges);
+
+  EXPECT_EQ(std::vector<int>({0}), tracker.initiallyReady());
+
+  std::vector<int> ready;
+  tracker.markCompleted(0, ready);
+  std::sort(ready.begin(), ready.end());
+  EXPECT_EQ(std::vector<int>({1, 2}), ready);
+
+  ready.clear();
+  tracker.markCompleted(2, ready);
+  EXPECT_TRUE(ready.empty());
+  tracker.markCompleted(1, ready);
+  EXPECT_EQ(std::vector<int>({3}), ready);
+
+  EXPECT_FALSE(tracker.allCompleted());
+  ready.clear();
+  tracker.markCompleted(3, ready);
+  EXPECT_TRUE(ready.empty());
+  EXPECT_TRUE(tracker.allCompleted());
+}
+
+TEST(ModuleDependencyTrackerTests, DuplicateConnectionsCountOnce)
+{
+  EdgeVector edges { {0, 1}, {0, 1}, {2, 1} };
+  ModuleDependencyTracker tracker(3, edges);
+
+  EXPECT_EQ(std::vector<int>({0, 2}), tracker.initiallyReady());
+
+  std::vector<int> ready;
+  tracker.markCompleted(0, ready);
+  EXPECT_TRUE(ready.empty());
+  tracker.markCompleted(2, ready);
+  EXPECT_EQ(std::vector<int>({1}), ready);
+}
+
+TEST(ModuleDependencyTrackerTests, DisconnectedModulesAreAllReady)
+{
+  ModuleDependencyTracker tracker(3, {});
+  EXPECT_EQ(std::vector<int>({0, 1, 2}), tracker.initiallyReady());
+  EXPECT_EQ(0, tracker.completedCount());
+}
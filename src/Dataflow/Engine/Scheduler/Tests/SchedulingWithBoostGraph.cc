@@ -44,6 +44,7 @@
 #include <Dataflow/Engine/Scheduler/BoostGraphParallelScheduler.h>
 #include <Dataflow/Engine/Scheduler/BasicMultithreadedNetworkExecutor.h>
 #include <Dataflow/Engine/Scheduler/BasicParallelExecutionStrategy.h>
+#include <Dataflow/Engine/Scheduler/DynamicParallelExecutionStrategy.h>
 #include <Core/Algorithms/Factory/HardCodedAlgorithmFactory.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Logging/Log.h>
@@ -281,6 +282,25 @@ TEST_F(SchedulingWithBoostGraph, NetworkFromMatrixCalculatorMultiThreaded)
   EXPECT_EQ(186, reportOutput.get<5>());
 }
 
+TEST_F(SchedulingWithBoostGraph, NetworkFromMatrixCalculatorDynamicMultiThreaded)
+{
+  setupBasicNetwork();
+
+  DynamicParallelExecutionStrategy strategy;
+  ExecutionContext context(matrixMathNetwork, &matrixMathNetwork);
+  Mutex m("exec");
+  auto done = strategy.execute(context, m);
+  ASSERT_TRUE(done.valid());
+  done.wait();
+
+  auto reportOutput = transient_value_cast<ReportMatrixInfoAlgorithm::Outputs>(report->get_state()->getTransientValue("ReportedInfo"));
+  EXPECT_EQ(3, reportOutput.get<1>());
+  EXPECT_EQ(3, reportOutput.get<2>());
+  EXPECT_EQ(9, reportOutput.get<3>());
+  EXPECT_EQ(22, reportOutput.get<4>());
+  EXPECT_EQ(186, reportOutput.get<5>());
+}
+
 TEST_F(SchedulingWithBoostGraph, SerialNetworkOrder)
 {
   setupBasicNetwork();
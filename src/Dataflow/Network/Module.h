@@ -114,6 +114,7 @@ namespace Networks {
     std::string get_packagename() const;
     ModuleId id() const override;
     bool isDeprecated() const override { return false; }
+    ModuleExecutionCost executionCost() const override { return ModuleExecutionCost::Light; }
     std::string replacementModuleName() const override { return ""; }
     ModuleReexecutionStrategyHandle getReexecutionStrategy() const override final;
     void setReexecutionStrategy(ModuleReexecutionStrategyHandle caching) override final;
@@ -37,6 +37,14 @@ namespace SCIRun {
 namespace Dataflow {
 namespace Networks {
 
+  /// Scheduling hint for the dynamic executor: Light modules share execution slots, while
+  /// InternallyParallel modules (those running their own multithreaded algorithms) take all of them.
+  enum class ModuleExecutionCost
+  {
+    Light,
+    InternallyParallel
+  };
+
   class SCISHARE ModuleInfoProvider
   {
   public:
@@ -60,6 +68,7 @@ namespace Networks {
     virtual bool hasUI() const = 0;
     virtual const ModuleLookupInfo& info() const = 0;
     virtual bool hasDynamicPorts() const = 0;
+    virtual ModuleExecutionCost executionCost() const = 0;
 
     virtual std::string helpPageUrl() const = 0;
     virtual std::string newHelpPageUrl() const = 0;
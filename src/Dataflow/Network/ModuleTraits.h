@@ -83,6 +83,7 @@ namespace Modules
   #define CONVERTED_VERSION_OF_MODULE(modName) public: std::string legacyModuleName() const override { return #modName; }
   #define NEW_HELP_WEBPAGE_ONLY public: std::string helpPageUrl() const override { return newHelpPageUrl(); }
   #define DEPRECATED_MODULE_REPLACE_WITH(modName) public: bool isDeprecated() const override { return true; } std::string replacementModuleName() const override { return #modName; }
+  #define INTERNALLY_PARALLEL_MODULE public: Dataflow::Networks::ModuleExecutionCost executionCost() const override { return Dataflow::Networks::ModuleExecutionCost::InternallyParallel; }
   #define DISABLED_WITHOUT_ABOVE_COMPILE_FLAG public: bool isImplementationDisabled() const override { return true; }
 }
 }
@@ -67,6 +67,7 @@ namespace SCIRun {
           MOCK_CONST_METHOD0(hasUI, bool());
           MOCK_CONST_METHOD0(isDeprecated, bool());
           MOCK_CONST_METHOD0(hasDynamicPorts, bool());
+          MOCK_CONST_METHOD0(executionCost, ModuleExecutionCost());
           MOCK_CONST_METHOD0(metadata, const MetadataMap&());
           MOCK_CONST_METHOD0(helpPageUrl, std::string());
           MOCK_CONST_METHOD0(newHelpPageUrl, std::string());
@@ -61,6 +61,16 @@ void VarBuffer::writeBytes(const char* bytes, size_t numBytes)
   mSerializer->writeBytes(bytes, numBytes);
 }
 
+char* VarBuffer::reserveBytes(size_t numBytes)
+{
+  while (mSerializer->getOffset() + numBytes > mBufferSize)
+    resize();
+
+  size_t bufferOffset = mSerializer->getOffset();
+  mSerializer->setOffset(bufferOffset + numBytes);
+  return getBuffer() + bufferOffset;
+}
+
 void VarBuffer::writeNullTermString(const char* str)
 {
   size_t stringLength = std::strlen(str);
@@ -26,26 +26,29 @@
 */
 
 
-#ifndef ENGINE_SCHEDULER_DYNAMICEXECUTOR_WORKUNITPRODUCERINTERFACE_H
-#define ENGINE_SCHEDULER_DYNAMICEXECUTOR_WORKUNITPRODUCERINTERFACE_H
 
-#include <Dataflow/Engine/Scheduler/share.h>
+#ifndef INTERFACE_MODULES_SimulateForwardMagneticFieldDialog_H
+#define INTERFACE_MODULES_SimulateForwardMagneticFieldDialog_H
+
+#include "Interface/Modules/BrainStimulator/ui_SimulateForwardMagneticFieldDialog.h"
+#include <Interface/Modules/Base/ModuleDialogGeneric.h>
+#include <Interface/Modules/BrainStimulator/share.h>
 
 namespace SCIRun {
-  namespace Dataflow {
-    namespace Engine {
-      namespace DynamicExecutor {
-
-        class SCISHARE ProducerInterface
-        {
-        public:
-          virtual ~ProducerInterface() {}
-          virtual bool isDone() const = 0;
-          virtual void enqueueReadyModules() const = 0;
-        };
-
-        typedef SharedPointer<ProducerInterface> ProducerInterfacePtr;
-      }}
-  }}
+namespace Gui {
+
+class SCISHARE SimulateForwardMagneticFieldDialog : public ModuleDialogGeneric,
+  public Ui::SimulateForwardMagneticFieldDialog
+{
+  Q_OBJECT
+
+public:
+  SimulateForwardMagneticFieldDialog(const std::string& name,
+    SCIRun::Dataflow::Networks::ModuleStateHandle state,
+    QWidget* parent = nullptr);
+};
+
+}
+}
 
 #endif
@@ -26,27 +26,29 @@
 */
 
 
-#ifndef ENGINE_SCHEDULER_DYNAMICEXECUTOR_WORKQUEUE_H
-#define ENGINE_SCHEDULER_DYNAMICEXECUTOR_WORKQUEUE_H
 
-#include <Dataflow/Network/NetworkFwd.h>
-#include <boost/next_prior.hpp>
-#include <boost/lockfree/spsc_queue.hpp>
-#include <Dataflow/Engine/Scheduler/share.h>
+#ifndef INTERFACE_MODULES_SolveBiotSavartDialog_H
+#define INTERFACE_MODULES_SolveBiotSavartDialog_H
 
-namespace SCIRun {
-namespace Dataflow {
-namespace Engine {
-  namespace DynamicExecutor {
+#include "Interface/Modules/BrainStimulator/ui_SolveBiotSavartDialog.h"
+#include <Interface/Modules/Base/ModuleDialogGeneric.h>
+#include <Interface/Modules/BrainStimulator/share.h>
 
-    template <class Unit>
-    using WorkQueue = boost::lockfree::spsc_queue<Unit>;
+namespace SCIRun {
+namespace Gui {
 
-    typedef WorkQueue<Networks::ModuleHandle> ModuleWorkQueue;
-    typedef SharedPointer<ModuleWorkQueue> ModuleWorkQueuePtr;
+class SCISHARE SolveBiotSavartDialog : public ModuleDialogGeneric,
+  public Ui::SolveBiotSavartDialog
+{
+  Q_OBJECT
 
-  }}
+public:
+  SolveBiotSavartDialog(const std::string& name,
+    SCIRun::Dataflow::Networks::ModuleStateHandle state,
+    QWidget* parent = nullptr);
+};
 
-}}
+}
+}
 
 #endif
@@ -43,6 +43,7 @@ CalculateDistanceToFieldDialog::CalculateDistanceToFieldDialog(const std::string
 
   addCheckBoxManager(truncateDistanceCheckBox_, Parameters::Truncate);
   addDoubleSpinBoxManager(truncateDoubleSpinBox_, Parameters::TruncateDistance);
+  addCheckBoxManager(approximateOnGridCheckBox_, Parameters::ApproximateOnGrid);
   addComboBoxManager(basisTypeComboBox_, Parameters::BasisType);
   addComboBoxManager(dataTypeComboBox_, Parameters::OutputFieldDatatype);
 }
@@ -57,6 +57,7 @@ BuildBEMatrixDialog::BuildBEMatrixDialog(const std::string& name, ModuleStateHan
   fixSize();
   WidgetStyleMixin::tableHeaderStyle(this->tableWidget);
   tableWidget->resizeColumnsToContents();
+  addDoubleSpinBoxManager(crossBlockToleranceDoubleSpinBox_, Parameters::CrossBlockTolerance);
 
   connect(tableWidget, &QTableWidget::cellChanged, this, &BuildBEMatrixDialog::pushTable);
 }
@@ -48,5 +48,7 @@ SolveComplexLinearSystemDialog::SolveComplexLinearSystemDialog(const std::string
   addComboBoxManager(methodComboBox_, Variables::Method,
     {{"Conjugate Gradient (Eigen)", "cg"},
     {"BiConjugate Gradient (Eigen)", "bicg"},
-    {"Least Squares Conjugate Gradient (Eigen)", "lscg"}});
+    {"Least Squares Conjugate Gradient (Eigen)", "lscg"},
+    {"Sparse LDLT, Hermitian (Eigen)", "ldlt"},
+    {"Sparse LU (Eigen)", "lu"}});
 }
@@ -85,10 +85,18 @@ SolveLinearSystemDialog::SolveLinearSystemDialog(const std::string& name, Module
 	myPlot->show();
 #endif
 
-  addComboBoxManager(preconditionerComboBox_, Variables::Preconditioner);
+  addComboBoxManager(preconditionerComboBox_, Variables::Preconditioner,
+    {{"Jacobi", "Jacobi"},
+    {"None", "None"},
+    {"Incomplete Cholesky (IC0)", "IC0"},
+    {"Incomplete LU (ILU0)", "ILU0"},
+    {"Algebraic Multigrid (AMG)", "AMG"}});
   addComboBoxManager(methodComboBox_, Variables::Method,
     {{"Conjugate Gradient (SCI)", "cg"},
+    {"Pipelined Conjugate Gradient (SCI)", "pipelined_cg"},
     {"BiConjugate Gradient (SCI)", "bicg"},
     {"Jacobi (SCI)", "jacobi"},
-    {"MINRES (SCI)", "minres"}});
+    {"MINRES (SCI)", "minres"},
+    {"Sparse LDLT, symmetric (direct)", "ldlt"},
+    {"Sparse LU (direct)", "lu"}});
 }
@@ -65,6 +65,7 @@ ShowFieldDialog::ShowFieldDialog(const std::string& name, ModuleStateHandle stat
   addCheckBoxManager(textAlwaysVisibleCheckBox_, Parameters::TextAlwaysVisible);
   addCheckBoxManager(renderIndicesLocationsCheckBox_, Parameters::RenderAsLocation);
   addCheckBoxManager(useFaceNormalsCheckBox_, Parameters::UseFaceNormals);
+  addCheckBoxManager(shareFaceVerticesCheckBox_, Parameters::FaceSharedVertices);
   addDoubleSpinBoxManager(transparencyDoubleSpinBox_, Parameters::FaceTransparencyValue);
   addDoubleSpinBoxManager(nodeTransparencyDoubleSpinBox_, Parameters::NodeTransparencyValue);
   addDoubleSpinBoxManager(edgeTransparencyDoubleSpinBox_, Parameters::EdgeTransparencyValue);
@@ -93,6 +94,7 @@ ShowFieldDialog::ShowFieldDialog(const std::string& name, ModuleStateHandle stat
     defaultMeshColorButton_, textColorPushButton_ });
 
   connectButtonToExecuteSignal(useFaceNormalsCheckBox_);
+  connectButtonToExecuteSignal(shareFaceVerticesCheckBox_);
 
   createExecuteInteractivelyToggleAction();
 
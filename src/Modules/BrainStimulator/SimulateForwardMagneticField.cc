@@ -41,7 +41,7 @@ using namespace SCIRun::Dataflow::Networks;
 
 MODULE_INFO_DEF(SimulateForwardMagneticField, BrainStimulator, SCIRun)
 
-SimulateForwardMagneticField::SimulateForwardMagneticField() : Module(staticInfo_, false)
+SimulateForwardMagneticField::SimulateForwardMagneticField() : Module(staticInfo_)
 {
  INITIALIZE_PORT(ElectricField);
  INITIALIZE_PORT(ConductivityTensor);
@@ -53,6 +53,8 @@ SimulateForwardMagneticField::SimulateForwardMagneticField() : Module(staticInfo
 
 void SimulateForwardMagneticField::setStateDefaults()
 {
+  setStateDoubleFromAlgo(Parameters::TreecodeTheta);
+  setStateIntFromAlgo(Parameters::TreecodeDegree);
 }
 
 void SimulateForwardMagneticField::execute()
@@ -64,6 +66,8 @@ void SimulateForwardMagneticField::execute()
 
   if (needToExecute())
   {
+    setAlgoDoubleFromState(Parameters::TreecodeTheta);
+    setAlgoIntFromState(Parameters::TreecodeDegree);
      auto output = algo().run(make_input((ElectricField, EField)(ConductivityTensor, CondTensor)(DipoleSources, Dipoles)(DetectorLocations, Detectors)));
     sendOutputFromAlgorithm(MagneticField, output);
     sendOutputFromAlgorithm(MagneticFieldMagnitudes, output);
@@ -70,6 +70,7 @@ class SCISHARE SimulateForwardMagneticField : public SCIRun::Dataflow::Networks:
     LEGACY_BIOPSE_MODULE
 
     MODULE_TRAITS_AND_INFO(ModuleFlags::ModuleHasAlgorithm)
+    INTERNALLY_PARALLEL_MODULE
 };
 
 }}}
@@ -39,7 +39,7 @@ using namespace SCIRun::Dataflow::Networks;
 
 MODULE_INFO_DEF(SolveBiotSavart, BrainStimulator, SCIRun)
 
-SolveBiotSavart::SolveBiotSavart() : Module(staticInfo_, false)
+SolveBiotSavart::SolveBiotSavart() : Module(staticInfo_)
 {
   INITIALIZE_PORT(Mesh);
   INITIALIZE_PORT(Coil);
@@ -51,10 +51,15 @@ void SolveBiotSavart::setStateDefaults()
 {
   auto state = get_state();
   setStateIntFromAlgo(Parameters::OutType);
+  setStateDoubleFromAlgo(Parameters::TreecodeTheta);
+  setStateIntFromAlgo(Parameters::TreecodeDegree);
 }
 
 void SolveBiotSavart::execute()
 {
+  setAlgoDoubleFromState(Parameters::TreecodeTheta);
+  setAlgoIntFromState(Parameters::TreecodeDegree);
+
   if (oport_connected(VectorBField) || oport_connected(VectorAField))
   {
     setAlgoIntFromState(Parameters::OutType);
@@ -64,6 +64,7 @@ namespace SCIRun {
         NEW_BRAIN_STIMULATOR_MODULE
 
         MODULE_TRAITS_AND_INFO(ModuleFlags::ModuleHasAlgorithm)
+        INTERNALLY_PARALLEL_MODULE
       };
 
 }}}
@@ -51,6 +51,7 @@ namespace SCIRun {
         OUTPUT_PORT(0, Mapping, Matrix);
 
         MODULE_TRAITS_AND_INFO(ModuleFlags::ModuleHasUIAndAlgorithm)
+        INTERNALLY_PARALLEL_MODULE
       };
 
     }
@@ -54,6 +54,7 @@ namespace SCIRun {
         OUTPUT_PORT(1, ValueField, Field);
 
         MODULE_TRAITS_AND_INFO(ModuleFlags::ModuleHasUIAndAlgorithm)
+        INTERNALLY_PARALLEL_MODULE
       };
     }
   }
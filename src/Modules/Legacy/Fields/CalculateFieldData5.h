@@ -55,6 +55,7 @@ namespace SCIRun {
         OUTPUT_PORT(0, OutputField, Field);
 
         MODULE_TRAITS_AND_INFO(ModuleFlags::ModuleHasUI)
+        INTERNALLY_PARALLEL_MODULE
       private:
         bool addFieldVariableIfPresent(const FieldList& fields, NewArrayMathEngine& engine, int index) const;
       };
@@ -57,6 +57,7 @@ namespace SCIRun {
         OUTPUT_PORT(0, SignedDistanceField, Field);
         OUTPUT_PORT(1, ValueField, Field);
         MODULE_TRAITS_AND_INFO(ModuleFlags::ModuleHasAlgorithm)
+        INTERNALLY_PARALLEL_MODULE
       };
 
     }
@@ -53,6 +53,7 @@ namespace Fields {
     OUTPUT_PORT(0, Remapped_Destination, Field);
 
     MODULE_TRAITS_AND_INFO(ModuleFlags::ModuleHasUIAndAlgorithm)
+    INTERNALLY_PARALLEL_MODULE
   };
 
 }}}
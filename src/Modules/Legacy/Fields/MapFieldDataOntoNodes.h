@@ -54,6 +54,7 @@ namespace Fields {
     OUTPUT_PORT(0, OutputField, Field);
 
     MODULE_TRAITS_AND_INFO(ModuleFlags::ModuleHasUIAndAlgorithm)
+    INTERNALLY_PARALLEL_MODULE
   };
 
 }}}
@@ -55,6 +55,7 @@ namespace SCIRun {
         OUTPUT_PORT(0, Stiffness_Matrix, Matrix);
         OUTPUT_PORT(1, Stiffness_Matrix_Complex, ComplexSparseRowMatrix);
         MODULE_TRAITS_AND_INFO(ModuleFlags::ModuleHasAlgorithm)
+        INTERNALLY_PARALLEL_MODULE
       };
 
     }
@@ -67,6 +67,7 @@ void BuildBEMatrix::setStateDefaults()
   get_state()->setValue(Parameters::BoundaryConditionList, VariableList());
   get_state()->setValue(Parameters::OutsideConductivityList, VariableList());
   get_state()->setValue(Parameters::InsideConductivityList, VariableList());
+  get_state()->setValue(Parameters::CrossBlockTolerance, 0.0);
 }
 
 void BuildBEMatrix::execute()
@@ -80,8 +81,9 @@ void BuildBEMatrix::execute()
     auto boundaryConditions = state->getValue(Parameters::BoundaryConditionList).toVector();
     auto outsideConds = state->getValue(Parameters::OutsideConductivityList).toVector();
     auto insideConds = state->getValue(Parameters::InsideConductivityList).toVector();
+    auto crossBlockTolerance = state->getValue(Parameters::CrossBlockTolerance).toDouble();
 
-    BuildBEMatrixImpl impl(fieldNames, boundaryConditions, outsideConds, insideConds, this);
+    BuildBEMatrixImpl impl(fieldNames, boundaryConditions, outsideConds, insideConds, crossBlockTolerance, this);
     MatrixHandle transferMatrix = impl.executeImpl(inputs);
     auto fieldTypes = impl.getInputTypes();
     state->setTransientValue(Parameters::FieldTypeList, fieldTypes);
@@ -57,11 +57,13 @@ BuildBEMatrixImpl::BuildBEMatrixImpl(const VariableList& names,
   const VariableList& bdyConds,
   const VariableList& outside,
   const VariableList& inside,
+  double crossBlockTolerance,
   LegacyLoggerInterface* log) :
   names_(names),
   bdyConds_(bdyConds),
   outside_(outside),
   inside_(inside),
+  crossBlockTolerance_(crossBlockTolerance),
   log_(log)
 {
 
@@ -128,7 +130,7 @@ MatrixHandle BuildBEMatrixImpl::executeImpl(const FieldList& inputs)
 
   // The specific BEM routine (2 so far) to be called is dependent on the inputs in the fields vector,
   // so we check for the conditions and call the appropriate routine:
-  auto BEMalgo = BEMAlgoImplFactory::create(fields);
+  auto BEMalgo = BEMAlgoImplFactory::create(fields, crossBlockTolerance_);
 
   if (!BEMalgo)
   {
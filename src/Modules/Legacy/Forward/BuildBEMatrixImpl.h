@@ -46,6 +46,7 @@ namespace SCIRun {
           const Core::Algorithms::VariableList& bdyConds,
           const Core::Algorithms::VariableList& outside,
           const Core::Algorithms::VariableList& inside,
+          double crossBlockTolerance,
           Core::Logging::LegacyLoggerInterface* log);
 
         Core::Datatypes::MatrixHandle executeImpl(const FieldList& inputs);
@@ -55,6 +56,7 @@ namespace SCIRun {
         const Core::Algorithms::VariableList& bdyConds_;
         const Core::Algorithms::VariableList& outside_;
         const Core::Algorithms::VariableList& inside_;
+        double crossBlockTolerance_;
         const Core::Logging::LegacyLoggerInterface* log_;
         std::vector<std::string> inputTypes_;
       };
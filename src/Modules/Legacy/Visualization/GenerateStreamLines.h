@@ -52,6 +52,7 @@ namespace SCIRun {
         OUTPUT_PORT(0, Streamlines, Field);
 
         MODULE_TRAITS_AND_INFO(ModuleFlags::ModuleHasUIAndAlgorithm)
+        INTERNALLY_PARALLEL_MODULE
       };
     }
   }
@@ -67,14 +67,10 @@ void SolveLinearSystem::execute()
   if (needToExecute())
   {
     /// @todo: why aren't these checks in the algo class?
-    if (rhs->ncols() != 1)
-      THROW_ALGORITHM_INPUT_ERROR("Right-hand side matrix must contain only one column.");
     if (!matrixIs::sparse(A))
       THROW_ALGORITHM_INPUT_ERROR("Left-hand side matrix to solve must be sparse.");
-
-    auto rhsCol = castMatrix::toColumn(rhs);
-    if (!rhsCol)
-      rhsCol = convertMatrix::toColumn(rhs);
+    if (rhs->ncols() == 0)
+      THROW_ALGORITHM_INPUT_ERROR("Right-hand side matrix has no columns.");
 
     auto tolerance = get_state()->getValue(Variables::TargetError).toDouble();
     auto maxIterations = get_state()->getValue(Variables::MaxIterations).toInt();
@@ -100,7 +96,19 @@ void SolveLinearSystem::execute()
       ScopedTimeRemarker perf(this, "Linear solver");
       remark("Using preconditioner: " + precond);
 
-      auto output = algo().run(withInputData((LHS, A)(RHS, rhsCol)));
+      AlgorithmOutput output;
+      if (rhs->ncols() == 1)
+      {
+        auto rhsCol = castMatrix::toColumn(rhs);
+        if (!rhsCol)
+          rhsCol = convertMatrix::toColumn(rhs);
+        output = algo().run(withInputData((LHS, A)(RHS, rhsCol)));
+      }
+      else
+      {
+        // several right-hand sides are solved together
+        output = algo().run(withInputData((LHS, A)(RHS, convertMatrix::toDense(rhs))));
+      }
 
       sendOutputFromAlgorithm(Solution, output);
     }
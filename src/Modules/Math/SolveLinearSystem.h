@@ -52,6 +52,7 @@ namespace Math {
     OUTPUT_PORT(0, Solution, Matrix);
 
     MODULE_TRAITS_AND_INFO(ModuleFlags::ModuleHasUIAndAlgorithm)
+    INTERNALLY_PARALLEL_MODULE
   };
 
 }}}
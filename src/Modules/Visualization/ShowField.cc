@@ -37,6 +37,7 @@
 #include <Core/Datatypes/Feedback.h>
 #include <Core/GeometryPrimitives/Vector.h>
 #include <Core/GeometryPrimitives/Tensor.h>
+#include <Core/Thread/Parallel.h>
 #include <Graphics/Glyphs/GlyphGeom.h>
 
 using namespace SCIRun;
@@ -87,11 +88,30 @@ public:
     RenderState state, GeometryHandle geom,
     const std::string& id);
 
+  /// Face tessellation into faceBuffers_; see renderFaces.
   void renderFacesLinear(
     FieldHandle field,
-    std::optional<ColorMapHandle> colorMap,
-    RenderState state, GeometryHandle geom,
-    const std::string& id);
+    ColorMapHandle coordinateMap,
+    const RenderState& state);
+
+  void renderFacesIndexed(
+    FieldHandle field,
+    ColorMapHandle coordinateMap,
+    const RenderState& state);
+
+  void recolorFaces(ColorMapHandle coordinateMap);
+
+  void addFacePass(
+    GeometryHandle geom,
+    const std::string& uniqueNodeID,
+    std::shared_ptr<spire::VarBuffer> vbo,
+    std::shared_ptr<spire::VarBuffer> ibo,
+    const BBox& bbox,
+    bool useNormals,
+    bool useColorMap,
+    ColorMapHandle textureMap,
+    ColorScheme colorScheme,
+    const RenderState& state);
 
   void addFaceGeom(
     const std::vector<Point>  &points,
@@ -115,6 +135,32 @@ public:
   RenderState getEdgeRenderState(std::optional<ColorMapHandle> colorMap);
   RenderState getFaceRenderState(std::optional<ColorMapHandle> colorMap);
 private:
+  /// Face buffers of the last execute. Positions, normals and indices only depend on the
+  /// field and the face options in key, so a colormap change just rewrites the texture
+  /// coordinates from the cached data magnitudes.
+  struct FaceBuffers
+  {
+    struct Pass
+    {
+      std::string name;
+      std::shared_ptr<spire::VarBuffer> vbo;
+      std::shared_ptr<spire::VarBuffer> ibo;
+      std::vector<double> magnitudes;
+    };
+
+    Datatype::id_type fieldId = -1;
+    std::string key;
+    std::vector<Pass> passes;
+    BBox bbox;
+    bool useNormals = false;
+    size_t floatsPerVertex = 0;
+    size_t texCoordOffset = 0;
+    size_t magnitudesPerVertex = 1;
+    double rescaleScale = 0;
+    double rescaleShift = 0;
+  };
+
+  FaceBuffers faceBuffers_;
   float faceTransparencyValue_ = 0.65f;
   float edgeTransparencyValue_ = 0.65f;
   float nodeTransparencyValue_ = 0.65f;
@@ -182,6 +228,7 @@ void ShowField::setStateDefaults()
 
   state->setValue(UseFaceNormals, false);
   state->setValue(FaceInvertNormals, false);
+  state->setValue(FaceSharedVertices, false);
 
   state->setValue(FieldName, std::string());
 
@@ -378,6 +425,8 @@ GeometryHandle GeometryBuilder::buildGeometryObject(
 
   if (showFaces)
     renderFaces(field, colorMap, getFaceRenderState(colorMap), geom, geom->uniqueID());
+  else
+    faceBuffers_ = FaceBuffers();
 
   if (showEdges)
     renderEdges(field, colorMap, getEdgeRenderState(colorMap), geom, geom->uniqueID());
@@ -389,36 +438,6 @@ GeometryHandle GeometryBuilder::buildGeometryObject(
 }
 
 
-void GeometryBuilder::renderFaces(
-  FieldHandle field,
-  std::optional<SharedPointer<ColorMap>> colorMap,
-  RenderState state, GeometryHandle geom,
-  const std::string& id)
-{
-  VField* fld = field->vfield();
-  VMesh*  mesh = field->vmesh();
-
-  // Directly ported from SCIRUN 4. Unsure what 'linear' is.
-  // I'm assuming it means linear interpolation as opposed to nearest neighbor
-  // interpolation along the basis. But I could be wrong.
-  bool doLinear = (fld->basis_order() < 2 && mesh->basis_order() < 2);
-
-  // Todo: Check for texture -- this is indicative of volume rendering.
-  // if(mesh->is_regularmesh() && mesh->is_surface() &&
-  //    get_flag(render_state, USE_TEXTURE))
-
-  if (doLinear)
-  {
-    return renderFacesLinear(field, colorMap, state, geom, id);
-  }
-  else
-  {
-    std::cout << "Non linear faces not supported at this time." << std::endl;
-  }
-}
-
-
-
 namespace
 {
   template <typename T>
@@ -468,6 +487,34 @@ namespace
     return ((int)writeQuads << 2) | ((int)writeNormals << 1) | ((int)writeTexCoords);
   }
 
+  // The reduction ColorMap::valueToIndex applies to each data type, kept separately so
+  // it can be re-indexed when only the colormap rescaling changes.
+  template <typename Index>
+  double dataMagnitude(VField* fld, Index idx)
+  {
+    if (fld->is_scalar())
+    {
+      double scalar;
+      fld->get_value(scalar, idx);
+      return scalar;
+    }
+    if (fld->is_vector())
+    {
+      Vector vector;
+      fld->get_value(vector, idx);
+      return vector.length();
+    }
+    if (fld->is_tensor())
+    {
+      Tensor tensor;
+      fld->get_value(tensor, idx);
+      double eigen1, eigen2, eigen3;
+      tensor.get_eigenvalues(eigen1, eigen2, eigen3);
+      return Vector(eigen1, eigen2, eigen3).length();
+    }
+    return 0;
+  }
+
   void spiltColorMapToTextureAndCoordinates(
     const std::optional<SharedPointer<ColorMap>>& colorMap,
     ColorMapHandle& textureMap, ColorMapHandle& coordinateMap)
@@ -491,16 +538,195 @@ namespace
 
 
 
-void GeometryBuilder::renderFacesLinear(
+void GeometryBuilder::renderFaces(
   FieldHandle field,
   std::optional<SharedPointer<ColorMap>> colorMap,
-  RenderState state,
-  GeometryHandle geom,
+  RenderState state, GeometryHandle geom,
   const std::string& id)
 {
   VField* fld = field->vfield();
   VMesh*  mesh = field->vmesh();
 
+  // Directly ported from SCIRUN 4. Unsure what 'linear' is.
+  // I'm assuming it means linear interpolation as opposed to nearest neighbor
+  // interpolation along the basis. But I could be wrong.
+  bool doLinear = (fld->basis_order() < 2 && mesh->basis_order() < 2);
+
+  // Todo: Check for texture -- this is indicative of volume rendering.
+  // if(mesh->is_regularmesh() && mesh->is_surface() &&
+  //    get_flag(render_state, USE_TEXTURE))
+
+  if (!doLinear)
+  {
+    std::cout << "Non linear faces not supported at this time." << std::endl;
+    return;
+  }
+
+  // Shared vertices need one attribute value per node, so element data keeps the per-face path.
+  bool useColorMap = fld->basis_order() >= 0 && state.get(RenderState::ActionFlags::USE_COLORMAP);
+  VMesh::Node::size_type numNodes;
+  mesh->size(numNodes);
+  bool canShareVertices = (!useColorMap || fld->basis_order() == 1)
+    && static_cast<size_t>(numNodes) <= std::numeric_limits<uint32_t>::max();
+  bool shareVertices = state_->getValue(FaceSharedVertices).toBool() && canShareVertices;
+  bool invertNormals = state_->getValue(FaceInvertNormals).toBool();
+
+  ColorMapHandle textureMap, coordinateMap;
+  spiltColorMapToTextureAndCoordinates(colorMap, textureMap, coordinateMap);
+
+  std::ostringstream key;
+  key << shareVertices << useColorMap << invertNormals
+    << state.get(RenderState::ActionFlags::USE_NORMALS)
+    << state.get(RenderState::ActionFlags::USE_FACE_NORMALS);
+
+  if (faceBuffers_.fieldId != field->id() || faceBuffers_.key != key.str())
+  {
+    faceBuffers_ = FaceBuffers();
+    faceBuffers_.fieldId = field->id();
+    faceBuffers_.key = key.str();
+    faceBuffers_.bbox = mesh->get_bounding_box();
+    faceBuffers_.rescaleScale = coordinateMap->getColorMapRescaleScale();
+    faceBuffers_.rescaleShift = coordinateMap->getColorMapRescaleShift();
+
+    if (shareVertices)
+      renderFacesIndexed(field, coordinateMap, state);
+    else
+      renderFacesLinear(field, coordinateMap, state);
+  }
+  else if (useColorMap)
+  {
+    recolorFaces(coordinateMap);
+  }
+
+  ColorScheme colorScheme = useColorMap ? ColorScheme::COLOR_MAP : ColorScheme::COLOR_UNIFORM;
+  for (const auto& pass : faceBuffers_.passes)
+  {
+    std::stringstream ss;
+    ss << invertNormals << static_cast<int>(colorScheme) << faceTransparencyValue_ << pass.name;
+
+    addFacePass(geom, id + "face" + ss.str(), pass.vbo, pass.ibo, faceBuffers_.bbox,
+      faceBuffers_.useNormals, useColorMap, textureMap, colorScheme, state);
+  }
+}
+
+void GeometryBuilder::recolorFaces(ColorMapHandle coordinateMap)
+{
+  if (faceBuffers_.rescaleScale == coordinateMap->getColorMapRescaleScale()
+    && faceBuffers_.rescaleShift == coordinateMap->getColorMapRescaleShift())
+    return;
+
+  faceBuffers_.rescaleScale = coordinateMap->getColorMapRescaleScale();
+  faceBuffers_.rescaleShift = coordinateMap->getColorMapRescaleShift();
+
+  const size_t floatsPerVertex = faceBuffers_.floatsPerVertex;
+  const size_t texCoordOffset = faceBuffers_.texCoordOffset;
+  const size_t magnitudesPerVertex = faceBuffers_.magnitudesPerVertex;
+
+  for (auto& pass : faceBuffers_.passes)
+  {
+    // The previous buffer may still be owned by the renderer, so recolor a copy.
+    const size_t bytes = pass.vbo->getBufferSize();
+    std::shared_ptr<spire::VarBuffer> vbo(new spire::VarBuffer(bytes));
+    auto vertices = reinterpret_cast<float*>(vbo->reserveBytes(bytes));
+    std::copy(pass.vbo->getBuffer(), pass.vbo->getBuffer() + bytes, reinterpret_cast<char*>(vertices));
+
+    const auto& magnitudes = pass.magnitudes;
+    Parallel::For(0, magnitudes.size() / magnitudesPerVertex, 4096, [&](size_t begin, size_t end)
+    {
+      for (size_t v = begin; v < end; ++v)
+      {
+        float* texCoords = vertices + v * floatsPerVertex + texCoordOffset;
+        const double* magnitude = &magnitudes[v * magnitudesPerVertex];
+        texCoords[0] = static_cast<float>(coordinateMap->valueToIndex(magnitude[0]));
+        texCoords[1] = static_cast<float>(coordinateMap->valueToIndex(magnitude[magnitudesPerVertex - 1]));
+      }
+    });
+    pass.vbo = vbo;
+  }
+}
+
+void GeometryBuilder::addFacePass(
+  GeometryHandle geom,
+  const std::string& uniqueNodeID,
+  std::shared_ptr<spire::VarBuffer> vbo,
+  std::shared_ptr<spire::VarBuffer> ibo,
+  const BBox& bbox,
+  bool useNormals,
+  bool useColorMap,
+  ColorMapHandle textureMap,
+  ColorScheme colorScheme,
+  const RenderState& state)
+{
+  std::string vboName = uniqueNodeID + "VBO";
+  std::string iboName = uniqueNodeID + "IBO";
+  std::string passName = uniqueNodeID + "Pass";
+  std::string shader = (useNormals ? "Shaders/Phong" : "Shaders/Flat");
+
+  std::vector<SpireVBO::AttributeData> attribs;
+  std::vector<SpireSubPass::Uniform> uniforms;
+
+  attribs.push_back(SpireVBO::AttributeData("aPos", 3 * sizeof(float)));
+  uniforms.push_back(SpireSubPass::Uniform("uUseClippingPlanes", true));
+  uniforms.push_back(SpireSubPass::Uniform("uUseFog", true));
+  uniforms.push_back(SpireSubPass::Uniform("uTransparency", faceTransparencyValue_));
+
+  if (useNormals)
+  {
+    attribs.push_back(SpireVBO::AttributeData("aNormal", 3 * sizeof(float)));
+    uniforms.push_back(SpireSubPass::Uniform("uAmbientColor", glm::vec4(0.1f, 0.1f, 0.1f, 1.0f)));
+    uniforms.push_back(SpireSubPass::Uniform("uSpecularColor", glm::vec4(0.1f, 0.1f, 0.1f, 0.1f)));
+    uniforms.push_back(SpireSubPass::Uniform("uSpecularPower", 32.0f));
+  }
+
+  SpireTexture2D texture;
+  if (useColorMap)
+  {
+    shader += "_ColorMap";
+    attribs.push_back(SpireVBO::AttributeData("aTexCoords", 2 * sizeof(float)));
+
+    const static int colorMapResolution = 256;
+    for(int i = 0; i < colorMapResolution; ++i)
+    {
+      ColorRGB color = textureMap->valueToColor(static_cast<float>(i)/colorMapResolution * 2.0 - 1.0);
+      texture.bitmap.push_back(color.r()*255.99f);
+      texture.bitmap.push_back(color.g()*255.99f);
+      texture.bitmap.push_back(color.b()*255.99f);
+      texture.bitmap.push_back(color.a()*255.99f);
+    }
+    texture.name = "ColorMap";
+    texture.height = 1;
+    texture.width = colorMapResolution;
+  }
+  else
+  {
+    uniforms.push_back(SpireSubPass::Uniform("uDiffuseColor",
+      glm::vec4(state.defaultColor.r(), state.defaultColor.g(), state.defaultColor.b(), 1.0f)));
+  }
+
+  //numVBOElements is only used in dead code and should be removed which is why its hard coded to 0
+  SpireVBO geomVBO(vboName, attribs, vbo, 0, bbox, true);
+  geom->vbos().push_back(geomVBO);
+
+  SpireIBO geomIBO(iboName, SpireIBO::PRIMITIVE::TRIANGLES, sizeof(uint32_t), ibo);
+  geom->ibos().push_back(geomIBO);
+
+  SpireText text;
+  SpireSubPass pass(passName, vboName, iboName, shader,
+    colorScheme, state, RenderType::RENDER_VBO_IBO, geomVBO, geomIBO, text, texture);
+
+  for (const auto& uniform : uniforms) pass.addUniform(uniform);
+
+  geom->passes().push_back(pass);
+}
+
+void GeometryBuilder::renderFacesLinear(
+  FieldHandle field,
+  ColorMapHandle coordinateMap,
+  const RenderState& state)
+{
+  VField* fld = field->vfield();
+  VMesh*  mesh = field->vmesh();
+
   mesh->synchronize(Mesh::FACES_E);
 
   VMesh::Face::size_type numFaces;
@@ -531,32 +757,21 @@ void GeometryBuilder::renderFacesLinear(
   bool isCellData = (fld->basis_order() == 0 && mesh->dimensionality() == 3);
   bool isFaceData = (fld->basis_order() == 0 && mesh->dimensionality() == 2);
   bool isNodeData = (fld->basis_order() == 1);
-  bool isScalar = fld->is_scalar();
-  bool isVector = fld->is_vector();
-  bool isTensor = fld->is_tensor();
-  //int colorMapCase = (isCellData * 0 + isFaceData * 1 + isNodeData * 2) * 3;
-  //colorMapCase += isScalar * 0 + isVector * 1 + isTensor * 2;
-
-  ColorScheme colorScheme = ColorScheme::COLOR_UNIFORM;
-
-
-  ColorMapHandle textureMap, coordinateMap;
-  spiltColorMapToTextureAndCoordinates(colorMap, textureMap, coordinateMap);
 
   if (useColorMap)
-  {
     numAttributes += 2;
-    colorScheme = ColorScheme::COLOR_MAP;
-  }
 
   int writeCase = getWriteCase(useQuads, useNormals, useColorMap);
 
+  faceBuffers_.useNormals = useNormals;
+  faceBuffers_.floatsPerVertex = numAttributes;
+  faceBuffers_.texCoordOffset = useNormals ? 6 : 3;
+  faceBuffers_.magnitudesPerVertex = isCellData ? 2 : 1;
+
   std::vector<Point> points(numNodesPerFace);
   std::vector<Vector> normals(numNodesPerFace);
   std::vector<glm::vec2> textureCoords(numNodesPerFace);
-  std::vector<double> svals(numNodesPerFace);
-  std::vector<Vector> vvals(numNodesPerFace);
-  std::vector<Tensor> tvals(numNodesPerFace);
+  std::vector<double> magnitudes(numNodesPerFace);
 
   size_t passNumber = 0;
   size_t facesLeft = mesh->num_faces();
@@ -575,6 +790,10 @@ void GeometryBuilder::renderFacesLinear(
     auto iboBuffer = iboBufferSPtr.get();
     auto vboBuffer = vboBufferSPtr.get();
 
+    std::vector<double> passMagnitudes;
+    if (useColorMap)
+      passMagnitudes.reserve(facesLeftInThisPass * numNodesPerFace * faceBuffers_.magnitudesPerVertex);
+
     if(useQuads)
     {
       uint32_t nodesInThisPass = facesLeftInThisPass * 4;
@@ -650,91 +869,31 @@ void GeometryBuilder::renderFacesLinear(
           VMesh::Elem::array_type cells;
           mesh->get_elems(cells, *fiter);
 
-          if (isScalar)
-          {
-            fld->get_value(svals[0], cells[0]);
-            if (cells.size() > 1) fld->get_value(svals[1], cells[1]);
-            else svals[1] = svals[0];
+          magnitudes[0] = dataMagnitude(fld, cells[0]);
+          magnitudes[1] = cells.size() > 1 ? dataMagnitude(fld, cells[1]) : magnitudes[0];
 
-            for (size_t i = 0; i < numNodesPerFace; ++i)
-            {
-              textureCoords[i].x = coordinateMap->valueToIndex(svals[0]);
-              textureCoords[i].y = coordinateMap->valueToIndex(svals[1]);
-            }
-          }
-          else if (isVector)
+          for (size_t i = 0; i < numNodesPerFace; ++i)
           {
-            fld->get_value(vvals[0], cells[0]);
-            if (cells.size() > 1) fld->get_value(vvals[1], cells[1]);
-            else svals[1] = svals[0];
-
-            for (size_t i = 0; i < numNodesPerFace; ++i)
-            {
-              textureCoords[i].x = coordinateMap->valueToIndex(vvals[0]);
-              textureCoords[i].y = coordinateMap->valueToIndex(vvals[1]);
-            }
-          }
-          else if (isTensor)
-          {
-            fld->get_value(tvals[0], cells[0]);
-            if (cells.size() > 1) fld->get_value(tvals[1], cells[1]);
-            else svals[1] = svals[0];
-
-            for (size_t i = 0; i < numNodesPerFace; ++i)
-            {
-              textureCoords[i].x = coordinateMap->valueToIndex(tvals[0]);
-              textureCoords[i].y = coordinateMap->valueToIndex(tvals[1]);
-            }
+            textureCoords[i].x = coordinateMap->valueToIndex(magnitudes[0]);
+            textureCoords[i].y = coordinateMap->valueToIndex(magnitudes[1]);
+            passMagnitudes.push_back(magnitudes[0]);
+            passMagnitudes.push_back(magnitudes[1]);
           }
         }
-        // Element data (faces)
-        else if (isFaceData)
+        else
         {
-          if (isScalar)
-          {
-            fld->get_value(svals[0], *fiter);
-            textureCoords[0].x = coordinateMap->valueToIndex(svals[0]);
-          }
-          else if (isVector)
-          {
-            fld->get_value(vvals[0], *fiter);
-            textureCoords[0].x = coordinateMap->valueToIndex(vvals[0]);
-          }
-          else if (isTensor)
-          {
-            fld->get_value(tvals[0], *fiter);
-            textureCoords[0].x = coordinateMap->valueToIndex(tvals[0]);
-          }
+          // Element data (faces)
+          if (isFaceData)
+            std::fill(magnitudes.begin(), magnitudes.end(), dataMagnitude(fld, *fiter));
+          // Data at nodes
+          else if (isNodeData)
+            for (size_t i = 0; i < numNodesPerFace; ++i)
+              magnitudes[i] = dataMagnitude(fld, nodes[i]);
 
           for (size_t i = 0; i < numNodesPerFace; ++i)
-            textureCoords[i].y = textureCoords[i].x = textureCoords[0].x;
-        }
-        // Data at nodes
-        else if (isNodeData)
-        {
-          if (isScalar)
-          {
-            for (size_t i = 0; i < numNodesPerFace; ++i)
-            {
-              fld->get_value(svals[i], nodes[i]);
-              textureCoords[i].x = textureCoords[i].y = coordinateMap->valueToIndex(svals[i]);
-            }
-          }
-          else if (isVector)
           {
-            for (size_t i = 0; i < numNodesPerFace; ++i)
-            {
-              fld->get_value(vvals[i], nodes[i]);
-              textureCoords[i].x = textureCoords[i].y = coordinateMap->valueToIndex(vvals[i]);
-            }
-          }
-          else if (isTensor)
-          {
-            for (size_t i = 0; i < numNodesPerFace; ++i)
-            {
-              fld->get_value(tvals[i], nodes[i]);
-              textureCoords[i].x = textureCoords[i].y = coordinateMap->valueToIndex(tvals[i]);
-            }
+            textureCoords[i].x = textureCoords[i].y = coordinateMap->valueToIndex(magnitudes[i]);
+            passMagnitudes.push_back(magnitudes[i]);
           }
         }
       }
@@ -755,72 +914,152 @@ void GeometryBuilder::renderFacesLinear(
       --facesLeftInThisPass;
     }
 
-    std::stringstream ss;
-    ss << invertNormals << static_cast<int>(colorScheme) << faceTransparencyValue_ << "_" << passNumber;
+    faceBuffers_.passes.push_back({ "_" + std::to_string(passNumber),
+      vboBufferSPtr, iboBufferSPtr, std::move(passMagnitudes) });
+    ++passNumber;
+  }
+}
 
-    std::string uniqueNodeID = id + "face" + ss.str();
-    std::string vboName = uniqueNodeID + "VBO";
-    std::string iboName = uniqueNodeID + "IBO";
-    std::string passName = uniqueNodeID + "Pass";
-    std::string shader = (useNormals ? "Shaders/Phong" : "Shaders/Flat");
 
-    std::vector<SpireVBO::AttributeData> attribs;
-    std::vector<SpireSubPass::Uniform> uniforms;
 
-    attribs.push_back(SpireVBO::AttributeData("aPos", 3 * sizeof(float)));
-    uniforms.push_back(SpireSubPass::Uniform("uUseClippingPlanes", true));
-    uniforms.push_back(SpireSubPass::Uniform("uUseFog", true));
-    uniforms.push_back(SpireSubPass::Uniform("uTransparency", faceTransparencyValue_));
+void GeometryBuilder::renderFacesIndexed(
+  FieldHandle field,
+  ColorMapHandle coordinateMap,
+  const RenderState& state)
+{
+  VField* fld = field->vfield();
+  VMesh*  mesh = field->vmesh();
 
-    if (useNormals)
-    {
-      attribs.push_back(SpireVBO::AttributeData("aNormal", 3 * sizeof(float)));
-      uniforms.push_back(SpireSubPass::Uniform("uAmbientColor", glm::vec4(0.1f, 0.1f, 0.1f, 1.0f)));
-      uniforms.push_back(SpireSubPass::Uniform("uSpecularColor", glm::vec4(0.1f, 0.1f, 0.1f, 0.1f)));
-      uniforms.push_back(SpireSubPass::Uniform("uSpecularPower", 32.0f));
-    }
+  mesh->synchronize(Mesh::FACES_E);
 
-    SpireTexture2D texture;
-    if (useColorMap)
-    {
-      shader += "_ColorMap";
-      attribs.push_back(SpireVBO::AttributeData("aTexCoords", 2 * sizeof(float)));
+  VMesh::Face::size_type numFaces;
+  mesh->size(numFaces);
+  if (numFaces == 0) return;
+
+  VMesh::Node::size_type numNodes;
+  mesh->size(numNodes);
+
+  VMesh::Node::array_type firstFace;
+  mesh->get_nodes(firstFace, VMesh::Face::index_type(0));
+  const size_t numNodesPerFace = firstFace.size();
+  const bool useQuads = (numNodesPerFace == 4);
+  const size_t indicesPerFace = useQuads ? 6 : 3;
+
+  bool useNormals = state.get(RenderState::ActionFlags::USE_NORMALS);
+  bool useFaceNormals = state.get(RenderState::ActionFlags::USE_FACE_NORMALS) && mesh->has_normals();
+  bool invertNormals = state_->getValue(FaceInvertNormals).toBool();
+  if (useNormals && useFaceNormals)
+    mesh->synchronize(Mesh::NORMALS_E);
 
-      const static int colorMapResolution = 256;
-      for(int i = 0; i < colorMapResolution; ++i)
+  bool useColorMap = (fld->basis_order() == 1 && state.get(RenderState::ActionFlags::USE_COLORMAP));
+
+  // Interleaved per-node layout: position, then optional normal and texture coordinates.
+  const size_t normalOffset = 3;
+  const size_t texCoordOffset = normalOffset + (useNormals ? 3 : 0);
+  const size_t floatsPerNode = texCoordOffset + (useColorMap ? 2 : 0);
+
+  faceBuffers_.useNormals = useNormals;
+  faceBuffers_.floatsPerVertex = floatsPerNode;
+  faceBuffers_.texCoordOffset = texCoordOffset;
+  faceBuffers_.magnitudesPerVertex = 1;
+
+  const size_t numIndices = static_cast<size_t>(numFaces) * indicesPerFace;
+  std::shared_ptr<spire::VarBuffer> iboBufferSPtr(new spire::VarBuffer(numIndices * sizeof(uint32_t)));
+  std::shared_ptr<spire::VarBuffer> vboBufferSPtr(new spire::VarBuffer(numNodes * floatsPerNode * sizeof(float)));
+  auto indices = reinterpret_cast<uint32_t*>(iboBufferSPtr->reserveBytes(numIndices * sizeof(uint32_t)));
+  auto vertices = reinterpret_cast<float*>(vboBufferSPtr->reserveBytes(numNodes * floatsPerNode * sizeof(float)));
+  std::vector<double> magnitudes(useColorMap ? static_cast<size_t>(numNodes) : 0);
+
+  const size_t grain = 4096;
+
+  Parallel::For(0, numFaces, grain, [&](size_t begin, size_t end)
+  {
+    VMesh::Node::array_type nodes;
+    for (size_t f = begin; f < end; ++f)
+    {
+      mesh->get_nodes(nodes, VMesh::Face::index_type(f));
+      uint32_t* face = indices + f * indicesPerFace;
+      face[0] = static_cast<uint32_t>(nodes[0]);
+      face[1] = static_cast<uint32_t>(nodes[1]);
+      face[2] = static_cast<uint32_t>(nodes[2]);
+      if (useQuads)
       {
-        ColorRGB color = textureMap->valueToColor(static_cast<float>(i)/colorMapResolution * 2.0 - 1.0);
-        texture.bitmap.push_back(color.r()*255.99f);
-        texture.bitmap.push_back(color.g()*255.99f);
-        texture.bitmap.push_back(color.b()*255.99f);
-        texture.bitmap.push_back(color.a()*255.99f);
+        face[3] = static_cast<uint32_t>(nodes[2]);
+        face[4] = static_cast<uint32_t>(nodes[3]);
+        face[5] = static_cast<uint32_t>(nodes[0]);
       }
-      texture.name = "ColorMap";
-      texture.height = 1;
-      texture.width = colorMapResolution;
     }
-    else
+  });
+
+  Parallel::For(0, numNodes, grain, [&](size_t begin, size_t end)
+  {
+    Point p;
+    Vector n;
+    for (size_t i = begin; i < end; ++i)
     {
-      uniforms.push_back(SpireSubPass::Uniform("uDiffuseColor",
-        glm::vec4(state.defaultColor.r(), state.defaultColor.g(), state.defaultColor.b(), 1.0f)));
-    }
+      VMesh::Node::index_type node(i);
+      float* vertex = vertices + i * floatsPerNode;
 
-    //numVBOElements is only used in dead code and should be removed which is why its hard coded to 0
-    SpireVBO geomVBO(vboName, attribs, vboBufferSPtr, 0, mesh->get_bounding_box(), true);
-    geom->vbos().push_back(geomVBO);
+      mesh->get_point(p, node);
+      vertex[0] = static_cast<float>(p.x());
+      vertex[1] = static_cast<float>(p.y());
+      vertex[2] = static_cast<float>(p.z());
 
-    SpireIBO geomIBO(iboName, SpireIBO::PRIMITIVE::TRIANGLES, sizeof(uint32_t), iboBufferSPtr);
-    geom->ibos().push_back(geomIBO);
+      if (useNormals && useFaceNormals)
+      {
+        mesh->get_normal(n, node);
+        if (invertNormals)
+          n = -n;
+        vertex[normalOffset + 0] = static_cast<float>(n.x());
+        vertex[normalOffset + 1] = static_cast<float>(n.y());
+        vertex[normalOffset + 2] = static_cast<float>(n.z());
+      }
 
-    SpireText text;
-    SpireSubPass pass(passName, vboName, iboName, shader,
-      colorScheme, state, RenderType::RENDER_VBO_IBO, geomVBO, geomIBO, text, texture);
+      if (useColorMap)
+      {
+        magnitudes[i] = dataMagnitude(fld, node);
+        vertex[texCoordOffset + 0] = vertex[texCoordOffset + 1] =
+          static_cast<float>(coordinateMap->valueToIndex(magnitudes[i]));
+      }
+    }
+  });
 
-    for (const auto& uniform : uniforms) pass.addUniform(uniform);
+  // Shared vertices cannot carry flat per-face normals, so accumulate area weighted
+  // face normals onto the nodes instead.
+  if (useNormals && !useFaceNormals)
+  {
+    std::vector<Vector> nodeNormals(numNodes, Vector(0, 0, 0));
+    auto position = [vertices, floatsPerNode](uint32_t node)
+    {
+      const float* v = vertices + node * floatsPerNode;
+      return Point(v[0], v[1], v[2]);
+    };
+    for (size_t t = 0; t < numIndices; t += 3)
+    {
+      Point p0 = position(indices[t]), p1 = position(indices[t + 1]), p2 = position(indices[t + 2]);
+      Vector norm = Cross(p1 - p0, p2 - p1);
+      nodeNormals[indices[t]] += norm;
+      nodeNormals[indices[t + 1]] += norm;
+      nodeNormals[indices[t + 2]] += norm;
+    }
 
-    geom->passes().push_back(pass);
-    ++passNumber;
+    Parallel::For(0, numNodes, grain, [&](size_t begin, size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        Vector norm = nodeNormals[i];
+        norm.safe_normalize();
+        if (invertNormals)
+          norm = -norm;
+        float* vertex = vertices + i * floatsPerNode;
+        vertex[normalOffset + 0] = static_cast<float>(norm.x());
+        vertex[normalOffset + 1] = static_cast<float>(norm.y());
+        vertex[normalOffset + 2] = static_cast<float>(norm.z());
+      }
+    });
   }
+
+  faceBuffers_.passes.push_back({ "_shared", vboBufferSPtr, iboBufferSPtr, std::move(magnitudes) });
 }
 
 
@@ -1110,3 +1349,4 @@ ALGORITHM_PARAMETER_DEF(Visualization, TextSize);
 ALGORITHM_PARAMETER_DEF(Visualization, TextPrecision);
 ALGORITHM_PARAMETER_DEF(Visualization, TextColoring);
 ALGORITHM_PARAMETER_DEF(Visualization, UseFaceNormals);
+ALGORITHM_PARAMETER_DEF(Visualization, FaceSharedVertices);
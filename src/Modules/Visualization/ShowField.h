@@ -83,6 +83,7 @@ namespace SCIRun {
         ALGORITHM_PARAMETER_DECL(TextPrecision);
         ALGORITHM_PARAMETER_DECL(TextColoring);
         ALGORITHM_PARAMETER_DECL(UseFaceNormals);
+        ALGORITHM_PARAMETER_DECL(FaceSharedVertices);
       }
     }
   }
@@ -30,6 +30,9 @@
 #include <Modules/Visualization/ShowField.h>
 #include <Core/Logging/Log.h>
 #include <Core/Datatypes/ColorMap.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Graphics/Datatypes/GeometryImpl.h>
 
 using namespace SCIRun::Testing;
 using namespace SCIRun::TestUtils;
@@ -126,6 +129,88 @@ TEST_F(ShowFieldStateGeometryNameSynchronizationTest, GeometryNameSynchronizesWi
   EXPECT_NE(inputChangeShouldBeDifferent, hash1);
 }
 
+class ShowFieldSharedVertexTest : public ModuleTest
+{
+protected:
+  DatatypeHandle executeFaces(bool shareVertices)
+  {
+    auto state = showField_->get_state();
+    state->setValue(ShowFaces, true);
+    state->setValue(ShowEdges, false);
+    state->setValue(ShowNodes, false);
+    state->setValue(FacesColoring, 1);
+    state->setValue(FaceSharedVertices, shareVertices);
+    showField_->execute();
+    return getDataOnThisOutputPort(showField_, 0);
+  }
+
+  UseRealModuleStateFactory f_;
+  ModuleHandle showField_;
+};
+
+TEST_F(ShowFieldSharedVertexTest, EmitsOneVertexPerNodeAndIndexesFaces)
+{
+  LogSettings::Instance().setVerbose(false);
+  showField_ = makeModule("ShowField");
+  showField_->setStateDefaults();
+  auto latVol = CreateEmptyLatVol(4, 5, 6);
+  stubPortNWithThisData(showField_, 0, latVol);
+  stubPortNWithThisData(showField_, 1, StandardColorMapFactory::create());
+
+  auto perFace = std::dynamic_pointer_cast<Graphics::Datatypes::GeometryObjectSpire>(executeFaces(false));
+  auto shared = std::dynamic_pointer_cast<Graphics::Datatypes::GeometryObjectSpire>(executeFaces(true));
+  ASSERT_TRUE(perFace != nullptr);
+  ASSERT_TRUE(shared != nullptr);
+  ASSERT_EQ(1, shared->vbos().size());
+  ASSERT_EQ(1, shared->ibos().size());
+
+  auto mesh = latVol->vmesh();
+  mesh->synchronize(Mesh::FACES_E);
+  const size_t numNodes = mesh->num_nodes();
+  const size_t numFaces = mesh->num_faces();
+
+  const auto& vbo = shared->vbos().front();
+  size_t vertexBytes = 0;
+  for (const auto& attribute : vbo.attributes)
+    vertexBytes += attribute.sizeInBytes;
+  EXPECT_EQ(perFace->vbos().front().attributes.size(), vbo.attributes.size());
+  EXPECT_EQ(numNodes * vertexBytes, vbo.data->getBufferSize());
+  EXPECT_EQ(numFaces * 4 * vertexBytes, perFace->vbos().front().data->getBufferSize());
+
+  const auto& ibo = shared->ibos().front();
+  ASSERT_EQ(numFaces * 6 * sizeof(uint32_t), ibo.data->getBufferSize());
+  auto indices = reinterpret_cast<const uint32_t*>(ibo.data->getBuffer());
+  for (size_t i = 0; i < numFaces * 6; ++i)
+    ASSERT_LT(indices[i], numNodes);
+}
+
+TEST_F(ShowFieldSharedVertexTest, ColorMapChangeReusesFaceGeometry)
+{
+  LogSettings::Instance().setVerbose(false);
+  showField_ = makeModule("ShowField");
+  showField_->setStateDefaults();
+  stubPortNWithThisData(showField_, 0, CreateEmptyLatVol(4, 5, 6));
+
+  for (bool shareVertices : { false, true })
+  {
+    stubPortNWithThisData(showField_, 1, StandardColorMapFactory::create("Rainbow"));
+    auto first = std::dynamic_pointer_cast<Graphics::Datatypes::GeometryObjectSpire>(executeFaces(shareVertices));
+
+    stubPortNWithThisData(showField_, 1, StandardColorMapFactory::create("Blackbody"));
+    auto recolored = std::dynamic_pointer_cast<Graphics::Datatypes::GeometryObjectSpire>(executeFaces(shareVertices));
+
+    stubPortNWithThisData(showField_, 1, StandardColorMapFactory::create("Blackbody", 256, 0, false, 2.0, 0.5));
+    auto rescaled = std::dynamic_pointer_cast<Graphics::Datatypes::GeometryObjectSpire>(executeFaces(shareVertices));
+
+    ASSERT_TRUE(first && recolored && rescaled);
+    EXPECT_EQ(first->ibos().front().data, recolored->ibos().front().data);
+    EXPECT_EQ(first->vbos().front().data, recolored->vbos().front().data);
+    EXPECT_EQ(first->ibos().front().data, rescaled->ibos().front().data);
+    EXPECT_NE(first->vbos().front().data, rescaled->vbos().front().data);
+    EXPECT_EQ(first->vbos().front().data->getBufferSize(), rescaled->vbos().front().data->getBufferSize());
+  }
+}
+
 class ShowFieldPerformanceTest : public ModuleTest {};
 
 TEST_F(ShowFieldPerformanceTest, TestFacePerformance)
@@ -291,6 +291,45 @@ FieldHandle CubeTriSurfLinearBasis(data_info_type type)
 
 }}
 
+FieldHandle SCIRun::TestUtils::GridTetVolLinearBasis(size_type sizex, size_type sizey, size_type sizez, data_info_type type)
+{
+  FieldInformation fi(mesh_info_type::TETVOLMESH_E, databasis_info_type::LINEARDATA_E, type);
+  FieldHandle field = CreateField(fi);
+  auto vmesh = field->vmesh();
+
+  auto node = [=](index_type i, index_type j, index_type k)
+  { return VMesh::Node::index_type(i + (sizex+1)*(j + (sizey+1)*k)); };
+
+  vmesh->node_reserve((sizex+1)*(sizey+1)*(sizez+1));
+  vmesh->elem_reserve(6*sizex*sizey*sizez);
+  for (index_type k = 0; k <= sizez; k++)
+    for (index_type j = 0; j <= sizey; j++)
+      for (index_type i = 0; i <= sizex; i++)
+        vmesh->add_point(Point(double(i)/sizex, double(j)/sizey, double(k)/sizez));
+
+  // Six tetrahedra around the diagonal from corner 0 to corner 6 of each cell
+  const int tets[6][4] = { {0,1,2,6}, {0,2,3,6}, {0,3,7,6}, {0,7,4,6}, {0,4,5,6}, {0,5,1,6} };
+  VMesh::Node::array_type vdata(4);
+  for (index_type k = 0; k < sizez; k++)
+    for (index_type j = 0; j < sizey; j++)
+      for (index_type i = 0; i < sizex; i++)
+      {
+        const VMesh::Node::index_type corners[8] = {
+          node(i,j,k), node(i+1,j,k), node(i+1,j+1,k), node(i,j+1,k),
+          node(i,j,k+1), node(i+1,j,k+1), node(i+1,j+1,k+1), node(i,j+1,k+1) };
+        for (const auto& tet : tets)
+        {
+          for (int n = 0; n < 4; n++)
+            vdata[n] = corners[tet[n]];
+          vmesh->add_elem(vdata);
+        }
+      }
+
+  field->vfield()->resize_values();
+  field->vfield()->clear_all_values();
+  return field;
+}
+
 FieldHandle SCIRun::TestUtils::CreateEmptyLatVol()
 {
   size_type sizex = 3, sizey = 4, sizez = 5;
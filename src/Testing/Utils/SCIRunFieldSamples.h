@@ -90,6 +90,10 @@ SCISHARE FieldHandle CubeTriSurfLinearBasis(data_info_type type);
 SCISHARE FieldHandle TetrahedronTriSurfConstantBasis(data_info_type type);
 SCISHARE FieldHandle TetrahedronTriSurfLinearBasis(data_info_type type);
 
+/// Unit cube split into sizex*sizey*sizez cells of six tetrahedra each.
+SCISHARE FieldHandle GridTetVolLinearBasis(size_type sizex, size_type sizey, size_type sizez,
+  data_info_type type = data_info_type::DOUBLE_E);
+
 SCISHARE FieldHandle CreateEmptyLatVol();
 SCISHARE FieldHandle CreateEmptyLatVol(size_type sizex, size_type sizey, size_type sizez,
   data_info_type type = data_info_type::DOUBLE_E,